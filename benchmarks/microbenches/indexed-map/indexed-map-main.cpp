@@ -36,9 +36,11 @@ int main(int argc, char** argv) {
   auto instance = map.createInstance();
   instance->listAllAvailableFunctions();
 
+  auto lookup = instance->get<bool(int64_t, int64_t*)>("lookup");
+
   int64_t val = 0;
-  auto x = instance->op("lookup", 1, &val);
-  LOG(INFO) << std::any_cast<bool>(x);
+  auto x = lookup(1, &val);
+  LOG(INFO) << x;
 
   return 0;
 }
@@ -0,0 +1,108 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#include <dcds/dcds.hpp>
+
+// Builds many small generated types in one process to measure the footprint of the (shared) JIT per type, and
+// whether destroying the builders gives the generated code back.
+
+static constexpr size_t n_types = 100;
+
+static size_t getCurrentRSS() {
+  // resident pages, see proc(5)
+  size_t total = 0, resident = 0;
+  if (auto* f = fopen("/proc/self/statm", "r")) {
+    if (fscanf(f, "%zu %zu", &total, &resident) != 2) resident = 0;
+    fclose(f);
+  }
+  return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+static size_t getPeakRSS() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+static std::shared_ptr<dcds::Builder> generateType(size_t i) {
+  auto name = "jit_service_type_" + std::to_string(i);
+  auto builder = std::make_shared<dcds::Builder>(name);
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto attr = builder->addAttribute("value", dcds::valueType::INT64, UINT64_C(0));
+
+  auto get = builder->createFunction("get", dcds::valueType::INT64);
+  auto get_tmp = get->addTempVariable("tmp", dcds::valueType::INT64);
+  get->getStatementBuilder()->addReadStatement(attr, get_tmp);
+  get->getStatementBuilder()->addReturnStatement(get_tmp);
+
+  auto set = builder->createFunction("set", dcds::valueType::VOID);
+  set->addArgument("new_value", dcds::valueType::INT64);
+  set->getStatementBuilder()->addUpdateStatement(attr, "new_value");
+  set->getStatementBuilder()->addReturnVoidStatement();
+
+  return builder;
+}
+
+int main(int argc, char** argv) {
+  dcds::InitializeLog(argc, argv);
+  LOG(INFO) << "JIT_SERVICE: building " << n_types << " types";
+
+  auto rss_start = getCurrentRSS();
+  std::vector<std::shared_ptr<dcds::Builder>> builders;
+  builders.reserve(n_types);
+
+  {
+    time_block t("Build time: ");
+    for (size_t i = 0; i < n_types; i++) {
+      builders.emplace_back(generateType(i));
+      builders.back()->build();
+    }
+  }
+
+  // touch every type once so that lazily compiled code is accounted for as well.
+  for (auto& builder : builders) {
+    auto* instance = builder->createInstance();
+    auto set = instance->get<void(int64_t)>("set");
+    auto get = instance->get<int64_t()>("get");
+    set(42);
+    CHECK(get() == 42);
+    delete instance;
+  }
+  auto rss_built = getCurrentRSS();
+
+  builders.clear();
+  auto rss_unloaded = getCurrentRSS();
+
+  LOG(INFO) << "RSS before: " << (rss_start >> 10) << " KB";
+  LOG(INFO) << "RSS with " << n_types << " types: " << (rss_built >> 10) << " KB ("
+            << ((rss_built - rss_start) / n_types >> 10) << " KB/type)";
+  LOG(INFO) << "RSS after unloading: " << (rss_unloaded >> 10) << " KB";
+  LOG(INFO) << "Peak RSS: " << (getPeakRSS() >> 10) << " KB";
+
+  return 0;
+}
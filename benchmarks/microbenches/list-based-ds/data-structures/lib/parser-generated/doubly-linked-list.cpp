@@ -351,7 +351,8 @@ size_t DoublyLinkedList::benchmark_fifo(size_t n_threads, size_t num_op_per_thre
   auto instance = builder->createInstance();
   auto thr = dcds::ThreadRunner(n_threads);
   auto runtime_ms = thr(
-      [num_op_per_thread](const uint64_t _tid, dcds::JitContainer* _instance) {
+      [num_op_per_thread](const uint64_t _tid, dcds::JitFunction<void(uint64_t)> _push_front,
+                          dcds::JitFunction<bool(uint64_t*)> _pop_back) {
         std::mt19937 gen;
         std::uniform_int_distribution<> distrib(0, 1);
         uint64_t val;
@@ -359,14 +360,14 @@ size_t DoublyLinkedList::benchmark_fifo(size_t n_threads, size_t num_op_per_thre
         for (size_t i = 0; i < num_op_per_thread; i++) {
           if (distrib(gen) == 0) {
             // push
-            _instance->op("push_front", i);
+            _push_front(i);
           } else {
             // pop
-            _instance->op("pop_back", &val);
+            _pop_back(&val);
           }
         }
       },
-      instance);
+      instance->get<void(uint64_t)>("push_front"), instance->get<bool(uint64_t*)>("pop_back"));
 
   dcds::storage::TableRegistry::getInstance().clear();
 
@@ -381,7 +382,8 @@ size_t DoublyLinkedList::benchmark_stack(size_t n_threads, size_t num_op_per_thr
   auto instance = builder->createInstance();
   auto thr = dcds::ThreadRunner(n_threads);
   auto runtime_ms = thr(
-      [num_op_per_thread](const uint64_t _tid, dcds::JitContainer* _instance) {
+      [num_op_per_thread](const uint64_t _tid, dcds::JitFunction<void(uint64_t)> _push_front,
+                          dcds::JitFunction<bool(uint64_t*)> _pop_front) {
         std::mt19937 gen;
         std::uniform_int_distribution<> distrib(0, 1);
         uint64_t val;
@@ -389,14 +391,14 @@ size_t DoublyLinkedList::benchmark_stack(size_t n_threads, size_t num_op_per_thr
         for (size_t i = 0; i < num_op_per_thread; i++) {
           if (distrib(gen) == 0) {
             // push
-            _instance->op("push_front", i);
+            _push_front(i);
           } else {
             // pop
-            _instance->op("pop_front", &val);
+            _pop_front(&val);
           }
         }
       },
-      instance);
+      instance->get<void(uint64_t)>("push_front"), instance->get<bool(uint64_t*)>("pop_front"));
 
   dcds::storage::TableRegistry::getInstance().clear();
 
@@ -412,7 +414,8 @@ size_t DoublyLinkedList::benchmark_stack2(size_t n_threads, size_t num_op_per_th
   auto instance = builder->createInstance();
   auto thr = dcds::ThreadRunner(n_threads);
   auto runtime_ms = thr(
-      [num_op_per_thread](const uint64_t _tid, dcds::JitContainer* _instance) {
+      [num_op_per_thread](const uint64_t _tid, dcds::JitFunction<void(uint64_t)> _push_back,
+                          dcds::JitFunction<bool(uint64_t*)> _pop_back) {
         std::mt19937 gen;
         std::uniform_int_distribution<> distrib(0, 1);
         uint64_t val;
@@ -420,14 +423,14 @@ size_t DoublyLinkedList::benchmark_stack2(size_t n_threads, size_t num_op_per_th
         for (size_t i = 0; i < num_op_per_thread; i++) {
           if (distrib(gen) == 0) {
             // push
-            _instance->op("push_back", i);
+            _push_back(i);
           } else {
             // pop
-            _instance->op("pop_back", &val);
+            _pop_back(&val);
           }
         }
       },
-      instance);
+      instance->get<void(uint64_t)>("push_back"), instance->get<bool(uint64_t*)>("pop_back"));
 
   dcds::storage::TableRegistry::getInstance().clear();
 
@@ -443,7 +446,8 @@ size_t DoublyLinkedList::benchmark_stack3(size_t n_threads, size_t num_op_per_th
   auto instance = builder->createInstance();
   auto thr = dcds::ThreadRunner(n_threads);
   auto runtime_ms = thr(
-      [num_op_per_thread](const uint64_t _tid, dcds::JitContainer* _instance) {
+      [num_op_per_thread](const uint64_t _tid, dcds::JitFunction<void(uint64_t)> _push_back,
+                          dcds::JitFunction<bool(uint64_t*)> _pop_back) {
         std::mt19937 gen;
         std::uniform_int_distribution<> distrib(1, 5);
         uint64_t val;
@@ -451,14 +455,14 @@ size_t DoublyLinkedList::benchmark_stack3(size_t n_threads, size_t num_op_per_th
         for (size_t i = 0; i < num_op_per_thread; i++) {
           if (distrib(gen) > 2) {
             // push
-            _instance->op("push_back", i);
+            _push_back(i);
           } else {
             // pop
-            _instance->op("pop_back", &val);
+            _pop_back(&val);
           }
         }
       },
-      instance);
+      instance->get<void(uint64_t)>("push_back"), instance->get<bool(uint64_t*)>("pop_back"));
 
   dcds::storage::TableRegistry::getInstance().clear();
 
@@ -112,7 +112,8 @@ size_t LinkedList::benchmark(size_t n_threads, size_t num_op_per_thread, bool pr
   auto instance = builder->createInstance();
   auto thr = dcds::ThreadRunner(n_threads);
   auto runtime_ms = thr(
-      [num_op_per_thread](const uint64_t _tid, dcds::JitContainer* _instance) {
+      [num_op_per_thread](const uint64_t _tid, dcds::JitFunction<void(uint64_t)> _push,
+                          dcds::JitFunction<bool(uint64_t*)> _pop) {
         constexpr size_t seed = 42;
         std::mt19937 gen;
         std::uniform_int_distribution<> distrib(0, 1);
@@ -121,14 +122,14 @@ size_t LinkedList::benchmark(size_t n_threads, size_t num_op_per_thread, bool pr
         for (size_t i = 0; i < num_op_per_thread; i++) {
           if (distrib(gen) == 0) {
             // push
-            _instance->op("push", i);
+            _push(i);
           } else {
             // pop
-            _instance->op("pop", &val);
+            _pop(&val);
           }
         }
       },
-      instance);
+      instance->get<void(uint64_t)>("push"), instance->get<bool(uint64_t*)>("pop"));
 
   dcds::storage::TableRegistry::getInstance().clear();
 
@@ -142,7 +143,8 @@ size_t LinkedList::benchmark2(size_t n_threads, size_t num_op_per_thread, bool p
   auto instance = builder->createInstance();
   auto thr = dcds::ThreadRunner(n_threads);
   auto runtime_ms = thr(
-      [num_op_per_thread](const uint64_t _tid, dcds::JitContainer* _instance) {
+      [num_op_per_thread](const uint64_t _tid, dcds::JitFunction<void(uint64_t)> _push,
+                          dcds::JitFunction<bool(uint64_t*)> _pop) {
         constexpr size_t seed = 42;
         std::mt19937 gen;
         std::uniform_int_distribution<> distrib(1, 5);
@@ -151,14 +153,14 @@ size_t LinkedList::benchmark2(size_t n_threads, size_t num_op_per_thread, bool p
         for (size_t i = 0; i < num_op_per_thread; i++) {
           if (distrib(gen) > 2) {
             // push
-            _instance->op("push", i);
+            _push(i);
           } else {
             // pop
-            _instance->op("pop", &val);
+            _pop(&val);
           }
         }
       },
-      instance);
+      instance->get<void(uint64_t)>("push"), instance->get<bool(uint64_t*)>("pop"));
 
   dcds::storage::TableRegistry::getInstance().clear();
 
@@ -172,12 +174,12 @@ size_t LinkedList::benchmark_push(size_t n_threads, size_t num_op_per_thread, bo
   auto instance = builder->createInstance();
   auto thr = dcds::ThreadRunner(n_threads);
   auto runtime_ms = thr(
-      [num_op_per_thread](const uint64_t _tid, dcds::JitContainer* _instance) {
+      [num_op_per_thread](const uint64_t _tid, dcds::JitFunction<void(uint64_t)> _push) {
         for (size_t i = 0; i < num_op_per_thread; i++) {
-          _instance->op("push", i);
+          _push(i);
         }
       },
-      instance);
+      instance->get<void(uint64_t)>("push"));
 
   dcds::storage::TableRegistry::getInstance().clear();
 
@@ -454,6 +456,9 @@ void FIFO::testMT(size_t n_threads, size_t iterations) {
   instance->op("empty");  // warmup
   instance->op("push", 1);
 
+  auto push = instance->get<void(uint64_t)>("push");
+  auto pop = instance->get<bool(uint64_t*)>("pop");
+
   std::vector<std::thread> runners;
   std::barrier<void (*)()> sync_point(n_threads, []() {});
 
@@ -477,11 +482,11 @@ void FIFO::testMT(size_t n_threads, size_t iterations) {
         }};
 
         for (size_t i = 0; i < iterations; i++) {
-          instance->op("push", 1);
+          push(1);
         }
 
         for (size_t i = 0; i < iterations; i++) {
-          instance->op("pop", &val);
+          pop(&val);
           local_sum += val;
         }
       }
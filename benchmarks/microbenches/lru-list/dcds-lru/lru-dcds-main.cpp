@@ -132,21 +132,22 @@ static auto test_dcds_MT_rw_zipf(size_t n_threads, double zipf_theta = 0, bool p
   }
 
   auto instance = lru->createInstance();
+  auto insert = instance->get<bool(int64_t, int64_t)>("insert");
 
   auto thr = dcds::ThreadRunner(n_threads);
   std::vector<std::vector<size_t>> thread_keys = initWorkload(n_threads, zipf_theta);
 
   auto runtime_ms = thr(
-      [thread_keys](const uint64_t _tid, dcds::JitContainer* _instance, const size_t _nr) {
+      [thread_keys](const uint64_t _tid, dcds::JitFunction<bool(int64_t, int64_t)> _insert, const size_t _nr) {
         static thread_local auto thr_keys = thread_keys[_tid];
 
         for (size_t i = 0; i < num_op_per_thread; i++) {
           // auto c = i%domain_max;
           auto c = thr_keys[i];
-          auto v = _instance->op("insert", c, c);
+          auto v = _insert(c, c);
         }
       },
-      instance, domain_max);
+      insert, domain_max);
 
   dcds::storage::TableRegistry::getInstance().clear();
 
@@ -0,0 +1,96 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <dcds/dcds.hpp>
+
+#include "dcds-generated/indexed-map.hpp"
+
+// Build (JIT) time of the optimization profiles against the throughput of the code they generate.
+
+static constexpr size_t n_keys = 1'000'000;
+
+static std::string toString(dcds::hints::OptimizationProfile profile) {
+  switch (profile) {
+    case dcds::hints::OptimizationProfile::LATENCY:
+      return "latency";
+    case dcds::hints::OptimizationProfile::SIZE:
+      return "size";
+    case dcds::hints::OptimizationProfile::COMPILE_SPEED:
+      return "compile-speed";
+  }
+  return "unknown";
+}
+
+static void benchmarkProfile(dcds::hints::OptimizationProfile profile, dcds::hints::TargetHints target) {
+  auto label = toString(profile) + (target == dcds::hints::TargetHints::PORTABLE ? "/portable" : "/host");
+
+  auto map = dcds::datastructures::IndexedMap();
+  map.getBuilder()->addHint(profile);
+  map.getBuilder()->addHint(target);
+
+  std::chrono::milliseconds build_time{};
+  {
+    time_block t{[&](auto tms) { build_time = tms; }};
+    map.build(true, false);
+  }
+
+  auto instance = map.createInstance();
+  auto insert = instance->get<bool(int64_t, int64_t)>("insert");
+  auto lookup = instance->get<bool(int64_t, int64_t*)>("lookup");
+
+  std::chrono::milliseconds insert_time{};
+  {
+    time_block t{[&](auto tms) { insert_time = tms; }};
+    for (size_t i = 0; i < n_keys; i++) insert(static_cast<int64_t>(i), static_cast<int64_t>(i));
+  }
+
+  std::chrono::milliseconds lookup_time{};
+  int64_t sum = 0;
+  {
+    time_block t{[&](auto tms) { lookup_time = tms; }};
+    for (size_t i = 0; i < n_keys; i++) {
+      int64_t val = 0;
+      lookup(static_cast<int64_t>(i), &val);
+      sum += val;
+    }
+  }
+  CHECK(sum == static_cast<int64_t>(n_keys * (n_keys - 1) / 2)) << "unexpected lookup results";
+
+  auto mops = [](auto time) { return static_cast<double>(n_keys) / std::max<double>(1, time.count()) / 1000; };
+  LOG(INFO) << label << ": build " << build_time.count() << " ms, insert " << mops(insert_time)
+            << " MOps/s, lookup " << mops(lookup_time) << " MOps/s";
+  delete instance;
+}
+
+int main(int argc, char** argv) {
+  dcds::InitializeLog(argc, argv);
+  LOG(INFO) << "OPT_PROFILES: " << n_keys << " keys";
+
+  for (auto target : {dcds::hints::TargetHints::HOST_CPU, dcds::hints::TargetHints::PORTABLE}) {
+    for (auto profile : {dcds::hints::OptimizationProfile::LATENCY, dcds::hints::OptimizationProfile::SIZE,
+                         dcds::hints::OptimizationProfile::COMPILE_SPEED}) {
+      benchmarkProfile(profile, target);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <dcds/dcds.hpp>
+
+// Contention on neighbouring records of an array under the different record layouts. Every thread increments its own
+// slot, so any slowdown with more threads comes from records (or their locks) sharing a cache line.
+
+static constexpr size_t n_ops_per_thread = 10'000'000;
+static constexpr size_t max_threads = 16;
+
+struct layout_policy_t {
+  std::string label;
+  std::vector<dcds::hints::LayoutHints> hints;
+};
+
+static auto buildSlotArray(const layout_policy_t& policy, size_t policy_id) {
+  auto builder = std::make_shared<dcds::Builder>("RecordLayout_" + std::to_string(policy_id));
+
+  // type names are table names, so each policy gets its own slot type.
+  auto slot = builder->createType("Slot_" + std::to_string(policy_id));
+  for (auto hint : policy.hints) slot->addHint(hint);
+  auto value = slot->addAttribute("value", dcds::valueType::INT64, UINT64_C(0));
+
+  {
+    auto fn = slot->createFunction("inc", dcds::valueType::VOID);
+    fn->setAlwaysInline(true);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    sb->addReadStatement(value, v);
+    sb->addUpdateStatement(value, std::make_shared<dcds::expressions::AddExpression>(
+                                      v, std::make_shared<dcds::expressions::Int64Constant>(1)));
+    sb->addReturnVoidStatement();
+  }
+
+  {
+    auto fn = slot->createFunction("get", dcds::valueType::INT64);
+    fn->setAlwaysInline(true);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    sb->addReadStatement(value, v);
+    sb->addReturnStatement(v);
+  }
+
+  builder->addAttributeArray("slots", slot, max_threads);
+
+  for (auto fn_name : {"inc", "get"}) {
+    auto is_get = std::string(fn_name) == "get";
+    auto fn = builder->createFunction(fn_name, is_get ? dcds::valueType::INT64 : dcds::valueType::VOID);
+    auto idx = fn->addArgument("idx", dcds::valueType::INT64);
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto sb = fn->getStatementBuilder();
+    sb->addReadStatement(builder->getAttribute("slots"), rec, idx);
+    if (is_get) {
+      auto ret = fn->addTempVariable("ret", dcds::valueType::INT64);
+      sb->addMethodCall(slot, rec, fn_name, ret);
+      sb->addReturnStatement(ret);
+    } else {
+      sb->addMethodCall(slot, rec, fn_name);
+      sb->addReturnVoidStatement();
+    }
+  }
+
+  builder->injectCC();
+  builder->build();
+  return builder;
+}
+
+static void benchmarkPolicy(const layout_policy_t& policy, size_t policy_id) {
+  auto builder = buildSlotArray(policy, policy_id);
+  auto instance = builder->createInstance();
+  auto inc = instance->get<void(int64_t)>("inc");
+  auto get = instance->get<int64_t(int64_t)>("get");
+
+  for (size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+    dcds::ThreadRunner thr(static_cast<std::ptrdiff_t>(n_threads));
+    auto runtime_ms = thr(
+        [&inc](const uint64_t tid) {
+          for (size_t i = 0; i < n_ops_per_thread; i++) inc(static_cast<int64_t>(tid));
+        });
+
+    auto mops = static_cast<double>(n_ops_per_thread * n_threads) / std::max<double>(1, runtime_ms) / 1000;
+    LOG(INFO) << policy.label << ": threads " << n_threads << ", " << mops << " MOps/s, " << runtime_ms << " ms";
+  }
+
+  CHECK(get(0) > 0) << "slot 0 was never incremented";
+  delete instance;
+}
+
+int main(int argc, char** argv) {
+  dcds::InitializeLog(argc, argv);
+  LOG(INFO) << "RECORD_LAYOUT: " << n_ops_per_thread << " ops per thread";
+
+  using dcds::hints::LayoutHints;
+  std::vector<layout_policy_t> policies{
+      {"packed", {LayoutHints::PACKED}},
+      {"aligned-columns", {LayoutHints::ALIGNED_COLUMNS}},
+      {"cache-line-records", {LayoutHints::ALIGNED_COLUMNS, LayoutHints::CACHE_LINE_ALIGNED_RECORDS}},
+      {"cache-line-records/separate-metadata",
+       {LayoutHints::ALIGNED_COLUMNS, LayoutHints::CACHE_LINE_ALIGNED_RECORDS, LayoutHints::SEPARATE_METADATA}},
+  };
+
+  for (size_t i = 0; i < policies.size(); i++) {
+    benchmarkPolicy(policies[i], i);
+  }
+
+  dcds::storage::TableRegistry::getInstance().clear();
+  return 0;
+}
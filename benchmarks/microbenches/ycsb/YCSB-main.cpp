@@ -23,6 +23,7 @@
 #include <absl/flags/parse.h>
 
 #include <dcds/dcds.hpp>
+#include <thread>
 
 #include "ycsb.hpp"
 
@@ -32,6 +33,16 @@ ABSL_FLAG(uint16_t, num_threads, 1, "number of threads");
 ABSL_FLAG(uint16_t, rw_ratio, 0, "rw_ratio");
 ABSL_FLAG(double, zipf_theta, 0, "zipf_theta");
 ABSL_FLAG(bool, use_flag, false, "use the flags or ignore");
+ABSL_FLAG(std::string, index, "array", "records storage: array, hash (cuckoo), open_addressing or ordered");
+ABSL_FLAG(bool, read_scaling, false, "lookup-only throughput of every records storage, from 1 to 144 threads");
+
+static std::optional<dcds::hints::IndexHints> parseIndexFlag(const std::string& index) {
+  if (index == "array") return std::nullopt;
+  if (index == "hash") return dcds::hints::IndexHints::HASH;
+  if (index == "open_addressing") return dcds::hints::IndexHints::OPEN_ADDRESSING;
+  if (index == "ordered") return dcds::hints::IndexHints::ORDERED;
+  LOG(FATAL) << "Unknown index: " << index;
+}
 
 static void play() {
   LOG(INFO) << "play";
@@ -104,6 +115,28 @@ static void no_flags() {
   }
 }
 
+// Read-only scaling of the indexes: open_addressing and ordered lookups do not write to shared memory in the index
+// (optimistic reads; open_addressing only pins the epoch in a slot of the thread), while hash (libcuckoo) locks the
+// buckets which it reads. The records and their number stay the same across the thread counts, so that only the
+// concurrency changes.
+static void read_scaling() {
+  constexpr size_t num_records = 16_M;
+  std::vector<size_t> cores{1, 2, 4, 8, 16, 18, 24, 32, 36, 48, 64, 72, 84, 108, 120, 128, 144};
+
+  for (const auto* index : {"array", "hash", "open_addressing", "ordered"}) {
+    LOG(INFO) << "###### Index: " << index;
+    {
+      auto ycsb = YCSB(1, num_records, parseIndexFlag(index));
+      for (auto t : cores) {
+        if (t > std::thread::hardware_concurrency()) break;
+        ycsb.test_MT_lookup_random(t);
+      }
+    }
+    dcds::storage::TableRegistry::getInstance().clear();
+    dcds::indexes::IndexRegistry::getInstance().clear();
+  }
+}
+
 static void use_flags(int argc, char** argv) {
   // absl::ParseCommandLine(argc, argv);
   auto num_columns = absl::GetFlag(FLAGS_num_columns);
@@ -111,6 +144,7 @@ static void use_flags(int argc, char** argv) {
   auto num_threads = absl::GetFlag(FLAGS_num_threads);
   auto rw_ratio = absl::GetFlag(FLAGS_rw_ratio);
   auto zipf_theta = absl::GetFlag(FLAGS_zipf_theta);
+  auto index = absl::GetFlag(FLAGS_index);
 
   if (zipf_theta >= 1) zipf_theta = zipf_theta / 100;
 
@@ -121,11 +155,12 @@ static void use_flags(int argc, char** argv) {
   LOG(INFO) << "num_threads: " << num_threads;
   LOG(INFO) << "rw_ratio: " << rw_ratio;
   LOG(INFO) << "zipf_theta: " << zipf_theta;
+  LOG(INFO) << "index: " << index;
 
   assert(rw_ratio >= 0 && rw_ratio <= 100);
 
   for (size_t r = 0; r < num_runs; r++) {
-    auto ycsb = YCSB(num_columns, num_threads * 1_M);
+    auto ycsb = YCSB(num_columns, num_threads * 1_M, parseIndexFlag(index));
     if (zipf_theta > 0) {
       ycsb.test_MT_rw_zipf(num_threads, zipf_theta, rw_ratio);
     } else {
@@ -133,6 +168,7 @@ static void use_flags(int argc, char** argv) {
     }
 
     dcds::storage::TableRegistry::getInstance().clear();
+    dcds::indexes::IndexRegistry::getInstance().clear();
   }
 }
 
@@ -143,7 +179,9 @@ int main(int argc, char** argv) {
   LOG(INFO) << "YCSB";
 
   auto use_flag = absl::GetFlag(FLAGS_use_flag);
-  if (use_flag) {
+  if (absl::GetFlag(FLAGS_read_scaling)) {
+    read_scaling();
+  } else if (use_flag) {
     use_flags(argc, argv);
   } else {
     play();
@@ -23,12 +23,19 @@
 #define DCDS_YCSB_HPP
 
 #include <dcds/dcds.hpp>
+#include <dcds/indexes/index-registry.hpp>
+#include <numeric>
+#include <optional>
 #include <random>
+#include <thread>
 
 #include "dcds/util/bench-utils/zipf-generator.hpp"
 
 constexpr size_t num_txn_per_thread = 5_M;
 constexpr size_t num_ops_per_txn = 10;
+// lookup/update always take max_columns value arguments so that they can be resolved once into a fixed-signature
+// typed handle; only the first n_columns of them are read/written.
+constexpr size_t max_columns = 10;
 
 const std::string item_name = "YCSB_ITEM";
 const auto item_type = dcds::valueType::INT64;
@@ -42,6 +49,19 @@ class YCSB {
       item_builder->addAttribute("column_" + std::to_string(i), item_type, UINT64_C(88));
     }
 
+    if (index_type) {
+      auto key_attr = item_builder->addAttribute("key_", dcds::valueType::INT64, UINT64_C(0));
+
+      // void set_key(key)
+      auto set_key_fn = item_builder->createFunction("set_key", dcds::valueType::VOID);
+      auto key_arg = set_key_fn->addArgument("key", dcds::valueType::INT64);
+      set_key_fn->setAlwaysInline(true);
+
+      auto sb = set_key_fn->getStatementBuilder();
+      sb->addUpdateStatement(key_attr, key_arg);
+      sb->addReturnVoidStatement();
+    }
+
     // read_all
     {
       // void get_record(column_1 *, column_2 *, column_2 *,...)
@@ -84,12 +104,27 @@ class YCSB {
     return item_builder;
   }
 
+  // only for indexed records (the array ones exist upfront); the initial records are bulk loaded instead.
+  void generateInsertFunction() {
+    // void insert(key)
+    auto fn = _builder->createFunction("insert", dcds::valueType::VOID);
+    auto key_arg = fn->addArgument("key", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+
+    auto rec = sb->addInsertStatement(_builder->getRegisteredType(item_name), "rec");
+    sb->addMethodCall(_builder->getRegisteredType(item_name), rec, "set_key",
+                      std::vector<std::shared_ptr<dcds::expressions::Expression>>{key_arg});
+    sb->addInsertStatement(_builder->getAttribute("records"), key_arg, rec);
+
+    sb->addReturnVoidStatement();
+  }
+
   void generateUpdateFunction() {
     // void update(key, val_1, val_2, ...)
     auto fn = _builder->createFunction("update", dcds::valueType::VOID);
     auto key_arg = fn->addArgument("key", dcds::valueType::INT64);
 
-    for (size_t i = 0; i < n_columns; i++) {
+    for (size_t i = 0; i < max_columns; i++) {
       fn->addArgument("val_" + std::to_string(i), item_type);
     }
 
@@ -117,7 +152,7 @@ class YCSB {
     auto fn = _builder->createFunction("lookup", dcds::valueType::VOID);
     auto key_arg = fn->addArgument("key", dcds::valueType::INT64);
 
-    for (size_t i = 0; i < n_columns; i++) {
+    for (size_t i = 0; i < max_columns; i++) {
       fn->addArgument("column_" + std::to_string(i) + "_ret", item_type, true);
     }
 
@@ -184,13 +219,19 @@ class YCSB {
   }
 
  public:
+  using lookup_fn_t = dcds::JitFunction<void(int64_t, int64_t*, int64_t*, int64_t*, int64_t*, int64_t*, int64_t*,
+                                             int64_t*, int64_t*, int64_t*, int64_t*)>;
+  using update_fn_t = dcds::JitFunction<void(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t,
+                                             int64_t, int64_t, int64_t)>;
+
   inline auto test_MT_lookup_random(size_t n_threads, bool print_res = true) {
     assert(instance);
+    auto lookup_fn = instance->get<lookup_fn_t::signature_t>("lookup");
     auto thr = dcds::ThreadRunner(n_threads);
 
     //  dcds::profiling::ProfileRegion my_region("YCSB_MT_lookup_random");
     auto runtime_ms = thr(
-        [](const uint64_t _tid, dcds::JitContainer* _instance, size_t _nr) {
+        [](const uint64_t _tid, lookup_fn_t lookup, size_t _nr) {
           int64_t o1 = 99;
           int64_t o2 = 99;
           int64_t o3 = 99;
@@ -205,12 +246,11 @@ class YCSB {
           std::uniform_real_distribution<double> dist{0.0, 1.0};
           // dcds::profiling::Profile::resume();
           for (size_t i = 0; i < num_txn_per_thread; i++) {
-            _instance->op("lookup", (static_cast<size_t>(dist(engine) * _nr)) % _nr, &o1, &o2, &o3, &o4, &o5, &o6, &o7,
-                          &o8, &o9, &o10);
+            lookup((static_cast<size_t>(dist(engine) * _nr)) % _nr, &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
           }
           // dcds::profiling::Profile::pause();
         },
-        instance, n_records);
+        lookup_fn, n_records);
 
     if (print_res) printThroughput(runtime_ms, n_threads, " (Random)");
     return runtime_ms;
@@ -218,11 +258,12 @@ class YCSB {
 
   inline auto test_MT_lookup_sequential(size_t n_threads, bool print_res = true) {
     assert(instance);
+    auto lookup_fn = instance->get<lookup_fn_t::signature_t>("lookup");
     auto thr = dcds::ThreadRunner(n_threads);
 
     //  dcds::profiling::ProfileRegion my_region("YCSB_MT_lookup_sequential");
     auto runtime_ms = thr(
-        [](const uint64_t _tid, dcds::JitContainer* _instance, size_t _nr) {
+        [](const uint64_t _tid, lookup_fn_t lookup, size_t _nr) {
           int64_t o1 = 99;
           int64_t o2 = 99;
           int64_t o3 = 99;
@@ -235,10 +276,10 @@ class YCSB {
           int64_t o10 = 99;
 
           for (size_t i = 0; i < num_txn_per_thread; i++) {
-            _instance->op("lookup", i % _nr, &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
+            lookup(i % _nr, &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
           }
         },
-        instance, n_records);
+        lookup_fn, n_records);
 
     if (print_res) printThroughput(runtime_ms, n_threads, " (Sequential)");
     return runtime_ms;
@@ -247,11 +288,13 @@ class YCSB {
   inline auto test_MT_rw_random(size_t n_threads, const uint write_ratio = 50, bool print_res = true) {
     assert(instance);
     assert(write_ratio >= 0 && write_ratio <= 100);
+    auto lookup_fn = instance->get<lookup_fn_t::signature_t>("lookup");
+    auto update_fn = instance->get<update_fn_t::signature_t>("update");
     auto thr = dcds::ThreadRunner(n_threads);
 
     //  dcds::profiling::ProfileRegion my_region("YCSB_MT_lookup_random");
     auto runtime_ms = thr(
-        [write_ratio](const uint64_t _tid, dcds::JitContainer* _instance, const size_t _nr) {
+        [write_ratio](const uint64_t _tid, lookup_fn_t lookup, update_fn_t update, const size_t _nr) {
           int64_t o1 = 99;
           int64_t o2 = 99;
           int64_t o3 = 99;
@@ -269,7 +312,7 @@ class YCSB {
           if (write_ratio == 0) {
             for (size_t i = 0; i < num_txn_per_thread; i++) {
               // read-op
-              _instance->op("lookup", dist(engine), &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
+              lookup(dist(engine), &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
             }
           } else {
             std::mt19937 rw_gen(std::random_device{}());
@@ -278,15 +321,15 @@ class YCSB {
             for (size_t i = 0; i < num_txn_per_thread; i++) {
               if (rw_dist(rw_gen) < write_ratio) {
                 // write-op
-                _instance->op("update", dist(engine), &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
+                update(dist(engine), o1, o2, o3, o4, o5, o6, o7, o8, o9, o10);
               } else {
                 // read-op
-                _instance->op("lookup", dist(engine), &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
+                lookup(dist(engine), &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
               }
             }
           }
         },
-        instance, n_records);
+        lookup_fn, update_fn, n_records);
 
     if (print_res) printThroughput(runtime_ms, n_threads, " (Random)(R/W: " + std::to_string(write_ratio) + " )");
     return runtime_ms;
@@ -299,11 +342,13 @@ class YCSB {
 
     assert(instance);
     assert(write_ratio >= 0 && write_ratio <= 100);
+    auto lookup_fn = instance->get<lookup_fn_t::signature_t>("lookup");
+    auto update_fn = instance->get<update_fn_t::signature_t>("update");
     auto thr = dcds::ThreadRunner(n_threads);
 
     //  dcds::profiling::ProfileRegion my_region("YCSB_MT_lookup_random");
     auto runtime_ms = thr(
-        [write_ratio, zipf_theta](const uint64_t _tid, dcds::JitContainer* _instance, const size_t _nr) {
+        [write_ratio, zipf_theta](const uint64_t _tid, lookup_fn_t lookup, update_fn_t update, const size_t _nr) {
           int64_t o1 = 99;
           int64_t o2 = 99;
           int64_t o3 = 99;
@@ -322,7 +367,7 @@ class YCSB {
           if (write_ratio == 0) {
             for (size_t i = 0; i < num_txn_per_thread; i++) {
               // read-op
-              _instance->op("lookup", zipf(), &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
+              lookup(zipf(), &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
             }
           } else {
             std::mt19937 rw_gen(std::random_device{}());
@@ -331,15 +376,15 @@ class YCSB {
             for (size_t i = 0; i < num_txn_per_thread; i++) {
               if (rw_dist(rw_gen) < write_ratio) {
                 // write-op
-                _instance->op("update", zipf(), &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
+                update(zipf(), o1, o2, o3, o4, o5, o6, o7, o8, o9, o10);
               } else {
                 // read-op
-                _instance->op("lookup", zipf(), &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
+                lookup(zipf(), &o1, &o2, &o3, &o4, &o5, &o6, &o7, &o8, &o9, &o10);
               }
             }
           }
         },
-        instance, n_records);
+        lookup_fn, update_fn, n_records);
 
     if (print_res)
       printThroughput(runtime_ms, n_threads,
@@ -376,11 +421,24 @@ class YCSB {
               << " | total_time: " << runtime_ms << "ms";
   }
 
-  explicit YCSB(size_t num_columns = 1, size_t num_records = 16_M)
-      : n_columns(num_columns), n_records(num_records), _n_ops(0), _builder(std::make_shared<dcds::Builder>("YCSB")) {
+  // index: records in an indexed list with the given index (e.g., to compare the indexes) instead of an array.
+  explicit YCSB(size_t num_columns = 1, size_t num_records = 16_M,
+                std::optional<dcds::hints::IndexHints> index = std::nullopt)
+      : n_columns(num_columns),
+        n_records(num_records),
+        _n_ops(0),
+        index_type(index),
+        _builder(std::make_shared<dcds::Builder>("YCSB")) {
+    CHECK(n_columns <= max_columns) << "YCSB supports at most " << max_columns << " columns";
     auto ycsb_item = this->generateYCSB_Item();
 
-    _builder->addAttributeArray("records", ycsb_item, num_records);
+    if (index_type) {
+      // the number of records is known upfront.
+      _builder->addAttributeIndexedList("records", ycsb_item, "key_", *index_type, {n_records});
+      this->generateInsertFunction();
+    } else {
+      _builder->addAttributeArray("records", ycsb_item, num_records);
+    }
 
     this->generateUpdateFunction();
     this->generateLookupFunction();
@@ -398,6 +456,18 @@ class YCSB {
     _builder->build();
 
     instance = _builder->createInstance();
+    if (index_type) {
+      // the instance is not shared yet: load it without a transaction per record.
+      std::vector<int64_t> keys(n_records);
+      std::iota(keys.begin(), keys.end(), 0);
+      instance->bulkLoad("records", keys.data(), keys.size(), std::thread::hardware_concurrency());
+
+      for (const auto& stats : dcds::indexes::IndexRegistry::getInstance().getStats()) {
+        LOG(INFO) << "Index: entries: " << stats.entries << " | memory: " << (stats.memory_bytes / 1_M) << "MB"
+                  << " | resizes: " << stats.resizes << " | resize_time: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(stats.resize_time).count() << "ms";
+      }
+    }
     // LOG(INFO) << "Instance: " << instance;
     // instance->listAllAvailableFunctions();
     //    LOG(INFO) << "warmup--";
@@ -412,6 +482,7 @@ class YCSB {
   const size_t n_columns;
   const size_t n_records;
   size_t _n_ops;
+  const std::optional<dcds::hints::IndexHints> index_type;
   std::shared_ptr<dcds::Builder> _builder;
   dcds::JitContainer* instance;
 };
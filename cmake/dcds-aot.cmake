@@ -0,0 +1,56 @@
+# Ahead-of-time (AOT) generated data structures.
+#
+# dcds_add_aot_library(<target>
+#     GENERATOR <executable-target>
+#     DATA_STRUCTURES <name>...
+#     [OUTPUT_DIRECTORY <dir>])
+#
+# At build time, runs `<generator> <output-dir>`. The generator is a regular program linking dcds, which declares
+# the data structures with dcds::Builder and exports each of them with dcds::CodeExporter::exportToDirectory.
+# For every name in DATA_STRUCTURES, it is expected to produce <output-dir>/<name>.o and <output-dir>/<name>.hpp.
+# The objects are archived into the static library <target>, which exposes the generated headers and links the
+# DCDS runtime only (dcds_runtime: storage, transactions, indexes and the runtime functions, without LLVM).
+# CodeExporter targets the baseline CPU of the triple unless the generator asks for
+# dcds::hints::TargetHints::HOST_CPU, so the library can run on other machines than the build machine. E.g., as in
+# examples/aot:
+#
+#   add_executable(counter_generator generator.cpp)
+#   target_link_libraries(counter_generator PUBLIC dcds)
+#   dcds_add_aot_library(counter_aot GENERATOR counter_generator DATA_STRUCTURES Counter)
+#   target_link_libraries(my_app PUBLIC counter_aot)   # #include <Counter.hpp>, dcds::aot::Counter
+function(dcds_add_aot_library target)
+    cmake_parse_arguments(AOT "" "GENERATOR;OUTPUT_DIRECTORY" "DATA_STRUCTURES" ${ARGN})
+
+    if (NOT AOT_GENERATOR)
+        message(FATAL_ERROR "dcds_add_aot_library(${target}): GENERATOR is required")
+    endif ()
+    if (NOT AOT_DATA_STRUCTURES)
+        message(FATAL_ERROR "dcds_add_aot_library(${target}): DATA_STRUCTURES is required")
+    endif ()
+    if (NOT AOT_OUTPUT_DIRECTORY)
+        set(AOT_OUTPUT_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}/${target}-aot)
+    endif ()
+
+    set(_objects)
+    set(_headers)
+    foreach (_ds ${AOT_DATA_STRUCTURES})
+        list(APPEND _objects ${AOT_OUTPUT_DIRECTORY}/${_ds}.o)
+        list(APPEND _headers ${AOT_OUTPUT_DIRECTORY}/${_ds}.hpp)
+    endforeach ()
+
+    add_custom_command(
+            OUTPUT ${_objects} ${_headers}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${AOT_OUTPUT_DIRECTORY}
+            COMMAND $<TARGET_FILE:${AOT_GENERATOR}> ${AOT_OUTPUT_DIRECTORY}
+            DEPENDS ${AOT_GENERATOR}
+            COMMENT "Generating DCDS AOT data structures: ${AOT_DATA_STRUCTURES}"
+            VERBATIM)
+
+    set_source_files_properties(${_objects} PROPERTIES EXTERNAL_OBJECT TRUE GENERATED TRUE)
+    set_source_files_properties(${_headers} PROPERTIES GENERATED TRUE)
+
+    add_library(${target} STATIC ${_objects} ${_headers})
+    set_target_properties(${target} PROPERTIES LINKER_LANGUAGE CXX)
+    target_include_directories(${target} PUBLIC ${AOT_OUTPUT_DIRECTORY})
+    target_link_libraries(${target} PUBLIC dcds_runtime)
+endfunction(dcds_add_aot_library)
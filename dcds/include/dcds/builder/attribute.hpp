@@ -30,6 +30,7 @@
 #include <utility>
 #include <vector>
 
+#include "dcds/builder/hints/builder-hints.hpp"
 #include "dcds/common/common.hpp"
 #include "dcds/common/types.hpp"
 #include "dcds/util/logging.hpp"
@@ -84,6 +85,9 @@ class Attribute {
 
   bool is_compile_time_constant;
   bool is_runtime_constant;
+
+  // layout hint: stored in the record's out-of-line cold part (see BuilderOptPasses::opt_pass_splitHotColdAttributes)
+  bool is_cold = false;
 };
 
 class SimpleAttribute : public Attribute {
@@ -144,21 +148,99 @@ class AttributeList : public Attribute {
 // fixed-length, can be integer-indexed.
 class AttributeArray : public AttributeList {
  public:
-  AttributeArray(std::string _name, const std::shared_ptr<Builder>& _type, size_t _len)
-      : AttributeList(std::move(_name), _type, _len) {}
+  AttributeArray(std::string _name, const std::shared_ptr<Builder>& _type, size_t _len, uint32_t _layout_flags = 0)
+      : AttributeList(std::move(_name), _type, _len), layout_flags(_layout_flags) {}
+
+  AttributeArray(const std::string& _name, dcds::valueType _type, size_t _len, std::any default_value = {},
+                 size_t _lock_stripes = 0)
+      : AttributeList(_name, std::make_shared<SimpleAttribute>(_name, _type, std::move(default_value)), _len),
+        lock_stripes(_lock_stripes) {}
+
+  // hints::LayoutHints added to the ones of the element type for the storage of this array only (e.g., COLUMN_STORE).
+  // Arrays with extra flags get their own table.
+  const uint32_t layout_flags = 0;
 
-  AttributeArray(const std::string& _name, dcds::valueType _type, size_t _len, std::any default_value = {})
-      : AttributeList(_name, std::make_shared<SimpleAttribute>(_name, _type, std::move(default_value)), _len) {}
+  // primitive arrays: element i is locked with stripe (i % lock_stripes), 0 locks the owning record instead.
+  const size_t lock_stripes = 0;
 };
 
+// Attribute of a composite key, which takes `bits` bits of the packed key.
+struct CompositeKeyPart {
+  std::string attribute;
+  uint32_t bits;
+};
+
+// Word of each part of a composite key: the parts are packed in order into 64-bit words, and a part which does not fit
+// in the rest of a word starts the next one.
+inline std::vector<uint32_t> compositeKeyWords(const std::vector<uint32_t>& bits) {
+  std::vector<uint32_t> words;
+  uint32_t word = 0;
+  uint32_t used = 0;
+  for (auto part_bits : bits) {
+    if (used + part_bits > 64) {
+      word++;
+      used = 0;
+    }
+    words.push_back(word);
+    used += part_bits;
+  }
+  return words;
+}
+
+// Width of the binary key (indexes::BinaryKey) of a composite key of more than one word, 0 for one word (INT64).
+inline size_t compositeKeyBytes(const std::vector<CompositeKeyPart>& parts) {
+  std::vector<uint32_t> bits;
+  for (const auto& part : parts) bits.push_back(part.bits);
+  auto words = bits.empty() ? 0 : compositeKeyWords(bits).back() + 1;
+  return words <= 1 ? 0 : (words == 2 ? 16 : 32);
+}
+
 // variable-length, index. cannot be integer-indexed.
 class AttributeIndexedList : public AttributeList {
  public:
   // later: have type of index also, maybe we can figure that out from workload.
-  AttributeIndexedList(std::string _name, const std::shared_ptr<Builder>& _type, std::string key_attribute_name)
-      : AttributeList(std::move(_name), _type, 0), key_attribute(std::move(key_attribute_name)) {}
-
+  AttributeIndexedList(std::string _name, const std::shared_ptr<Builder>& _type, std::string key_attribute_name,
+                       valueType _key_type, hints::IndexHints _index_type = hints::IndexHints::HASH,
+                       hints::IndexSizeHints _size_hints = {})
+      : AttributeList(std::move(_name), _type, 0),
+        key_attribute(std::move(key_attribute_name)),
+        key_type(_key_type),
+        index_type(_index_type),
+        size_hints(_size_hints) {}
+
+  AttributeIndexedList(std::string _name, const std::shared_ptr<Builder>& _type,
+                       std::vector<CompositeKeyPart> _key_parts,
+                       hints::IndexHints _index_type = hints::IndexHints::HASH,
+                       hints::IndexSizeHints _size_hints = {}, std::string _primary_list = {}, bool _is_unique = true)
+      : AttributeList(std::move(_name), _type, 0),
+        key_type(compositeKeyBytes(_key_parts) ? valueType::RECORD_PTR : valueType::INT64),
+        key_bytes(compositeKeyBytes(_key_parts)),
+        key_parts(std::move(_key_parts)),
+        index_type(_index_type),
+        size_hints(_size_hints),
+        primary_list(std::move(_primary_list)),
+        is_unique(_is_unique) {}
+
+  [[nodiscard]] bool isCompositeKey() const { return !key_parts.empty(); }
+  [[nodiscard]] bool isSecondaryIndex() const { return !primary_list.empty(); }
+
+  // empty for composite keys, which are packed from key_parts (expressions::CompositeKeyExpression).
   const std::string key_attribute;
+  const valueType key_type;
+  // composite keys wider than 64 bits: the bytes of their binary key, which the generated code passes by pointer (the
+  // key_type is RECORD_PTR). 0 otherwise.
+  const size_t key_bytes = 0;
+  const std::vector<CompositeKeyPart> key_parts{};
+  const hints::IndexHints index_type;
+  const hints::IndexSizeHints size_hints;
+
+  // Secondary indexes (Builder::addSecondaryIndex) index the records of primary_list, and are maintained by the
+  // generated code on inserts into and removes from it, and on updates of their key attributes. A non-unique one has
+  // the primary key appended to its key parts, so its entries are unique per record and looked up with range scans.
+  const std::string primary_list{};
+  const bool is_unique = true;
+  // set by BuilderOptPasses: entries are inserted at commit instead, as no function reads the index after updating it.
+  bool defer_maintenance = false;
 
   // this needs its own functions also.
   // std::vector<std::string> intrinsics{"contains", "get", "insert", "remove"};
@@ -23,6 +23,7 @@
 #define DCDS_BUILDER_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <deque>
 #include <iostream>
@@ -50,6 +51,7 @@ class Codegen;
 class LLVMCodegen;
 class JitContainer;
 class CCInjector;
+class CodeExporter;
 
 class Builder : remove_copy {
   friend class Codegen;
@@ -57,6 +59,7 @@ class Builder : remove_copy {
   friend class FunctionBuilder;
   friend class BuilderOptPasses;
   friend class CCInjector;
+  friend class CodeExporter;
 
  public:
   ///
@@ -158,47 +161,172 @@ class Builder : remove_copy {
     attributes.emplace(name, pt);
     return pt;
   }
-  auto addAttributeArray(const std::string& name, const std::shared_ptr<Builder>& type, size_t len) {
+
+  // layout: added to the layout of `type` for the elements of this array only, e.g., LayoutHints::COLUMN_STORE.
+  auto addAttributeArray(const std::string& name, const std::shared_ptr<Builder>& type, size_t len,
+                         hints::LayoutHints layout) {
     CHECK(!hasAttribute(name)) << "Duplicate attribute name: " << name;
     CHECK(len > 0) << "Cannot create an array with zero length";
     CHECK(registered_subtypes.contains(type->getName())) << "Unknown/Unregistered type: " << type;
 
-    auto pt = std::make_shared<dcds::AttributeArray>(name, type, len);
+    auto pt = std::make_shared<dcds::AttributeArray>(name, type, len, std::to_underlying(layout));
     attributes.emplace(name, pt);
     return pt;
   }
 
+  auto addAttributeArray(const std::string& name, const std::shared_ptr<Builder>& type, size_t len) {
+    return addAttributeArray(name, type, len, hints::LayoutHints::PACKED);
+  }
+
+  // Elements are stored densely in one buffer. lock_stripes: with concurrency control, element i is locked with
+  // stripe (i % lock_stripes); `len` gives a lock per element, and 0 locks the whole array with the owning record.
   auto addAttributeArray(const std::string& name, dcds::valueType type, size_t len,
-                         const std::any& default_value = {}) {
-    CHECK(hasAttribute(name)) << "Duplicate attribute name: " << name;
+                         const std::any& default_value = {}, size_t lock_stripes = 0) {
+    CHECK(!hasAttribute(name)) << "Duplicate attribute name: " << name;
     CHECK(len > 0) << "Cannot create an array with zero length";
+    CHECK(lock_stripes <= len) << "More lock stripes than elements: " << lock_stripes << " > " << len;
 
-    auto pt = std::make_shared<dcds::AttributeArray>(name, type, len, default_value);
+    auto pt = std::make_shared<dcds::AttributeArray>(name, type, len, default_value, lock_stripes);
     attributes.emplace(name, pt);
     return pt;
   }
 
+  // index_type: ORDERED for lists which are scanned in key order (StatementBuilder::addRangeScan).
+  // size_hints: expected size, e.g., a large capacity for a large map, none for small lists in many instances.
   auto addAttributeIndexedList(const std::string& name, const std::shared_ptr<Builder>& type,
-                               const std::string& key_attribute) {
+                               const std::string& key_attribute,
+                               hints::IndexHints index_type = hints::IndexHints::HASH,
+                               hints::IndexSizeHints size_hints = {}) {
     CHECK(!hasAttribute(name)) << "Duplicate attribute name: " << name;
     CHECK(type->hasAttribute(key_attribute))
         << "Indexed list type (" << type->getName() << ") does not contain the key-attribute: " << key_attribute;
+    CHECK(size_hints.growth_factor >= 2) << "Index growth factor below 2: " << size_hints.growth_factor;
 
     // TODO: check recursively (e.g., LRU has a map of DoublyLinkedList::Node, which is two layers down.
     // CHECK(registered_subtypes.contains(type->getName())) << "Unknown/Unregistered type: " << type->getName();
 
-    auto pt = std::make_shared<dcds::AttributeIndexedList>(name, type, key_attribute);
+    auto key_type = type->getAttribute(key_attribute)->type;
+    CHECK(key_type == valueType::INT64 || key_type == valueType::INT32 || key_type == valueType::FLOAT ||
+          key_type == valueType::DOUBLE)
+        << "Unsupported index key type: " << key_attribute << " : " << key_type
+        << " (wider keys, e.g., strings, are composite keys, see indexes::StringKey)";
+    auto pt = std::make_shared<dcds::AttributeIndexedList>(name, type, key_attribute, key_type, index_type, size_hints);
     attributes.emplace(name, pt);
     return pt;
   }
   auto addAttributeIndexedList(const std::string& name, const std::shared_ptr<Builder>& type,
-                               std::shared_ptr<dcds::Attribute>& key_attribute) {
-    return addAttributeIndexedList(name, type, key_attribute->name);
+                               std::shared_ptr<dcds::Attribute>& key_attribute,
+                               hints::IndexHints index_type = hints::IndexHints::HASH,
+                               hints::IndexSizeHints size_hints = {}) {
+    return addAttributeIndexedList(name, type, key_attribute->name, index_type, size_hints);
+  }
+
+  // Composite key of integer attributes, e.g., (w_id, d_id, o_id), packed into one 64-bit key in the given order: the
+  // first part is the most significant, so that ordered indexes sort by it first. Keys are built from values of the
+  // parts with expressions::CompositeKeyExpression, and each value has to fit in the bits of its part (signed).
+  // Parts of more than 64 bits in total are packed into up to four 64-bit words of a binary key (see
+  // compositeKeyWords), e.g., four 64-bit parts for string keys (indexes::StringKey).
+  auto addAttributeIndexedList(const std::string& name, const std::shared_ptr<Builder>& type,
+                               const std::vector<CompositeKeyPart>& key_parts,
+                               hints::IndexHints index_type = hints::IndexHints::HASH,
+                               hints::IndexSizeHints size_hints = {}) {
+    CHECK(!hasAttribute(name)) << "Duplicate attribute name: " << name;
+    CHECK(size_hints.growth_factor >= 2) << "Index growth factor below 2: " << size_hints.growth_factor;
+    checkCompositeKey(name, type, key_parts, index_type);
+
+    auto pt = std::make_shared<dcds::AttributeIndexedList>(name, type, key_parts, index_type, size_hints);
+    attributes.emplace(name, pt);
+    return pt;
+  }
+
+  // Secondary index over the records of the indexed list primary_list, on a composite key of their attributes, e.g.,
+  // customers by (c_w_id, c_d_id, c_last). It is kept up to date by the generated code, within the transaction: on
+  // inserts into and removes from the primary list, and on updates of the key attributes through method calls on its
+  // records from this type. Users only read it: with a CompositeKeyExpression of key_parts if unique, otherwise with a
+  // range scan, as the key parts of the primary list are appended to the key (first, in the remaining bits of a 64-bit
+  // key or in a word of its own, for a single-attribute primary key) and span the range. Primary keys of records are
+  // expected not to change.
+  auto addSecondaryIndex(const std::string& name, const std::string& primary_list,
+                         const std::vector<CompositeKeyPart>& key_parts, bool unique,
+                         hints::IndexHints index_type = hints::IndexHints::HASH,
+                         hints::IndexSizeHints size_hints = {}) {
+    CHECK(!hasAttribute(name)) << "Duplicate attribute name: " << name;
+    CHECK(hasAttribute(primary_list)) << "Primary list does not exists: " << primary_list;
+    auto primary = getAttribute(primary_list);
+    CHECK(primary->type_category == ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST) << "Attribute is not a list: " << primary_list;
+    auto primaryList = std::static_pointer_cast<AttributeList>(primary);
+    CHECK(!primaryList->is_fixed_size && !primaryList->is_primitive_type)
+        << "Attribute is not an indexed list: " << primary_list;
+    auto primaryIndexedList = std::static_pointer_cast<AttributeIndexedList>(primary);
+    CHECK(!primaryIndexedList->isSecondaryIndex()) << "Secondary index of a secondary index: " << primary_list;
+    CHECK(unique || index_type == hints::IndexHints::ORDERED)
+        << "Non-unique secondary index needs an ordered index for its range scans: " << name;
+    CHECK(size_hints.growth_factor >= 2) << "Index growth factor below 2: " << size_hints.growth_factor;
+
+    auto type = primaryList->composite_type;
+    auto index_parts = key_parts;
+    if (!unique) {
+      auto hasPart = [&](const std::string& attribute) {
+        return std::any_of(key_parts.begin(), key_parts.end(),
+                           [&](const CompositeKeyPart& part) { return part.attribute == attribute; });
+      };
+      if (primaryIndexedList->isCompositeKey()) {
+        for (const auto& part : primaryIndexedList->key_parts) {
+          if (!hasPart(part.attribute)) index_parts.push_back(part);
+        }
+      } else if (!hasPart(primaryIndexedList->key_attribute)) {
+        uint32_t used_bits = 0;
+        for (const auto& part : key_parts) used_bits += part.bits;
+        index_parts.push_back({primaryIndexedList->key_attribute, used_bits < 64 ? 64 - used_bits : 64});
+      }
+    }
+    checkCompositeKey(name, type, index_parts, index_type);
+
+    auto pt = std::make_shared<dcds::AttributeIndexedList>(name, type, index_parts, index_type, size_hints,
+                                                           primary_list, unique);
+    attributes.emplace(name, pt);
+    return pt;
+  }
+
+  [[nodiscard]] auto getSecondaryIndexes() const {
+    std::vector<std::shared_ptr<AttributeIndexedList>> ret;
+    for (const auto& [name, attr] : attributes) {
+      if (attr->type_category != ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST) continue;
+      auto list = std::static_pointer_cast<AttributeList>(attr);
+      if (list->is_fixed_size || list->is_primitive_type) continue;
+      auto indexedList = std::static_pointer_cast<AttributeIndexedList>(attr);
+      if (indexedList->isSecondaryIndex()) ret.push_back(indexedList);
+    }
+    return ret;
+  }
+  [[nodiscard]] auto getSecondaryIndexes(const std::string& primary_list) const {
+    auto ret = getSecondaryIndexes();
+    std::erase_if(ret, [&](const auto& secondary) { return secondary->primary_list != primary_list; });
+    return ret;
   }
 
   auto operator[](const std::string& name) { return getAttribute(name); }
 
  private:
+  static void checkCompositeKey(const std::string& name, const std::shared_ptr<Builder>& type,
+                                const std::vector<CompositeKeyPart>& key_parts, hints::IndexHints index_type) {
+    CHECK(!key_parts.empty()) << "Composite key without parts: " << name;
+    std::vector<uint32_t> bits;
+    for (const auto& part : key_parts) {
+      CHECK(type->hasAttribute(part.attribute))
+          << "Indexed list type (" << type->getName() << ") does not contain the key-attribute: " << part.attribute;
+      auto part_type = type->getAttribute(part.attribute)->type;
+      CHECK(part_type == valueType::INT64 || part_type == valueType::INT32)
+          << "Composite key part is not an integer: " << part.attribute << " : " << part_type;
+      CHECK(part.bits > 0 && part.bits <= 64) << "Invalid width of composite key part: " << part.attribute;
+      bits.push_back(part.bits);
+    }
+    auto words = compositeKeyWords(bits).back() + 1;
+    CHECK(words <= 4) << "Composite key wider than four 64-bit words: " << name << " (" << words << " words)";
+    CHECK(words == 1 || index_type != hints::IndexHints::OPEN_ADDRESSING)
+        << "Open-addressing index with a composite key wider than 64 bits: " << name;
+  }
+
   // should be called from optPasses only, otherwise user may declare, use and then delete it causing dangling issues.
   // if to be provided to user, then check the usage on each remove call to verify.
   void removeAttribute(const std::string& name) {
@@ -259,8 +387,24 @@ class Builder : remove_copy {
       case hints::BuilderHints::ALWAYS_COMPOSE_INTERNAL:
         LOG(WARNING) << "TODO ALWAYS_COMPOSE_INTERNAL";
         break;
+      case hints::BuilderHints::RUN_BUILDER_OPT_PASSES:
+        run_builder_opt_passes = true;
+        break;
+      case hints::BuilderHints::SPLIT_HOT_COLD_ATTRIBUTES:
+        split_hot_cold_attributes = true;
+        break;
     }
   }
+  void addHint(hints::OptimizationProfile profile) { optimization_profile = profile; }
+  void addHint(hints::TargetHints target) { target_hint = target; }
+  void addHint(hints::LayoutHints layout) {
+    // PACKED resets the layout, the others add to it.
+    layout_flags = (layout == hints::LayoutHints::PACKED) ? 0 : (layout_flags | std::to_underlying(layout));
+  }
+
+  [[nodiscard]] auto getOptimizationProfile() const { return optimization_profile; }
+  [[nodiscard]] auto getTargetHint() const { return target_hint; }
+  [[nodiscard]] auto getLayoutFlags() const { return layout_flags; }
 
   std::shared_ptr<Builder> clone(std::string name);
 
@@ -288,7 +432,7 @@ class Builder : remove_copy {
   std::map<std::string, std::shared_ptr<Attribute>> attributes;
   std::map<std::string, std::shared_ptr<FunctionBuilder>> functions;
   std::map<std::string, std::shared_ptr<Builder>> registered_subtypes;
-  std::shared_ptr<Builder> parentType{};
+  std::weak_ptr<Builder> parentType{};
 
  private:
   bool is_jit_generated = false;
@@ -296,6 +440,11 @@ class Builder : remove_copy {
 
  private:
   bool is_multi_threaded = true;
+  bool run_builder_opt_passes = false;
+  bool split_hot_cold_attributes = false;
+  hints::OptimizationProfile optimization_profile = hints::OptimizationProfile::LATENCY;
+  hints::TargetHints target_hint = hints::TargetHints::HOST_CPU;
+  uint32_t layout_flags = std::to_underlying(hints::LayoutHints::PACKED);
 
   const size_t type_id;
 
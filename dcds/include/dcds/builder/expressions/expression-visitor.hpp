@@ -25,6 +25,7 @@
 #include "dcds/builder/expressions/binary-expressions.hpp"
 #include "dcds/builder/expressions/constant-expressions.hpp"
 #include "dcds/builder/expressions/expressions.hpp"
+#include "dcds/builder/expressions/key-expressions.hpp"
 #include "dcds/builder/expressions/unary-expressions.hpp"
 
 namespace dcds::expressions {
@@ -61,6 +62,9 @@ class ExpressionVisitor {
   virtual void* visit(const expressions::FunctionArgumentExpression& expr) = 0;
   virtual void* visit(const expressions::TemporaryVariableExpression& expr) = 0;
 
+  // Keys
+  virtual void* visit(const expressions::CompositeKeyExpression& expr) = 0;
+
   virtual ~ExpressionVisitor() = default;
 };
 
@@ -0,0 +1,92 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#ifndef DCDS_KEY_EXPRESSIONS_HPP
+#define DCDS_KEY_EXPRESSIONS_HPP
+
+#include <utility>
+#include <vector>
+
+#include "dcds/builder/attribute.hpp"
+#include "dcds/builder/expressions/expressions.hpp"
+#include "dcds/util/logging.hpp"
+
+namespace dcds::expressions {
+
+// Key of an indexed list with a composite key (Builder::addAttributeIndexedList with key parts), from the values of
+// its parts. The values are packed into an INT64 in the generated code: each one biased to unsigned and truncated to
+// the bits of its part, the first part the most significant, so that the order of the keys is the lexicographic order
+// of the values. Keys of more than 64 bits are packed likewise into the words of a binary key, each one compared as
+// unsigned, which the generated code passes by pointer (AttributeIndexedList::key_bytes).
+class CompositeKeyExpression : public Expression {
+ public:
+  CompositeKeyExpression(const std::shared_ptr<dcds::Attribute>& indexed_list,
+                         std::vector<std::shared_ptr<Expression>> _values)
+      : values(std::move(_values)) {
+    CHECK(indexed_list->type_category == ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST) << "Attribute is not a list type";
+    auto list = std::static_pointer_cast<AttributeList>(indexed_list);
+    CHECK(!list->is_fixed_size && !list->is_primitive_type) << "Attribute is not a indexed-list type";
+    auto indexedList = std::static_pointer_cast<AttributeIndexedList>(indexed_list);
+    CHECK(indexedList->isCompositeKey()) << "Indexed list does not have a composite key: " << indexed_list->name;
+    CHECK(values.size() == indexedList->key_parts.size())
+        << "Composite key of " << indexed_list->name << " has " << indexedList->key_parts.size() << " parts, got "
+        << values.size();
+
+    for (size_t i = 0; i < values.size(); i++) {
+      CHECK(values[i]->getResultType() == valueType::INT64 || values[i]->getResultType() == valueType::INT32)
+          << "Composite key value is not an integer: " << values[i]->toString();
+      bits.push_back(indexedList->key_parts[i].bits);
+    }
+    key_type = indexedList->key_type;
+    key_bytes = indexedList->key_bytes;
+  }
+
+  [[nodiscard]] valueType getResultType() const override { return key_type; }
+
+  void* accept(ExpressionVisitor* v) override;
+
+  [[nodiscard]] std::string toString() const override {
+    std::string ret{"("};
+    for (size_t i = 0; i < values.size(); i++) {
+      ret += (i ? ", " : "") + values[i]->toString();
+    }
+    return ret + ")";
+  }
+
+  [[nodiscard]] int getNumOperands() const override { return static_cast<int>(values.size()); }
+  [[nodiscard]] bool isUnaryExpression() const override { return false; }
+  [[nodiscard]] bool isBinaryExpression() const override { return false; }
+
+  [[nodiscard]] const auto& getValues() const { return values; }
+  [[nodiscard]] const auto& getBits() const { return bits; }
+  [[nodiscard]] auto getKeyBytes() const { return key_bytes; }
+
+ private:
+  std::vector<std::shared_ptr<Expression>> values;
+  std::vector<uint32_t> bits;
+  valueType key_type;
+  size_t key_bytes;
+};
+
+}  // namespace dcds::expressions
+
+#endif  // DCDS_KEY_EXPRESSIONS_HPP
@@ -22,6 +22,9 @@
 #ifndef DCDS_BUILDER_HINTS_HPP
 #define DCDS_BUILDER_HINTS_HPP
 
+#include <cstddef>
+#include <cstdint>
+
 namespace dcds::hints {
 
 enum class BuilderHints {
@@ -29,7 +32,73 @@ enum class BuilderHints {
   SINGLE_THREADED,
   MULTI_THREADED,
   // Composability Hints
-  ALWAYS_COMPOSE_INTERNAL
+  ALWAYS_COMPOSE_INTERNAL,
+  // Build Hints
+  // Run BuilderOptPasses in build(). Off by default, as the passes rewrite the specification in place, including the
+  // registered sub-types, which other builders may share.
+  RUN_BUILDER_OPT_PASSES,
+  // Split records into hot and cold parts in BuilderOptPasses::runAll with static weights (every function weighs the
+  // same). Off by default, as is the split without a profile (BuilderOptPasses::setFunctionWeights).
+  SPLIT_HOT_COLD_ATTRIBUTES
+};
+
+// How the generated code of a data structure is optimized by the JIT.
+enum class OptimizationProfile {
+  // Full optimization (-O3, vectorization, aggressive instruction selection) for the lowest latency per op.
+  LATENCY,
+  // Smallest code (-Oz); keeps the instruction cache footprint of many generated types low.
+  SIZE,
+  // Light optimization (-O1, fast instruction selection) for the shortest build and JIT time.
+  COMPILE_SPEED
+};
+
+// How the records of a type are laid out in storage. Flags, can be combined.
+enum class LayoutHints : uint32_t {
+  // Columns in declaration order, records back to back. The default.
+  PACKED = 0,
+  // Columns sorted by width, so that each one is naturally aligned.
+  ALIGNED_COLUMNS = 1u << 0,
+  // Records padded to and aligned at a cache line, so that neighbouring records (e.g., elements of an array) updated
+  // by different threads do not falsely share lines.
+  CACHE_LINE_ALIGNED_RECORDS = 1u << 1,
+  // Record metadata (locks) in the record and the data in a parallel array, so that acquiring a lock does not
+  // invalidate the line other threads read the data from.
+  SEPARATE_METADATA = 1u << 2,
+  // PAX-style: the records of a group (e.g., the elements of a fixed-size array) store each column in its own dense,
+  // cache-line aligned array, so that scans over one attribute touch only that attribute. Usually set per array
+  // attribute, see Builder::addAttributeArray.
+  COLUMN_STORE = 1u << 3
+};
+
+// Which index an indexed list (Builder::addAttributeIndexedList) is built on.
+enum class IndexHints : uint32_t {
+  // Concurrent hash map: point lookups only.
+  HASH,
+  // Concurrent B+-tree (optimistic lock coupling): point lookups and ordered scans, see StatementBuilder::addRangeScan.
+  ORDERED,
+  // Open-addressing hash table whose lookups are generated inline (optimistic, no locks): point lookups only.
+  OPEN_ADDRESSING
+};
+
+// Sizing of an index (Builder::addAttributeIndexedList).
+struct IndexSizeHints {
+  // Expected number of entries, allocated upfront by the hash indexes. 0: unknown, the index starts small and grows
+  // with the inserts.
+  size_t capacity = 0;
+  // Factor by which a full hash index grows (OPEN_ADDRESSING: rounded up to a power of two, HASH: always doubles).
+  // ORDERED grows node by node and ignores both.
+  size_t growth_factor = 2;
+  // Counting Bloom filter in front of the index (sized by capacity), which the generated lookups probe first: for
+  // lists which are mostly looked up with absent keys. Adds a filter update to every insert and remove.
+  bool negative_lookup_filter = false;
+};
+
+// Which CPU the generated code is compiled for.
+enum class TargetHints {
+  // All the features of the host CPU (e.g., AVX-512 when available).
+  HOST_CPU,
+  // Baseline of the target architecture, for code that is exported or cached for other machines.
+  PORTABLE
 };
 
 }
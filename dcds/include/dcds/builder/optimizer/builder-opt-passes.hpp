@@ -22,7 +22,9 @@
 #ifndef DCDS_BUILDER_OPT_PASSES_HPP
 #define DCDS_BUILDER_OPT_PASSES_HPP
 
+#include <functional>
 #include <iostream>
+#include <map>
 #include <set>
 #include <utility>
 
@@ -66,21 +68,103 @@ class BuilderOptPasses {
   //    FIND_DANGLING_RECORD_CREATIONS,
   //  };
 
+  struct redundancy_stats_t {
+    size_t forwarded_reads{};   // reads replaced by the value of an earlier read of the same attribute
+    size_t forwarded_writes{};  // reads replaced by the source of an earlier update of the same attribute
+    size_t removed_locks{};     // CC_LOCK statements on a lock already held in the enclosing scope
+
+    [[nodiscard]] size_t total() const { return forwarded_reads + forwarded_writes + removed_locks; }
+    redundancy_stats_t& operator+=(const redundancy_stats_t& other) {
+      forwarded_reads += other.forwarded_reads;
+      forwarded_writes += other.forwarded_writes;
+      removed_locks += other.removed_locks;
+      return *this;
+    }
+  };
+
+  struct op_footprint_t {
+    size_t bytes_before{};  // record bytes, in whole cache lines, an op touches with the declared layout
+    size_t bytes_after{};   // the same with the hot/cold layout
+  };
+
   explicit BuilderOptPasses(std::shared_ptr<Builder> _builder) : builder(std::move(_builder)) {}
 
+  // Runs all the passes over the builder and all of its (nested) sub-types. Called by Builder::build if the
+  // RUN_BUILDER_OPT_PASSES hint is given; running it again is harmless. The hot/cold split only runs with the
+  // SPLIT_HOT_COLD_ATTRIBUTES hint or function weights.
   void runAll();
 
+  // Runtime profile (calls per function) for the hot/cold split in runAll.
+  void setFunctionWeights(std::map<std::string, size_t> weights) { function_weights = std::move(weights); }
+
   void opt_pass_remove_unused_functions_from_composite_types(bool recursive);
+
+  // Removes attributes which are never used, and write-only attributes together with their updates and locks. The
+  // record layout (storage columns, attribute indexes) is derived from the remaining attributes during codegen.
   void opt_pass_removeUnusedAttributes();
+  [[nodiscard]] auto getNumRemovedAttributes() const { return n_removed_attributes; }
+
+  // Value numbering over the statements of each function: as all reads and updates of a function act on the same
+  // record within one transaction, a read of an attribute whose value is already held in a local variable (or a
+  // constant) is replaced by a temporary-variable assignment. Also drops locks which are already held. Can be run
+  // before and after CCInjector; only the latter finds redundant locks.
+  void opt_pass_eliminateRedundantStatements();
+  [[nodiscard]] const auto& getRedundancyStats() const { return redundancy_stats; }
+
+  // Marks the rarely accessed attributes of the type cold, so that they are stored in a separate part of the record
+  // and the hot part, with the lock, spans fewer cache lines. Access frequency of an attribute is the sum of the
+  // weights of the functions using it; function_weights can come from a runtime profile (calls per function), and
+  // functions not in it weigh 1. Types which already have cold attributes are left as they are.
+  void opt_pass_splitHotColdAttributes(const std::map<std::string, size_t>& function_weights = {});
+  [[nodiscard]] const auto& getFootprintReport() const { return footprint_report; }  // function -> footprint
+
+  // Batches the maintenance of non-unique secondary indexes at commit (AttributeIndexedList::defer_maintenance), when
+  // no function reads such an index after maintaining it, as it would not see its own entries. Only for the top-level
+  // type, whose functions are transactions of their own; functions of nested types may be called one after another
+  // within one transaction.
+  void opt_pass_deferSecondaryIndexMaintenance();
+  [[nodiscard]] auto getNumDeferredIndexes() const { return n_deferred_indexes; }
+
+ private:
+  struct available_value_t {
+    std::shared_ptr<expressions::Expression> value;
+    std::string depends_on;  // local variable holding the value, if any.
+    bool from_update;
+  };
+  using available_values_t = std::map<std::string, available_value_t>;                 // attribute -> value
+  using held_locks_t = std::map<std::pair<std::string, std::string>, LockStatement2*>;  // {type, attribute} -> lock
+
+  void eliminateRedundantStatements(const std::shared_ptr<StatementBuilder>& sb, available_values_t& available,
+                                    held_locks_t held_locks);
+  static void invalidateVariable(available_values_t& available, const std::string& var_name);
+  static bool mayUpdateRecords(const std::shared_ptr<StatementBuilder>& sb, std::set<const FunctionBuilder*>& visited);
 
  private:
   static void setParent(const std::shared_ptr<Builder>& currentBuilder);
-  static void removeWriteOnlyAttribute(std::shared_ptr<Builder>& currentBuilder, const std::string& attribute_name,
+  static void for_each_type(const std::shared_ptr<Builder>& root,
+                            const std::function<void(const std::shared_ptr<Builder>&)>& func);
+
+  static bool removeWriteOnlyAttribute(const std::shared_ptr<Builder>& currentBuilder,
+                                       const std::string& attribute_name,
                                        const BuilderOptPasses::attribute_stat_t& attributeStats);
-  static bool removeAttributeStatements(const std::shared_ptr<StatementBuilder>& sb, const std::string& attribute_name);
+  static size_t removeAttributeStatements(const std::shared_ptr<StatementBuilder>& sb, const std::string& type_name,
+                                          const std::string& attribute_name);
+  static size_t countRemainingStatements(const std::shared_ptr<StatementBuilder>& sb, const std::string& type_name,
+                                         const std::string& attribute_name, bool& leaves_empty_block);
 
  private:
   std::shared_ptr<Builder> builder;
+  // attributes which are used from outside the type's functions, i.e., keys of a parent's indexed list.
+  std::set<std::string> pinned_attributes{};
+
+  redundancy_stats_t redundancy_stats{};
+  size_t n_removed_attributes = 0;
+  size_t n_deferred_indexes = 0;
+  std::map<std::string, op_footprint_t> footprint_report{};
+  std::map<std::string, size_t> function_weights{};
+
+  // an attribute is cold if accessed at most 1/cold_access_ratio as often as the hottest one.
+  static constexpr size_t cold_access_ratio = 4;
 };
 
 }  // namespace dcds
@@ -52,6 +52,13 @@ class CCInjector {
   void injectCC_statementBlock(std::shared_ptr<StatementBuilder> &s, const attribute_locks &locks_in_scope,
                                attribute_trait_t type_traits, attribute_traits &traits_in_scope);
 
+  static bool isPrimitiveArray(std::shared_ptr<StatementBuilder> &s, const std::string &attribute_name);
+  // lock for accessing an element of a primitive array: the owning record, or the element's stripe if striped.
+  static void placeElementLock(std::map<attribute_info, LockStatement2 *> &lock_placed,
+                               attribute_traits &traits_in_scope, std::deque<Statement *>::iterator &pos,
+                               std::shared_ptr<StatementBuilder> &s, const std::string &attribute_name,
+                               const std::shared_ptr<expressions::Expression> &index_expr, bool lock_exclusive);
+
  private:
   Builder *builder;
 
@@ -77,6 +77,11 @@ class StatementBuilder {
   void addUpdateStatement(const std::shared_ptr<dcds::Attribute> &attribute,
                           const std::shared_ptr<expressions::Expression> &source);
 
+  // For primitive arrays
+  void addUpdateStatement(const std::shared_ptr<dcds::Attribute> &attribute,
+                          const std::shared_ptr<dcds::expressions::Expression> &key,
+                          const std::shared_ptr<expressions::Expression> &source);
+
   // For array/list
   void addInsertStatement(const std::shared_ptr<dcds::Attribute> &attribute,
                           const std::shared_ptr<dcds::expressions::Expression> &key,
@@ -128,6 +133,13 @@ class StatementBuilder {
   std::shared_ptr<StatementBuilder> addWhileLoop(dcds::expressions::Expression *loop_cond);
   std::shared_ptr<StatementBuilder> addDoWhileLoop(dcds::expressions::Expression *loop_cond);
 
+  // Ordered scan of an indexed list with an ORDERED index: the returned body runs for each record with a key in
+  // [lower, upper], in key order, with the record in `record`.
+  std::shared_ptr<StatementBuilder> addRangeScan(const std::shared_ptr<dcds::Attribute> &attribute,
+                                                 const std::shared_ptr<expressions::Expression> &lower,
+                                                 const std::shared_ptr<expressions::Expression> &upper,
+                                                 const std::shared_ptr<expressions::LocalVariableExpression> &record);
+
  public:
   [[maybe_unused]] [[nodiscard]] bool haveReturnCall() const { return doesReturn; }
   [[maybe_unused]] [[nodiscard]] bool haveMethodCalls() const { return doesHaveMethodCalls; }
@@ -147,7 +159,10 @@ class StatementBuilder {
       if (s->stType == dcds::statementType::CONDITIONAL_STATEMENT) {
         auto conditional = reinterpret_cast<const ConditionalStatement *>(s);
         conditional->ifBlock->for_each_statement(func);
-        conditional->elseBLock->for_each_statement(func);
+        if (conditional->elseBLock) conditional->elseBLock->for_each_statement(func);
+      } else if (s->stType == dcds::statementType::FOR_LOOP || s->stType == dcds::statementType::WHILE_LOOP ||
+                 s->stType == dcds::statementType::DO_WHILE_LOOP || s->stType == dcds::statementType::RANGE_SCAN) {
+        reinterpret_cast<const LoopStatement *>(s)->body->for_each_statement(func);
       }
     }
   }
@@ -196,6 +211,7 @@ class StatementBuilder {
   friend class ForLoopStatement;
   friend class WhileLoopStatement;
   friend class DoWhileLoopStatement;
+  friend class RangeScanStatement;
 };
 
 // std::ostream &operator<<(std::ostream &out, const StatementBuilder &sb);
@@ -39,6 +39,7 @@ enum class statementType {
   READ_INDEXED,
   INSERT_INDEXED,
   REMOVE_INDEXED,
+  UPDATE_INDEXED,
 
   UPDATE,
   CREATE,
@@ -53,7 +54,8 @@ enum class statementType {
 
   FOR_LOOP,
   WHILE_LOOP,
-  DO_WHILE_LOOP
+  DO_WHILE_LOOP,
+  RANGE_SCAN
 };
 inline std::ostream& operator<<(std::ostream& os, dcds::statementType ty) {
   os << "statementType::";
@@ -71,6 +73,9 @@ inline std::ostream& operator<<(std::ostream& os, dcds::statementType ty) {
     case dcds::statementType::REMOVE_INDEXED:
       os << "REMOVE_INDEXED";
       break;
+    case dcds::statementType::UPDATE_INDEXED:
+      os << "UPDATE_INDEXED";
+      break;
     case statementType::UPDATE:
       os << "UPDATE";
       break;
@@ -92,6 +97,9 @@ inline std::ostream& operator<<(std::ostream& os, dcds::statementType ty) {
     case statementType::DO_WHILE_LOOP:
       os << "DO_WHILE_LOOP";
       break;
+    case statementType::RANGE_SCAN:
+      os << "RANGE_SCAN";
+      break;
     case statementType::METHOD_CALL:
       os << "METHOD_CALL";
       break;
@@ -329,6 +337,30 @@ class DoWhileLoopStatement : public LoopStatement {
   ~DoWhileLoopStatement() override = default;
 };
 
+// Runs the body for each record of an ordered indexed list with a key in [lower, upper], in key order.
+class RangeScanStatement : public LoopStatement {
+ public:
+  explicit RangeScanStatement(std::string source_attribute, std::shared_ptr<expressions::Expression> lower_key,
+                              std::shared_ptr<expressions::Expression> upper_key,
+                              std::shared_ptr<expressions::LocalVariableExpression> record,
+                              std::shared_ptr<StatementBuilder> loop_body)
+      : LoopStatement(statementType::RANGE_SCAN, std::move(loop_body)),
+        source_attr(std::move(source_attribute)),
+        lower_expr(std::move(lower_key)),
+        upper_expr(std::move(upper_key)),
+        record_var(std::move(record)) {}
+  RangeScanStatement(const RangeScanStatement&) = default;
+
+  const std::string source_attr;
+  const std::shared_ptr<expressions::Expression> lower_expr;
+  const std::shared_ptr<expressions::Expression> upper_expr;
+  const std::shared_ptr<expressions::LocalVariableExpression> record_var;
+
+ public:
+  [[nodiscard]] Statement* clone() const override;
+  ~RangeScanStatement() override = default;
+};
+
 // class LockStatement : public Statement {
 //  public:
 //   explicit LockStatement(std::string typeName, std::string attribute_name, size_t typeID, bool lock_exclusive = true)
@@ -350,17 +382,24 @@ class DoWhileLoopStatement : public LoopStatement {
 class LockStatement2 : public Statement {
  public:
   explicit LockStatement2(std::string typeName, std::string attribute_name, size_t typeID, bool lock_exclusive = true)
+      : LockStatement2(std::move(typeName), std::move(attribute_name), typeID, lock_exclusive, nullptr) {}
+
+  // lock on an element (or its stripe) of a primitive array attribute, instead of the whole record.
+  explicit LockStatement2(std::string typeName, std::string attribute_name, size_t typeID, bool lock_exclusive,
+                          std::shared_ptr<expressions::Expression> element_index)
       : Statement(statementType::CC_LOCK),
         attribute(std::move(attribute_name)),
         type_name(std::move(typeName)),
         type_id(typeID),
-        is_exclusive(lock_exclusive) {}
+        is_exclusive(lock_exclusive),
+        index_expr(std::move(element_index)) {}
   LockStatement2(const LockStatement2&) = default;
 
   const std::string attribute;
   const std::string type_name;
   const size_t type_id;
   bool is_exclusive;
+  const std::shared_ptr<expressions::Expression> index_expr;
 
  public:
   [[nodiscard]] Statement* clone() const override { return new LockStatement2(*this); }
@@ -429,10 +468,27 @@ class RemoveIndexedStatement : public Statement {
   ~RemoveIndexedStatement() override = default;
 };
 
-// class UpdateIndexedStatement: public Statement {
-//
-// };
-//
+// element of a primitive array.
+class UpdateIndexedStatement : public Statement {
+ public:
+  explicit UpdateIndexedStatement(std::string destination_attribute, std::shared_ptr<expressions::Expression> index_key,
+                                  std::shared_ptr<expressions::Expression> source)
+      : Statement(statementType::UPDATE_INDEXED),
+        destination_attr(std::move(destination_attribute)),
+        index_expr(std::move(index_key)),
+        source_expr(std::move(source)) {}
+
+  UpdateIndexedStatement(const UpdateIndexedStatement&) = default;
+
+  const std::string destination_attr;
+  const std::shared_ptr<expressions::Expression> index_expr;
+  const std::shared_ptr<expressions::Expression> source_expr;
+
+  [[nodiscard]] Statement* clone() const override { return new UpdateIndexedStatement(*this); }
+
+  ~UpdateIndexedStatement() override = default;
+};
+
 // class UpsertIndexedStatement : public Statement {
 //
 // };
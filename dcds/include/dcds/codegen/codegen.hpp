@@ -22,10 +22,34 @@
 #ifndef DCDS_CODEGEN_HPP
 #define DCDS_CODEGEN_HPP
 
+#include <chrono>
+
 #include "dcds/builder/builder.hpp"
 
 namespace dcds {
 
+struct jit_startup_stats_t {
+  // Time to hand the generated code (or the cached object) to the JIT. ORC materializes on lookup, so this excludes
+  // compiling and linking, except for the tier-0 build with tiered compilation.
+  std::chrono::microseconds load_time{0};
+  // Time to resolve the addresses of all exposed functions. Includes compiling (on an object cache miss) or linking
+  // (on a hit) them, unless compilation is lazy.
+  std::chrono::microseconds resolve_time{0};
+  // Both of the above: the time until all functions are callable, to compare object cache hits and misses.
+  std::chrono::microseconds startup_time{0};
+  bool lazy_compilation = false;
+  bool tiered_compilation = false;
+  bool object_cache_hit = false;
+  // Functions switched to the optimized tier so far; updated by Codegen::getStartupStats.
+  size_t tiered_up_functions = 0;
+};
+
+// Generated loader of an indexed list, for JitContainer::bulkLoad.
+struct bulk_loader_t {
+  const void* address;
+  dcds::valueType key_type;
+};
+
 class Codegen {
  public:
   virtual void build(dcds::Builder* _builder, bool is_nested_type = false) = 0;
@@ -34,6 +58,7 @@ class Codegen {
 
   virtual void printIR() = 0;
   virtual void saveToFile(const std::string& filename) = 0;
+  virtual void emitObjectFile(const std::string& filename) = 0;
 
   virtual void* getFunction(const std::string& name) = 0;
   virtual void* getFunctionPrefixed(const std::string& name) = 0;
@@ -47,6 +72,23 @@ class Codegen {
     return available_jit_functions[name];
   }
 
+  // Generated loader of an indexed list (see LLVMCodegen::buildBulkLoaders), null if the list has none.
+  inline const bulk_loader_t* getBulkLoader(const std::string& list_name) const {
+    assert(is_jit_done);
+    auto it = bulk_loaders.find(list_name);
+    return it == bulk_loaders.end() ? nullptr : &it->second;
+  }
+
+  inline const auto& getStartupStats() {
+    assert(is_jit_done);
+    startup_stats.tiered_up_functions = getNumTieredUpFunctions();
+    return startup_stats;
+  }
+  // Number of compilation units compiled so far by the JIT shared by all builders; grows on first calls when lazy.
+  [[nodiscard]] virtual size_t getNumCompiledUnits() const = 0;
+  // Number of functions of this data structure switched to the optimized tier so far, with tiered compilation.
+  [[nodiscard]] virtual size_t getNumTieredUpFunctions() const = 0;
+
   virtual ~Codegen();
 
  protected:
@@ -55,7 +97,9 @@ class Codegen {
  protected:
   dcds::Builder* top_level_builder;
   std::map<std::string, jit_function_t*> available_jit_functions;
+  std::map<std::string, bulk_loader_t> bulk_loaders;
   bool is_jit_done = false;
+  jit_startup_stats_t startup_stats;
 };
 
 }  // namespace dcds
@@ -50,6 +50,13 @@ class LLVMExpressionVisitor : public ExpressionVisitor {
     return static_cast<llvm::Value*>(val);
   }
 
+  // Packs the (integer) values of the parts of a composite key, see CompositeKeyExpression.
+  static llvm::Value* packCompositeKey(llvm::IRBuilder<>* builder, const std::vector<llvm::Value*>& values,
+                                       const std::vector<uint32_t>& bits);
+  // Same, for composite keys of more than one word: into the words of the binary key at key ([n x i64]*).
+  static void packBinaryKey(llvm::IRBuilder<>* builder, llvm::Value* key, const std::vector<llvm::Value*>& values,
+                            const std::vector<uint32_t>& bits, size_t key_bytes);
+
   // std::shared_ptr
 
  private:
@@ -86,6 +93,9 @@ class LLVMExpressionVisitor : public ExpressionVisitor {
   void* visit(const expressions::FunctionArgumentExpression& functionArgumentExpr) override;
   void* visit(const expressions::TemporaryVariableExpression& expr) override;
 
+  // Keys
+  void* visit(const expressions::CompositeKeyExpression& expr) override;
+
  private:
   llvm::Value* loadValueIfRequired(llvm::Value* in, dcds::valueType dcds_value_type);
 
@@ -35,8 +35,9 @@ extern "C" void* getTableRegistry();
 extern "C" void* getTable(const char* table_name);
 // TODO: make always inline when registering.
 extern "C" uint doesTableExists(const char* table_name);
+// layout_flags: hints::LayoutHints of the type.
 extern "C" void* createTablesInternal(char* table_name, dcds::valueType attributeTypes[], char* attributeNames[],
-                                      int num_attributes);
+                                      const bool attributeIsCold[], int num_attributes, uint32_t layout_flags);
 
 extern "C" void* c1(char* table_name);
 extern "C" void* c2(int num_attributes);
@@ -58,6 +59,7 @@ extern "C" void printUInt64(uint64_t X);
 
 // TODO: make always inline when registering.
 extern "C" void* createDsContainer(void* txnManager, uintptr_t data);
+extern "C" void destroyDsContainer(void* container);
 extern "C" uintptr_t extractRecordFromDsContainer(void* container);
 
 extern "C" void table_read_attribute(void* _txnManager, uintptr_t _mainRecord, void* txn, void* dst,
@@ -65,6 +67,10 @@ extern "C" void table_read_attribute(void* _txnManager, uintptr_t _mainRecord, v
 extern "C" void table_read_attribute_offset(void* _txnManager, uintptr_t _mainRecord, void* txnPtr, void* dst,
                                             size_t attributeIdx, size_t record_offset);
 extern "C" uintptr_t table_get_nth_record(void* _txnManager, uintptr_t _mainRecord, void* txnPtr, size_t record_offset);
+// Reads an 8-byte attribute which does not change after construction (runtime constant), without txn or CC.
+extern "C" uintptr_t table_read_runtime_constant(uintptr_t _mainRecord, size_t attributeIdx);
+// Base of the column of a group of records (e.g., the elements of an array) starting at _mainRecord.
+extern "C" void* table_get_column(uintptr_t _mainRecord, size_t attributeIdx);
 
 extern "C" void table_write_attribute(void* _txnManager, uintptr_t _mainRecord, void* txnPtr, void* src,
                                       uint attributeIdx);
@@ -73,6 +79,11 @@ extern "C" void table_write_attribute_offset(void* _txnManager, uintptr_t _mainR
 
 extern "C" bool lock_shared(void* _txnManager, void* txnPtr, uintptr_t record);
 extern "C" bool lock_exclusive(void* _txnManager, void* txnPtr, uintptr_t record);
+
+// Pin the reclamation epoch of the calling thread (util::Epoch) for a generated operation, so that the index tables
+// and records it reads are not freed meanwhile. epoch_pin returns whether it pinned, i.e., whether epoch_unpin is due.
+extern "C" bool epoch_pin();
+extern "C" void epoch_unpin();
 // extern "C" bool unlock_all(void* _txnManager, void* txnPtr);
 
 #endif  // DCDS_FUNCTIONS_HPP
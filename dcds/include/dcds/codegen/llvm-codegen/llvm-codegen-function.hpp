@@ -22,6 +22,8 @@
 #ifndef DCDS_LLVM_CODEGEN_FUNCTION_HPP
 #define DCDS_LLVM_CODEGEN_FUNCTION_HPP
 
+#include <functional>
+
 #include "dcds/builder/function-builder.hpp"
 #include "dcds/codegen/llvm-codegen/llvm-codegen.hpp"
 
@@ -69,6 +71,10 @@ class LLVMCodegenFunction {
 
   llvm::Value *getVariable(const std::string &name);
 
+  // Value generated once, at the start of the entry block, and reused by every later request for the same key within
+  // this function, e.g., loop-invariant lookups which LLVM cannot hoist past the stores of a loop body.
+  llvm::Value *getEntryBlockValue(const std::string &key, const std::function<llvm::Value *()> &generate);
+
   bool doesReturn() { return fb->getReturnValueType() != valueType::VOID; }
 
   [[nodiscard]] llvm::BasicBlock *GetReturnBlock() const { return returnBB; }
@@ -110,6 +116,8 @@ class LLVMCodegenFunction {
   llvm::BasicBlock *returnBB;
   // allocated variables at function-level
   std::unordered_map<std::string, llvm::Value *> allocated_vars;
+  // values generated in the entry block (getEntryBlockValue)
+  std::unordered_map<std::string, llvm::Value *> entry_block_values;
 
   // Restore points.
   //  LLVMCodegenFunction *previous_fn;
@@ -22,6 +22,9 @@
 #ifndef DCDS_LLVM_CODEGEN_STATEMENT_HPP
 #define DCDS_LLVM_CODEGEN_STATEMENT_HPP
 
+#include <map>
+#include <vector>
+
 #include "dcds/codegen/llvm-codegen/llvm-codegen-function.hpp"
 #include "dcds/codegen/llvm-codegen/llvm-codegen.hpp"
 #include "dcds/codegen/llvm-codegen/llvm-scoped-context.hpp"
@@ -72,10 +75,12 @@ class LLVMCodegenStatement {
   void buildStatement_ReadIndexed(Statement *stmt);
   void buildStatement_InsertIndexed(Statement *stmt);
   void buildStatement_RemoveIndexed(Statement *stmt);
+  void buildStatement_UpdateIndexed(Statement *stmt);
 
   void buildStatement_ForLoop(dcds::Statement *stmt);
   void buildStatement_WhileLoop(dcds::Statement *stmt);
   void buildStatement_DoWhileLoop(dcds::Statement *stmt);
+  void buildStatement_RangeScan(dcds::Statement *stmt);
 
   void gen_conditional_abort(llvm::Value *do_continue);
 
@@ -88,14 +93,64 @@ class LLVMCodegenStatement {
   llvm::Value *getArg_mainRecord();
   llvm::Value *getArg_txn();
 
+  // Value of an attribute which cannot change in this function (compile-time constants as immediates, runtime
+  // constants without a transactional read), or nullptr if it has to be read through the table.
+  llvm::Value *readConstantAttribute(const std::string &attribute_name);
+  // Base record of an array/indexed-list attribute, i.e., the index pointer or the first record of the array.
+  llvm::Value *readListBaseRecord(const std::string &attribute_name);
+  // Address of the index-th element of a primitive array.
+  llvm::Value *primitiveArrayElement(const std::shared_ptr<AttributeArray> &attributeArray, llvm::Value *index);
+
+  // Secondary indexes (Builder::addSecondaryIndex) are maintained along with their primary list: entries are added
+  // after an insert into it, removed with a remove from it, and moved on method calls which update their keys.
+  void insertSecondaryEntries(const std::shared_ptr<AttributeIndexedList> &primary, llvm::Value *primary_base,
+                              llvm::Value *primary_key, llvm::Value *record);
+  void removeSecondaryEntries(const std::shared_ptr<AttributeIndexedList> &primary, llvm::Value *record);
+  // secondary indexes of this type on records of the callee's type, whose key attributes the callee may update.
+  std::vector<std::shared_ptr<AttributeIndexedList>> secondaryIndexesUpdatedBy(const FunctionBuilder &callee);
+  void updateSecondaryEntries(const std::vector<std::shared_ptr<AttributeIndexedList>> &secondaries,
+                              llvm::Value *record, const std::map<std::string, llvm::Value *> &old_values);
+
+  // Attribute of a record of the given type, e.g., an element of a list.
+  llvm::Value *readRecordAttribute(const std::shared_ptr<Builder> &type, llvm::Value *record,
+                                   const std::string &attribute_name);
+  // Key of a record in the indexed list: its key attribute, or its key parts packed from the given/read values.
+  llvm::Value *readRecordKey(const std::shared_ptr<AttributeIndexedList> &indexedList, llvm::Value *record);
+  llvm::Value *packRecordKey(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                             const std::map<std::string, llvm::Value *> &values);
+  // Exclusive lock of a record whose key attributes are read to maintain indexes, nothing without a transaction.
+  void lockIndexedRecord(llvm::Value *record);
+  void gen_return_false();
+
  private:
   LLVMScopedContext *build_ctx;
 
  private:
-  llvm::Value *call_index_find(valueType key_type, llvm::Value *base_record_ptr, llvm::Value *index_key);
-  llvm::Value *call_index_insert(valueType key_type, llvm::Value *base_record_ptr, llvm::Value *index_key,
-                                 llvm::Value *index_value);
-  llvm::Value *call_index_remove(valueType key_type, llvm::Value *base_record_ptr, llvm::Value *index_key);
+  // Key of an indexed statement: a value of the key type, or, for binary keys (AttributeIndexedList::key_bytes), a
+  // pointer to the key, as the index calls take them.
+  llvm::Value *genIndexKey(const std::shared_ptr<expressions::Expression> &key_expr);
+  llvm::Value *indexKeysDiffer(const std::shared_ptr<AttributeIndexedList> &indexedList, llvm::Value *key_a,
+                               llvm::Value *key_b);
+
+  // Lookup as the transaction (if any) sees the index, i.e., with its own uncommitted entries. 0 if absent.
+  llvm::Value *call_index_find(const std::shared_ptr<AttributeIndexedList> &indexedList, llvm::Value *base_record_ptr,
+                               llvm::Value *index_key);
+  // Lookup in an OpenAddressingIndex, generated inline instead of a call. Returns the record, or 0 if absent.
+  llvm::Value *inlineIndexFind(valueType key_type, llvm::Value *base_record_ptr, llvm::Value *index_key);
+  // NegativeLookupFilter::mayContain on the filter of the index, generated inline. False if the index has no such key.
+  llvm::Value *inlineFilterProbe(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                 llvm::Value *base_record_ptr, llvm::Value *index_key);
+  llvm::Value *call_index_insert(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                 llvm::Value *base_record_ptr, llvm::Value *index_key, llvm::Value *index_value);
+  // Also takes back inserts of this transaction, whose keys it locked already, so that it does not fail then.
+  // removed: if not null, an i64 slot which gets the removed record, or 0.
+  llvm::Value *call_index_remove(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                 llvm::Value *base_record_ptr, llvm::Value *index_key, llvm::Value *removed = nullptr);
+  llvm::Value *call_secondary_insert(const std::shared_ptr<AttributeIndexedList> &secondary,
+                                     llvm::Value *base_record_ptr, llvm::Value *index_key, llvm::Value *record);
+  llvm::Value *call_index_scan_next(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                    llvm::Value *base_record_ptr, llvm::Value *cursor, llvm::Value *inclusive,
+                                    llvm::Value *upper, llvm::Value *record);
 };
 
 }  // namespace dcds
@@ -98,17 +98,18 @@ class LLVMCodegen : public Codegen, public LLVMCodegenContext {
  public:
   explicit LLVMCodegen(dcds::Builder *builder);
   ~LLVMCodegen() override {
-    theLLVMFPM->doFinalization();
-    theLLVMFPM.reset();
-
+    // The context is shared with other builders and the compile threads.
+    auto lock = theLLVMContext.getLock();
     temporaryVariableIRMap.clear();
     llvmBuilder.reset();
+    theLLVMModule.reset();
     userFunctions.clear();
     this->availableFunctions.clear();
   }
 
   void build(dcds::Builder *builder, bool is_nested_type) override;
   void saveToFile(const std::string &filename) override;
+  void emitObjectFile(const std::string &filename) override;
   void jitCompileAndLoad() override;
 
   void printIR() override;
@@ -117,6 +118,9 @@ class LLVMCodegen : public Codegen, public LLVMCodegenContext {
   void *getFunction(const std::string &name) override;
   void *getFunctionPrefixed(const std::string &name) override;
 
+  [[nodiscard]] size_t getNumCompiledUnits() const override;
+  [[nodiscard]] size_t getNumTieredUpFunctions() const override;
+
  private:
   void runOptimizationPasses() override;
 
@@ -131,7 +135,6 @@ class LLVMCodegen : public Codegen, public LLVMCodegenContext {
 
  private:
   void initializeLLVMModule(const std::string &name);
-  void initializePassManager();
 
   void codegenHelloWorld();
 
@@ -144,6 +147,7 @@ class LLVMCodegen : public Codegen, public LLVMCodegenContext {
   void initializeArrayAttributes(dcds::Builder &builder, std::map<std::string, llvm::Function *> &fn_init_sub_tables,
                                  llvm::Value *txn_manager, llvm::Value *main_record, llvm::Value *txn);
   void buildDestructor();
+  void buildBulkLoaders(dcds::Builder &builder);
   void buildFunctions(dcds::Builder *builder, bool is_nested_type);
   void buildOneFunction(dcds::Builder *builder, std::shared_ptr<FunctionBuilder> &fb, bool is_nested_type);
   llvm::Function *buildOneFunction_outer(dcds::Builder *builder, std::shared_ptr<FunctionBuilder> &fb,
@@ -152,7 +156,8 @@ class LLVMCodegen : public Codegen, public LLVMCodegenContext {
 
   llvm::Function *buildInitTablesFn(dcds::Builder &builder, llvm::Value *table_name);
   llvm::Function *genInitStorageFn(const std::string &function_name_prefix, llvm::Value *table_name,
-                                   const std::map<std::string, std::shared_ptr<Attribute>> &attributes);
+                                   const std::map<std::string, std::shared_ptr<Attribute>> &attributes,
+                                   uint32_t layout_flags);
 
   llvm::Function *genFunctionSignature(
       std::shared_ptr<FunctionBuilder> &fb, const std::vector<llvm::Type *> &pre_args = {},
@@ -163,6 +168,10 @@ class LLVMCodegen : public Codegen, public LLVMCodegenContext {
   std::map<std::string, llvm::Value *> allocateTemporaryVariables(std::shared_ptr<FunctionBuilder> &fb,
                                                                   llvm::BasicBlock *basicBlock);
   llvm::Value *allocateOneVar(const std::string &var_name, dcds::valueType var_type, std::any init_value = {});
+  // Scratch memory of a single statement, e.g., the destination of a runtime call. The slot is allocated in the entry
+  // block and only live (lifetime markers) between allocateScratchVar and releaseScratchVar.
+  llvm::AllocaInst *allocateScratchVar(const std::string &var_name, llvm::Type *type);
+  void releaseScratchVar(llvm::AllocaInst *var);
 
   llvm::Type *DcdsToLLVMType(dcds::valueType dcds_type, bool is_reference = false);
 
@@ -171,16 +180,19 @@ class LLVMCodegen : public Codegen, public LLVMCodegenContext {
   std::unordered_map<std::string, llvm::Value *> temporaryVariableIRMap;
 
  private:
-  std::unique_ptr<LLVMContext> theLLVMContext;
-  std::unique_ptr<legacy::FunctionPassManager> theLLVMFPM;
+  llvm::orc::ThreadSafeContext theLLVMContext;
   std::unique_ptr<IRBuilder<>> llvmBuilder;
   std::unique_ptr<Module> theLLVMModule;
 
  private:
   std::map<std::string, StructType *> record_value_struct_types;
+  // indexed lists with a generated bulk loader (buildBulkLoaders), with their key type.
+  std::vector<std::pair<std::string, dcds::valueType>> bulk_load_lists;
 
  private:
-  std::unique_ptr<LLVMJIT> jitter;
+  const LLVMOptimizationConfig optimization_config;
+  std::shared_ptr<LLVMJIT> jitEngine;
+  std::unique_ptr<LLVMJITDylib> jitter;
 
   // private:
   //  CodeExporter raw_code_exporter;
@@ -138,6 +138,11 @@ class LLVMCodegenContext {
   static llvm::PointerType *getPointerType(llvm::Type *type);
 
   static llvm::AllocaInst *createAlloca(llvm::BasicBlock *InsertAtBB, const std::string &VarName, llvm::Type *varType);
+  /**
+   * Allocates in the entry block of the function being generated, whatever the current insertion point is (e.g., a
+   * loop body), so that the stack slot is static and can be promoted to registers by mem2reg/SROA.
+   */
+  llvm::AllocaInst *createEntryBlockAlloca(const std::string &VarName, llvm::Type *varType) const;
 
   void CreateIfElseBlocks(llvm::Function *fn, const std::string &if_name, const std::string &else_name,
                           llvm::BasicBlock **if_block, llvm::BasicBlock **else_block,
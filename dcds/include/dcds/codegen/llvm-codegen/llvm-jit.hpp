@@ -25,9 +25,6 @@
 #include <llvm/ADT/STLExtras.h>
 #include <llvm/ADT/StringRef.h>
 #include <llvm/ADT/iterator_range.h>
-#include <llvm/Analysis/TargetLibraryInfo.h>
-#include <llvm/Analysis/TargetTransformInfo.h>
-#include <llvm/CodeGen/TargetPassConfig.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/JITSymbol.h>
 #include <llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h>
@@ -45,18 +42,20 @@
 #include <llvm/ExecutionEngine/SectionMemoryManager.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/LLVMContext.h>
-#include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Mangler.h>
 #include <llvm/Support/DynamicLibrary.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/ThreadPool.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
-#include <llvm/Transforms/IPO.h>
-#include <llvm/Transforms/IPO/PassManagerBuilder.h>
-#include <llvm/Transforms/InstCombine/InstCombine.h>
-#include <llvm/Transforms/Scalar.h>
-#include <llvm/Transforms/Scalar/GVN.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#include "dcds/codegen/llvm-codegen/llvm-object-cache.hpp"
+#include "dcds/codegen/llvm-codegen/llvm-optimizer.hpp"
 #include "dcds/util/logging.hpp"
 #include "dcds/util/timing.hpp"
 
@@ -65,61 +64,55 @@ namespace dcds {
 static bool print_generated_code = false;
 static bool print_optimized_code = false;
 
-class PassConfiguration {
- public:
-  std::unique_ptr<llvm::TargetMachine> JTM;
-  llvm::Triple ModuleTriple;
-  llvm::TargetLibraryInfoImpl TLII;
-  llvm::legacy::PassManager Passes;
-  llvm::PassManagerBuilder Builder;
-  llvm::ImmutablePass *TTIPass;
-  llvm::FunctionPass *PrefetchPass;
-
- public:
-  explicit PassConfiguration(std::unique_ptr<llvm::TargetMachine> TM)
-      : JTM(std::move(TM)),
-        ModuleTriple(JTM->getTargetTriple()),
-        TLII(ModuleTriple),
-        TTIPass(createTargetTransformInfoWrapperPass(JTM->getTargetIRAnalysis())),
-        PrefetchPass(llvm::createLoopDataPrefetchPass()) {
-    llvm::Pass *TPC = dynamic_cast<llvm::LLVMTargetMachine *>(JTM.get())->createPassConfig(Passes);
-    Passes.add(TPC);
-
-    Passes.add(new llvm::TargetLibraryInfoWrapperPass(TLII));
-
-    // Add internal analysis passes from the target machine.
-    Passes.add(createTargetTransformInfoWrapperPass(JTM->getTargetIRAnalysis()));
-
-    Builder.OptLevel = 3;
-    Builder.SizeLevel = 0;
-
-    Builder.Inliner = llvm::createFunctionInliningPass(3, 0, false);
+struct LLVMJITOptions {
+  // Compile functions on their first call, through lazy call-through stubs, instead of compiling the whole module
+  // when it is loaded. Env: DCDS_JIT_LAZY=1
+  bool lazy_compilation = false;
 
-    Builder.DisableUnrollLoops = false;
-    Builder.LoopVectorize = true;
+  // With lazy compilation, additionally start compiling all exposed functions on the compile threads right after
+  // loading, so that first calls rarely wait for the compiler. Env: DCDS_JIT_BACKGROUND_COMPILE=1
+  bool background_compilation = false;
 
-    Builder.SLPVectorize = true;
+  // Size of the compile thread pool of the JIT engine; 0 (the default) compiles on the calling thread. Background
+  // compilation and off-thread tier-ups need compile threads. Env: DCDS_JIT_COMPILE_THREADS=<n>
+  size_t compile_threads = 0;
 
-    JTM->adjustPassManager(Builder);
+  // Tiered compilation: functions first run as an unoptimized (-O0, FastISel) tier-0 build that counts its calls.
+  // Once a function was called tier_up_threshold times, it is recompiled with the optimizing pipeline on a compile
+  // thread, and its indirection stub is switched to the optimized code. Takes precedence over lazy_compilation.
+  // Env: DCDS_JIT_TIERED=1, DCDS_JIT_TIER_UP_THRESHOLD=<n>
+  bool tiered_compilation = false;
+  uint64_t tier_up_threshold = 1000;
 
-    Builder.populateModulePassManager(Passes);
-  }
+  static LLVMJITOptions createFromEnvironment();
 };
 
-class LLVMJIT {
+class LLVMJITDylib;
+
+// JIT engine: one ExecutionSession, compile pipeline, LLVMContext and compile thread pool. The process-wide instance
+// (getInstance) is shared by all builders, each of which loads its code into its own LLVMJITDylib.
+class LLVMJIT : public std::enable_shared_from_this<LLVMJIT> {
  public:
   ~LLVMJIT() {
+    if (compileThreads) compileThreads->wait();
     if (auto Err = ES.endSession()) ES.reportError(std::move(Err));
+    if (auto Err = EPCIU->cleanup()) ES.reportError(std::move(Err));
   }
 
   explicit LLVMJIT(
+      const LLVMJITOptions &options = LLVMJITOptions::createFromEnvironment(),
       llvm::orc::JITTargetMachineBuilder JTMB = llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost())
                                                     .setCodeGenOptLevel(llvm::CodeGenOpt::Aggressive)
                                                     .setCodeModel(llvm::CodeModel::Model::Large))
       : DL(llvm::cantFail(JTMB.getDefaultDataLayoutForTarget())),
         Mangle(ES, this->DL),
+        target_fingerprint(JTMB.getTargetTriple().str() + "|" + JTMB.getCPU() + "|" + JTMB.getFeatures().getString()),
+        objectCache(LLVMObjectCache::createFromEnvironment()),
         ObjectLayer(ES, []() { return std::make_unique<llvm::SectionMemoryManager>(); }),
-        CompileLayer(ES, ObjectLayer, std::make_unique<llvm::orc::ConcurrentIRCompiler>(JTMB)),
+        CompileLayer(ES, ObjectLayer, std::make_unique<LLVMProfileCompiler>(JTMB, objectCache.get())),
+        Tier0CompileLayer(ES, ObjectLayer,
+                          std::make_unique<llvm::orc::ConcurrentIRCompiler>(
+                              llvm::orc::JITTargetMachineBuilder(JTMB).setCodeGenOptLevel(llvm::CodeGenOpt::None))),
         PrintOptimizedIRLayer(
             ES, CompileLayer,
             [](llvm::orc::ThreadSafeModule TSM,
@@ -129,21 +122,19 @@ class LLVMJIT {
             }),
         TransformLayer(ES, PrintOptimizedIRLayer,
                        [_JTMB = std::move(JTMB)](llvm::orc::ThreadSafeModule TSM,
-                                                 const llvm::orc::MaterializationResponsibility &R) mutable
-                       -> llvm::Expected<llvm::orc::ThreadSafeModule> {
-                         auto TM = _JTMB.createTargetMachine();
-                         if (!TM) return TM.takeError();
-                         return optimizeModule2(std::move(TSM), std::move(TM.get()));
-                         // return optimizeModule(std::move(TSM), R);
+                                                 const llvm::orc::MaterializationResponsibility &R)
+                           -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+                         return optimizeModule(std::move(TSM), _JTMB);
                        }),
         PrintGeneratedIRLayer(
             ES, TransformLayer,
-            [](llvm::orc::ThreadSafeModule TSM,
-               const llvm::orc::MaterializationResponsibility &R) -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+            [this](llvm::orc::ThreadSafeModule TSM,
+                   const llvm::orc::MaterializationResponsibility &R) -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+              n_compiled_modules++;
               if (print_generated_code) return printIR(std::move(TSM));
               return std::move(TSM);
             }),
-        MainJD(llvm::cantFail(ES.createJITDylib("main"))),
+        TSCtx(std::make_unique<llvm::LLVMContext>()),
         vtuneProfiler(llvm::JITEventListener::createIntelJITEventListener()) {
     if (vtuneProfiler == nullptr) {
       LOG(WARNING) << "Could not create VTune listener";
@@ -162,59 +153,158 @@ class LLVMJIT {
     //          LOG(INFO) << "Emitted " << k << " " << mb.get();
     //        });
 
-    //    ES.setDispatchTask([&p = pool](std::unique_ptr<llvm::orc::Task> T) {
-    //      p.enqueue([UnownedT = std::move(T)]() mutable { UnownedT->run(); });
-    //    });
+    if (options.compile_threads > 0) {
+      compileThreads = std::make_unique<llvm::ThreadPool>(llvm::hardware_concurrency(options.compile_threads));
+      ES.setDispatchTask([this](std::unique_ptr<llvm::orc::Task> T) {
+        compileThreads->async([UnownedT = T.release()]() mutable {
+          std::unique_ptr<llvm::orc::Task> task(UnownedT);
+          task->run();
+        });
+      });
+    }
 
-    MainJD.addGenerator(
-        llvm::cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(this->DL.getGlobalPrefix())));
+    EPCIU = llvm::cantFail(llvm::orc::EPCIndirectionUtils::Create(ES.getExecutorProcessControl()));
+    EPCIU->createLazyCallThroughManager(ES, llvm::pointerToJITTargetAddress(&handleLazyCallThroughError));
+    llvm::cantFail(llvm::orc::setUpInProcessLCTMReentryViaEPCIU(*EPCIU));
   }
 
- public:
-  void *getCompiledFunction(llvm::Function *function_ptr);
-  void *getCompiledFunction(const std::string &function_name);
+  // Process-wide JIT engine, created with the options from the environment on first use.
+  static std::shared_ptr<LLVMJIT> getInstance();
+
+  // Creates an empty dylib for the code of one builder; its code is unloaded when the returned handle is destroyed.
+  // Per-dylib options (lazy/tiered compilation) are taken from `options`, engine-wide ones are ignored.
+  std::unique_ptr<LLVMJITDylib> createDylib(const std::string &name,
+                                            const LLVMJITOptions &options = LLVMJITOptions::createFromEnvironment());
 
  public:
   const llvm::DataLayout &getDataLayout() const { return DL; }
-  llvm::orc::JITDylib &getMainJITDylib() { return MainJD; }
 
-  void addModule(llvm::orc::ThreadSafeModule M) { llvm::cantFail(PrintGeneratedIRLayer.add(MainJD, std::move(M))); }
+  // Context shared by the modules of all builders using this engine. Lock it (getLock) while creating or modifying IR.
+  llvm::orc::ThreadSafeContext &getContext() { return TSCtx; }
 
-  void dump() { ES.dump(llvm::outs()); }
+  [[nodiscard]] bool isObjectCacheEnabled() const { return objectCache != nullptr; }
 
-  llvm::JITEvaluatedSymbol lookup(llvm::StringRef Name) {
-    return llvm::cantFail(ES.lookup({&MainJD}, Mangle(Name.str())));
-  }
+  // Number of modules (with lazy/tiered compilation: function partitions) compiled by this engine so far.
+  [[nodiscard]] size_t getNumCompiledModules() const { return n_compiled_modules; }
 
-  void *getRawAddress(std::string const &name) {
-    return reinterpret_cast<void *>(llvm::cantFail(ES.lookup({&MainJD}, Mangle(name))).getAddress());
-  }
+  void dump() { ES.dump(llvm::outs()); }
 
  private:
   static llvm::Expected<llvm::orc::ThreadSafeModule> printIR(llvm::orc::ThreadSafeModule module,
                                                              const std::string &suffix = "");
 
-  //  static llvm::Expected<llvm::orc::ThreadSafeModule> optimizeModule(llvm::orc::ThreadSafeModule TSM,
-  //                                                                    const llvm::orc::MaterializationResponsibility
-  //                                                                    &R);
-  static llvm::orc::ThreadSafeModule optimizeModule2(llvm::orc::ThreadSafeModule TSM,
-                                                     std::unique_ptr<llvm::TargetMachine> TM);
+  // Runs the pipeline of the LLVMOptimizationConfig attached to the module, for the target machine derived from JTMB.
+  static llvm::Expected<llvm::orc::ThreadSafeModule> optimizeModule(llvm::orc::ThreadSafeModule TSM,
+                                                                    const llvm::orc::JITTargetMachineBuilder &JTMB);
+
+  // Compiles the requested functions together with every function they (transitively) call within the module, so
+  // that the inliner still sees the always-inline helpers of a lazily compiled function.
+  static llvm::Optional<llvm::orc::CompileOnDemandLayer::GlobalValueSet> partitionWithCallees(
+      llvm::orc::CompileOnDemandLayer::GlobalValueSet requested);
+
+  static void handleLazyCallThroughError();
 
  private:
   llvm::orc::ExecutionSession ES{llvm::cantFail(llvm::orc::SelfExecutorProcessControl::Create())};
   llvm::DataLayout DL;
   llvm::orc::MangleAndInterner Mangle;
 
+  const std::string target_fingerprint;
+  std::unique_ptr<LLVMObjectCache> objectCache;
+
   llvm::orc::RTDyldObjectLinkingLayer ObjectLayer;
   llvm::orc::IRCompileLayer CompileLayer;
+  llvm::orc::IRCompileLayer Tier0CompileLayer;
   llvm::orc::IRTransformLayer PrintOptimizedIRLayer;
   llvm::orc::IRTransformLayer TransformLayer;
   llvm::orc::IRTransformLayer PrintGeneratedIRLayer;
 
-  llvm::orc::JITDylib &MainJD;
+  llvm::orc::ThreadSafeContext TSCtx;
+
+  std::unique_ptr<llvm::ThreadPool> compileThreads;
+  std::unique_ptr<llvm::orc::EPCIndirectionUtils> EPCIU;
+  std::atomic<size_t> n_compiled_modules = 0;
+  std::atomic<size_t> n_dylibs = 0;
 
   std::mutex vtuneLock;
   llvm::JITEventListener *vtuneProfiler;
+
+  friend class LLVMJITDylib;
+};
+
+// Code of one builder inside a (shared) LLVMJIT. All of it is removed from the engine on destruction, so the
+// addresses handed out by this dylib must not be used afterwards.
+class LLVMJITDylib {
+ public:
+  ~LLVMJITDylib();
+
+  LLVMJITDylib(const LLVMJITDylib &) = delete;
+  LLVMJITDylib &operator=(const LLVMJITDylib &) = delete;
+
+ public:
+  void *getCompiledFunction(llvm::Function *function_ptr);
+  void *getCompiledFunction(const std::string &function_name);
+
+ public:
+  const llvm::DataLayout &getDataLayout() const { return engine->getDataLayout(); }
+  llvm::orc::JITDylib &getMainJITDylib() { return MainJD; }
+  LLVMJIT &getEngine() { return *engine; }
+
+  // Returns true if the module was served from the object cache.
+  bool addModule(llvm::orc::ThreadSafeModule M);
+
+  [[nodiscard]] bool isObjectCacheEnabled() const {
+    return engine->isObjectCacheEnabled() && !options.lazy_compilation && !options.tiered_compilation;
+  }
+  [[nodiscard]] bool isLazyCompilationEnabled() const { return options.lazy_compilation; }
+  [[nodiscard]] bool isTieredCompilationEnabled() const { return options.tiered_compilation; }
+
+  // Number of functions that were switched from tier-0 to optimized code so far.
+  [[nodiscard]] size_t getNumTieredUpFunctions() const { return n_tiered_up_functions; }
+
+  // Starts compiling the given (lazily compiled) functions on the compile threads, so that their first call does not
+  // pay for compilation. No-op unless lazy and background compilation are enabled and the engine has compile threads.
+  void compileInBackground(const std::vector<std::string> &function_names);
+
+  llvm::JITEvaluatedSymbol lookup(llvm::StringRef Name) {
+    return llvm::cantFail(engine->ES.lookup({&MainJD}, engine->Mangle(Name.str())));
+  }
+
+  void *getRawAddress(std::string const &name) { return reinterpret_cast<void *>(lookup(name).getAddress()); }
+
+ private:
+  LLVMJITDylib(std::shared_ptr<LLVMJIT> _engine, llvm::orc::JITDylib &_jd, const LLVMJITOptions &_options);
+
+  static LLVMJITOptions normalizeOptions(LLVMJITOptions options);
+
+  // Adds the tier-0 build of M to the main dylib behind indirection stubs, and keeps M for the optimized tier.
+  void addModuleTiered(llvm::orc::ThreadSafeModule M);
+  void instrumentTier0Function(llvm::Function &F, const std::string &exposed_name);
+  static void tierUpCallback(LLVMJITDylib *dylib, const char *function_name);
+  void tierUp(const std::string &function_name);
+
+  // Asynchronous lookup of fully materialized symbols in dylib; the dylib is not removed before on_complete ran.
+  void lookupAsync(llvm::orc::JITDylib &dylib, llvm::orc::SymbolLookupSet symbols,
+                   std::function<void(llvm::Expected<llvm::orc::SymbolMap>)> on_complete);
+
+ private:
+  const std::shared_ptr<LLVMJIT> engine;
+  llvm::orc::JITDylib &MainJD;
+  const LLVMJITOptions options;
+
+  // Lazy/tiered compilation. Per dylib, as CompileOnDemandLayer keeps per-target-dylib state.
+  std::unique_ptr<llvm::orc::CompileOnDemandLayer> CODLayer;
+
+  static constexpr auto tier0_suffix = ".tier0";
+  static constexpr auto tier_up_function_name = "dcds.jit.tier_up";
+  std::unique_ptr<llvm::orc::IndirectStubsManager> TierStubs;
+  llvm::orc::JITDylib *Tier1JD = nullptr;
+  llvm::orc::JITDylib *Tier1ImplJD = nullptr;
+  std::atomic<size_t> n_tiered_up_functions = 0;
+
+  std::atomic<size_t> n_pending_lookups = 0;
+
+  friend class LLVMJIT;
 };
 
 }  // namespace dcds
@@ -0,0 +1,74 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#ifndef DCDS_LLVM_OBJECT_CACHE_HPP
+#define DCDS_LLVM_OBJECT_CACHE_HPP
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace dcds {
+
+// Persistent, content-addressed cache of JIT-compiled objects.
+// The key of a module is a SHA1 over its unoptimized IR (which is the lowered form of the builder: attributes,
+// functions and hints), the LLVM version and the target (triple, cpu, features). Objects are stored as
+// <cache_dir>/<key>.o and are loaded directly into the object layer on a hit, skipping the optimization and
+// compilation pipeline entirely.
+class LLVMObjectCache : public llvm::ObjectCache {
+ public:
+  explicit LLVMObjectCache(std::string cache_directory);
+
+  // Returns a cache rooted at $DCDS_JIT_CACHE_DIR, or nullptr if the variable is not set.
+  static std::unique_ptr<LLVMObjectCache> createFromEnvironment();
+
+  static std::string computeKey(const llvm::Module &module, const std::string &target_fingerprint);
+  static void setModuleKey(llvm::Module &module, const std::string &key);
+  static std::optional<std::string> getModuleKey(const llvm::Module &module);
+
+ public:
+  void notifyObjectCompiled(const llvm::Module *module, llvm::MemoryBufferRef obj) override;
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *module) override;
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const std::string &key);
+
+  [[nodiscard]] const auto &getCacheDirectory() const { return cache_dir; }
+  [[nodiscard]] auto getHitCount() const { return n_hits.load(); }
+  [[nodiscard]] auto getMissCount() const { return n_misses.load(); }
+
+ private:
+  [[nodiscard]] std::string getObjectPath(const std::string &key) const;
+
+ private:
+  const std::string cache_dir;
+
+  std::atomic<size_t> n_hits{};
+  std::atomic<size_t> n_misses{};
+};
+
+}  // namespace dcds
+
+#endif  // DCDS_LLVM_OBJECT_CACHE_HPP
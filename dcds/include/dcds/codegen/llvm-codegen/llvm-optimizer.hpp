@@ -0,0 +1,82 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#ifndef DCDS_LLVM_OPTIMIZER_HPP
+#define DCDS_LLVM_OPTIMIZER_HPP
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/ExecutionEngine/Orc/IRCompileLayer.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "dcds/builder/hints/builder-hints.hpp"
+
+namespace dcds {
+
+// Optimization settings of one generated module (see hints::OptimizationProfile and hints::TargetHints). They are
+// attached to the module as module flags, so that they travel with it (and with the function partitions of lazy and
+// tiered compilation) through the layers of the JIT, which is shared by builders with different settings.
+struct LLVMOptimizationConfig {
+  hints::OptimizationProfile profile = hints::OptimizationProfile::LATENCY;
+  hints::TargetHints target = hints::TargetHints::HOST_CPU;
+
+  void attachTo(llvm::Module &module) const;
+  // Modules without attached settings get the defaults.
+  static LLVMOptimizationConfig readFrom(const llvm::Module &module);
+
+  [[nodiscard]] llvm::OptimizationLevel getOptimizationLevel() const;
+  [[nodiscard]] llvm::CodeGenOpt::Level getCodeGenOptLevel() const;
+
+  // Derives the target machine of this config from the one of the host.
+  [[nodiscard]] llvm::orc::JITTargetMachineBuilder getTargetMachineBuilder(
+      llvm::orc::JITTargetMachineBuilder host) const;
+
+  [[nodiscard]] std::string toString() const;
+};
+
+class LLVMOptimizer {
+ public:
+  // Per-module default pipeline of the new pass manager for the profile of `config`.
+  static void optimize(llvm::Module &module, llvm::TargetMachine &TM, const LLVMOptimizationConfig &config);
+
+  // Cheap function-level cleanup (mem2reg, instcombine, reassociate, GVN, simplifycfg, DCE) of generated IR.
+  static void simplify(llvm::Module &module);
+};
+
+// Compiles every module with a target machine matching its LLVMOptimizationConfig (code generation opt-level, CPU and
+// features), on the calling thread like ConcurrentIRCompiler.
+class LLVMProfileCompiler : public llvm::orc::IRCompileLayer::IRCompiler {
+ public:
+  explicit LLVMProfileCompiler(llvm::orc::JITTargetMachineBuilder _JTMB, llvm::ObjectCache *_objCache = nullptr);
+
+  llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> operator()(llvm::Module &M) override;
+
+ private:
+  llvm::orc::JITTargetMachineBuilder JTMB;
+  llvm::ObjectCache *objCache;
+};
+
+}  // namespace dcds
+
+#endif  // DCDS_LLVM_OPTIMIZER_HPP
@@ -0,0 +1,60 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#ifndef DCDS_LLVM_RUNTIME_ATTRIBUTES_HPP
+#define DCDS_LLVM_RUNTIME_ATTRIBUTES_HPP
+
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/Function.h>
+
+#include <string>
+#include <vector>
+
+namespace dcds {
+
+// Function and parameter attributes of the runtime functions called from generated code (functions.hpp,
+// index-functions.hpp). Without them, every runtime call is opaque to LLVM: it may unwind, read or write any memory and
+// capture every pointer passed to it, so temporaries passed as destinations can never be forwarded or promoted and
+// repeated calls are never combined.
+//
+// Generated code also touches runtime memory directly: it loads and stores array columns, and probes open-addressing
+// indexes and filters inline. Hence no runtime function is declared to access only inaccessible (or argument) memory,
+// and only lookups which read nothing but metadata are readonly. When adding or changing a runtime function, keep its
+// entry in llvm-runtime-attributes.cpp in sync with what the implementation actually touches, and with what generated
+// code touches directly.
+class LLVMRuntimeAttributes {
+ public:
+  struct function_attributes_t {
+    std::vector<llvm::Attribute::AttrKind> fn;
+    std::vector<std::vector<llvm::Attribute::AttrKind>> params;
+  };
+
+  // Adds the known attributes of a runtime function declaration, looked up by its symbol name. Returns false (and
+  // leaves the declaration untouched) for unknown functions.
+  static bool annotate(llvm::Function *fn);
+
+  static const function_attributes_t *lookup(const std::string &symbol_name);
+};
+
+}  // namespace dcds
+
+#endif  // DCDS_LLVM_RUNTIME_ATTRIBUTES_HPP
@@ -37,16 +37,23 @@ using table_id_t = uint16_t;
 using column_id_t = uint8_t;
 using rw_set_t = std::map<std::string, std::set<std::string>>;
 
+constexpr size_t CACHE_LINE_SIZE = 64;
+
 class jit_function_t {
  public:
   const std::string name;
   const void *address;
   const dcds::valueType returnType;
   const std::vector<std::pair<std::string, dcds::valueType>> args;
+  const std::vector<bool> args_by_reference;  // per argument: passed as a pointer
 
   jit_function_t(std::string _name, void *_address, dcds::valueType _return_type,
-                 std::vector<std::pair<std::string, dcds::valueType>> _args)
-      : name(std::move(_name)), address(_address), returnType(_return_type), args(std::move(_args)) {}
+                 std::vector<std::pair<std::string, dcds::valueType>> _args, std::vector<bool> _args_by_reference)
+      : name(std::move(_name)),
+        address(_address),
+        returnType(_return_type),
+        args(std::move(_args)),
+        args_by_reference(std::move(_args_by_reference)) {}
 };
 
 }  // namespace dcds
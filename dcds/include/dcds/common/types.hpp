@@ -63,6 +63,28 @@ inline std::ostream &operator<<(std::ostream &os, dcds::valueType ty) {
 
   return os;
 }
+
+// storage width of a value of the given type, as laid out in the records.
+inline size_t valueTypeSize(dcds::valueType ty) {
+  switch (ty) {
+    case dcds::valueType::INT64:
+      return sizeof(int64_t);
+    case dcds::valueType::INT32:
+      return sizeof(int32_t);
+    case dcds::valueType::FLOAT:
+      return sizeof(float);
+    case dcds::valueType::DOUBLE:
+      return sizeof(double);
+    case dcds::valueType::RECORD_PTR:
+      return sizeof(void *);
+    case dcds::valueType::BOOL:
+      return sizeof(bool);
+    case dcds::valueType::VOID:
+      return 0;
+  }
+  return 0;
+}
+
 inline std::ostream &operator<<(std::ostream &os, dcds::VAR_SOURCE_TYPE ty) {
   os << "dcds::VAR_SOURCE_TYPE::";
   switch (ty) {
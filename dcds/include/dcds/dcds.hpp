@@ -26,12 +26,15 @@
 #include "dcds/builder/expressions/binary-expressions.hpp"
 #include "dcds/builder/expressions/constant-expressions.hpp"
 #include "dcds/builder/expressions/expressions.hpp"
+#include "dcds/builder/expressions/key-expressions.hpp"
 #include "dcds/builder/expressions/unary-expressions.hpp"
 #include "dcds/builder/function-builder.hpp"
 #include "dcds/builder/optimizer/builder-opt-passes.hpp"
 #include "dcds/builder/statement-builder.hpp"
 #include "dcds/common/common.hpp"
+#include "dcds/exporter/code-exporter.hpp"
 #include "dcds/exporter/jit-container.hpp"
+#include "dcds/indexes/binary-key.hpp"
 #include "dcds/util/affinity-manager.hpp"
 #include "dcds/util/logging.hpp"
 #include "dcds/util/profiling.hpp"
@@ -22,48 +22,55 @@
 #ifndef DCDS_GENERATOR_HPP
 #define DCDS_GENERATOR_HPP
 
-#include <deque>
+#include <memory>
 #include <string>
-#include <vector>
+#include <utility>
 
+#include "dcds/builder/builder.hpp"
 #include "dcds/util/erase-constructor-idioms.hpp"
 
 namespace dcds {
 
 /*
- * This class should export .hpp/.so file in the provided output directory.
- * Also, it should add license on the top.
+ * Ahead-of-time export of a data structure. For a builder named `X`, it generates in the output directory:
+ *  - X.o:   optimized, position-independent object file with the constructor and one symbol per exposed function.
+ *  - X.hpp: typed C++ header (with license on the top) declaring the symbols and a thin `dcds::aot::X` class, so
+ *           that binaries can link the generated data structure without any JIT compilation at startup.
+ *  The object file still depends on the DCDS runtime (storage, transactions and indexes), hence, consumers link
+ *  against libdcds. See `dcds_add_aot_library` in cmake/dcds-aot.cmake for the build-time helper.
+ *  The object is built once and may run on other machines than the one building it, hence, it targets the baseline
+ *  CPU of the triple (TargetHints::PORTABLE) unless another target is given; the builder's own target hint only
+ *  applies to its JIT-ed code.
  * */
 class CodeExporter : public dcds::remove_copy {
  public:
-  CodeExporter() = default;
+  explicit CodeExporter(std::shared_ptr<Builder> _builder, hints::TargetHints _target = hints::TargetHints::PORTABLE)
+      : builder(std::move(_builder)), target(_target) {}
   virtual ~CodeExporter() = default;
 
  public:
-  void exportToFile(std::string filename);
-  void createStruct(std::string name, std::vector<dcds::SimpleAttribute> attributes);
+  void exportToDirectory(const std::string &output_directory);
+
+  void exportObjectFile(const std::string &filename);
+  void exportHeaderFile(const std::string &filename);
+
+ private:
+  static std::string getLicenseString();
+  static std::string toCppType(dcds::valueType type);
+  static std::string toIdentifier(const std::string &name);
 
  private:
-  std::deque<std::string> structs;
+  std::shared_ptr<Builder> builder;
+  const hints::TargetHints target;
 
   // A .hpp file will have
   //  - License
   //  - Constructor
   //  - public functions
-  //  - public struct (ds struct type)
   //  - private struct (ds container struct)
-  //  - Destructor?
+  //  - Destructor
 };
 
-// class CodeExporterContext : public dcds::remove_copy {
-//  public:
-//   CodeExporterContext() {}
-//   virtual ~CodeExporterContext();
-//
-//  public:
-//   std::string getLicenseString();
-// };
-
 }  // namespace dcds
 
 #endif  // DCDS_GENERATOR_HPP
@@ -22,16 +22,80 @@
 #ifndef DCDS_JIT_CONTAINER_HPP
 #define DCDS_JIT_CONTAINER_HPP
 
+#include <algorithm>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "dcds/codegen/codegen.hpp"
 #include "dcds/codegen/llvm-codegen/functions.hpp"
+#include "dcds/indexes/index.hpp"
 #include "dcds/storage/table-registry.hpp"
 #include "dcds/transaction/transaction.hpp"
 
 namespace dcds {
 
 class Builder;
+class JitContainer;
+
+template <typename Signature>
+class JitFunction;
+
+// Typed handle to a generated function, resolved once through JitContainer::get and afterwards called directly
+// through the function pointer, that is, without the op-name lookup, variadic call and std::any boxing of
+// JitContainer::op. Reference arguments of the generated function are passed as pointers.
+template <typename R, typename... Args>
+class JitFunction<R(Args...)> {
+ public:
+  using signature_t = R(Args...);
+  using fn_ptr_t = R (*)(void *, uintptr_t, Args...);
+
+  JitFunction() = default;
+
+  inline R operator()(Args... args) const { return fn(txnManager, mainRecord, args...); }
+
+  explicit operator bool() const { return fn != nullptr; }
+
+ private:
+  JitFunction(fn_ptr_t _fn, void *_txnManager, uintptr_t _mainRecord)
+      : fn(_fn), txnManager(_txnManager), mainRecord(_mainRecord) {}
+
+  template <typename T>
+  static constexpr bool matchesType(dcds::valueType type) {
+    using U = std::remove_cv_t<T>;
+    if constexpr (std::is_void_v<U>) {
+      return type == dcds::valueType::VOID;
+    } else if constexpr (std::is_same_v<U, bool>) {
+      return type == dcds::valueType::BOOL;
+    } else if constexpr (std::is_integral_v<U> && sizeof(U) == sizeof(int32_t)) {
+      return type == dcds::valueType::INT32;
+    } else if constexpr (std::is_integral_v<U> && sizeof(U) == sizeof(int64_t)) {
+      return type == dcds::valueType::INT64 || type == dcds::valueType::RECORD_PTR;
+    } else if constexpr (std::is_same_v<U, float>) {
+      return type == dcds::valueType::FLOAT;
+    } else if constexpr (std::is_same_v<U, double>) {
+      return type == dcds::valueType::DOUBLE;
+    } else {
+      return false;
+    }
+  }
+
+  // reference arguments have to be pointers in the signature, and by-value ones must not be.
+  static bool matches(const jit_function_t &f) {
+    if (!matchesType<R>(f.returnType) || f.args.size() != sizeof...(Args)) return false;
+    size_t i = 0;
+    return ((std::is_pointer_v<Args> == f.args_by_reference[i] &&
+             matchesType<std::remove_pointer_t<Args>>(f.args[i++].second)) &&
+            ...);
+  }
+
+ private:
+  fn_ptr_t fn = nullptr;
+  void *txnManager = nullptr;
+  uintptr_t mainRecord = 0;
+
+  friend class JitContainer;
+};
 
 class JitContainer {
  public:
@@ -103,6 +167,55 @@ class JitContainer {
     assert(false && "how come here?");
   }
 
+  // e.g., auto lookup = instance->get<bool(int64_t, int64_t *)>("lookup"); lookup(key, &val);
+  template <typename Signature>
+  JitFunction<Signature> get(const std::string &op_name) {
+    auto &functions = codegen_engine->getAvailableFunctions();
+    auto it = functions.find(op_name);
+    CHECK(it != functions.end()) << "Unknown op: " << op_name;
+    CHECK(JitFunction<Signature>::matches(*(it->second))) << "Signature mismatch for op: " << op_name;
+
+    return JitFunction<Signature>(
+        reinterpret_cast<typename JitFunction<Signature>::fn_ptr_t>(const_cast<void *>(it->second->address)),
+        _container->txnManager, _container->mainRecord);
+  }
+
+  // Loads n records with the given keys, and default values otherwise, into the indexed list `list_name`, e.g., to
+  // populate a DS before running a workload, instead of calling a generated insert op (a transaction) per key. The
+  // generated loader of the list allocates the records in groups on n_threads threads, then the index gets all of
+  // them at once (Index<K>::bulkInsert), which sizes it upfront, or builds an ordered one from the sorted keys.
+  //
+  // There is no transaction, hence no CC or logging: the DS must not be published yet, i.e., no op runs concurrently
+  // with the load. The keys must be new and unique. K is the key type of the list.
+  template <typename K>
+  void bulkLoad(const std::string &list_name, const K *keys, size_t n, size_t n_threads = 1) {
+    using loader_fn_t = uintptr_t (*)(void *, uintptr_t, const void *, size_t, uintptr_t *);
+
+    auto *loader = codegen_engine->getBulkLoader(list_name);
+    CHECK(loader) << "No bulk loader for list: " << list_name;
+    CHECK(JitFunction<void()>::matchesType<K>(loader->key_type)) << "Key type mismatch for list: " << list_name;
+    if (n == 0) return;
+
+    auto fn = reinterpret_cast<loader_fn_t>(const_cast<void *>(loader->address));
+    n_threads = std::clamp<size_t>(n_threads, 1, n);
+    auto chunk = (n + n_threads - 1) / n_threads;
+    std::vector<uintptr_t> records(n);
+
+    auto load = [&](size_t begin) {
+      auto len = std::min(chunk, n - begin);
+      return fn(_container->txnManager, _container->mainRecord, keys + begin, len, records.data() + begin);
+    };
+    std::vector<std::thread> workers;
+    for (size_t begin = chunk; begin < n; begin += chunk) workers.emplace_back(load, begin);
+    auto index = load(0);
+    for (auto &w : workers) w.join();
+
+    auto inserted = reinterpret_cast<indexes::IndexBase *>(index)->_bulk_insert_erased(keys, records.data(), n);
+    CHECK(inserted == n) << "Bulk load of " << list_name << ": " << (n - inserted) << " keys repeat or exist already";
+  }
+
+  [[nodiscard]] const jit_startup_stats_t &getJitStartupStats() const { return codegen_engine->getStartupStats(); }
+
   void listAllAvailableFunctions() {
     auto functions = codegen_engine->getAvailableFunctions();
     for (auto &f : functions) {
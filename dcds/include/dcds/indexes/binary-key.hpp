@@ -0,0 +1,123 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+
+#ifndef DCDS_BINARY_KEY_HPP
+#define DCDS_BINARY_KEY_HPP
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace dcds::indexes {
+
+// Fixed-width key of N bytes, for composite keys wider than 64 bits (packed 64 bits per word by the generated code,
+// see Builder::addAttributeIndexedList) and for string keys (StringKey). Keys are stored inline in the index, and
+// compare word by word as unsigned, the first word the most significant, as packed INT64 keys do.
+template <size_t N>
+struct BinaryKey {
+  static_assert(N == 16 || N == 32);
+  static constexpr size_t n_words = N / 8;
+  // one per word, so that words are hashed independently (and in parallel, in the generated probes) and then folded.
+  static constexpr uint64_t word_multipliers[4] = {UINT64_C(0xC2B2AE3D27D4EB4F), UINT64_C(0x9E3779B97F4A7C15),
+                                                   UINT64_C(0xFF51AFD7ED558CCD), UINT64_C(0xC4CEB9FE1A85EC53)};
+
+  uint64_t words[n_words];
+
+  friend bool operator==(const BinaryKey &, const BinaryKey &) = default;
+  friend std::strong_ordering operator<=>(const BinaryKey &a, const BinaryKey &b) {
+    for (size_t i = 0; i < n_words; i++) {
+      if (a.words[i] != b.words[i]) return a.words[i] <=> b.words[i];
+    }
+    return std::strong_ordering::equal;
+  }
+
+  // 64 bits of the key, for the hashes which take keys of up to 64 bits (e.g., NegativeLookupFilter::keyBits).
+  [[nodiscard]] uint64_t fold() const {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < n_words; i++) bits ^= words[i] * word_multipliers[i];
+    return bits;
+  }
+
+  [[nodiscard]] uint64_t hash() const {
+    auto h = fold();
+    h = (h ^ (h >> 32)) * word_multipliers[0];
+    return h ^ (h >> 29);
+  }
+};
+
+static_assert(sizeof(BinaryKey<16>) == 16 && sizeof(BinaryKey<32>) == 32);
+
+// String keys on 32-byte binary keys, so that indexes compare and hash them without dereferencing a pointer. Strings of
+// up to inline_bytes bytes are stored in the key, with their length in the last byte. Longer ones keep their first
+// inline_bytes bytes, followed by a 56-bit hash of the whole string. Hence, equal strings have equal keys, and keys order
+// as their strings, except for long strings with the same first inline_bytes bytes, which order by their hash.
+//
+// Keys of long strings are not unique to their string: two collide if they share the prefix and the hash. So the index
+// finds a candidate, which a lookup of a long string (isExact is false) compares out of line to the whole string, where
+// the application keeps it (e.g., in the record). Keys hold no references, so removes and rollbacks have nothing to
+// release.
+//
+// Indexed lists take them as a composite key of four 64-bit INT64 parts, of which parts() gives the values.
+class StringKey {
+ public:
+  using key_type = BinaryKey<32>;
+  static constexpr size_t inline_bytes = 24;
+
+  static key_type encode(std::string_view str);
+  // Whether the key is the string itself (a short one), i.e., equal keys are equal strings.
+  static bool isExact(const key_type &key);
+  // The string of an exact key, otherwise its first inline_bytes bytes.
+  static std::string decode(const key_type &key);
+
+  // Values of the parts which the generated code packs into key (each 64-bit part is biased by 2^63).
+  static std::array<int64_t, key_type::n_words> parts(const key_type &key) {
+    std::array<int64_t, key_type::n_words> ret{};
+    for (size_t i = 0; i < key_type::n_words; i++) ret[i] = static_cast<int64_t>(key.words[i] ^ part_bias);
+    return ret;
+  }
+  static key_type fromParts(const std::array<int64_t, key_type::n_words> &parts) {
+    key_type ret{};
+    for (size_t i = 0; i < key_type::n_words; i++) ret.words[i] = static_cast<uint64_t>(parts[i]) ^ part_bias;
+    return ret;
+  }
+
+ private:
+  static constexpr uint64_t part_bias = uint64_t{1} << 63;
+  static constexpr uint8_t long_marker = 0xFF;
+  static key_type pack(std::string_view prefix, uint8_t last, uint64_t hash);
+  static uint64_t hashOf(std::string_view str);
+};
+
+}  // namespace dcds::indexes
+
+template <size_t N>
+struct std::hash<dcds::indexes::BinaryKey<N>> {
+  size_t operator()(const dcds::indexes::BinaryKey<N> &key) const noexcept { return key.hash(); }
+};
+
+#endif  // DCDS_BINARY_KEY_HPP
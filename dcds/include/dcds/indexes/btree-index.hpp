@@ -0,0 +1,524 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+#ifndef DCDS_BTREE_INDEX_HPP
+#define DCDS_BTREE_INDEX_HPP
+
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "dcds/indexes/index.hpp"
+#include "dcds/util/intrinsic-macros.hpp"
+
+namespace dcds::indexes {
+
+// B+-tree with optimistic lock coupling (Leis et al., "The ART of practical synchronization", DaMoN'16): readers
+// traverse without writing to shared memory and validate node versions, writers lock only the nodes they modify.
+// Full nodes are split eagerly on the way down, so a split never propagates up.
+//
+// Nodes are never freed while the tree exists: removal does not merge nodes, hence optimistic readers can always
+// follow a pointer they read, even if the node changed meanwhile (they restart on the version mismatch).
+template <typename K>
+class BTreeIndex : public OrderedIndex<K> {
+ public:
+  using value_type = typename Index<K>::value_type;
+  using key_type = typename Index<K>::key_type;
+
+ private:
+  static constexpr size_t page_size = 4096;
+  // a bulk build leaves 1/bulk_slack of every node free.
+  static constexpr size_t bulk_slack = 8;
+
+  // version | locked (bit 1) | obsolete (bit 0).
+  class OptLock {
+   public:
+    uint64_t readLockOrRestart(bool &needRestart) const {
+      uint64_t version = typeVersionLockObsolete.load();
+      if (isLocked(version) || isObsolete(version)) {
+        DCDS_SPIN_PAUSE();
+        needRestart = true;
+      }
+      return version;
+    }
+
+    void upgradeToWriteLockOrRestart(uint64_t &version, bool &needRestart) {
+      if (typeVersionLockObsolete.compare_exchange_strong(version, version + 0b10)) {
+        version = version + 0b10;
+      } else {
+        DCDS_SPIN_PAUSE();
+        needRestart = true;
+      }
+    }
+
+    void writeUnlock() { typeVersionLockObsolete.fetch_add(0b10); }
+
+    void readUnlockOrRestart(uint64_t startRead, bool &needRestart) const {
+      needRestart = (startRead != typeVersionLockObsolete.load());
+    }
+    void checkOrRestart(uint64_t startRead, bool &needRestart) const { readUnlockOrRestart(startRead, needRestart); }
+
+   private:
+    static bool isLocked(uint64_t version) { return (version & 0b10) == 0b10; }
+    static bool isObsolete(uint64_t version) { return (version & 1) == 1; }
+
+    std::atomic<uint64_t> typeVersionLockObsolete{0b100};
+  };
+
+  enum class PageType : uint8_t { INNER, LEAF };
+
+  struct NodeBase : public OptLock {
+    explicit NodeBase(PageType _type) : type(_type) {}
+    const PageType type;
+    uint16_t count = 0;
+  };
+
+  // position of the first key >= k, or > k if not inclusive.
+  static uint16_t search(const key_type *keys, uint16_t count, key_type k, bool inclusive) {
+    uint16_t lower = 0;
+    uint16_t upper = count;
+    while (lower < upper) {
+      uint16_t mid = lower + (upper - lower) / 2;
+      if (keys[mid] < k || (!inclusive && keys[mid] == k)) {
+        lower = mid + 1;
+      } else {
+        upper = mid;
+      }
+    }
+    return lower;
+  }
+
+  struct Leaf : public NodeBase {
+    static constexpr uint16_t max_entries = (page_size - sizeof(NodeBase)) / (sizeof(key_type) + sizeof(value_type));
+
+    Leaf() : NodeBase(PageType::LEAF) {}
+
+    [[nodiscard]] bool isFull() const { return this->count == max_entries; }
+
+    void insert(uint16_t pos, key_type k, value_type v) {
+      assert(this->count < max_entries);
+      memmove(keys + pos + 1, keys + pos, sizeof(key_type) * (this->count - pos));
+      memmove(payloads + pos + 1, payloads + pos, sizeof(value_type) * (this->count - pos));
+      keys[pos] = k;
+      payloads[pos] = v;
+      this->count++;
+    }
+
+    void remove(uint16_t pos) {
+      memmove(keys + pos, keys + pos + 1, sizeof(key_type) * (this->count - pos - 1));
+      memmove(payloads + pos, payloads + pos + 1, sizeof(value_type) * (this->count - pos - 1));
+      this->count--;
+    }
+
+    // keys <= separator stay here, the upper half moves to the returned leaf.
+    Leaf *split(key_type &separator) {
+      auto *right = new Leaf();
+      right->count = this->count - (this->count / 2);
+      this->count = this->count - right->count;
+      memcpy(right->keys, keys + this->count, sizeof(key_type) * right->count);
+      memcpy(right->payloads, payloads + this->count, sizeof(value_type) * right->count);
+      separator = keys[this->count - 1];
+      return right;
+    }
+
+    key_type keys[max_entries];
+    value_type payloads[max_entries];
+  };
+
+  // children[i] holds the keys in (keys[i-1], keys[i]], children[count] the ones above keys[count-1].
+  struct Inner : public NodeBase {
+    static constexpr uint16_t max_entries = (page_size - sizeof(NodeBase)) / (sizeof(key_type) + sizeof(NodeBase *));
+
+    Inner() : NodeBase(PageType::INNER) {}
+
+    [[nodiscard]] bool isFull() const { return this->count == (max_entries - 1); }
+
+    void insert(key_type k, NodeBase *child) {
+      assert(this->count < max_entries - 1);
+      auto pos = search(keys, this->count, k, true);
+      memmove(keys + pos + 1, keys + pos, sizeof(key_type) * (this->count - pos + 1));
+      memmove(children + pos + 1, children + pos, sizeof(NodeBase *) * (this->count - pos + 1));
+      keys[pos] = k;
+      children[pos] = child;
+      std::swap(children[pos], children[pos + 1]);
+      this->count++;
+    }
+
+    Inner *split(key_type &separator) {
+      auto *right = new Inner();
+      right->count = this->count - (this->count / 2);
+      this->count = this->count - right->count - 1;
+      separator = keys[this->count];
+      memcpy(right->keys, keys + this->count + 1, sizeof(key_type) * (right->count + 1));
+      memcpy(right->children, children + this->count + 1, sizeof(NodeBase *) * (right->count + 1));
+      return right;
+    }
+
+    NodeBase *children[max_entries];
+    key_type keys[max_entries];
+  };
+
+ public:
+  BTreeIndex() : root(new Leaf()) {}
+  ~BTreeIndex() { destroy(root.load()); }
+
+  BTreeIndex(const BTreeIndex &) = delete;
+  BTreeIndex &operator=(const BTreeIndex &) = delete;
+
+  value_type _find(key_type key) override {
+    value_type value{};
+    _find(key, value);
+    return value;
+  }
+
+  bool _find(key_type key, value_type &value) override {
+    key_type found = key;
+    bool inclusive = true;
+    while (true) {
+      bool needRestart = false;
+      bool ret = tryNext(found, inclusive, key, value, needRestart);
+      if (!needRestart) return ret;
+    }
+  }
+
+  bool _contains(key_type key) override {
+    value_type value{};
+    return _find(key, value);
+  }
+
+  bool _insert(key_type key, value_type value) override { return upsert(key, value, true, false); }
+  bool _update(key_type key, value_type value) override { return upsert(key, value, false, true); }
+
+  void _remove(key_type key) override {
+    for (size_t restarts = 0;; backoff(++restarts)) {
+      bool needRestart = false;
+      Inner *parent = nullptr;
+      uint64_t versionParent = 0;
+      uint64_t versionNode = 0;
+      auto *leaf = descend(key, true, parent, versionParent, versionNode, nullptr, needRestart);
+      if (needRestart) continue;
+
+      leaf->upgradeToWriteLockOrRestart(versionNode, needRestart);
+      if (needRestart) continue;
+      if (parent) {
+        parent->readUnlockOrRestart(versionParent, needRestart);
+        if (needRestart) {
+          leaf->writeUnlock();
+          continue;
+        }
+      }
+
+      auto pos = search(leaf->keys, leaf->count, key, true);
+      if (pos < leaf->count && leaf->keys[pos] == key) {
+        leaf->remove(pos);
+        n_entries--;
+      }
+      leaf->writeUnlock();
+      return;
+    }
+  }
+
+  // An empty tree is built bottom-up from the sorted entries: leaves and inner nodes are filled in key order up to
+  // bulk_fill, instead of splitting them insert by insert. The build replaces the root at the end and frees the
+  // previous (empty) one, hence it must not run concurrently with other operations on the tree, e.g., it loads a tree
+  // which is not published yet. Inserts into a non-empty tree go one by one.
+  size_t _bulk_insert(const key_type *keys, const value_type *values, size_t n) override {
+    if (n_entries.load() != 0 || root.load()->type != PageType::LEAF) {
+      return OrderedIndex<K>::_bulk_insert(keys, values, n);
+    }
+
+    std::vector<std::pair<key_type, value_type>> entries;
+    entries.reserve(n);
+    for (size_t i = 0; i < n; i++) entries.emplace_back(keys[i], values[i]);
+    // stable, so that the first of repeated keys is the one kept.
+    std::stable_sort(entries.begin(), entries.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    entries.erase(std::unique(entries.begin(), entries.end(),
+                              [](const auto &a, const auto &b) { return a.first == b.first; }),
+                  entries.end());
+    if (entries.empty()) return 0;
+
+    // nodes of the level being built, with the largest key below each.
+    std::vector<std::pair<NodeBase *, key_type>> level;
+    auto leaf_fill = bulkFill(Leaf::max_entries);
+    for (size_t i = 0; i < entries.size(); i += leaf_fill) {
+      auto *leaf = new Leaf();
+      leaf->count = std::min(leaf_fill, entries.size() - i);
+      for (uint16_t j = 0; j < leaf->count; j++) {
+        leaf->keys[j] = entries[i + j].first;
+        leaf->payloads[j] = entries[i + j].second;
+      }
+      level.emplace_back(leaf, leaf->keys[leaf->count - 1]);
+    }
+
+    size_t nodes = level.size();
+    auto inner_fill = bulkFill(Inner::max_entries - 1) + 1;  // children
+    while (level.size() > 1) {
+      std::vector<std::pair<NodeBase *, key_type>> parents;
+      for (size_t i = 0; i < level.size(); i += inner_fill) {
+        auto *inner = new Inner();
+        auto n_children = std::min(inner_fill, level.size() - i);
+        inner->count = n_children - 1;
+        for (uint16_t j = 0; j < n_children; j++) {
+          inner->children[j] = level[i + j].first;
+          if (j < inner->count) inner->keys[j] = level[i + j].second;
+        }
+        parents.emplace_back(inner, level[i + n_children - 1].second);
+      }
+      nodes += parents.size();
+      level = std::move(parents);
+    }
+
+    delete static_cast<Leaf *>(root.exchange(level.front().first));
+    n_nodes = nodes;
+    n_entries = entries.size();
+    return entries.size();
+  }
+
+  // grows node by node (splits): nothing is resized.
+  IndexStats _stats() override {
+    return IndexStats{hints::IndexHints::ORDERED, n_entries.load(), n_nodes.load() * page_size, 0,
+                      std::chrono::nanoseconds(0)};
+  }
+
+  bool _next(key_type &key, bool inclusive, key_type upper, value_type &value) override {
+    while (true) {
+      bool needRestart = false;
+      bool ret = tryNext(key, inclusive, upper, value, needRestart);
+      if (!needRestart) return ret;
+    }
+  }
+
+ private:
+  static void backoff(size_t restarts) {
+    if (restarts % 64 == 0) {
+      sched_yield();
+    } else {
+      DCDS_SPIN_PAUSE();
+    }
+  }
+
+  // entries per node of a bulk build, so that the first inserts after it do not split every node they reach.
+  static size_t bulkFill(size_t max_entries) { return std::max<size_t>(max_entries - max_entries / bulk_slack, 1); }
+
+  static void destroy(NodeBase *node) {
+    if (node->type == PageType::INNER) {
+      auto *inner = static_cast<Inner *>(node);
+      for (uint16_t i = 0; i <= inner->count; i++) destroy(inner->children[i]);
+      delete inner;
+    } else {
+      delete static_cast<Leaf *>(node);
+    }
+  }
+
+  // Optimistically descends to the leaf which holds `key` (or, if not inclusive, the first key above it), returning
+  // it with its version and its parent. fence, if given, is set to the upper bound of the leaf's key range, if any.
+  Leaf *descend(key_type key, bool inclusive, Inner *&parent, uint64_t &versionParent, uint64_t &versionNode,
+                std::pair<bool, key_type> *fence, bool &needRestart) {
+    NodeBase *node = root.load();
+    versionNode = node->readLockOrRestart(needRestart);
+    if (needRestart || node != root.load()) {
+      needRestart = true;
+      return nullptr;
+    }
+
+    while (node->type == PageType::INNER) {
+      auto *inner = static_cast<Inner *>(node);
+      if (parent) {
+        parent->readUnlockOrRestart(versionParent, needRestart);
+        if (needRestart) return nullptr;
+      }
+      parent = inner;
+      versionParent = versionNode;
+
+      auto pos = search(inner->keys, inner->count, key, inclusive);
+      if (fence && pos < inner->count) *fence = {true, inner->keys[pos]};
+      node = inner->children[pos];
+      inner->checkOrRestart(versionNode, needRestart);
+      if (needRestart) return nullptr;
+      versionNode = node->readLockOrRestart(needRestart);
+      if (needRestart) return nullptr;
+    }
+    return static_cast<Leaf *>(node);
+  }
+
+  // key and inclusive are advanced past empty leaves, so that a restart does not visit them again.
+  bool tryNext(key_type &key, bool &inclusive, key_type upper, value_type &value, bool &needRestart) {
+    while (true) {
+      Inner *parent = nullptr;
+      uint64_t versionParent = 0;
+      uint64_t versionNode = 0;
+      std::pair<bool, key_type> fence{false, key_type{}};
+      auto *leaf = descend(key, inclusive, parent, versionParent, versionNode, &fence, needRestart);
+      if (needRestart) return false;
+
+      auto pos = search(leaf->keys, leaf->count, key, inclusive);
+      bool found = pos < leaf->count;
+      key_type found_key{};
+      value_type found_value{};
+      if (found) {
+        found_key = leaf->keys[pos];
+        found_value = leaf->payloads[pos];
+      }
+
+      // a concurrent split may have moved the keys right after the leaf was reached, the parent tells.
+      if (parent) {
+        parent->readUnlockOrRestart(versionParent, needRestart);
+        if (needRestart) return false;
+      }
+      leaf->readUnlockOrRestart(versionNode, needRestart);
+      if (needRestart) return false;
+
+      if (found) {
+        if (upper < found_key) return false;
+        key = found_key;
+        value = found_value;
+        return true;
+      }
+
+      // the rest of this leaf is empty (or removed), continue in the next subtree.
+      if (!fence.first || !(fence.second < upper)) return false;
+      key = fence.second;
+      inclusive = false;
+    }
+  }
+
+  bool upsert(key_type key, value_type value, bool insert_new, bool update_existing) {
+    for (size_t restarts = 0;; backoff(++restarts)) {
+      bool needRestart = false;
+
+      NodeBase *node = root.load();
+      uint64_t versionNode = node->readLockOrRestart(needRestart);
+      if (needRestart || node != root.load()) continue;
+
+      Inner *parent = nullptr;
+      uint64_t versionParent = 0;
+
+      while (node->type == PageType::INNER) {
+        auto *inner = static_cast<Inner *>(node);
+
+        if (inner->isFull()) {
+          splitNode(node, versionNode, parent, versionParent, needRestart);
+          break;
+        }
+
+        if (parent) {
+          parent->readUnlockOrRestart(versionParent, needRestart);
+          if (needRestart) break;
+        }
+        parent = inner;
+        versionParent = versionNode;
+
+        node = inner->children[search(inner->keys, inner->count, key, true)];
+        inner->checkOrRestart(versionNode, needRestart);
+        if (needRestart) break;
+        versionNode = node->readLockOrRestart(needRestart);
+        if (needRestart) break;
+      }
+      if (needRestart) continue;
+
+      auto *leaf = static_cast<Leaf *>(node);
+      if (leaf->isFull()) {
+        splitNode(node, versionNode, parent, versionParent, needRestart);
+        continue;
+      }
+
+      leaf->upgradeToWriteLockOrRestart(versionNode, needRestart);
+      if (needRestart) continue;
+      if (parent) {
+        parent->readUnlockOrRestart(versionParent, needRestart);
+        if (needRestart) {
+          leaf->writeUnlock();
+          continue;
+        }
+      }
+
+      auto pos = search(leaf->keys, leaf->count, key, true);
+      bool exists = pos < leaf->count && leaf->keys[pos] == key;
+      bool done = false;
+      if (exists && update_existing) {
+        leaf->payloads[pos] = value;
+        done = true;
+      } else if (!exists && insert_new) {
+        leaf->insert(pos, key, value);
+        n_entries++;
+        done = true;
+      }
+      leaf->writeUnlock();
+      return done;
+    }
+  }
+
+  // Splits the full node under its parent, or under a new root. Always sets needRestart, as the path changed.
+  void splitNode(NodeBase *node, uint64_t &versionNode, Inner *parent, uint64_t &versionParent, bool &needRestart) {
+    if (parent) {
+      parent->upgradeToWriteLockOrRestart(versionParent, needRestart);
+      if (needRestart) return;
+    }
+    node->upgradeToWriteLockOrRestart(versionNode, needRestart);
+    if (needRestart) {
+      if (parent) parent->writeUnlock();
+      return;
+    }
+    if (!parent && node != root.load()) {
+      // someone else added a root meanwhile.
+      node->writeUnlock();
+      needRestart = true;
+      return;
+    }
+
+    key_type separator{};
+    NodeBase *right;
+    if (node->type == PageType::INNER) {
+      right = static_cast<Inner *>(node)->split(separator);
+    } else {
+      right = static_cast<Leaf *>(node)->split(separator);
+    }
+    n_nodes++;
+    if (parent) {
+      parent->insert(separator, right);
+    } else {
+      n_nodes++;
+      auto *new_root = new Inner();
+      new_root->count = 1;
+      new_root->keys[0] = separator;
+      new_root->children[0] = node;
+      new_root->children[1] = right;
+      root.store(new_root);
+    }
+
+    node->writeUnlock();
+    if (parent) parent->writeUnlock();
+    needRestart = true;
+  }
+
+ private:
+  std::atomic<NodeBase *> root;
+  std::atomic<size_t> n_entries{0};
+  std::atomic<size_t> n_nodes{1};
+};
+
+}  // namespace dcds::indexes
+
+#endif  // DCDS_BTREE_INDEX_HPP
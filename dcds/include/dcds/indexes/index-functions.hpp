@@ -24,16 +24,22 @@
 
 #include <iostream>
 
+#include "dcds/builder/hints/builder-hints.hpp"
 #include "dcds/common/common.hpp"
 #include "dcds/common/types.hpp"
+#include "dcds/indexes/binary-key.hpp"
 #include "dcds/indexes/index.hpp"
+#include "dcds/transaction/transaction.hpp"
 
-extern "C" uintptr_t createIndexMap(dcds::valueType key_type);
+// capacity, growth_factor, negative_lookup_filter: hints::IndexSizeHints
+// key_bytes: 0 for keys of key_type, otherwise the width of the BinaryKey keys (AttributeIndexedList::key_bytes).
+extern "C" uintptr_t createIndexMap(dcds::valueType key_type, size_t key_bytes, dcds::hints::IndexHints index_type,
+                                    size_t capacity, size_t growth_factor, bool negative_lookup_filter);
 
 template <typename K>
 uintptr_t index_find(uintptr_t index, K key) {
   uintptr_t ret = 0;
-  reinterpret_cast<dcds::indexes::Index<K>*>(index)->_find(key, ret);
+  reinterpret_cast<dcds::indexes::Index<K>*>(index)->find(key, ret);
   // LOG(INFO) <<"[index_find] Index: " << index <<  " | key: " << key << " found_status: " << found <<  " | val: " <<
   // ret;
   return ret;
@@ -41,13 +47,13 @@ uintptr_t index_find(uintptr_t index, K key) {
 
 template <typename K>
 bool contains(uintptr_t index, K key) {
-  return reinterpret_cast<dcds::indexes::Index<K>*>(index)->_contains(key);
+  return reinterpret_cast<dcds::indexes::Index<K>*>(index)->contains(key);
 }
 
 template <typename K>
 bool index_insert(uintptr_t index, K key, uintptr_t value) {
   auto idx = reinterpret_cast<dcds::indexes::Index<K>*>(index);
-  auto ins_res = idx->_insert(key, value);
+  auto ins_res = idx->insert(key, value);
   // LOG(INFO) <<"[index_insert] Index: " << index <<  " | key: " << key << " | val: " << value << " |res: " << ins_res;
   return ins_res;
 }
@@ -55,8 +61,147 @@ bool index_insert(uintptr_t index, K key, uintptr_t value) {
 template <typename K>
 void index_remove(uintptr_t index, K key) {
   auto idx = reinterpret_cast<dcds::indexes::Index<K>*>(index);
-  idx->_remove(key);
+  idx->remove(key);
   // LOG(INFO) << "[index_remove]: remove key: " << key;
 }
 
+// Exclusive lock of an index key (stripe) until the end of the transaction. Aborts the transaction if it is locked.
+bool index_lock_key(dcds::txn::Txn* txn, dcds::txn::cc::RecordMetaData& key_lock);
+
+// Whether the transaction logged index writes, which only it finds until it commits. False without a transaction.
+extern "C" bool index_txn_has_writes(void* txnPtr);
+
+// Lookup within a transaction, txnPtr is null without concurrency control. The index writes of a transaction are only
+// applied when it commits (see txn::IndexLog), so its own entries, or removes, are found in its log first.
+template <typename K>
+uintptr_t index_find_txn(void* txnPtr, uintptr_t index, K key) {
+  auto* txn = static_cast<dcds::txn::Txn*>(txnPtr);
+  if (txn) {
+    bool present;
+    uintptr_t value;
+    auto idx = reinterpret_cast<dcds::indexes::Index<K>*>(index);
+    if (txn->getLog().findIndexEntry(idx, &key, sizeof(K), present, value)) return present ? value : 0;
+  }
+  return index_find(index, key);
+}
+
+// Transactional insert/remove, txnPtr is null without concurrency control. The key is locked until the end of the
+// transaction, and the entry is logged, to be applied at commit. As the key is locked, no other transaction may insert
+// it in between, so the insert fails right away on an existing key, as this transaction finds it.
+template <typename K>
+bool index_insert_txn(void* txnPtr, uintptr_t index, K key, uintptr_t value) {
+  auto* txn = static_cast<dcds::txn::Txn*>(txnPtr);
+  if (!txn) return index_insert(index, key, value);
+
+  auto idx = reinterpret_cast<dcds::indexes::Index<K>*>(index);
+  if (!index_lock_key(txn, idx->keyLock(key))) return false;
+  if (index_find_txn(txnPtr, index, key)) return false;
+
+  txn->getLog().addIndexInsertLog(idx, &key, sizeof(K), value);
+  return true;
+}
+
+// Insert for keys which cannot exist already (non-unique secondary indexes), so it is not checked against the index.
+template <typename K>
+bool index_insert_deferred_txn(void* txnPtr, uintptr_t index, K key, uintptr_t value) {
+  auto* txn = static_cast<dcds::txn::Txn*>(txnPtr);
+  if (!txn) return index_insert(index, key, value);
+
+  auto idx = reinterpret_cast<dcds::indexes::Index<K>*>(index);
+  if (!index_lock_key(txn, idx->keyLock(key))) return false;
+
+  txn->getLog().addIndexDeferredInsertLog(idx, &key, sizeof(K), value);
+  return true;
+}
+
+// removed: if not null, set to the entry which the remove takes out (0 if none), looked up once the key is locked.
+template <typename K>
+bool index_remove_txn(void* txnPtr, uintptr_t index, K key, uintptr_t* removed) {
+  auto* txn = static_cast<dcds::txn::Txn*>(txnPtr);
+  if (!txn) {
+    if (removed) *removed = index_find(index, key);
+    index_remove(index, key);
+    return true;
+  }
+
+  auto idx = reinterpret_cast<dcds::indexes::Index<K>*>(index);
+  if (!index_lock_key(txn, idx->keyLock(key))) return false;
+  if (removed) *removed = index_find_txn(txnPtr, index, key);
+
+  txn->getLog().addIndexRemoveLog(idx, &key, sizeof(K));
+  return true;
+}
+
+// Step of an ordered scan: the next entry after *cursor (or at it, if inclusive) up to upper. See OrderedIndex::_next.
+template <typename K>
+bool index_scan_next(uintptr_t index, K* cursor, bool inclusive, K upper, uintptr_t* record) {
+  return reinterpret_cast<dcds::indexes::OrderedIndex<K>*>(index)->_next(*cursor, inclusive, upper, *record);
+}
+
+// Binary keys (BinaryKey) are passed by pointer, to the key in the frame of the generated code.
+template <typename K>
+uintptr_t index_find_ref(uintptr_t index, const K* key) {
+  return index_find(index, *key);
+}
+
+template <typename K>
+uintptr_t index_find_txn_ref(void* txnPtr, uintptr_t index, const K* key) {
+  return index_find_txn(txnPtr, index, *key);
+}
+
+template <typename K>
+void index_remove_ref(uintptr_t index, const K* key) {
+  index_remove(index, *key);
+}
+
+template <typename K>
+bool index_insert_txn_ref(void* txnPtr, uintptr_t index, const K* key, uintptr_t value) {
+  return index_insert_txn(txnPtr, index, *key, value);
+}
+
+template <typename K>
+bool index_insert_deferred_txn_ref(void* txnPtr, uintptr_t index, const K* key, uintptr_t value) {
+  return index_insert_deferred_txn(txnPtr, index, *key, value);
+}
+
+template <typename K>
+bool index_remove_txn_ref(void* txnPtr, uintptr_t index, const K* key, uintptr_t* removed) {
+  return index_remove_txn(txnPtr, index, *key, removed);
+}
+
+template <typename K>
+bool index_scan_next_ref(uintptr_t index, K* cursor, bool inclusive, const K* upper, uintptr_t* record) {
+  return index_scan_next(index, cursor, inclusive, *upper, record);
+}
+
+// The instantiations which the generated code calls, for the key types of indexed lists. They are instantiated once,
+// in the runtime library (index-functions.cpp), which JIT-compiled code and objects exported ahead of time link.
+#define DCDS_INDEX_FUNCTIONS(prefix, K)                                         \
+  prefix uintptr_t index_find<K>(uintptr_t, K);                                 \
+  prefix uintptr_t index_find_txn<K>(void*, uintptr_t, K);                      \
+  prefix bool index_insert<K>(uintptr_t, K, uintptr_t);                         \
+  prefix void index_remove<K>(uintptr_t, K);                                    \
+  prefix bool index_insert_txn<K>(void*, uintptr_t, K, uintptr_t);              \
+  prefix bool index_insert_deferred_txn<K>(void*, uintptr_t, K, uintptr_t);     \
+  prefix bool index_remove_txn<K>(void*, uintptr_t, K, uintptr_t*);             \
+  prefix bool index_scan_next<K>(uintptr_t, K*, bool, K, uintptr_t*);
+
+#define DCDS_BINARY_KEY_INDEX_FUNCTIONS(prefix, K)                                    \
+  DCDS_INDEX_FUNCTIONS(prefix, K)                                                     \
+  prefix uintptr_t index_find_ref<K>(uintptr_t, const K*);                            \
+  prefix uintptr_t index_find_txn_ref<K>(void*, uintptr_t, const K*);                 \
+  prefix void index_remove_ref<K>(uintptr_t, const K*);                               \
+  prefix bool index_insert_txn_ref<K>(void*, uintptr_t, const K*, uintptr_t);         \
+  prefix bool index_insert_deferred_txn_ref<K>(void*, uintptr_t, const K*, uintptr_t); \
+  prefix bool index_remove_txn_ref<K>(void*, uintptr_t, const K*, uintptr_t*);        \
+  prefix bool index_scan_next_ref<K>(uintptr_t, K*, bool, const K*, uintptr_t*);
+
+DCDS_INDEX_FUNCTIONS(extern template, int64_t)
+DCDS_INDEX_FUNCTIONS(extern template, int32_t)
+DCDS_INDEX_FUNCTIONS(extern template, float)
+DCDS_INDEX_FUNCTIONS(extern template, double)
+DCDS_INDEX_FUNCTIONS(extern template, uintptr_t)
+DCDS_BINARY_KEY_INDEX_FUNCTIONS(extern template, dcds::indexes::BinaryKey<16>)
+DCDS_BINARY_KEY_INDEX_FUNCTIONS(extern template, dcds::indexes::BinaryKey<32>)
+
 #endif  // DCDS_INDEX_FUNCTIONS_HPP
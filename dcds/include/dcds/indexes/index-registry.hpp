@@ -0,0 +1,63 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#ifndef DCDS_INDEX_REGISTRY_HPP
+#define DCDS_INDEX_REGISTRY_HPP
+
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "dcds/builder/hints/builder-hints.hpp"
+#include "dcds/common/types.hpp"
+#include "dcds/indexes/index.hpp"
+#include "dcds/util/singleton.hpp"
+
+namespace dcds::indexes {
+
+// Indexes of the indexed lists, created by the generated constructors.
+class IndexRegistry : public dcds::Singleton<IndexRegistry> {
+  friend class dcds::Singleton<IndexRegistry>;
+
+ public:
+  // key_bytes: 0 for keys of key_type, otherwise the width of BinaryKey keys.
+  IndexBase* createIndex(dcds::valueType key_type, size_t key_bytes, hints::IndexHints index_type,
+                         const hints::IndexSizeHints& size_hints);
+
+  // One entry per index, e.g., to report the memory per index and the time spent resizing.
+  std::vector<IndexStats> getStats();
+
+  // Drops all the indexes, as TableRegistry::clear, once no instance uses them anymore.
+  void clear();
+
+ private:
+  std::mutex registry_lk{};
+  std::unordered_set<IndexBase*> indexes;
+
+ private:
+  ~IndexRegistry() = default;
+  IndexRegistry() = default;
+};
+
+}  // namespace dcds::indexes
+
+#endif  // DCDS_INDEX_REGISTRY_HPP
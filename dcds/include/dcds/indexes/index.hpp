@@ -22,15 +22,75 @@
 #ifndef DCDS_INDEX_HPP
 #define DCDS_INDEX_HPP
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <functional>
 #include <iostream>
 #include <libcuckoo/cuckoohash_map.hh>
 
+#include "dcds/builder/hints/builder-hints.hpp"
+#include "dcds/indexes/negative-lookup-filter.hpp"
+#include "dcds/transaction/concurrency-control/record-metadata.hpp"
+
 namespace dcds::indexes {
 
+struct IndexStats {
+  hints::IndexHints index_type;
+  size_t entries;
+  // allocated by the index, including the memory it keeps for concurrent readers.
+  size_t memory_bytes;
+  size_t resizes;
+  std::chrono::nanoseconds resize_time;
+  // of the negative-lookup filter, if any.
+  size_t filter_bytes = 0;
+};
+
+// Key-type independent part of the indexes, e.g., for the IndexRegistry.
+class IndexBase {
+ public:
+  // The filter pointer directly follows the vtable pointer, for the probe which is generated inline.
+  static constexpr size_t filter_offset = sizeof(void *);
+
+  IndexBase() { assert(reinterpret_cast<uintptr_t>(&filter) - reinterpret_cast<uintptr_t>(this) == filter_offset); }
+  virtual ~IndexBase() { delete filter; }
+
+  // Attaches a negative-lookup filter, before the index has any entry.
+  void enableNegativeLookupFilter(size_t expected_entries) {
+    assert(filter == nullptr);
+    filter = new NegativeLookupFilter(expected_entries);
+  }
+  [[nodiscard]] const NegativeLookupFilter *negativeLookupFilter() const { return filter; }
+
+  virtual IndexStats _stats() = 0;
+
+  // Operations on a key of the index's key type, behind a pointer, e.g., for the index entries of transaction logs.
+  virtual bool _insert_erased(const void *key, uintptr_t value) = 0;
+  virtual bool _find_erased(const void *key, uintptr_t &value) = 0;
+  virtual void _remove_erased(const void *key) = 0;
+  virtual size_t _bulk_insert_erased(const void *keys, const uintptr_t *values, size_t n) = 0;
+
+  // Lock of the keys with this hash, for transactional inserts and removes (index_insert_txn/index_remove_txn). The
+  // locks are striped, so concurrent writers of different keys rarely conflict, instead of all locking the record
+  // which owns the index.
+  txn::cc::RecordMetaData &keyLockStripe(size_t key_hash) {
+    return key_locks[(key_hash * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - key_lock_bits)];
+  }
+
+ protected:
+  NegativeLookupFilter *filter = nullptr;
+
+ private:
+  static constexpr size_t key_lock_bits = 9;
+  std::array<txn::cc::RecordMetaData, size_t{1} << key_lock_bits> key_locks{};
+};
+
 // NOTE: value_type should be default constructible
 
 template <typename K>
-class Index {
+class Index : public IndexBase {
  public:
   using key_type = K;
   using value_type = uintptr_t;
@@ -42,12 +102,82 @@ class Index {
   virtual bool _insert(key_type key, value_type value) = 0;
   virtual bool _update(key_type key, value_type value) = 0;
   virtual void _remove(key_type key) = 0;
+
+  // Inserts n entries at once, e.g., to load the index of a DS which is not published yet: implementations size (or
+  // build) the index for all of them upfront, instead of growing it insert by insert. Keys which are in the index
+  // already, or repeat in the batch, are skipped (the first one is kept). Returns the number of entries inserted.
+  virtual size_t _bulk_insert(const key_type *keys, const value_type *values, size_t n) {
+    size_t inserted = 0;
+    for (size_t i = 0; i < n; i++) inserted += _insert(keys[i], values[i]);
+    return inserted;
+  }
+
+  // Operations which keep the negative-lookup filter (if any) in sync with the index, for the runtime functions.
+  bool find(key_type key, value_type &value) {
+    if (this->filter && !this->filter->mayContain(key)) return false;
+    return _find(key, value);
+  }
+  bool contains(key_type key) {
+    if (this->filter && !this->filter->mayContain(key)) return false;
+    return _contains(key);
+  }
+  bool insert(key_type key, value_type value) {
+    if (!this->filter) return _insert(key, value);
+    this->filter->add(key);
+    if (_insert(key, value)) return true;
+    this->filter->remove(key);
+    return false;
+  }
+  // The key must not be inserted or removed concurrently (as with the key locks of transactions), otherwise two
+  // removes could both find it and both remove it from the filter.
+  void remove(key_type key) {
+    if (!this->filter) return _remove(key);
+    value_type value;
+    if (!_find(key, value)) return;
+    _remove(key);
+    this->filter->remove(key);
+  }
+
+  // The keys of skipped entries stay added to the filter, which only makes it less precise.
+  size_t bulkInsert(const key_type *keys, const value_type *values, size_t n) {
+    if (this->filter) {
+      for (size_t i = 0; i < n; i++) this->filter->add(keys[i]);
+    }
+    return _bulk_insert(keys, values, n);
+  }
+
+  bool _insert_erased(const void *key, value_type value) final {
+    return insert(*static_cast<const key_type *>(key), value);
+  }
+  bool _find_erased(const void *key, value_type &value) final {
+    return find(*static_cast<const key_type *>(key), value);
+  }
+  void _remove_erased(const void *key) final { remove(*static_cast<const key_type *>(key)); }
+  size_t _bulk_insert_erased(const void *keys, const value_type *values, size_t n) final {
+    return bulkInsert(static_cast<const key_type *>(keys), values, n);
+  }
+
+  txn::cc::RecordMetaData &keyLock(key_type key) { return this->keyLockStripe(std::hash<key_type>{}(key)); }
 };
 
+// Indexes which keep their keys sorted.
+template <typename K>
+class OrderedIndex : public Index<K> {
+ public:
+  using value_type = typename Index<K>::value_type;
+  using key_type = typename Index<K>::key_type;
+
+  // Smallest entry with a key after `key` (or equal to it, if inclusive) and not above `upper`. On success, `key` is
+  // set to the found key, so that calling again with inclusive = false continues the scan; no state is kept in between.
+  virtual bool _next(key_type &key, bool inclusive, key_type upper, value_type &value) = 0;
+};
+
+// libcuckoo grows the table by doubling it (IndexSizeHints::growth_factor does not apply), and migrates the buckets
+// to the new table lazily, on the next access to them.
 template <typename K>
 class CuckooHashIndex : public Index<K> {
  public:
-  CuckooHashIndex() { _idx.reserve(1_M); };
+  explicit CuckooHashIndex(size_t capacity = 0) : _idx(capacity ? capacity : initial_capacity) {}
 
   using value_type = typename Index<K>::value_type;
   using key_type = typename Index<K>::key_type;
@@ -60,16 +190,52 @@ class CuckooHashIndex : public Index<K> {
     // return _idx.find_fn(key, [&value](const auto &v) mutable { value = v; });
   }
 
-  bool _insert(key_type key, value_type value) override { return _idx.insert(key, value); }
+  bool _insert(key_type key, value_type value) override {
+    auto hashpower = _idx.hashpower();
+    auto start = std::chrono::steady_clock::now();
+    auto ret = _idx.insert(key, value);
+    // the insert which grew the table, the migration of the buckets is spread over the accesses after it.
+    if (_idx.hashpower() != hashpower) {
+      resizes++;
+      resize_ns += (std::chrono::steady_clock::now() - start) / std::chrono::nanoseconds(1);
+    }
+    return ret;
+  }
 
   bool _contains(key_type key) override { return _idx.contains(key); }
 
+  // a single resize to the final size, instead of doubling along the way.
+  size_t _bulk_insert(const key_type *keys, const value_type *values, size_t n) override {
+    auto start = std::chrono::steady_clock::now();
+    if (_idx.reserve(_idx.size() + n)) {
+      resizes++;
+      resize_ns += (std::chrono::steady_clock::now() - start) / std::chrono::nanoseconds(1);
+    }
+    size_t inserted = 0;
+    for (size_t i = 0; i < n; i++) inserted += _idx.insert(keys[i], values[i]);
+    return inserted;
+  }
+
   bool _update(key_type key, value_type value) override { return _idx.update(key, value); }
 
   void _remove(key_type key) override { _idx.erase(key); }
 
+  IndexStats _stats() override {
+    // a bucket has a slot (key, value, partial key, occupied) per entry; locks are cache-line aligned.
+    auto slot_bytes = sizeof(key_type) + sizeof(value_type) + 2;
+    auto lock_bytes = std::min(_idx.bucket_count(), max_num_locks) * 64;
+    return IndexStats{hints::IndexHints::HASH, _idx.size(), _idx.capacity() * slot_bytes + lock_bytes, resizes.load(),
+                      std::chrono::nanoseconds(resize_ns.load())};
+  }
+
  private:
+  // smallest table of libcuckoo (a few buckets), instead of reserving for a large index upfront.
+  static constexpr size_t initial_capacity = 16;
+  static constexpr size_t max_num_locks = size_t{1} << 16;
+
   libcuckoo::cuckoohash_map<K, uintptr_t> _idx;
+  std::atomic<size_t> resizes{0};
+  std::atomic<uint64_t> resize_ns{0};
 };
 
 }  // namespace dcds::indexes
@@ -0,0 +1,147 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#ifndef DCDS_NEGATIVE_LOOKUP_FILTER_HPP
+#define DCDS_NEGATIVE_LOOKUP_FILTER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "dcds/indexes/binary-key.hpp"
+
+namespace dcds::indexes {
+
+// Byte offsets of the filter, for the probe which is generated inline in IR (LLVMCodegenStatement::inlineFilterProbe).
+struct NegativeLookupFilterLayout {
+  size_t words;
+  size_t word_shift;
+};
+
+// Blocked counting Bloom filter in front of an index (hints::IndexSizeHints::negative_lookup_filter), so that lookups
+// of absent keys usually skip the index. A key maps to one 64-bit word, i.e., 16 4-bit counters, of which it increments
+// 3. Hence, a probe is a single load and testing three nibbles, and writers update a word with a CAS.
+//
+// Removes decrement the counters, instead of rebuilding the filter. A counter which saturates (15) sticks, so that it
+// never drops to zero while a key still maps to it. The filter has a fixed size: one word per expected entry (about
+// 2% false positives), past it, only the precision degrades.
+//
+// Keys are added before they are inserted in the index and removed after they are removed from it, so a probe which
+// misses means that the index does not have the key. Removes must only be called for keys in the filter, i.e., the
+// writers of a key are serialized (see Index<K>::remove).
+class NegativeLookupFilter {
+ public:
+  static constexpr uint64_t hash_multiplier = UINT64_C(0xC2B2AE3D27D4EB4F);
+  static constexpr size_t counters_per_key = 3;
+  static constexpr uint64_t counter_max = 15;
+  // bits of the hash which select the counters of a key in its word; the word is selected by the upper bits.
+  static constexpr unsigned counter_shifts[counters_per_key] = {20, 24, 28};
+  static constexpr size_t default_words = 4096;
+  static constexpr size_t max_words = size_t{1} << 28;
+
+  explicit NegativeLookupFilter(size_t expected_entries = 0)
+      : words(new std::atomic<uint64_t>[wordsFor(expected_entries)]()),
+        word_shift(64 - std::countr_zero(wordsFor(expected_entries))) {
+    static_assert(offsetof(NegativeLookupFilter, words) == layout.words);
+    static_assert(offsetof(NegativeLookupFilter, word_shift) == layout.word_shift);
+  }
+
+  NegativeLookupFilter(const NegativeLookupFilter &) = delete;
+  NegativeLookupFilter &operator=(const NegativeLookupFilter &) = delete;
+
+  ~NegativeLookupFilter() { delete[] words; }
+
+  static_assert(std::is_standard_layout_v<std::atomic<uint64_t>>);
+  static constexpr NegativeLookupFilterLayout layout{0, sizeof(std::atomic<uint64_t> *)};
+
+  // The generated probe computes the same hash and counters, over the key bits zero-extended to 64 bits, or folded for
+  // binary keys.
+  static inline uint64_t hash(uint64_t bits) {
+    auto h = bits * hash_multiplier;
+    return h ^ (h >> 29);
+  }
+
+  template <typename K>
+  static inline uint64_t keyBits(K key) {
+    static_assert(sizeof(K) == 4 || sizeof(K) == 8);
+    return std::bit_cast<std::conditional_t<sizeof(K) == 8, uint64_t, uint32_t>>(key);
+  }
+  template <size_t N>
+  static inline uint64_t keyBits(const BinaryKey<N> &key) { return key.fold(); }
+
+  template <typename K>
+  bool mayContain(K key) const {
+    auto h = hash(keyBits(key));
+    auto word = words[h >> word_shift].load(std::memory_order_acquire);
+    for (auto shift : counter_shifts) {
+      if (((word >> counterBit(h, shift)) & counter_max) == 0) return false;
+    }
+    return true;
+  }
+
+  template <typename K>
+  void add(K key) {
+    update(hash(keyBits(key)), true);
+  }
+
+  template <typename K>
+  void remove(K key) {
+    update(hash(keyBits(key)), false);
+  }
+
+  size_t memoryBytes() const { return (size_t{1} << (64 - word_shift)) * sizeof(uint64_t); }
+
+ private:
+  static size_t wordsFor(size_t expected_entries) {
+    return std::bit_ceil(std::clamp(expected_entries ? expected_entries : default_words, size_t{64}, max_words));
+  }
+
+  static inline unsigned counterBit(uint64_t h, unsigned shift) { return ((h >> shift) & 15) * 4; }
+
+  void update(uint64_t h, bool increment) {
+    auto &word = words[h >> word_shift];
+    auto old_word = word.load(std::memory_order_relaxed);
+    uint64_t new_word;
+    do {
+      new_word = old_word;
+      // applied one after the other, as two counters of a key can be the same.
+      for (auto shift : counter_shifts) {
+        auto bit = counterBit(h, shift);
+        auto counter = (new_word >> bit) & counter_max;
+        if (counter == counter_max || (!increment && counter == 0)) continue;
+        new_word = increment ? new_word + (uint64_t{1} << bit) : new_word - (uint64_t{1} << bit);
+      }
+    } while (!word.compare_exchange_weak(old_word, new_word, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  std::atomic<uint64_t> *const words;
+  const uint64_t word_shift;
+};
+
+static_assert(std::is_standard_layout_v<NegativeLookupFilter>);
+
+}  // namespace dcds::indexes
+
+#endif  // DCDS_NEGATIVE_LOOKUP_FILTER_HPP
@@ -0,0 +1,650 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#ifndef DCDS_OPEN_ADDRESSING_INDEX_HPP
+#define DCDS_OPEN_ADDRESSING_INDEX_HPP
+
+#include <atomic>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "dcds/indexes/index.hpp"
+#include "dcds/util/epoch.hpp"
+#include "dcds/util/intrinsic-macros.hpp"
+
+namespace dcds::indexes {
+
+// Byte offsets of the index memory layout, for the lookup which is generated inline in IR
+// (LLVMCodegenStatement::inlineIndexFind). Only depends on the width of the key.
+struct OpenAddressingLayout {
+  size_t index_table;  // OpenAddressingIndex::table
+  size_t table_group_mask;
+  size_t table_groups;
+  size_t group_bytes;
+  size_t group_version;
+  size_t group_tags;
+  size_t group_keys;
+  size_t group_values;
+};
+
+// Hash index with linear probing over groups of 16 slots. Every slot has a one-byte tag next to the others of its
+// group (0: empty, 1: deleted, 0x80 | 7 bits of the hash: used), so that a probe compares the 16 tags of a group at
+// once (SIMD) and only looks at the keys of matching tags.
+//
+// Lookups are optimistic: every group has a version which writers make odd while they change the group, readers
+// validate it after reading the group and restart on a change. Hence, lookups do not write to shared memory: the only
+// store is the epoch pin of the thread (util::Epoch), to its own slot.
+//
+// The odd version is also the lock of the group for writers: a writer locks the home group of its key (which
+// serializes the writers of a key) and the group it changes, if another one. Writers only take the whole index, one
+// at a time, while a resize is ongoing, or to start one.
+//
+// Growth is incremental: past 3/4 of the slots, the next table is allocated and every write copies a few groups to it
+// (and applies itself to the groups already copied), until the next table replaces the current one. Lookups only read
+// the current table, so they neither wait for a resize nor look at two tables. The groups of a replaced table are
+// left odd, hence a lookup which still reads it restarts on the new one. Lookups pin the epoch while they read a table
+// (generated code pins once per operation), and a replaced table is freed by a later writer once no thread pinned
+// before the replacement is still pinned. An index without a capacity hint starts on a shared empty table, allocated
+// on the first insert.
+//
+// Keys are compared bitwise (e.g., 0.0 and -0.0 are different float keys).
+template <typename K>
+class OpenAddressingIndex : public Index<K> {
+  static_assert(sizeof(K) == 4 || sizeof(K) == 8);
+
+ public:
+  using value_type = typename Index<K>::value_type;
+  using key_type = typename Index<K>::key_type;
+  using key_bits_type = std::conditional_t<sizeof(K) == 8, uint64_t, uint32_t>;
+
+  static constexpr size_t group_size = 16;
+  static constexpr uint8_t empty_tag = 0;
+  static constexpr uint8_t deleted_tag = 1;
+  static constexpr uint64_t hash_multiplier = UINT64_C(0x9E3779B97F4A7C15);
+
+  struct alignas(64) Group {
+    std::atomic<uint64_t> version;
+    uint8_t tags[group_size];
+    key_bits_type keys[group_size];
+    value_type values[group_size];
+  };
+
+  struct Table {
+    size_t group_mask;
+    Group *groups;
+    std::atomic<size_t> used;  // live and deleted slots.
+    std::atomic<size_t> live;
+  };
+
+  static_assert(std::is_standard_layout_v<Group> && std::is_standard_layout_v<Table>);
+
+  // The table pointer directly follows the Index<K> base (the vtable pointer and the key locks).
+  static constexpr OpenAddressingLayout layout{sizeof(Index<K>),
+                                               offsetof(Table, group_mask),
+                                               offsetof(Table, groups),
+                                               sizeof(Group),
+                                               offsetof(Group, version),
+                                               offsetof(Group, tags),
+                                               offsetof(Group, keys),
+                                               offsetof(Group, values)};
+
+  // The generated lookup computes the same hash, tag and home group.
+  static inline uint64_t hash(key_bits_type bits) { return static_cast<uint64_t>(bits) * hash_multiplier; }
+  static inline uint8_t tagOf(uint64_t h) { return static_cast<uint8_t>((h >> 57) | 0x80); }
+  static inline size_t homeGroup(uint64_t h, size_t group_mask) { return (h ^ (h >> 29)) & group_mask; }
+
+ public:
+  explicit OpenAddressingIndex(size_t capacity = 0, size_t growth_factor = 2)
+      : table(capacity ? allocateTable(groupsFor(capacity)) : &empty_table),
+        growth(std::bit_ceil(std::max(growth_factor, size_t{2}))) {
+    assert(reinterpret_cast<uintptr_t>(&table) - reinterpret_cast<uintptr_t>(this) == layout.index_table);
+  }
+
+  OpenAddressingIndex(const OpenAddressingIndex &) = delete;
+  OpenAddressingIndex &operator=(const OpenAddressingIndex &) = delete;
+
+  ~OpenAddressingIndex() override {
+    if (table.load() != &empty_table) freeTable(table.load());
+    if (next_table) freeTable(next_table);
+    for (auto &r : retired) freeTable(r.first);
+  }
+
+  value_type _find(key_type key) override {
+    value_type value = 0;
+    _find(key, value);
+    return value;
+  }
+
+  bool _find(key_type key, value_type &value) override {
+    auto bits = std::bit_cast<key_bits_type>(key);
+    auto h = hash(bits);
+    auto tag = tagOf(h);
+
+    // pinned before the table is loaded (a no-op within generated operations, which are pinned already).
+    util::Epoch::Guard pin;
+    return lookup(bits, h, tag, value);
+  }
+
+  bool _contains(key_type key) override {
+    value_type value = 0;
+    return _find(key, value);
+  }
+
+  bool _insert(key_type key, value_type value) override {
+    auto bits = std::bit_cast<key_bits_type>(key);
+    auto h = hash(bits);
+    if (auto ret = sharedInsert(bits, h, value)) return *ret;
+    lockExclusive();
+
+    Table *t = table.load(std::memory_order_relaxed);
+    if (t == &empty_table) {
+      t = allocateTable(1);
+      table.store(t, std::memory_order_release);
+    }
+
+    Group *group;
+    size_t slot;
+    bool inserted = !locate(t, bits, h, group, slot);
+    if (inserted) {
+      if (!next_table && (t->used + 1) * 4 > capacityOf(t) * 3) startResize(t);
+      // the resize did not keep up (only with very few groups): finish it before the table fills up.
+      if (next_table && (t->used + 1) * 8 > capacityOf(t) * 7) {
+        resizeStep(t->group_mask + 1);
+        t = table.load(std::memory_order_relaxed);
+      }
+
+      locateFree(t, h, group, slot);
+      writeSlot(t, group, slot, bits, value, tagOf(h), true);
+      if (next_table && migrated(t, group)) {
+        locateFree(next_table, h, group, slot);
+        writeSlot(next_table, group, slot, bits, value, tagOf(h), false);
+      }
+    }
+    if (next_table) resizeStep(resize_step);
+
+    unlockExclusive();
+    return inserted;
+  }
+
+  // In the exclusive mode, after growing the table once to hold all the entries below 3/4 of the slots, so that none
+  // of the inserts starts a resize.
+  size_t _bulk_insert(const key_type *keys, const value_type *values, size_t n) override {
+    lockExclusive();
+
+    Table *t = table.load(std::memory_order_relaxed);
+    if (next_table) {
+      resizeStep(t->group_mask + 1);
+      t = table.load(std::memory_order_relaxed);
+    }
+    if (t == &empty_table) {
+      t = allocateTable(groupsFor(n));
+      table.store(t, std::memory_order_release);
+    } else if ((t->used + n) * 4 > capacityOf(t) * 3) {
+      auto start = std::chrono::steady_clock::now();
+      next_table = allocateTable(std::max(groupsFor(t->live + n), t->group_mask + 1));
+      migrated_groups = 0;
+      resize_ns += (std::chrono::steady_clock::now() - start) / std::chrono::nanoseconds(1);
+      resizeStep(t->group_mask + 1);
+      t = table.load(std::memory_order_relaxed);
+    }
+
+    size_t inserted = 0;
+    for (size_t i = 0; i < n; i++) {
+      auto bits = std::bit_cast<key_bits_type>(keys[i]);
+      auto h = hash(bits);
+      Group *group;
+      size_t slot;
+      if (locate(t, bits, h, group, slot)) continue;
+      locateFree(t, h, group, slot);
+      writeSlot(t, group, slot, bits, values[i], tagOf(h), true);
+      inserted++;
+    }
+
+    unlockExclusive();
+    return inserted;
+  }
+
+  bool _update(key_type key, value_type value) override {
+    auto bits = std::bit_cast<key_bits_type>(key);
+    auto h = hash(bits);
+    if (auto ret = sharedWrite(bits, h, [value](Table *, Group &group, size_t slot) {
+          storeRelaxed(group.values[slot], value);
+        })) {
+      return *ret;
+    }
+    lockExclusive();
+
+    Table *t = table.load(std::memory_order_relaxed);
+    Group *group;
+    size_t slot;
+    bool found = locate(t, bits, h, group, slot);
+    if (found) {
+      beginWrite(*group);
+      storeRelaxed(group->values[slot], value);
+      endWrite(*group);
+      if (next_table && migrated(t, group) && locate(next_table, bits, h, group, slot)) group->values[slot] = value;
+    }
+    if (next_table) resizeStep(resize_step);
+
+    unlockExclusive();
+    return found;
+  }
+
+  void _remove(key_type key) override {
+    auto bits = std::bit_cast<key_bits_type>(key);
+    auto h = hash(bits);
+    if (sharedWrite(bits, h, [](Table *t, Group &group, size_t slot) {
+          storeRelaxed(group.tags[slot], deleted_tag);
+          t->live--;
+        }).has_value()) {
+      return;
+    }
+    lockExclusive();
+
+    Table *t = table.load(std::memory_order_relaxed);
+    Group *group;
+    size_t slot;
+    if (locate(t, bits, h, group, slot)) {
+      // the slot stays used (deleted) so that the probes which passed it still reach the keys after it.
+      beginWrite(*group);
+      storeRelaxed(group->tags[slot], deleted_tag);
+      endWrite(*group);
+      addExclusive(t->live, -1);
+      if (next_table && migrated(t, group) && locate(next_table, bits, h, group, slot)) {
+        group->tags[slot] = deleted_tag;
+        addExclusive(next_table->live, -1);
+      }
+    }
+    if (next_table) resizeStep(resize_step);
+
+    unlockExclusive();
+  }
+
+  IndexStats _stats() override {
+    lockExclusive();
+    Table *t = table.load(std::memory_order_relaxed);
+    IndexStats stats{hints::IndexHints::OPEN_ADDRESSING, t->live, 0, resizes,
+                     std::chrono::nanoseconds(resize_ns)};
+    if (t != &empty_table) stats.memory_bytes += bytesOf(t);
+    if (next_table) stats.memory_bytes += bytesOf(next_table);
+    for (auto &r : retired) stats.memory_bytes += bytesOf(r.first);
+    unlockExclusive();
+    return stats;
+  }
+
+ private:
+  // groups copied to the next table per write: the copy ends before the current table goes from 3/4 to 7/8 full.
+  static constexpr size_t resize_step = 2;
+
+  static inline Group empty_group{};
+  static inline Table empty_table{0, &empty_group, 0, 0};
+
+  template <typename T>
+  static inline T loadRelaxed(const T &src) {
+    return __atomic_load_n(&src, __ATOMIC_RELAXED);
+  }
+  template <typename T>
+  static inline void storeRelaxed(T &dst, T value) {
+    __atomic_store_n(&dst, value, __ATOMIC_RELAXED);
+  }
+
+  // the version of a group is odd while it is locked by a writer (and changing). The lock is taken at a version
+  // which the writer read before, so that it fails if the group changed since. In the exclusive mode, writers neither
+  // conflict with each other, nor with the locks of the shared mode (no shared writer remains).
+  static inline bool lockGroupAt(Group &group, uint64_t version) {
+    if (!group.version.compare_exchange_strong(version, version + 1, std::memory_order_acquire)) return false;
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+  }
+  static inline bool tryLockGroup(Group &group) {
+    auto version = group.version.load(std::memory_order_relaxed);
+    return !(version & 1) && lockGroupAt(group, version);
+  }
+
+  static inline void beginWrite(Group &group) {
+    group.version.store(group.version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+  static inline void endWrite(Group &group) {
+    group.version.store(group.version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // counters of the table in the exclusive mode, which no other writer updates meanwhile.
+  static inline void addExclusive(std::atomic<size_t> &counter, int64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  static inline size_t capacityOf(const Table *t) { return (t->group_mask + 1) * group_size; }
+  static inline size_t bytesOf(const Table *t) { return sizeof(Table) + (t->group_mask + 1) * sizeof(Group); }
+  // groups to hold `entries` below 3/4 of the slots.
+  static inline size_t groupsFor(size_t entries) { return std::bit_ceil((entries * 4 / 3) / group_size + 1); }
+
+  static Table *allocateTable(size_t n_groups) {
+    assert(std::has_single_bit(n_groups));
+    return new Table{n_groups - 1, new Group[n_groups](), 0, 0};
+  }
+
+  static void freeTable(Table *t) {
+    delete[] t->groups;
+    delete t;
+  }
+
+  // writer-side: the slot of the key, if present. Needs the home group of the key locked, or the exclusive mode. Other
+  // slots may change meanwhile, but no empty slot appears (deleted ones stay used), so the key does not move.
+  static bool locate(Table *t, key_bits_type bits, uint64_t h, Group *&group, size_t &slot) {
+    auto tag = tagOf(h);
+    for (size_t g = homeGroup(h, t->group_mask);; g = (g + 1) & t->group_mask) {
+      group = &t->groups[g];
+      bool hasEmpty = false;
+      for (slot = 0; slot < group_size; slot++) {
+        auto slotTag = loadRelaxed(group->tags[slot]);
+        if (slotTag == tag && loadRelaxed(group->keys[slot]) == bits) return true;
+        hasEmpty |= (slotTag == empty_tag);
+      }
+      if (hasEmpty) return false;
+    }
+  }
+
+  // writer-side: the first empty or deleted slot on the probe sequence of h.
+  static void locateFree(Table *t, uint64_t h, Group *&group, size_t &slot) {
+    for (size_t g = homeGroup(h, t->group_mask);; g = (g + 1) & t->group_mask) {
+      group = &t->groups[g];
+      for (slot = 0; slot < group_size; slot++) {
+        if (group->tags[slot] == empty_tag || group->tags[slot] == deleted_tag) return;
+      }
+    }
+  }
+
+  // shared mode: locks the group of the first free slot on the probe sequence of h, the home group is locked already.
+  // False if another writer has the group, then the caller restarts instead of waiting while it holds a lock.
+  static bool lockFree(Table *t, uint64_t h, Group *home, Group *&group, size_t &slot) {
+    for (size_t g = homeGroup(h, t->group_mask);; g = (g + 1) & t->group_mask) {
+      group = &t->groups[g];
+      bool hasFree = false;
+      for (slot = 0; slot < group_size && !hasFree; slot++) hasFree = isFree(loadRelaxed(group->tags[slot]));
+      if (!hasFree) continue;
+      if (group != home && !tryLockGroup(*group)) return false;
+      // the slot may have been taken before the group was locked.
+      for (slot = 0; slot < group_size; slot++) {
+        if (isFree(group->tags[slot])) return true;
+      }
+      if (group != home) endWrite(*group);
+    }
+  }
+
+  static inline bool isFree(uint8_t tag) { return tag == empty_tag || tag == deleted_tag; }
+
+  // the probe of _find, with the epoch pinned.
+  bool lookup(key_bits_type bits, uint64_t h, uint8_t tag, value_type &value) {
+    while (true) {
+      Table *t = table.load(std::memory_order_acquire);
+      for (size_t g = homeGroup(h, t->group_mask);; g = (g + 1) & t->group_mask) {
+        Group &group = t->groups[g];
+        auto version = group.version.load(std::memory_order_acquire);
+        if (version & 1) break;
+
+        bool found = false;
+        bool hasEmpty = false;
+        for (size_t i = 0; i < group_size; i++) {
+          auto slotTag = loadRelaxed(group.tags[i]);
+          hasEmpty |= (slotTag == empty_tag);
+          if (slotTag == tag && loadRelaxed(group.keys[i]) == bits) {
+            value = loadRelaxed(group.values[i]);
+            found = true;
+            break;
+          }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (group.version.load(std::memory_order_relaxed) != version) break;
+        if (found) return true;
+        if (hasEmpty) return false;
+      }
+      // concurrent write to a group on the way: restart from the (maybe new) table.
+      DCDS_SPIN_PAUSE();
+    }
+  }
+
+  // Writers take the index in the shared mode (several writers, which lock groups), or in the exclusive mode (one
+  // writer) while a resize is ongoing. A writer which waits for the exclusive mode keeps new ones from the shared one.
+  bool lockShared() {
+    if (exclusive_pending.load(std::memory_order_relaxed)) return false;
+    auto n = writers.load(std::memory_order_relaxed);
+    do {
+      if (n < 0) return false;
+    } while (!writers.compare_exchange_weak(n, n + 1, std::memory_order_acquire, std::memory_order_relaxed));
+    // e.g., a resize started since the first check.
+    if (exclusive_pending.load(std::memory_order_relaxed)) {
+      unlockShared();
+      return false;
+    }
+    return true;
+  }
+  void unlockShared() {
+    // one of the writers in the shared mode, which do not replace tables.
+    if (has_retired.load(std::memory_order_relaxed) && !reclaiming.exchange(true, std::memory_order_acquire)) {
+      freeRetired();
+      reclaiming.store(false, std::memory_order_release);
+    }
+    writers.fetch_sub(1, std::memory_order_release);
+  }
+
+  void lockExclusive() {
+    exclusive_pending.store(true, std::memory_order_relaxed);
+    int64_t idle = 0;
+    while (!writers.compare_exchange_weak(idle, -1, std::memory_order_acquire, std::memory_order_relaxed)) {
+      idle = 0;
+      DCDS_SPIN_PAUSE();
+    }
+  }
+  void unlockExclusive() {
+    if (has_retired.load(std::memory_order_relaxed)) freeRetired();
+    // the writes during a resize continue it, in the exclusive mode.
+    exclusive_pending.store(next_table != nullptr, std::memory_order_relaxed);
+    writers.store(0, std::memory_order_release);
+  }
+
+  // Insert in the shared mode. nullopt if it needs the exclusive one: the first insert, or the table has to grow.
+  //
+  // The key is looked up before the home group is locked, at the version read before the lookup: a writer of the same
+  // key meanwhile changed the version. Locking first would wait for the group to be fetched before reading it.
+  std::optional<bool> sharedInsert(key_bits_type bits, uint64_t h, value_type value) {
+    if (!lockShared()) return std::nullopt;
+
+    std::optional<bool> ret;
+    Table *t = table.load(std::memory_order_relaxed);
+    while (t != &empty_table) {
+      Group *home = &t->groups[homeGroup(h, t->group_mask)];
+      Group *group;
+      size_t slot;
+      auto version = home->version.load(std::memory_order_acquire);
+      if (version & 1) {
+        DCDS_SPIN_PAUSE();
+        continue;
+      }
+      if (locate(t, bits, h, group, slot)) {
+        ret = false;
+        break;
+      }
+      // the slot is reserved upfront, so that concurrent inserts do not take the table past 3/4 either.
+      if ((t->used.fetch_add(1) + 1) * 4 > capacityOf(t) * 3) {
+        t->used--;
+        break;
+      }
+      if (!lockGroupAt(*home, version)) {
+        t->used--;
+        continue;
+      }
+      if (!lockFree(t, h, home, group, slot)) {
+        t->used--;
+        endWrite(*home);
+        DCDS_SPIN_PAUSE();
+        continue;
+      }
+
+      if (group->tags[slot] == deleted_tag) t->used--;
+      t->live++;
+      storeRelaxed(group->keys[slot], bits);
+      storeRelaxed(group->values[slot], value);
+      storeRelaxed(group->tags[slot], tagOf(h));
+      if (group != home) endWrite(*group);
+      endWrite(*home);
+      ret = true;
+      break;
+    }
+
+    unlockShared();
+    return ret;
+  }
+
+  // Update or remove of the slot of a key in the shared mode, write(table, group, slot) with the group locked. nullopt
+  // if it needs the exclusive mode, otherwise whether the key was found. Locks as sharedInsert.
+  template <typename F>
+  std::optional<bool> sharedWrite(key_bits_type bits, uint64_t h, F write) {
+    if (!lockShared()) return std::nullopt;
+
+    bool found = false;
+    Table *t = table.load(std::memory_order_relaxed);
+    while (t != &empty_table) {
+      Group *home = &t->groups[homeGroup(h, t->group_mask)];
+      Group *group;
+      size_t slot;
+      auto version = home->version.load(std::memory_order_acquire);
+      if (version & 1) {
+        DCDS_SPIN_PAUSE();
+        continue;
+      }
+      found = locate(t, bits, h, group, slot);
+      if (!found) break;
+      if (!lockGroupAt(*home, version)) continue;
+      if (group != home && !tryLockGroup(*group)) {
+        endWrite(*home);
+        DCDS_SPIN_PAUSE();
+        continue;
+      }
+      write(t, *group, slot);
+      if (group != home) endWrite(*group);
+      endWrite(*home);
+      break;
+    }
+
+    unlockShared();
+    return found;
+  }
+
+  // the next table is not visible to readers: no versioning there.
+  static void writeSlot(Table *t, Group *group, size_t slot, key_bits_type bits, value_type value, uint8_t tag,
+                        bool visible) {
+    if (group->tags[slot] == empty_tag) addExclusive(t->used, 1);
+    addExclusive(t->live, 1);
+    if (visible) beginWrite(*group);
+    storeRelaxed(group->keys[slot], bits);
+    storeRelaxed(group->values[slot], value);
+    storeRelaxed(group->tags[slot], tag);
+    if (visible) endWrite(*group);
+  }
+
+  // the group is already copied to the next table, so writes to it also go there.
+  inline bool migrated(const Table *t, const Group *group) const {
+    return static_cast<size_t>(group - t->groups) < migrated_groups;
+  }
+
+  // The next table is `growth` times larger, or as large if most of the used slots are deleted ones.
+  void startResize(Table *t) {
+    auto start = std::chrono::steady_clock::now();
+    auto n_groups = t->group_mask + 1;
+    if (t->live * 2 > t->used) n_groups *= growth;
+    next_table = allocateTable(n_groups);
+    migrated_groups = 0;
+    resize_ns += (std::chrono::steady_clock::now() - start) / std::chrono::nanoseconds(1);
+  }
+
+  // Copies the next n groups, and replaces the current table once all of them are copied.
+  void resizeStep(size_t n) {
+    auto start = std::chrono::steady_clock::now();
+    Table *t = table.load(std::memory_order_relaxed);
+
+    for (auto end = std::min(migrated_groups + n, t->group_mask + 1); migrated_groups < end; migrated_groups++) {
+      auto &src = t->groups[migrated_groups];
+      for (size_t i = 0; i < group_size; i++) {
+        if (src.tags[i] == empty_tag || src.tags[i] == deleted_tag) continue;
+        Group *group;
+        size_t slot;
+        locateFree(next_table, hash(src.keys[i]), group, slot);
+        writeSlot(next_table, group, slot, src.keys[i], src.values[i], src.tags[i], false);
+      }
+    }
+
+    if (migrated_groups == t->group_mask + 1) {
+      table.store(next_table, std::memory_order_release);
+      next_table = nullptr;
+      resizes++;
+
+      // readers still on the old table restart, and reload the table pointer.
+      for (size_t g = 0; g <= t->group_mask; g++) beginWrite(t->groups[g]);
+      retired.emplace_back(t, util::Epoch::current());
+      has_retired.store(true, std::memory_order_relaxed);
+    }
+    resize_ns += (std::chrono::steady_clock::now() - start) / std::chrono::nanoseconds(1);
+  }
+
+  // Frees the replaced tables which no lookup may still read: the epoch advanced twice since their replacement, so
+  // the threads pinned before it are no longer, while the ones pinned since loaded the current table.
+  void freeRetired() {
+    auto now = util::Epoch::tryAdvance();
+    std::erase_if(retired, [now](const std::pair<Table *, uint64_t> &r) {
+      if (!util::Epoch::reclaimable(r.second, now)) return false;
+      freeTable(r.first);
+      return true;
+    });
+    has_retired.store(!retired.empty(), std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<Table *> table;
+  const size_t growth;
+
+  // writers in the shared mode, -1 in the exclusive mode.
+  std::atomic<int64_t> writers{0};
+  std::atomic<bool> exclusive_pending{false};
+
+  // writer-side state of an ongoing resize.
+  Table *next_table = nullptr;
+  size_t migrated_groups = 0;
+
+  // replaced tables which lookups may still read, with the epoch of their replacement, until freeRetired.
+  std::vector<std::pair<Table *, uint64_t>> retired;
+  std::atomic<bool> has_retired{false};
+  std::atomic<bool> reclaiming{false};
+  size_t resizes = 0;
+  uint64_t resize_ns = 0;
+};
+
+}  // namespace dcds::indexes
+
+#endif  // DCDS_OPEN_ADDRESSING_INDEX_HPP
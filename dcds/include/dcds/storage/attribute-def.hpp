@@ -35,11 +35,14 @@ class AttributeDef {
   [[nodiscard]] inline auto getWidth() const { return std::get<2>(col); }
   [[nodiscard]] inline auto getSize() const { return getWidth(); }
   [[nodiscard]] inline auto getColumnDef() const { return col; }
+  [[nodiscard]] inline auto isCold() const { return is_cold; }
 
-  explicit AttributeDef(const std::string &name, valueType dType, size_t width) : col(name, dType, width) {}
+  explicit AttributeDef(const std::string &name, valueType dType, size_t width, bool cold = false)
+      : col(name, dType, width), is_cold(cold) {}
 
  private:
   std::tuple<std::string, valueType, size_t> col;
+  bool is_cold;  // stored in the record's out-of-line cold part.
 };
 
 }  // namespace dcds::storage
@@ -22,11 +22,10 @@
 #ifndef DCDS_TABLE_REGISTRY_HPP
 #define DCDS_TABLE_REGISTRY_HPP
 
-#include <llvm/ADT/DenseMap.h>
-#include <llvm/ADT/StringMap.h>
-
 #include <mutex>
 #include <shared_mutex>
+#include <string>
+#include <unordered_map>
 
 #include "dcds/common/common.hpp"
 #include "dcds/storage/table.hpp"
@@ -47,16 +46,17 @@ class TableRegistry : public dcds::Singleton<TableRegistry> {
   //  void registerTable();
   //  void unregisterTable();
 
-  Table* createTable(const std::string& name, const std::vector<AttributeDef>& columns, bool multi_version = false);
+  Table* createTable(const std::string& name, const std::vector<AttributeDef>& columns,
+                     const record_layout_t& layout = {}, bool multi_version = false);
   void dropTable();  // how to drop if it is a sharedPtr, someone might be holding reference to it?
 
   void clear();
 
  private:
   oneapi::tbb::rw_mutex registry_lk{};
-  llvm::DenseMap<table_id_t, Table*> tables;
+  std::unordered_map<table_id_t, Table*> tables;
 
-  llvm::StringMap<table_id_t> table_name_map;
+  std::unordered_map<std::string, table_id_t> table_name_map;
   alignas(64) std::atomic<table_id_t> table_id_generator;
 
  private:
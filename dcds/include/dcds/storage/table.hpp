@@ -47,6 +47,7 @@ using record_metadata_t = txn::cc::RecordMetaData_SingleVersion;
 
 class Table;
 class SingleVersionRowStore;
+class SingleVersionColumnStore;
 
 class RecordReference {
  public:
@@ -80,10 +81,19 @@ class RecordReference {
 
   friend class Table;
   friend class SingleVersionRowStore;
+  friend class SingleVersionColumnStore;
 };
 
 using record_reference_t = RecordReference;
 
+// How the records of a table are laid out in memory.
+struct record_layout_t {
+  bool sort_columns = true;        // widest first, so that each column is naturally aligned.
+  size_t record_alignment = 0;     // records start at, and are padded to, this; 0 packs them back to back.
+  bool separate_metadata = false;  // data in a parallel array, so that lock words do not share lines with data.
+  bool column_store = false;       // PAX: each group of records keeps every column in its own dense array.
+};
+
 // Row store (single version)
 class Table {
  public:
@@ -95,7 +105,7 @@ class Table {
 
   // we would need index attribute also, otherwise on what attribute the index is created on? rowId?
   Table(table_id_t tableId, std::string table_name, size_t recordSize, std::vector<AttributeDef> attributes,
-        bool is_multi_versioned = false);
+        record_layout_t record_layout = {}, bool is_multi_versioned = false);
   virtual ~Table() = default;
 
   auto name() { return this->table_name; }
@@ -123,6 +133,10 @@ class Table {
   virtual void getNthRecord(txn::Txn *txn, record_metadata_t *rc, void *dst, uint record_offset,
                             uint attribute_idx) = 0;
 
+  // Base address and the distance between consecutive values of a column, for the records of a group starting at rc.
+  // Dense (stride equals the column width) in column stores, so loops over a column can be vectorized.
+  virtual std::pair<void *, size_t> getColumn(record_metadata_t *rc, uint attribute_idx) = 0;
+
   virtual size_t size() = 0;
   virtual size_t capacity() = 0;
   virtual bool empty() = 0;
@@ -138,11 +152,16 @@ class Table {
   const table_id_t table_id;
   const std::string table_name;
 
-  const size_t record_size;
-  const size_t record_size_data_only;
+  const size_t record_size_data_only;  // packed data of all columns, as given to insert.
 
   std::vector<AttributeDef> columns;
 
+  const record_layout_t layout;
+  size_t record_size = 0;  // stride of the records: metadata and the hot part, or a pointer to it, plus padding.
+  size_t data_size = 0;    // hot part: hot columns, and a pointer to the cold part if any.
+  size_t data_stride = 0;  // of the hot parts, when kept in their own (parallel) array.
+  bool identity_layout = false;  // the hot part is laid out as the packed data given to insert.
+
   // Dictionaries if any.
   //  std::unordered_map<column_id_t, void*> dictionary_mappings;
 
@@ -154,6 +173,36 @@ class Table {
   std::vector<uint16_t> column_size_offsets{};
   std::vector<uint16_t> column_size{};
 
+  // Hot/cold split: cold columns are stored in a separately allocated part, which the hot part points to at
+  // cold_ptr_offset. Offsets of cold columns are relative to the cold part.
+  std::vector<uint16_t> column_input_offsets{};  // offsets in the packed data given to insert.
+  std::vector<bool> column_is_cold{};
+  static constexpr size_t cold_ptr_offset = 0;
+  size_t cold_data_size = 0;
+  size_t cold_stride = 0;
+
+  [[nodiscard]] inline bool hasColdPart() const { return cold_data_size != 0; }
+
+  // with separate metadata, the record holds a pointer to its hot part right after the metadata.
+  [[nodiscard]] static inline uintptr_t &dataPointer(record_metadata_t *rc) {
+    return *reinterpret_cast<uintptr_t *>(reinterpret_cast<uintptr_t>(rc) + sizeof(record_metadata_t));
+  }
+
+  [[nodiscard]] inline uintptr_t dataPart(record_metadata_t *rc) const {
+    if (layout.separate_metadata) return dataPointer(rc);
+    return reinterpret_cast<uintptr_t>(rc) + sizeof(record_metadata_t);
+  }
+
+  [[nodiscard]] inline uintptr_t &coldPart(record_metadata_t *rc) const {
+    return *reinterpret_cast<uintptr_t *>(dataPart(rc) + cold_ptr_offset);
+  }
+
+  [[nodiscard]] inline void *columnAddress(record_metadata_t *rc, uint attribute_idx) const {
+    auto base = dataPart(rc);
+    if (unlikely(column_is_cold[attribute_idx])) base = *reinterpret_cast<uintptr_t *>(base + cold_ptr_offset);
+    return reinterpret_cast<void *>(base + column_size_offsets[attribute_idx]);
+  }
+
  protected:
   const bool is_multiversion;
 };
@@ -161,7 +210,7 @@ class Table {
 class SingleVersionRowStore : public Table {
  public:
   SingleVersionRowStore(table_id_t tableId, const std::string &table_name, size_t recordSize,
-                        std::vector<AttributeDef> attributes);
+                        std::vector<AttributeDef> attributes, record_layout_t record_layout = {});
   ~SingleVersionRowStore() override;
 
  public:
@@ -185,6 +234,8 @@ class SingleVersionRowStore : public Table {
 
   void getNthRecord(txn::Txn *txn, record_metadata_t *rc, void *dst, uint record_offset, uint attribute_idx) override;
 
+  std::pair<void *, size_t> getColumn(record_metadata_t *rc, uint attribute_idx) override;
+
   void rollback_update(record_metadata_t *rc, void *prev_value, uint attribute_idx) override;
   void rollback_create(record_metadata_t *rc) override;
 
@@ -202,7 +253,71 @@ class SingleVersionRowStore : public Table {
 
  private:
   void *allocateRecordMemory(size_t n_records = 1);
+  void *allocateMemory(size_t bytes);
   void freeRecordMemory(void *);
+
+  record_metadata_t *initRecords(void *mem, size_t n_records);
+  void copyRecordData(record_metadata_t *rc, const void *data);
+};
+
+// Column store (single version), PAX-style: records inserted together (insertNRecord) form a group, allocated as
+//   [ column pointers | N x (record metadata, row index) | column 0 x N | column 1 x N | ... ]
+// with each column array starting at a cache line. Records are still referenced by their metadata, so locking and
+// getNthRecordReference work as in the row store, and the row index in the record maps it to its column slots.
+class SingleVersionColumnStore : public Table {
+ public:
+  SingleVersionColumnStore(table_id_t tableId, const std::string &table_name, size_t recordSize,
+                           std::vector<AttributeDef> attributes, record_layout_t record_layout = {});
+  ~SingleVersionColumnStore() override;
+
+ public:
+  record_reference_t insertRecord(txn::Txn *txn, const void *data) override;
+  record_reference_t insertNRecord(txn::Txn *txn, size_t N, const void *data) override;
+
+  void updateAttribute(txn::Txn *txn, record_metadata_t *, void *value, uint attribute_idx) override;
+  void updateNthRecord(txn::Txn *txn, record_metadata_t *, void *value, uint record_offset,
+                       uint attribute_idx) override;
+
+  void getData(txn::Txn *txn, record_metadata_t *rc, void *dst, size_t offset, size_t len) override;
+  void getAttribute(txn::Txn *txn, record_metadata_t *rc, void *dst, uint attribute_idx) override;
+
+  record_reference_t getNthRecordReference(txn::Txn *txn, record_metadata_t *rc, uint record_offset) override;
+
+  void getNthRecord(txn::Txn *txn, record_metadata_t *rc, void *dst, uint record_offset, uint attribute_idx) override;
+
+  std::pair<void *, size_t> getColumn(record_metadata_t *rc, uint attribute_idx) override;
+
+  void rollback_update(record_metadata_t *rc, void *prev_value, uint attribute_idx) override;
+  void rollback_create(record_metadata_t *rc) override;
+
+ public:
+  size_t size() override { return n_records; }
+  size_t capacity() override { return n_records; }
+  bool empty() override { return n_records == 0; }
+  void reserve(size_t) override { throw std::runtime_error("unimplemented"); }
+
+ private:
+  std::atomic<size_t> n_records{};
+  size_t header_size = 0;
+
+  dcds::utils::locks::SpinLock allocation_lock;
+  std::set<void *> memory_allocations;
+
+ private:
+  record_metadata_t *allocateGroup(size_t n_records_in_group, const void *data);
+
+  // index of the record in its group, stored right after the metadata.
+  [[nodiscard]] static inline size_t &rowOf(record_metadata_t *rc) {
+    return *reinterpret_cast<size_t *>(reinterpret_cast<uintptr_t>(rc) + sizeof(record_metadata_t));
+  }
+  // the group header: base address of each column array, in attribute order.
+  [[nodiscard]] inline uintptr_t *columnsOf(record_metadata_t *rc) const {
+    return reinterpret_cast<uintptr_t *>(reinterpret_cast<uintptr_t>(rc) - (rowOf(rc) * record_size) - header_size);
+  }
+  [[nodiscard]] inline void *columnAddress(record_metadata_t *rc, uint attribute_idx, size_t record_offset = 0) const {
+    return reinterpret_cast<void *>(columnsOf(rc)[attribute_idx] +
+                                    ((rowOf(rc) + record_offset) * column_size[attribute_idx]));
+  }
 };
 
 }  // namespace dcds::storage
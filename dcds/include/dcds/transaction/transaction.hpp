@@ -26,9 +26,10 @@
 
 #include "dcds/common/common.hpp"
 #include "dcds/common/types.hpp"
+#include "dcds/transaction/concurrency-control/record-metadata.hpp"
 #include "dcds/transaction/txn-log.hpp"
 #include "dcds/transaction/txn-utils.hpp"
-#include "llvm/ADT/SmallPtrSet.h"
+#include "dcds/util/small-set.hpp"
 
 namespace dcds::txn {
 
@@ -63,8 +64,10 @@ class Txn {
   TXN_STATUS status;
 
  public:
-  llvm::SmallPtrSet<uintptr_t, 10> exclusive_locks;
-  llvm::SmallPtrSet<uintptr_t, 10> shared_locks;
+  util::SmallSet<uintptr_t, 10> exclusive_locks;
+  util::SmallSet<uintptr_t, 10> shared_locks;
+  // exclusive locks of index keys (IndexBase::keyLockStripe), not of records.
+  util::SmallSet<cc::RecordMetaData*, 4> key_locks;
 
  public:
   void rollback();
@@ -22,20 +22,26 @@
 #ifndef DCDS_TXN_LOG_HPP
 #define DCDS_TXN_LOG_HPP
 
+#include <cstring>
 #include <deque>
 #include <forward_list>
 
 #include "dcds/common/common.hpp"
 
+namespace dcds::indexes {
+class IndexBase;
+}
+
 namespace dcds::txn {
 
-enum class TXN_LOG_TYPE { INSERT, READ, UPDATE, DELETE };
+enum class TXN_LOG_TYPE { INSERT, READ, UPDATE, DELETE, INDEX_INSERT, INDEX_REMOVE, INDEX_DEFERRED_INSERT };
 
 // TODO: use a allocator template!
 
 class TransactionLogItem {
  public:
   explicit TransactionLogItem(TXN_LOG_TYPE _type, uintptr_t _record) : type(_type), record(_record) {}
+  virtual ~TransactionLogItem() = default;
 
  protected:
   TXN_LOG_TYPE type;
@@ -52,6 +58,8 @@ class UpdateLog : public TransactionLogItem {
         prev_value(value),
         len(_len) {}
 
+  ~UpdateLog() override { free(prev_value); }
+
  private:
   column_id_t attribute_index;
   void* prev_value;
@@ -69,6 +77,34 @@ class InsertLog : public TransactionLogItem {
   friend class TransactionLog;
 };
 
+// Index entries, for the index (or the key) itself, the record is the value. They are all applied when the transaction
+// commits, in the order they were logged (a key may be removed and inserted again in one transaction), so that others
+// never find an entry of a transaction which may still roll back. Until then, the transaction finds its own entries
+// through findIndexEntry, and the key is locked (index_lock_key), so the entries cannot conflict at commit.
+//  INDEX_INSERT: checked against the index and the earlier entries when logged, as it must fail on an existing key.
+//  INDEX_REMOVE: the entry of the key, if any, is removed.
+//  INDEX_DEFERRED_INSERT: inserts which cannot fail (non-unique secondary indexes), so they are not checked.
+class IndexLog : public TransactionLogItem {
+ public:
+  inline IndexLog(TXN_LOG_TYPE _type, indexes::IndexBase* _index, const void* _key, size_t _key_len, uintptr_t _value)
+      : TransactionLogItem(_type, _value), index(_index), key(malloc(_key_len)), key_len(_key_len) {
+    memcpy(key, _key, _key_len);
+  }
+
+  ~IndexLog() override { free(key); }
+
+  [[nodiscard]] inline bool isKey(const indexes::IndexBase* _index, const void* _key, size_t _key_len) const {
+    return index == _index && key_len == _key_len && memcmp(key, _key, _key_len) == 0;
+  }
+
+ private:
+  indexes::IndexBase* index;
+  void* key;
+  size_t key_len;
+
+  friend class TransactionLog;
+};
+
 // class DeleteLog :  public TransactionLogItem{
 //  public:
 //   explicit DeleteLog(): TransactionLogItem(TXN_LOG_TYPE::DELETE){
@@ -92,7 +128,17 @@ class TransactionLog {
 
   void addUpdateLog(uintptr_t record, column_id_t attribute_idx, void* prev_value, size_t len);
   void addInsertLog(uintptr_t record);
+  void addIndexInsertLog(indexes::IndexBase* index, const void* key, size_t key_len, uintptr_t value);
+  void addIndexRemoveLog(indexes::IndexBase* index, const void* key, size_t key_len);
+  void addIndexDeferredInsertLog(indexes::IndexBase* index, const void* key, size_t key_len, uintptr_t value);
+
+  // The latest entry of this transaction for the key, if any: sets present (and value, if present) and returns true.
+  // Returns false if the transaction did not write the key, then the index has the entry.
+  bool findIndexEntry(const indexes::IndexBase* index, const void* key, size_t key_len, bool& present,
+                      uintptr_t& value) const;
+  [[nodiscard]] inline bool hasIndexEntries() const { return n_index_entries != 0; }
 
+  void commit();
   void rollback();
 
   ~TransactionLog() {
@@ -104,6 +150,8 @@ class TransactionLog {
  private:
   //  std::deque<TransactionLogItem*> log;
   std::forward_list<TransactionLogItem*> log;
+  // so that lookups of transactions without index writes skip the log.
+  size_t n_index_entries = 0;
 };
 
 }  // namespace dcds::txn
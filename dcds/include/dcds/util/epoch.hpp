@@ -0,0 +1,93 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+#ifndef DCDS_EPOCH_HPP
+#define DCDS_EPOCH_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace dcds::util {
+
+// Epoch-based reclamation of memory which readers access without locks, e.g., replaced index tables or the records of
+// rolled-back inserts. A thread pins the current epoch while it may hold such pointers, in a slot of its own, alone on
+// its cache line: pinning and unpinning only write memory of the thread. Memory which is unlinked (unreachable for
+// threads which pin from then on) is retired at the current epoch, and freed once the epoch advanced twice since. The
+// epoch only advances when every pinned thread is on the current one, i.e., a thread pinned at the retire epoch (or
+// before) is no longer pinned by then.
+class Epoch {
+ public:
+  struct alignas(64) Slot {
+    // the epoch the thread pinned, 0 if none.
+    std::atomic<uint64_t> pinned{0};
+    std::atomic<bool> in_use{false};
+    Slot *next = nullptr;
+  };
+
+  // The slot of the calling thread, taken on its first call and handed on to a later thread when it exits.
+  static Slot &slot();
+
+  // Pins the current epoch, unless the thread is pinned already (nested sections keep the outermost epoch). Returns
+  // whether it pinned, i.e., whether the matching unpin is due.
+  static inline bool pin(Slot &s) {
+    if (s.pinned.load(std::memory_order_relaxed) != 0) return false;
+    s.pinned.store(global_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    // the pin is visible before the thread reads any pointer, and the reclaimer sees it before it advances the epoch.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return true;
+  }
+  static inline void unpin(Slot &s) { s.pinned.store(0, std::memory_order_release); }
+
+  class Guard {
+   public:
+    Guard() : s(slot()), pinned(pin(s)) {}
+    ~Guard() {
+      if (pinned) unpin(s);
+    }
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+
+   private:
+    Slot &s;
+    const bool pinned;
+  };
+
+  // The epoch to retire memory at, once it is unlinked.
+  static inline uint64_t current() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return global_epoch.load(std::memory_order_relaxed);
+  }
+  static inline bool reclaimable(uint64_t retired_at, uint64_t now) { return now >= retired_at + 2; }
+
+  // Advances the epoch (at most twice) while every pinned thread is on the current one, and returns the epoch after.
+  static uint64_t tryAdvance();
+
+  // Frees ptr with the deleter once no thread may still hold it. Retired memory is kept per thread, and freed in
+  // batches by later retires of the thread; what is left when the thread exits goes to the next thread's batch.
+  static void retire(void *ptr, void (*deleter)(void *));
+
+ private:
+  static std::atomic<uint64_t> global_epoch;
+};
+
+}  // namespace dcds::util
+
+#endif  // DCDS_EPOCH_HPP
@@ -0,0 +1,78 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+#ifndef DCDS_SMALL_SET_HPP
+#define DCDS_SMALL_SET_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <unordered_set>
+
+namespace dcds::util {
+
+// Set of a few small values, e.g., the locks of a transaction: searched linearly in place up to N of them, in a hash
+// set beyond, without allocating for small sets.
+template <typename T, size_t N>
+class SmallSet {
+ public:
+  [[nodiscard]] bool contains(T value) const {
+    if (!large.empty()) return large.contains(value);
+    return std::find(small.begin(), small.begin() + n_small, value) != small.begin() + n_small;
+  }
+
+  bool insert(T value) {
+    if (!large.empty()) return large.insert(value).second;
+    if (contains(value)) return false;
+    if (n_small < N) {
+      small[n_small++] = value;
+      return true;
+    }
+    large.insert(small.begin(), small.end());
+    n_small = 0;
+    large.insert(value);
+    return true;
+  }
+
+  bool erase(T value) {
+    if (!large.empty()) return large.erase(value);
+    auto end = small.begin() + n_small;
+    auto it = std::find(small.begin(), end, value);
+    if (it == end) return false;
+    *it = small[--n_small];
+    return true;
+  }
+
+  template <typename F>
+  void forEach(F f) const {
+    for (size_t i = 0; i < n_small; i++) f(small[i]);
+    for (auto value : large) f(value);
+  }
+
+ private:
+  std::array<T, N> small;
+  size_t n_small = 0;
+  std::unordered_set<T> large;
+};
+
+}  // namespace dcds::util
+
+#endif  // DCDS_SMALL_SET_HPP
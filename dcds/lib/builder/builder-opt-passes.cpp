@@ -23,73 +23,121 @@
 
 #include <set>
 
+#include "dcds/builder/expressions/constant-expressions.hpp"
 #include "dcds/builder/statement.hpp"
+#include "dcds/storage/table.hpp"
 
 using namespace dcds;
 
+static constexpr bool print_debug_log = false;
+
+static const std::string& indexedSourceAttribute(const Statement* stmt) {
+  switch (stmt->stType) {
+    case statementType::READ_INDEXED:
+      return reinterpret_cast<const ReadIndexedStatement*>(stmt)->source_attr;
+    case statementType::INSERT_INDEXED:
+      return reinterpret_cast<const InsertIndexedStatement*>(stmt)->source_attr;
+    case statementType::REMOVE_INDEXED:
+      return reinterpret_cast<const RemoveIndexedStatement*>(stmt)->source_attr;
+    case statementType::UPDATE_INDEXED:
+      return reinterpret_cast<const UpdateIndexedStatement*>(stmt)->destination_attr;
+    case statementType::RANGE_SCAN:
+      return reinterpret_cast<const RangeScanStatement*>(stmt)->source_attr;
+    default:
+      throw dcds::exceptions::dcds_dynamic_exception("Not an indexed statement");
+  }
+}
+
+// statements which only exist for the given attribute: its updates and the locks on it.
+static bool isAttributeStatement(const Statement* stmt, const std::string& type_name,
+                                 const std::string& attribute_name) {
+  if (stmt->stType == statementType::UPDATE) {
+    return reinterpret_cast<const UpdateStatement*>(stmt)->destination_attr == attribute_name;
+  }
+  if (stmt->stType == statementType::CC_LOCK) {
+    auto lockStmt = reinterpret_cast<const LockStatement2*>(stmt);
+    return lockStmt->type_name == type_name && lockStmt->attribute == attribute_name;
+  }
+  return false;
+}
+
 void BuilderOptPasses::opt_pass_remove_unused_functions_from_composite_types(bool recursive) {
   if (builder->registered_subtypes.empty()) return;
 
-  LOG(INFO) << "PASS: opt_pass_remove_unused_functions_from_composite_types: " << builder->getName();
+  LOG_IF(INFO, print_debug_log) << "PASS: opt_pass_remove_unused_functions_from_composite_types: "
+                                << builder->getName();
 
+  // a type can be registered in more than one builder, and its functions be called from any type in the tree, so
+  // the usage is collected over the whole tree and not only from the direct parent.
   std::map<std::string, std::set<std::string>> type_fn_usage;
-  for (auto& t : builder->registered_subtypes) {
-    type_fn_usage.emplace(t.first, std::set<std::string>{});
-  }
+  for_each_type(builder, [&](const std::shared_ptr<Builder>& type) {
+    type_fn_usage.emplace(type->getName(), std::set<std::string>{});
+  });
 
-  builder->for_each_function([&](const std::shared_ptr<FunctionBuilder>& fb) {
-    fb->entryPoint->for_each_statement([&](const Statement* stmt) {
-      switch (stmt->stType) {
-        case statementType::METHOD_CALL: {
-          auto methodCall = reinterpret_cast<const MethodCallStatement*>(stmt);
-          auto typeName = methodCall->function_instance->builder->getName();
-          CHECK(type_fn_usage.contains(typeName))
-              << "Method call to an unregistered type in builder? builder: " << builder->getName()
-              << ", unregistered_type: " << methodCall->function_instance->builder->getName();
-          type_fn_usage[typeName].insert(methodCall->function_instance->getName());
-          break;
+  for_each_type(builder, [&](const std::shared_ptr<Builder>& type) {
+    type->for_each_function([&](const std::shared_ptr<FunctionBuilder>& fb) {
+      fb->entryPoint->for_each_statement([&](const Statement* stmt) {
+        switch (stmt->stType) {
+          case statementType::METHOD_CALL: {
+            auto methodCall = reinterpret_cast<const MethodCallStatement*>(stmt);
+            auto typeName = methodCall->function_instance->builder->getName();
+            CHECK(type_fn_usage.contains(typeName))
+                << "Method call to an unregistered type in builder? builder: " << type->getName()
+                << ", unregistered_type: " << methodCall->function_instance->builder->getName();
+            type_fn_usage[typeName].insert(methodCall->function_instance->getName());
+            break;
+          }
+          case statementType::CONDITIONAL_STATEMENT:
+          case statementType::FOR_LOOP:
+          case statementType::WHILE_LOOP:
+          case statementType::DO_WHILE_LOOP:
+          case statementType::RANGE_SCAN:
+          case statementType::CREATE:  // insert means constructor, but that is not exposed as function.
+          case statementType::READ:
+          case statementType::UPDATE:
+          case statementType::YIELD:
+          case statementType::LOG_STRING:
+          case statementType::TEMP_VAR_ASSIGN:
+          case statementType::READ_INDEXED:
+          case statementType::INSERT_INDEXED:
+          case statementType::REMOVE_INDEXED:
+          case statementType::UPDATE_INDEXED:
+            break;
+
+          case statementType::CC_LOCK:
+            //        case statementType::CC_LOCK_SHARED:
+            //        case statementType::CC_LOCK_EXCLUSIVE:
+            break;
         }
-        case statementType::CONDITIONAL_STATEMENT:
-        case statementType::CREATE:  // insert means constructor, but that is not exposed as function.
-        case statementType::READ:
-        case statementType::UPDATE:
-        case statementType::YIELD:
-        case statementType::LOG_STRING:
-        case statementType::TEMP_VAR_ASSIGN:
-        case statementType::READ_INDEXED:
-        case statementType::INSERT_INDEXED:
-          break;
-
-        case statementType::CC_LOCK:
-          //        case statementType::CC_LOCK_SHARED:
-          //        case statementType::CC_LOCK_EXCLUSIVE:
-          break;
-      }
+      });
     });
   });
 
-  LOG(INFO) << "functions used in " << builder->getName();
-  for (auto& [type, fUsage] : type_fn_usage) {
-    LOG(INFO) << "Type: " << type;
-    for (auto& fn : fUsage) {
-      LOG(INFO) << "\t" << fn;
+  if (print_debug_log) {
+    LOG(INFO) << "functions used in " << builder->getName();
+    for (auto& [type, fUsage] : type_fn_usage) {
+      LOG(INFO) << "Type: " << type;
+      for (auto& fn : fUsage) {
+        LOG(INFO) << "\t" << fn;
+      }
     }
+    LOG(INFO) << "Cleaning unused functions now.";
   }
-  LOG(INFO) << "Cleaning unused functions now.";
 
   // FIXME: BIG TODO: clone the builder before cleanup. and also freeze/finalize the builder.
 
-  for (auto& t : builder->registered_subtypes) {
-    t.second->dropAllFunctionsExceptList(type_fn_usage[t.first]);
-  }
-
   if (recursive) {
+    for_each_type(builder, [&](const std::shared_ptr<Builder>& type) {
+      // the functions of the root type are the exposed ones.
+      if (type != builder) type->dropAllFunctionsExceptList(type_fn_usage[type->getName()]);
+    });
+  } else {
     for (auto& t : builder->registered_subtypes) {
-      BuilderOptPasses ty(t.second);
-      ty.opt_pass_remove_unused_functions_from_composite_types(true);
+      t.second->dropAllFunctionsExceptList(type_fn_usage[t.first]);
     }
   }
 }
+
 BuilderOptPasses::AttributeStats::AttributeStats(const std::shared_ptr<Builder>& _builder, bool log_stats)
     : ds_name(_builder->getName()) {
   if (_builder->attributes.empty()) return;
@@ -120,15 +168,30 @@ BuilderOptPasses::AttributeStats::AttributeStats(const std::shared_ptr<Builder>&
           break;
         }
 
+        case statementType::READ_INDEXED:
+        case statementType::INSERT_INDEXED:
+        case statementType::REMOVE_INDEXED:
+        case statementType::UPDATE_INDEXED:
+        case statementType::RANGE_SCAN: {  // the body is visited by for_each_statement.
+          // all of them read the list's base record from the attribute, the list itself is updated in place.
+          auto action_attribute = indexedSourceAttribute(stmt);
+          assert(stats.contains(action_attribute));
+          stats[action_attribute].n_usage++;
+          stats[action_attribute].n_read++;
+          stats[action_attribute].readBy_functions.insert(fb->getName());
+          break;
+        }
+
         case statementType::CREATE:  // insert means constructor, but that is not exposed as function.
         // ??
         case statementType::METHOD_CALL:
         case statementType::CONDITIONAL_STATEMENT:
+        case statementType::FOR_LOOP:  // bodies are visited by for_each_statement.
+        case statementType::WHILE_LOOP:
+        case statementType::DO_WHILE_LOOP:
         case statementType::YIELD:
         case statementType::LOG_STRING:
         case statementType::TEMP_VAR_ASSIGN:
-        case statementType::READ_INDEXED:
-        case statementType::INSERT_INDEXED:
           break;
         case statementType::CC_LOCK:
           //        case statementType::CC_LOCK_SHARED:
@@ -156,11 +219,13 @@ BuilderOptPasses::AttributeStats::AttributeStats(const std::shared_ptr<Builder>&
 }
 
 void BuilderOptPasses::opt_pass_removeUnusedAttributes() {
-  LOG(INFO) << "BuilderOptPasses::opt_pass_removeUnusedAttributes: " << builder->getName();
-  AttributeStats attribute_stats(builder, true);
+  LOG_IF(INFO, print_debug_log) << "BuilderOptPasses::opt_pass_removeUnusedAttributes: " << builder->getName();
+  AttributeStats attribute_stats(builder, print_debug_log);
 
   // DONE: 1- remove the attribute which is absolutely not used.
-  // TODO: 2- remove writeOnly attributes but be careful as removing statement may cause domino effect.
+  // DONE: 2- remove writeOnly attributes, together with their updates and locks. For now, only when it does not
+  //  empty a conditional or loop block, so that there is no domino effect (see the bottom-up notes below).
+  // NOTE: old notes:
   //  also, if it is composite, make sure it is correct. as set_next is called on LL from outside, it shows 'next'
   //  write_only, but you cannot remove it semantically. or can you?
   //  i think we can because we dont have pop function, so what matters is the head actually, the other next does not.
@@ -187,130 +252,487 @@ void BuilderOptPasses::opt_pass_removeUnusedAttributes() {
 
   // what about read-only attributes, convert them to constant/non-attribute?
 
+  // collect first, as removing an attribute invalidates the iteration over the attribute map.
+  std::vector<std::string> unread_attributes;
   for (auto& [name, attr] : builder->attributes) {
-    const auto& stats = attribute_stats.get(name);
-    if (stats.n_usage == 0) {
-      // remove absolutely unused attributes.
-      builder->removeAttribute(name);
-    }
+    if (pinned_attributes.contains(builder->getName() + "." + name)) continue;
+    if (attribute_stats.get(name).n_read == 0) unread_attributes.push_back(name);
+  }
 
-    // FIXME: for now, just remove unused attributes only
-
-    //    if (stats.n_read == 0 && stats.n_write > 0) {
-    //      // write only attribute.
-    //      // remove attribute.
-    //      // remove any update calls to it.
-    //      // see it causes a function to be removed. if yes, then return it.
-    //      // the callee should do the statement thing recursively
-    //
-    //      BuilderOptPasses::removeWriteOnlyAttribute(builder, name, stats);
-    //    }
+  for (auto& name : unread_attributes) {
+    // a type keeps at least one attribute, so that it still has a storage to create its records in.
+    if (builder->attributes.size() == 1) break;
+    if (removeWriteOnlyAttribute(builder, name, attribute_stats.get(name))) n_removed_attributes++;
   }
 }
 
 void BuilderOptPasses::setParent(const std::shared_ptr<Builder>& currentBuilder) {
   for (auto& t : currentBuilder->registered_subtypes) {
-    t.second->parentType = t.second;
+    t.second->parentType = currentBuilder;
     setParent(t.second);
   }
 }
 
-bool BuilderOptPasses::removeAttributeStatements(const std::shared_ptr<StatementBuilder>& sb,
-                                                 const std::string& attribute_name) {
-  return false;
-  // Scratchpad, TODO: implement & fix.
-  //
-  //  // returns if the block is empty now.
-  //
-  //  // Caveat: if the update is actually linked to previous insert, then insert is a dangling one now.
-  //
-  //  std::deque<std::shared_ptr<Statement>> removedStatements;
-  //
-  //  std::erase_if(sb->statements, [&](const std::shared_ptr<Statement>& s) {
-  //    if (s->stType == statementType::UPDATE &&
-  //        std::static_pointer_cast<UpdateStatement>(s)->destination_attr == attribute_name) {
-  //      // blindly remove it? or save it like pos, or
-  //
-  //      removedStatements.emplace_back(s);
-  //      return true;
-  //    } else {
-  //      return false;
-  //    }
-  //  });
-  //
-  //  for (const auto& s : sb->statements) {
-  //    if (s->stType == statementType::CONDITIONAL_STATEMENT) {
-  //      auto conditional = std::static_pointer_cast<ConditionalStatement>(s);
-  //      // now there are two returns here!
-  //      auto toRemoveIfBlock = removeAttributeStatements(conditional->ifBlock, attribute_name);
-  //      auto toRemoveElseBlock = removeAttributeStatements(conditional->elseBLock, attribute_name);
-  //      LOG(INFO) << "toRemoveIfBlock: " << toRemoveIfBlock;
-  //      LOG(INFO) << "toRemoveElseBlock: " << toRemoveElseBlock;
-  //
-  //      // removing else block does not matter, as it will not create the else branch essentially.
-  //      // or for that matter, empty if would be optimized away, no?
-  //
-  //      // what about leading to an empty funtion?
-  //    }
-  //  }
-  //
-  //  LOG(INFO) << "SB SIZE: " << sb->statements.size();
-  //
-  //  // e.g.: for set_next, there is only one statement remaining, that is, returnVoid. so this function can be
-  //  removed.
-  //  // but do we want to? clang would do it for us or no?
-  //
-  //  // what about finding dangling records?
-  //
-  //  return sb->statements.empty();  // return true if block is empty now.
+void BuilderOptPasses::for_each_type(const std::shared_ptr<Builder>& root,
+                                     const std::function<void(const std::shared_ptr<Builder>&)>& func) {
+  // post-order, so that sub-types are visited before the types using them, and each type once.
+  std::set<std::string> visited;
+  std::function<void(const std::shared_ptr<Builder>&)> visit = [&](const std::shared_ptr<Builder>& type) {
+    if (!visited.insert(type->getName()).second) return;
+    for (auto& t : type->registered_subtypes) visit(t.second);
+    func(type);
+  };
+  visit(root);
+}
+
+size_t BuilderOptPasses::countRemainingStatements(const std::shared_ptr<StatementBuilder>& sb,
+                                                  const std::string& type_name, const std::string& attribute_name,
+                                                  bool& leaves_empty_block) {
+  if (!sb) return 0;
+  size_t remaining = 0;
+  for (const auto* stmt : sb->statements) {
+    if (isAttributeStatement(stmt, type_name, attribute_name)) continue;
+    remaining++;
+
+    if (stmt->stType == statementType::CONDITIONAL_STATEMENT) {
+      auto conditional = reinterpret_cast<const ConditionalStatement*>(stmt);
+      // an empty else-block is fine, the if-block is not.
+      if (countRemainingStatements(conditional->ifBlock, type_name, attribute_name, leaves_empty_block) == 0) {
+        leaves_empty_block = true;
+      }
+      countRemainingStatements(conditional->elseBLock, type_name, attribute_name, leaves_empty_block);
+    } else if (stmt->stType == statementType::FOR_LOOP || stmt->stType == statementType::WHILE_LOOP ||
+               stmt->stType == statementType::DO_WHILE_LOOP || stmt->stType == statementType::RANGE_SCAN) {
+      auto loop = reinterpret_cast<const LoopStatement*>(stmt);
+      if (countRemainingStatements(loop->body, type_name, attribute_name, leaves_empty_block) == 0) {
+        leaves_empty_block = true;
+      }
+    }
+  }
+  return remaining;
+}
+
+size_t BuilderOptPasses::removeAttributeStatements(const std::shared_ptr<StatementBuilder>& sb,
+                                                   const std::string& type_name, const std::string& attribute_name) {
+  if (!sb) return 0;
+  // NOTE: removed statements are not freed, the same as everywhere else statements are dropped.
+  // Caveat: if the update is actually linked to previous insert, then insert is a dangling one now.
+  size_t removed = std::erase_if(sb->statements, [&](const Statement* stmt) {
+    return isAttributeStatement(stmt, type_name, attribute_name);
+  });
+
+  for (auto* stmt : sb->statements) {
+    if (stmt->stType == statementType::CONDITIONAL_STATEMENT) {
+      auto conditional = reinterpret_cast<ConditionalStatement*>(stmt);
+      removed += removeAttributeStatements(conditional->ifBlock, type_name, attribute_name);
+      removed += removeAttributeStatements(conditional->elseBLock, type_name, attribute_name);
+    } else if (stmt->stType == statementType::FOR_LOOP || stmt->stType == statementType::WHILE_LOOP ||
+               stmt->stType == statementType::DO_WHILE_LOOP || stmt->stType == statementType::RANGE_SCAN) {
+      removed += removeAttributeStatements(reinterpret_cast<LoopStatement*>(stmt)->body, type_name, attribute_name);
+    }
+  }
+  return removed;
 }
 
-void BuilderOptPasses::removeWriteOnlyAttribute(std::shared_ptr<Builder>& currentBuilder,
+bool BuilderOptPasses::removeWriteOnlyAttribute(const std::shared_ptr<Builder>& currentBuilder,
                                                 const std::string& attribute_name,
                                                 const BuilderOptPasses::attribute_stat_t& stats) {
-  // Scratchpad, TODO: implement & fix.
-  /*
-  assert(stats.n_usage > 0);
-  assert(stats.n_read == 0);
-  assert(stats.n_write > 0);
-
-  LOG(INFO) << "removeAttribute: " << attribute_name;
-  // 1- remove the attribute
-  assert(currentBuilder->hasAttribute(attribute_name));
+  CHECK_EQ(stats.n_read, 0) << "Attribute is read: " << attribute_name;
+  CHECK(currentBuilder->hasAttribute(attribute_name)) << "Attribute does not exists: " << attribute_name;
+  const auto& type_name = currentBuilder->getName();
+
+  // dry-run first, as codegen expects non-empty if-blocks and loop bodies.
+  // TODO: remove the emptied blocks bottom-up instead, and then the emptied functions and the calls to them.
+  bool leaves_empty_block = false;
+  currentBuilder->for_each_function([&](const std::shared_ptr<FunctionBuilder>& fb) {
+    countRemainingStatements(fb->entryPoint, type_name, attribute_name, leaves_empty_block);
+  });
+  if (leaves_empty_block) {
+    LOG_IF(INFO, print_debug_log) << "Keeping write-only attribute '" << attribute_name << "' of '" << type_name
+                                  << "' as removing its statements empties a block";
+    return false;
+  }
+
+  size_t removed = 0;
+  currentBuilder->for_each_function([&](const std::shared_ptr<FunctionBuilder>& fb) {
+    removed += removeAttributeStatements(fb->entryPoint, type_name, attribute_name);
+  });
+  LOG_IF(INFO, print_debug_log) << "Removed " << removed << " statements of attribute '" << attribute_name << "'";
+
+  // the record layout is derived from the remaining attributes when the type is built.
   currentBuilder->removeAttribute(attribute_name);
+  return true;
+}
 
-  // 2- remove any method calls
+// cache lines spanned by [offset, offset + width) of a record part, assuming the part starts at a line boundary.
+static void touchCacheLines(std::set<size_t>& lines, size_t offset, size_t width) {
+  for (auto line = offset / CACHE_LINE_SIZE; line <= (offset + std::max<size_t>(width, 1) - 1) / CACHE_LINE_SIZE;
+       line++) {
+    lines.insert(line);
+  }
+}
 
-  for (auto& fName : stats.writeBy_functions) {
-    auto fn = currentBuilder->getFunction(fName);  // this function uses it.
+void BuilderOptPasses::opt_pass_splitHotColdAttributes(const std::map<std::string, size_t>& function_weights) {
+  LOG_IF(INFO, print_debug_log) << "BuilderOptPasses::opt_pass_splitHotColdAttributes: " << builder->getName();
+  footprint_report.clear();
+  if (builder->attributes.size() < 2) return;
+
+  bool already_split = std::any_of(builder->attributes.begin(), builder->attributes.end(),
+                                   [](const auto& a) { return a.second->is_cold; });
+  AttributeStats attribute_stats(builder, print_debug_log);
+
+  auto weight = [&](const std::string& fn_name) {
+    auto w = function_weights.find(fn_name);
+    return w == function_weights.end() ? size_t{1} : w->second;
+  };
+
+  // access frequency of each attribute, and the attributes each function touches.
+  std::map<std::string, size_t> frequency;
+  std::map<std::string, std::set<std::string>> fn_attributes;
+  size_t max_frequency = 0;
+  for (auto& [name, st] : attribute_stats.getAll()) {
+    std::set<std::string> users = st.readBy_functions;
+    users.insert(st.writeBy_functions.begin(), st.writeBy_functions.end());
+    size_t f = 0;
+    for (auto& fn : users) {
+      f += weight(fn);
+      fn_attributes[fn].insert(name);
+    }
+    frequency.emplace(name, f);
+    max_frequency = std::max(max_frequency, f);
+  }
 
-    auto x = removeAttributeStatements(fn->entryPoint, attribute_name);
-    LOG(INFO) << "X is " << x;
-    // then what? is x is true, then we should remove this function as this is empty essentially?
+  // footprints with the current layout, and with everything hot; the same column order as storage::Table.
+  std::vector<std::shared_ptr<Attribute>> column_order;
+  for (auto& [name, attr] : builder->attributes) column_order.push_back(attr);
+  if (builder->getLayoutFlags() & std::to_underlying(hints::LayoutHints::ALIGNED_COLUMNS)) {
+    std::stable_sort(column_order.begin(), column_order.end(),
+                     [](const auto& a, const auto& b) { return valueTypeSize(a->type) > valueTypeSize(b->type); });
   }
 
-  currentBuilder->for_each_function([&](const std::shared_ptr<FunctionBuilder>& fb) {
-    fb->entryPoint->for_each_statement([&](const std::shared_ptr<Statement>& stmt) {
-      if (stmt->stType == statementType::UPDATE &&
-          std::static_pointer_cast<UpdateStatement>(stmt)->destination_attr == attribute_name) {
+  auto footprint = [&](const std::set<std::string>& touched, bool with_split) {
+    bool has_cold = with_split && std::any_of(column_order.begin(), column_order.end(),
+                                              [](const auto& attr) { return attr->is_cold; });
+    std::set<size_t> hot_lines;
+    std::set<size_t> cold_lines;
+    touchCacheLines(hot_lines, 0, sizeof(storage::record_metadata_t));  // locks.
+    // the pointer to the cold part comes first.
+    size_t hot_offset = sizeof(storage::record_metadata_t) + (has_cold ? sizeof(uintptr_t) : 0);
+    size_t cold_offset = 0;
+    for (auto& attr : column_order) {
+      auto width = valueTypeSize(attr->type);
+      bool cold = with_split && attr->is_cold;
+      auto& offset = cold ? cold_offset : hot_offset;
+      if (touched.contains(attr->name)) touchCacheLines(cold ? cold_lines : hot_lines, offset, width);
+      offset += width;
+    }
+    if (!cold_lines.empty()) touchCacheLines(hot_lines, sizeof(storage::record_metadata_t), sizeof(uintptr_t));
+    return (hot_lines.size() + cold_lines.size()) * CACHE_LINE_SIZE;
+  };
+
+  if (!already_split && max_frequency > 0) {
+    size_t cold_bytes = 0;
+    std::vector<std::string> cold_attributes;
+    for (auto& [name, attr] : builder->attributes) {
+      if (pinned_attributes.contains(builder->getName() + "." + name)) continue;
+      if (frequency[name] * cold_access_ratio <= max_frequency) {
+        cold_attributes.push_back(name);
+        cold_bytes += valueTypeSize(attr->type);
       }
-    });
+    }
+
+    // the hot part gets a pointer to the cold one, so splitting off less than that does not shrink it.
+    if (cold_bytes > sizeof(uintptr_t)) {
+      for (auto& name : cold_attributes) {
+        LOG_IF(INFO, print_debug_log) << "cold attribute: " << builder->getName() << "." << name
+                                      << " | access frequency: " << frequency[name] << "/" << max_frequency;
+        builder->getAttribute(name)->is_cold = true;
+      }
+    }
+  }
+
+  for (auto& [fn, touched] : fn_attributes) {
+    op_footprint_t fp{footprint(touched, false), footprint(touched, true)};
+    LOG_IF(INFO, print_debug_log) << "\t" << fn << " | bytes touched: " << fp.bytes_before << " -> "
+                                  << fp.bytes_after;
+    footprint_report.emplace(fn, fp);
+  }
+}
+
+void BuilderOptPasses::invalidateVariable(available_values_t& available, const std::string& var_name) {
+  std::erase_if(available, [&](const auto& item) { return item.second.depends_on == var_name; });
+}
+
+bool BuilderOptPasses::mayUpdateRecords(const std::shared_ptr<StatementBuilder>& sb,
+                                        std::set<const FunctionBuilder*>& visited) {
+  if (!sb) return false;
+  for (const auto* stmt : sb->statements) {
+    switch (stmt->stType) {
+      case statementType::UPDATE:
+      case statementType::INSERT_INDEXED:
+      case statementType::REMOVE_INDEXED:
+      case statementType::UPDATE_INDEXED:
+        return true;
+      case statementType::METHOD_CALL: {
+        auto methodCall = reinterpret_cast<const MethodCallStatement*>(stmt);
+        // recursive calls are covered by the first visit.
+        if (visited.insert(methodCall->function_instance.get()).second &&
+            mayUpdateRecords(methodCall->function_instance->entryPoint, visited)) {
+          return true;
+        }
+        break;
+      }
+      case statementType::CONDITIONAL_STATEMENT: {
+        auto conditional = reinterpret_cast<const ConditionalStatement*>(stmt);
+        if (mayUpdateRecords(conditional->ifBlock, visited) || mayUpdateRecords(conditional->elseBLock, visited)) {
+          return true;
+        }
+        break;
+      }
+      case statementType::FOR_LOOP:
+      case statementType::WHILE_LOOP:
+      case statementType::DO_WHILE_LOOP:
+      case statementType::RANGE_SCAN:
+        if (mayUpdateRecords(reinterpret_cast<const LoopStatement*>(stmt)->body, visited)) return true;
+        break;
+      case statementType::READ:
+      case statementType::READ_INDEXED:
+      case statementType::CREATE:  // a new record, nobody else can have read it yet.
+      case statementType::YIELD:
+      case statementType::LOG_STRING:
+      case statementType::TEMP_VAR_ASSIGN:
+      case statementType::CC_LOCK:
+        break;
+    }
+  }
+  return false;
+}
+
+void BuilderOptPasses::eliminateRedundantStatements(const std::shared_ptr<StatementBuilder>& sb,
+                                                    available_values_t& available, held_locks_t held_locks) {
+  if (!sb) return;
+
+  // only attributes which are read/written as a whole value are forwarded.
+  auto isForwardable = [&](const std::string& attribute_name, valueType value_type) {
+    auto attribute = builder->getAttribute(attribute_name);
+    return attribute->type == value_type &&
+           (attribute->type_category == ATTRIBUTE_TYPE_CATEGORY::PRIMITIVE || attribute->type == valueType::RECORD_PTR);
+  };
+
+  // NOTE: replaced/removed statements are not freed, the same as everywhere else statements are dropped.
+  for (auto it = sb->statements.begin(); it != sb->statements.end();) {
+    auto* stmt = *it;
+    switch (stmt->stType) {
+      case statementType::READ: {
+        auto readStmt = reinterpret_cast<ReadStatement*>(stmt);
+        const auto& dest_var = readStmt->dest_expr->var_name;
+        auto prior = available.find(readStmt->source_attr);
+
+        if (prior != available.end() && isForwardable(readStmt->source_attr, readStmt->dest_expr->getResultType())) {
+          auto forwarded = prior->second;
+          forwarded.from_update ? redundancy_stats.forwarded_writes++ : redundancy_stats.forwarded_reads++;
+          LOG_IF(INFO, print_debug_log) << "forwarding read of " << readStmt->source_attr << " into " << dest_var
+                                        << " from " << forwarded.value->toString();
+
+          if (forwarded.depends_on == dest_var) {
+            // the destination already holds the value.
+            it = sb->statements.erase(it);
+            continue;
+          }
+          *it = new TempVarAssignStatement(forwarded.value, readStmt->dest_expr);
+          invalidateVariable(available, dest_var);
+        } else {
+          invalidateVariable(available, dest_var);
+          if (isForwardable(readStmt->source_attr, readStmt->dest_expr->getResultType())) {
+            available.insert_or_assign(readStmt->source_attr, available_value_t{readStmt->dest_expr, dest_var, false});
+          }
+        }
+        break;
+      }
+      case statementType::UPDATE: {
+        auto updStmt = reinterpret_cast<UpdateStatement*>(stmt);
+        const auto& source = updStmt->source_expr;
+        available.erase(updStmt->destination_attr);
+
+        if (isForwardable(updStmt->destination_attr, source->getResultType())) {
+          if (auto var = std::dynamic_pointer_cast<expressions::LocalVariableExpression>(source)) {
+            available.emplace(updStmt->destination_attr, available_value_t{source, var->var_name, true});
+          } else if (std::dynamic_pointer_cast<expressions::Constant>(source)) {
+            available.emplace(updStmt->destination_attr, available_value_t{source, "", true});
+          }
+        }
+        break;
+      }
+      case statementType::TEMP_VAR_ASSIGN:
+        invalidateVariable(available, reinterpret_cast<TempVarAssignStatement*>(stmt)->dest->var_name);
+        break;
+      case statementType::READ_INDEXED:
+        invalidateVariable(available, reinterpret_cast<ReadIndexedStatement*>(stmt)->dest_expr->var_name);
+        break;
+      case statementType::CREATE:
+        invalidateVariable(available, reinterpret_cast<InsertStatement*>(stmt)->destination_var);
+        break;
+      case statementType::METHOD_CALL: {
+        auto methodCall = reinterpret_cast<MethodCallStatement*>(stmt);
+        if (methodCall->has_return_dest) invalidateVariable(available, methodCall->return_dest->var_name);
+        // arguments may be passed by reference.
+        for (const auto& arg : methodCall->function_arguments) {
+          if (auto var = std::dynamic_pointer_cast<expressions::LocalVariableExpression>(arg)) {
+            invalidateVariable(available, var->var_name);
+          }
+        }
+        // the callee runs on another record, but may reach this one through its own references.
+        std::set<const FunctionBuilder*> visited{methodCall->function_instance.get()};
+        if (mayUpdateRecords(methodCall->function_instance->entryPoint, visited)) available.clear();
+        break;
+      }
+      case statementType::CONDITIONAL_STATEMENT: {
+        auto conditional = reinterpret_cast<ConditionalStatement*>(stmt);
+        auto if_available = available;
+        auto else_available = available;
+        eliminateRedundantStatements(conditional->ifBlock, if_available, held_locks);
+        eliminateRedundantStatements(conditional->elseBLock, else_available, held_locks);
+
+        // keep what is still available, unchanged, on both paths.
+        auto unchanged = [](const available_values_t& branch, const auto& item) {
+          auto b = branch.find(item.first);
+          return b != branch.end() && b->second.value == item.second.value &&
+                 b->second.depends_on == item.second.depends_on;
+        };
+        std::erase_if(available, [&](const auto& item) {
+          return !unchanged(if_available, item) || !unchanged(else_available, item);
+        });
+        break;
+      }
+      case statementType::FOR_LOOP:
+      case statementType::WHILE_LOOP:
+      case statementType::DO_WHILE_LOOP:
+      case statementType::RANGE_SCAN: {
+        // the body may run several times, so nothing from before the loop survives the first iteration.
+        available_values_t loop_available;
+        eliminateRedundantStatements(reinterpret_cast<LoopStatement*>(stmt)->body, loop_available, held_locks);
+        available.clear();
+        break;
+      }
+      case statementType::CC_LOCK: {
+        auto lockStmt = reinterpret_cast<LockStatement2*>(stmt);
+        // element (stripe) locks depend on the index value at that point, so they are never merged.
+        if (lockStmt->index_expr) break;
+        auto held = held_locks.find({lockStmt->type_name, lockStmt->attribute});
+        if (held != held_locks.end()) {
+          // locks are held until the end of the transaction, so upgrading the dominating one is enough.
+          if (lockStmt->is_exclusive) held->second->is_exclusive = true;
+          redundancy_stats.removed_locks++;
+          it = sb->statements.erase(it);
+          continue;
+        }
+        held_locks.emplace(std::make_pair(lockStmt->type_name, lockStmt->attribute), lockStmt);
+        break;
+      }
+      case statementType::INSERT_INDEXED:
+      case statementType::REMOVE_INDEXED:
+      case statementType::UPDATE_INDEXED:
+      case statementType::YIELD:
+      case statementType::LOG_STRING:
+        break;
+    }
+    ++it;
+  }
+}
+
+void BuilderOptPasses::opt_pass_eliminateRedundantStatements() {
+  LOG_IF(INFO, print_debug_log) << "BuilderOptPasses::opt_pass_eliminateRedundantStatements: "
+                                << builder->getName();
+  redundancy_stats_t before = redundancy_stats;
+
+  builder->for_each_function([&](const std::shared_ptr<FunctionBuilder>& fb) {
+    available_values_t available;
+    eliminateRedundantStatements(fb->entryPoint, available, {});
   });
-  */
+
+  LOG_IF(INFO, print_debug_log) << "\tforwarded_reads: " << (redundancy_stats.forwarded_reads - before.forwarded_reads)
+                                << " | forwarded_writes: "
+                                << (redundancy_stats.forwarded_writes - before.forwarded_writes)
+                                << " | removed_locks: " << (redundancy_stats.removed_locks - before.removed_locks);
+}
+
+void BuilderOptPasses::opt_pass_deferSecondaryIndexMaintenance() {
+  LOG_IF(INFO, print_debug_log) << "BuilderOptPasses::opt_pass_deferSecondaryIndexMaintenance: "
+                                << builder->getName();
+
+  for (auto& secondary : builder->getSecondaryIndexes()) {
+    // unique ones have to check their keys in place.
+    if (secondary->is_unique) continue;
+
+    auto updatesKey = [&](const MethodCallStatement* method) {
+      rw_set_t read_set, write_set;
+      method->function_instance->entryPoint->extractReadWriteSet_recursive(read_set, write_set);
+      const auto& written = write_set[secondary->composite_type->getName()];
+      return std::any_of(secondary->key_parts.begin(), secondary->key_parts.end(),
+                         [&](const CompositeKeyPart& part) { return written.contains(part.attribute); });
+    };
+
+    bool reads_own_entries = false;
+    builder->for_each_function([&](const std::shared_ptr<FunctionBuilder>& fb) {
+      bool reads = false;
+      bool maintains = false;
+      fb->entryPoint->for_each_statement([&](const Statement* stmt) {
+        if (stmt->stType == statementType::READ_INDEXED || stmt->stType == statementType::RANGE_SCAN) {
+          reads |= indexedSourceAttribute(stmt) == secondary->name;
+        } else if (stmt->stType == statementType::INSERT_INDEXED || stmt->stType == statementType::REMOVE_INDEXED) {
+          maintains |= indexedSourceAttribute(stmt) == secondary->primary_list;
+        } else if (stmt->stType == statementType::METHOD_CALL) {
+          maintains |= updatesKey(reinterpret_cast<const MethodCallStatement*>(stmt));
+        }
+      });
+      reads_own_entries |= reads && maintains;
+    });
+
+    secondary->defer_maintenance = !reads_own_entries;
+    if (secondary->defer_maintenance) n_deferred_indexes++;
+    LOG_IF(INFO, print_debug_log) << "\t" << secondary->name << " | deferred: " << secondary->defer_maintenance;
+  }
 }
 
 void BuilderOptPasses::runAll() {
-  LOG(INFO) << "BuilderOptPasses::runAll: " << builder->getName();
+  LOG_IF(INFO, print_debug_log) << "BuilderOptPasses::runAll: " << builder->getName();
   // first set the parent.
   setParent(builder);
 
   // NOTE: order matters
   opt_pass_remove_unused_functions_from_composite_types(true);
 
-  for (auto& t : builder->registered_subtypes) {
-    BuilderOptPasses ty(t.second);
+  // keys of indexed lists are read by the index itself, outside any function of the key's type.
+  for_each_type(builder, [&](const std::shared_ptr<Builder>& type) {
+    for (auto& [name, attr] : type->attributes) {
+      if (attr->type_category != ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST) continue;
+      auto list = std::static_pointer_cast<AttributeList>(attr);
+      if (list->is_fixed_size || list->is_primitive_type) continue;
+      auto indexedList = std::static_pointer_cast<AttributeIndexedList>(attr);
+      if (indexedList->isCompositeKey()) {
+        for (const auto& part : indexedList->key_parts) {
+          pinned_attributes.insert(list->composite_type->getName() + "." + part.attribute);
+        }
+      } else {
+        pinned_attributes.insert(list->composite_type->getName() + "." + indexedList->key_attribute);
+      }
+    }
+  });
+
+  // static weights would change the layout of every type on a guess, so the split needs a hint or a profile.
+  bool split_hot_cold = builder->split_hot_cold_attributes || !function_weights.empty();
+
+  // forwarding first, as it can turn attributes into write-only ones.
+  for_each_type(builder, [&](const std::shared_ptr<Builder>& type) {
+    BuilderOptPasses ty(type);
+    ty.pinned_attributes = pinned_attributes;
+    ty.opt_pass_eliminateRedundantStatements();
     ty.opt_pass_removeUnusedAttributes();
-  }
+    if (split_hot_cold) ty.opt_pass_splitHotColdAttributes(function_weights);
+    redundancy_stats += ty.getRedundancyStats();
+    n_removed_attributes += ty.getNumRemovedAttributes();
+  });
 
-  this->opt_pass_removeUnusedAttributes();
-}
\ No newline at end of file
+  // after the removal of unused attributes, which drops secondary indexes which are never read.
+  opt_pass_deferSecondaryIndexMaintenance();
+}
@@ -24,6 +24,7 @@
 #include <utility>
 
 #include "dcds/builder/function-builder.hpp"
+#include "dcds/builder/optimizer/builder-opt-passes.hpp"
 #include "dcds/builder/optimizer/cc-injector.hpp"
 #include "dcds/builder/statement-builder.hpp"
 #include "dcds/codegen/codegen.hpp"
@@ -140,6 +141,11 @@ void Builder::build() {
     throw dcds::exceptions::dcds_dynamic_exception("Data structure is already built");
   }
 
+  if (run_builder_opt_passes) {
+    // non-owning: the builder is not necessarily owned by a shared_ptr.
+    BuilderOptPasses(std::shared_ptr<Builder>(std::shared_ptr<Builder>(), this)).runAll();
+  }
+
   if (!codegen_engine) {
     codegen_engine = std::make_shared<LLVMCodegen>(this);
   }
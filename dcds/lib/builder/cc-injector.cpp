@@ -77,6 +77,17 @@ void CCInjector::injectCC_statementBlock(std::shared_ptr<StatementBuilder> &s, c
       attribute_info x{typeName, rd_st->dest_expr->var_name};
       traits_in_scope[x].is_const = true;
 
+      // elements of primitive arrays are values inside this type, hence, protected by its locks (or its stripes).
+      if (!type_traits.is_nascent && isPrimitiveArray(s, rd_st->source_attr)) {
+        placeElementLock(lock_placed, traits_in_scope, it, s, rd_st->source_attr, rd_st->index_expr, false);
+      }
+
+    } else if (st->stType == statementType::UPDATE_INDEXED) {
+      auto upd_st = reinterpret_cast<UpdateIndexedStatement *>(st);
+      if (!type_traits.is_nascent) {
+        placeElementLock(lock_placed, traits_in_scope, it, s, upd_st->destination_attr, upd_st->index_expr, true);
+      }
+
     } else if (st->stType == statementType::UPDATE) {
       auto upd_st = reinterpret_cast<UpdateStatement *>(st);
       if (!type_traits.is_nascent) {
@@ -124,14 +135,20 @@ void CCInjector::injectCC_statementBlock(std::shared_ptr<StatementBuilder> &s, c
       auto t = traits_in_scope.emplace(std::pair{ins_st->type_name, ins_st->destination_var}, attribute_trait_t{});
       t.first->second.is_nascent = true;
     } else if (st->stType == statementType::FOR_LOOP || st->stType == statementType::WHILE_LOOP ||
-               st->stType == statementType::DO_WHILE_LOOP) {
+               st->stType == statementType::DO_WHILE_LOOP || st->stType == statementType::RANGE_SCAN) {
       auto loop_st = reinterpret_cast<LoopStatement *>(st);
+      if (st->stType == statementType::RANGE_SCAN) {
+        // the same as READ_INDEXED: the index synchronizes itself, the records are locked by their own methods.
+        attribute_info x{typeName, reinterpret_cast<RangeScanStatement *>(st)->record_var->var_name};
+        traits_in_scope[x].is_const = true;
+      }
       injectCC_statementBlock(const_cast<std::shared_ptr<StatementBuilder> &>(loop_st->body), lock_placed, type_traits,
                               traits_in_scope);
     } else {
       // non-CC statements.
       if (!(st->stType == statementType::YIELD || st->stType == statementType::REMOVE_INDEXED ||
             st->stType == statementType::INSERT_INDEXED || st->stType == statementType::READ_INDEXED ||
+            st->stType == statementType::UPDATE_INDEXED ||
             st->stType == statementType::LOG_STRING)) {
         LOG(FATAL) << "Unknown statement for CC::Inject: " << st->stType;
       }
@@ -141,6 +158,34 @@ void CCInjector::injectCC_statementBlock(std::shared_ptr<StatementBuilder> &s, c
   }
 }
 
+bool CCInjector::isPrimitiveArray(std::shared_ptr<StatementBuilder> &s, const std::string &attribute_name) {
+  auto attribute = s->getFunction()->builder->getAttribute(attribute_name);
+  return attribute->type_category == ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST &&
+         std::static_pointer_cast<AttributeList>(attribute)->is_primitive_type;
+}
+
+void CCInjector::placeElementLock(std::map<attribute_info, LockStatement2 *> &lock_placed,
+                                  attribute_traits &traits_in_scope, std::deque<Statement *>::iterator &pos,
+                                  std::shared_ptr<StatementBuilder> &s, const std::string &attribute_name,
+                                  const std::shared_ptr<expressions::Expression> &index_expr, bool lock_exclusive) {
+  auto typeName = s->getFunction()->builder->getName();
+  auto typeId = s->getFunction()->builder->getTypeID();
+  auto attributeArray =
+      std::static_pointer_cast<AttributeArray>(s->getFunction()->builder->getAttribute(attribute_name));
+
+  if (attributeArray->lock_stripes == 0) {
+    placeLockIfAbsent(lock_placed, traits_in_scope, pos, s->statements, attribute_name, typeName, typeId,
+                      lock_exclusive);
+    return;
+  }
+
+  // the stripe depends on the index value at this point, so these locks are not de-duplicated across statements;
+  // re-acquiring a stripe already held by the txn is a no-op at runtime.
+  auto lkSt = new LockStatement2(typeName, attribute_name, typeId, lock_exclusive, index_expr);
+  pos = s->statements.insert(pos, reinterpret_cast<Statement *>(lkSt));
+  pos++;
+}
+
 void CCInjector::injectCC_function(std::shared_ptr<FunctionBuilder> &fb, attribute_trait_t type_trait) {
   LOG_IF(INFO, print_debug_log) << "[CCInjector::injectCC_function] begin: " << fb->getName()
                                 << " id: " << fb->function_id;
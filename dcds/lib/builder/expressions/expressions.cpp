@@ -23,6 +23,7 @@
 
 #include "dcds/builder/expressions/binary-expressions.hpp"
 #include "dcds/builder/expressions/expression-visitor.hpp"
+#include "dcds/builder/expressions/key-expressions.hpp"
 #include "dcds/builder/expressions/unary-expressions.hpp"
 
 using namespace dcds::expressions;
@@ -54,6 +55,9 @@ void* GreaterThanOrEqualToExpression::accept(ExpressionVisitor* v) { return v->v
 void* LessThanExpression::accept(ExpressionVisitor* v) { return v->visit(*this); }
 void* LessThanOrEqualToExpression::accept(ExpressionVisitor* v) { return v->visit(*this); }
 
+// Keys
+void* CompositeKeyExpression::accept(ExpressionVisitor* v) { return v->visit(*this); }
+
 std::string TemporaryVariableExpression::toString() const {
   std::stringstream out;
 
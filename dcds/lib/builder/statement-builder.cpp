@@ -22,6 +22,7 @@
 #include "dcds/builder/statement-builder.hpp"
 
 #include "dcds/builder/expressions/constant-expressions.hpp"
+#include "dcds/builder/expressions/key-expressions.hpp"
 #include "dcds/builder/function-builder.hpp"
 
 using namespace dcds;
@@ -33,6 +34,16 @@ std::shared_ptr<expressions::TemporaryVariableExpression> StatementBuilder::add_
                                                type);
 }
 
+// composite keys are only built by CompositeKeyExpression, so that the parts are packed the same everywhere.
+static void checkIndexKey(const std::shared_ptr<AttributeIndexedList> &indexedTy,
+                          const std::shared_ptr<expressions::Expression> &key) {
+  CHECK(key->getResultType() == indexedTy->key_type)
+      << "Mismatched key type: "
+      << "Expected: " << indexedTy->key_type << " vs Input: " << key->getResultType();
+  CHECK(!indexedTy->isCompositeKey() || dynamic_cast<expressions::CompositeKeyExpression *>(key.get()))
+      << "Key of an indexed list with a composite key is not a CompositeKeyExpression: " << key->toString();
+}
+
 void StatementBuilder::addReadStatement(const std::shared_ptr<dcds::Attribute> &attribute,
                                         const std::string &destination) {
   if (this->parent_function.hasTempVariable(destination)) {
@@ -78,10 +89,7 @@ void StatementBuilder::addReadStatement(const std::shared_ptr<dcds::Attribute> &
   } else {
     auto indexedTy = std::static_pointer_cast<AttributeIndexedList>(attributeList);
 
-    CHECK(key->getResultType() == indexedTy->composite_type->getAttribute(indexedTy->key_attribute)->type)
-        << "Mismatched key type: "
-        << "Expected: " << key->getResultType()
-        << " vs Input: " << indexedTy->composite_type->getAttribute(indexedTy->key_attribute)->type;
+    checkIndexKey(indexedTy, key);
   }
 
   if (attributeList->is_fixed_size) {
@@ -109,10 +117,9 @@ void StatementBuilder::addRemoveStatement(const std::shared_ptr<dcds::Attribute>
 
   auto indexedTy = std::static_pointer_cast<AttributeIndexedList>(attributeList);
 
-  CHECK(key->getResultType() == indexedTy->composite_type->getAttribute(indexedTy->key_attribute)->type)
-      << "Mismatched key type: "
-      << "Expected: " << key->getResultType()
-      << " vs Input: " << indexedTy->composite_type->getAttribute(indexedTy->key_attribute)->type;
+  checkIndexKey(indexedTy, key);
+  CHECK(!indexedTy->isSecondaryIndex()) << "Secondary index is maintained through its primary list: "
+                                        << indexedTy->primary_list;
 
   auto s = new RemoveIndexedStatement(attribute->name, key);
   statements.push_back(s);
@@ -131,10 +138,9 @@ void StatementBuilder::addInsertStatement(const std::shared_ptr<dcds::Attribute>
 
   auto indexedTy = std::static_pointer_cast<AttributeIndexedList>(attributeList);
 
-  CHECK(key->getResultType() == indexedTy->composite_type->getAttribute(indexedTy->key_attribute)->type)
-      << "Mismatched key type: "
-      << "Expected: " << key->getResultType()
-      << " vs Input: " << indexedTy->composite_type->getAttribute(indexedTy->key_attribute)->type;
+  checkIndexKey(indexedTy, key);
+  CHECK(!indexedTy->isSecondaryIndex()) << "Secondary index is maintained through its primary list: "
+                                        << indexedTy->primary_list;
 
   auto s = new InsertIndexedStatement(attribute->name, key, value);
   statements.push_back(s);
@@ -190,6 +196,26 @@ void StatementBuilder::addUpdateStatement(const std::shared_ptr<dcds::Attribute>
   this->parent_function._is_const = false;
 }
 
+void StatementBuilder::addUpdateStatement(const std::shared_ptr<dcds::Attribute> &attribute,
+                                          const std::shared_ptr<dcds::expressions::Expression> &key,
+                                          const std::shared_ptr<expressions::Expression> &source) {
+  CHECK(attribute->type_category == ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST) << "Attribute is not a array/list type";
+  CHECK(this->parent_function.hasAttribute(attribute)) << "Attribute not registered in the data structure";
+
+  auto attributeList = std::static_pointer_cast<AttributeList>(attribute);
+  CHECK(attributeList->is_fixed_size && attributeList->is_primitive_type)
+      << "Indexed updates are only for arrays of primitive types, update records through their methods";
+  CHECK(key->getResultType() == valueType::INT64) << "Key should be integral type for fixed-sized arrays";
+
+  if (source->getResultType() != attributeList->simple_type->type) {
+    throw dcds::exceptions::dcds_invalid_type_exception("Type mismatch between array element and source expression");
+  }
+
+  auto s = new UpdateIndexedStatement(attribute->name, key, source);
+  statements.push_back(s);
+  this->parent_function._is_const = false;
+}
+
 void StatementBuilder::addReturnStatement(const std::shared_ptr<expressions::Expression> &expr) {
   // How do we know if expr is valid?
   // checks?
@@ -441,6 +467,32 @@ std::shared_ptr<StatementBuilder> StatementBuilder::addDoWhileLoop(dcds::express
   return loop_body;
 }
 
+std::shared_ptr<StatementBuilder> StatementBuilder::addRangeScan(
+    const std::shared_ptr<dcds::Attribute> &attribute, const std::shared_ptr<expressions::Expression> &lower,
+    const std::shared_ptr<expressions::Expression> &upper,
+    const std::shared_ptr<expressions::LocalVariableExpression> &record) {
+  CHECK(attribute->type_category == ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST) << "Attribute is not a list type";
+  auto attributeList = std::static_pointer_cast<AttributeList>(attribute);
+  CHECK(attributeList->is_fixed_size == false) << "Attribute is not a indexed-list type";
+  CHECK(attributeList->is_primitive_type == false) << "Indexed list does not support primitive type yet";
+
+  auto indexedTy = std::static_pointer_cast<AttributeIndexedList>(attributeList);
+  CHECK(indexedTy->index_type == hints::IndexHints::ORDERED)
+      << "Range scan requires an ordered index on the indexed list: " << attribute->name;
+
+  checkIndexKey(indexedTy, lower);
+  checkIndexKey(indexedTy, upper);
+  CHECK(record->getType() == dcds::valueType::RECORD_PTR)
+      << "record is not of the type RECORD_PTR: " << record->getType();
+
+  auto loop_body = std::make_shared<StatementBuilder>(this->parent_function, this);
+  this->child_blocks++;
+
+  auto rs = new RangeScanStatement(attribute->name, lower, upper, record, loop_body);
+  statements.push_back(rs);
+  return loop_body;
+}
+
 void StatementBuilder::extractReadWriteSet_recursive(rw_set_t &read_set, rw_set_t &write_set) {
   this->for_each_statement([&](const Statement *stmt) {
     auto typeName = this->parent_function.builder->getName();
@@ -460,9 +512,16 @@ void StatementBuilder::extractReadWriteSet_recursive(rw_set_t &read_set, rw_set_
     } else if (stmt->stType == statementType::READ_INDEXED) {
       auto readStmt = reinterpret_cast<const ReadIndexedStatement *>(stmt);
       read_set[typeName].insert(readStmt->source_attr + "[" + readStmt->index_expr->toString() + "]");
+    } else if (stmt->stType == statementType::RANGE_SCAN) {
+      auto scanStmt = reinterpret_cast<const RangeScanStatement *>(stmt);
+      read_set[typeName].insert(scanStmt->source_attr + "[" + scanStmt->lower_expr->toString() + ", " +
+                                scanStmt->upper_expr->toString() + "]");
     } else if (stmt->stType == statementType::UPDATE) {
       auto updStmt = reinterpret_cast<const UpdateStatement *>(stmt);
       write_set[typeName].insert(updStmt->destination_attr);
+    } else if (stmt->stType == statementType::UPDATE_INDEXED) {
+      auto updStmt = reinterpret_cast<const UpdateIndexedStatement *>(stmt);
+      write_set[typeName].insert(updStmt->destination_attr + "[" + updStmt->index_expr->toString() + "]");
     } else if (stmt->stType == statementType::METHOD_CALL) {
       auto method = reinterpret_cast<const MethodCallStatement *>(stmt);
       method->function_instance->entryPoint->extractReadWriteSet_recursive(read_set, write_set);
@@ -522,6 +581,11 @@ void StatementBuilder::print(std::ostream &out, size_t indent_level) {
       // auto st = std::static_pointer_cast<UpdateStatement>(s);
       out << "src: " << st->source_expr->toString() << ", dst: " << st->destination_attr;
 
+    } else if (s->stType == statementType::UPDATE_INDEXED) {
+      auto st = reinterpret_cast<const UpdateIndexedStatement *>(s);
+      out << "src: " << st->source_expr->toString() << ", dst: " << st->destination_attr << "["
+          << st->index_expr->toString() << "]";
+
     } else if (s->stType == statementType::CREATE) {
       auto st = reinterpret_cast<const InsertStatement *>(s);
       // auto st = std::static_pointer_cast<InsertStatement>(s);
@@ -568,6 +632,7 @@ void StatementBuilder::print(std::ostream &out, size_t indent_level) {
       auto st = reinterpret_cast<const LockStatement2 *>(s);
       out << " [" << (st->is_exclusive ? "EXCLUSIVE" : "SHARED") << "]";
       out << " attribute: " << st->type_name << "::" << st->attribute;
+      if (st->index_expr) out << "[" << st->index_expr->toString() << "]";
     }
     // Loops
     else if (s->stType == dcds::statementType::FOR_LOOP) {
@@ -587,6 +652,12 @@ void StatementBuilder::print(std::ostream &out, size_t indent_level) {
       auto curr_indent = indent_level + 1;
       st->body->print(out, curr_indent + 1);
       out << "} WHILE ( " << st->cond_expr->toString() << ")" << std::endl;
+    } else if (s->stType == dcds::statementType::RANGE_SCAN) {
+      auto st = reinterpret_cast<const RangeScanStatement *>(s);
+      out << "SCAN " << st->record_var->toString() << " IN " << st->source_attr << "[" << st->lower_expr->toString()
+          << ", " << st->upper_expr->toString() << "]" << std::endl;
+      auto curr_indent = indent_level + 1;
+      st->body->print(out, curr_indent + 1);
     }
 
     out << std::endl;
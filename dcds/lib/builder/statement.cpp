@@ -44,4 +44,9 @@ Statement *WhileLoopStatement::clone() const {
 Statement *DoWhileLoopStatement::clone() const {
   return new DoWhileLoopStatement(const_cast<dcds::expressions::Expression *>(this->cond_expr),
                                   this->body->clone_deep());
-}
\ No newline at end of file
+}
+
+Statement *RangeScanStatement::clone() const {
+  return new RangeScanStatement(this->source_attr, this->lower_expr, this->upper_expr, this->record_var,
+                                this->body->clone_deep());
+}
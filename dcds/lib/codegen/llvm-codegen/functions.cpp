@@ -21,10 +21,12 @@
 
 #include "dcds/codegen/llvm-codegen/functions.hpp"
 
+#include "dcds/builder/hints/builder-hints.hpp"
 #include "dcds/exporter/jit-container.hpp"
 #include "dcds/storage/table-registry.hpp"
 #include "dcds/transaction/transaction-manager.hpp"
 #include "dcds/transaction/transaction-namespaces.hpp"
+#include "dcds/util/epoch.hpp"
 
 int printc(char* X) {
   printf("[printc:] %c\n", X[0]);
@@ -64,7 +66,7 @@ void* c4(char* attributeNames) {
 }
 
 void* createTablesInternal(char* table_name, dcds::valueType attributeTypes[], char* attributeNames[],
-                           int num_attributes) {
+                           const bool attributeIsCold[], int num_attributes, uint32_t layout_flags) {
   static std::mutex create_table_m;
 
   // create a static lock here so that everything is safer.
@@ -91,32 +93,19 @@ void* createTablesInternal(char* table_name, dcds::valueType attributeTypes[], c
     auto name = actual_attr_names[i];
     //    LOG(INFO) << "[createTablesInternal] Loading attribute: " << name << " | type: " << type;
 
-    int64_t attribute_size = 0;
-    switch (type) {
-      case dcds::valueType::INT64:
-        attribute_size = sizeof(int64_t);
-        break;
-      case dcds::valueType::INT32:
-        attribute_size = sizeof(int32_t);
-        break;
-      case dcds::valueType::FLOAT:
-        attribute_size = sizeof(float);
-        break;
-      case dcds::valueType::DOUBLE:
-        attribute_size = sizeof(double);
-        break;
-      case dcds::valueType::RECORD_PTR:
-        attribute_size = sizeof(void*);
-        break;
-      case dcds::valueType::BOOL:
-        attribute_size = sizeof(bool);
-        break;
-      case dcds::valueType::VOID:
-        assert(false && "void type cannot be used as variable type");
-    }
-    columns.emplace_back(name, type, attribute_size);
+    assert(type != dcds::valueType::VOID && "void type cannot be used as variable type");
+    auto attribute_size = dcds::valueTypeSize(type);
+    columns.emplace_back(name, type, attribute_size, attributeIsCold[i]);
   }
 
+  auto hasLayoutFlag = [&](dcds::hints::LayoutHints flag) { return (layout_flags & std::to_underlying(flag)) != 0; };
+  dcds::storage::record_layout_t layout;
+  layout.sort_columns = hasLayoutFlag(dcds::hints::LayoutHints::ALIGNED_COLUMNS);
+  layout.record_alignment =
+      hasLayoutFlag(dcds::hints::LayoutHints::CACHE_LINE_ALIGNED_RECORDS) ? dcds::CACHE_LINE_SIZE : 0;
+  layout.separate_metadata = hasLayoutFlag(dcds::hints::LayoutHints::SEPARATE_METADATA);
+  layout.column_store = hasLayoutFlag(dcds::hints::LayoutHints::COLUMN_STORE);
+
   // CRITICAL SECTION: so that if two DS instances are getting initialized together,
   // we don't create the same table twice.
   dcds::storage::Table* ret_table_ptr;
@@ -125,7 +114,7 @@ void* createTablesInternal(char* table_name, dcds::valueType attributeTypes[], c
     if (tableRegistry.exists(table_name)) {
       ret_table_ptr = tableRegistry.getTable(table_name);
     } else {
-      ret_table_ptr = tableRegistry.createTable(table_name, columns);
+      ret_table_ptr = tableRegistry.createTable(table_name, columns, layout);
     }
 
     assert(ret_table_ptr);
@@ -172,6 +161,8 @@ void* createDsContainer(void* txnManager, uintptr_t data) {
   return container_ptr;
 }
 
+void destroyDsContainer(void* container) { delete static_cast<dcds::JitContainer::dcds_jit_container_t*>(container); }
+
 uintptr_t extractRecordFromDsContainer(void* container) {
   auto c = static_cast<dcds::JitContainer::dcds_jit_container_t*>(container);
   return c->mainRecord;
@@ -215,6 +206,20 @@ void table_write_attribute_offset(void* _txnManager, uintptr_t _mainRecord, void
   storageTable->updateNthRecord(txn, mainRecord.operator->(), src, record_offset, attributeIdx);
 }
 
+uintptr_t table_read_runtime_constant(uintptr_t _mainRecord, size_t attributeIdx) {
+  auto mainRecord = dcds::storage::record_reference_t(_mainRecord);
+  auto storageTable = mainRecord.getTable();
+
+  uintptr_t value = 0;
+  storageTable->getAttribute(nullptr, mainRecord.operator->(), &value, attributeIdx);
+  return value;
+}
+
+void* table_get_column(uintptr_t _mainRecord, size_t attributeIdx) {
+  auto mainRecord = dcds::storage::record_reference_t(_mainRecord);
+  return mainRecord.getTable()->getColumn(mainRecord.operator->(), attributeIdx).first;
+}
+
 uintptr_t table_get_nth_record(void* _txnManager, uintptr_t _mainRecord, void* txnPtr, size_t record_offset) {
   // auto txnManager = reinterpret_cast<dcds::txn::TransactionManager*>(_txnManager);
   auto mainRecord = dcds::storage::record_reference_t(_mainRecord);
@@ -279,3 +284,7 @@ bool lock_exclusive(void* _txnManager, void* txnPtr, uintptr_t record) {
 
 // bool unlock_shared(void* _txnManager, uintptr_t record, void* txnPtr){}
 // bool unlock_exclusive(void* _txnManager, uintptr_t record, void* txnPtr){}
+
+bool epoch_pin() { return dcds::util::Epoch::pin(dcds::util::Epoch::slot()); }
+
+void epoch_unpin() { dcds::util::Epoch::unpin(dcds::util::Epoch::slot()); }
@@ -246,6 +246,17 @@ llvm::Value *LLVMCodegenFunction::getArgumentByPosition(uint32_t index) {
   return nullptr;
 }
 
+llvm::Value *LLVMCodegenFunction::getEntryBlockValue(const std::string &key,
+                                                     const std::function<llvm::Value *()> &generate) {
+  if (auto it = entry_block_values.find(key); it != entry_block_values.end()) return it->second;
+
+  llvm::IRBuilderBase::InsertPointGuard guard(*IRBuilder());
+  IRBuilder()->SetInsertPoint(entryBB, entryBB->begin());
+  auto *value = generate();
+  entry_block_values.emplace(key, value);
+  return value;
+}
+
 llvm::Value *LLVMCodegenFunction::getVariable(const std::string &name) {
   if (allocated_vars.contains(name))
     return allocated_vars[name];
@@ -21,6 +21,8 @@
 
 #include "dcds/codegen/llvm-codegen/llvm-codegen-statement.hpp"
 
+#include <tuple>
+
 #include "dcds/builder/function-builder.hpp"
 #include "dcds/codegen/llvm-codegen/expression-codegen/llvm-expression-visitor.hpp"
 #include "dcds/codegen/llvm-codegen/functions.hpp"
@@ -28,9 +30,29 @@
 #include "dcds/codegen/llvm-codegen/utils/loops.hpp"
 #include "dcds/codegen/llvm-codegen/utils/phi-node.hpp"
 #include "dcds/indexes/index-functions.hpp"
+#include "dcds/indexes/negative-lookup-filter.hpp"
+#include "dcds/indexes/open-addressing-index.hpp"
 
 static constexpr bool print_debug_log = false;
 
+// Width of the keys of an index, whose bits the inline index and filter probes hash.
+static size_t indexKeyBytes(dcds::valueType key_type) {
+  switch (key_type) {
+    case dcds::valueType::INT64:
+    case dcds::valueType::DOUBLE:
+    case dcds::valueType::RECORD_PTR:
+      return 8;
+    case dcds::valueType::INT32:
+    case dcds::valueType::FLOAT:
+      return 4;
+    case dcds::valueType::VOID:
+    case dcds::valueType::BOOL:
+      assert(false);
+      break;
+  }
+  return 0;
+}
+
 namespace dcds {
 using namespace dcds::expressions;
 
@@ -47,6 +69,8 @@ void LLVMCodegenStatement::buildStatement(Statement *stmt) {
     buildStatement_InsertIndexed(stmt);
   } else if (stmt->stType == dcds::statementType::REMOVE_INDEXED) {
     buildStatement_RemoveIndexed(stmt);
+  } else if (stmt->stType == dcds::statementType::UPDATE_INDEXED) {
+    buildStatement_UpdateIndexed(stmt);
   } else if (stmt->stType == dcds::statementType::UPDATE) {
     buildStatement_Update(stmt);
 
@@ -54,6 +78,11 @@ void LLVMCodegenStatement::buildStatement(Statement *stmt) {
     auto tempVarAssignSt = reinterpret_cast<TempVarAssignStatement *>(stmt);
 
     llvm::Value *source = LLVMExpressionVisitor::gen(build_ctx, tempVarAssignSt->source);
+    if (source->getType()->isPointerTy()) {
+      // source is another variable (or a by-reference argument), copy its value.
+      source = IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(tempVarAssignSt->source->getResultType()),
+                                       source);
+    }
     llvm::Value *destination = LLVMExpressionVisitor::gen(build_ctx, tempVarAssignSt->dest);
     IRBuilder()->CreateStore(source, destination);
 
@@ -81,6 +110,9 @@ void LLVMCodegenStatement::buildStatement(Statement *stmt) {
   } else if (stmt->stType == dcds::statementType::DO_WHILE_LOOP) {
     this->buildStatement_DoWhileLoop(stmt);
 
+  } else if (stmt->stType == dcds::statementType::RANGE_SCAN) {
+    this->buildStatement_RangeScan(stmt);
+
   } else if (stmt->stType == dcds::statementType::CC_LOCK) {
     buildStatement_CC_Lock(stmt);
 
@@ -186,6 +218,54 @@ void LLVMCodegenStatement::buildStatement_DoWhileLoop(dcds::Statement *stmt) {
   IRBuilder()->SetInsertPoint(AfterLoopBlock);
 }
 
+void LLVMCodegenStatement::buildStatement_RangeScan(dcds::Statement *stmt) {
+  auto scanStatement = reinterpret_cast<RangeScanStatement *>(stmt);
+  CHECK(!scanStatement->body->statements.empty()) << "Build range scan requested but loop body is empty";
+
+  auto indexedList = std::static_pointer_cast<AttributeIndexedList>(
+      build_ctx->current_builder->getAttribute(scanStatement->source_attr));
+  auto *keyTy = indexedList->key_bytes
+                    ? ArrayType::get(Type::getInt64Ty(ctx()), indexedList->key_bytes / sizeof(uint64_t))
+                    : build_ctx->codegen->DcdsToLLVMType(indexedList->key_type);
+
+  auto isLastStatementInBlock = (build_ctx->current_sb->statements.back() == stmt);
+  auto F = IRBuilder()->GetInsertBlock()->getParent();
+
+  auto *base_record_ptr = readListBaseRecord(scanStatement->source_attr);
+  llvm::Value *upper = genIndexKey(scanStatement->upper_expr);
+  llvm::Value *recordVar = LLVMExpressionVisitor::gen(build_ctx, scanStatement->record_var);
+
+  // the scan keeps no state in the index: the cursor is the last key visited, the next step continues after it.
+  auto *cursor = build_ctx->codegen->createEntryBlockAlloca("scan.cursor", keyTy);
+  auto *inclusive = build_ctx->codegen->createEntryBlockAlloca("scan.inclusive", Type::getInt1Ty(ctx()));
+  llvm::Value *lower = genIndexKey(scanStatement->lower_expr);
+  if (indexedList->key_bytes) lower = IRBuilder()->CreateLoad(keyTy, lower);
+  IRBuilder()->CreateStore(lower, cursor);
+  IRBuilder()->CreateStore(build_ctx->codegen->createTrue(), inclusive);
+
+  BasicBlock *LoopCondBlock = BasicBlock::Create(ctx(), "scan.loop.cond", F);
+  BasicBlock *LoopBodyBlock = BasicBlock::Create(ctx(), "scan.loop.body", F);
+  BasicBlock *AfterLoopBlock = isLastStatementInBlock ? build_ctx->getFunctionContext()->GetReturnBlock()
+                                                      : BasicBlock::Create(ctx(), "scan.after.loop", F);
+
+  IRBuilder()->CreateBr(LoopCondBlock);
+  IRBuilder()->SetInsertPoint(LoopCondBlock);
+
+  auto *found = call_index_scan_next(indexedList, base_record_ptr, cursor,
+                                     IRBuilder()->CreateLoad(Type::getInt1Ty(ctx()), inclusive), upper, recordVar);
+  IRBuilder()->CreateCondBr(found, LoopBodyBlock, AfterLoopBlock);
+  IRBuilder()->SetInsertPoint(LoopBodyBlock);
+
+  IRBuilder()->CreateStore(build_ctx->codegen->createFalse(), inclusive);
+
+  // Body of the loop:
+  LLVMScopedContext loop_body_ctx(this->build_ctx, scanStatement->body);
+  LLVMCodegenStatement::gen(&loop_body_ctx);
+
+  IRBuilder()->CreateBr(LoopCondBlock);
+  IRBuilder()->SetInsertPoint(AfterLoopBlock);
+}
+
 void LLVMCodegenStatement::buildStatement_ConditionalStatement(Statement *stmt) {
   auto conditionalStatement = reinterpret_cast<ConditionalStatement *>(stmt);
   CHECK(!conditionalStatement->ifBlock->statements.empty())
@@ -244,6 +324,11 @@ void LLVMCodegenStatement::buildStatement_Read(Statement *stmt) {
 
   llvm::Value *destination = LLVMExpressionVisitor::gen(build_ctx, readStmt->dest_expr);
 
+  if (auto *constant = readConstantAttribute(readStmt->source_attr)) {
+    IRBuilder()->CreateStore(constant, destination);
+    return;
+  }
+
   //    extern "C" void table_read_attribute(
   //    void* _txnManager, uintptr_t _mainRecord,
   //    void* txn, void* dst, uint attributeIdx);
@@ -255,20 +340,95 @@ void LLVMCodegenStatement::buildStatement_Read(Statement *stmt) {
       Type::getVoidTy(ctx()));
 }
 
-llvm::Value *LLVMCodegenStatement::call_index_find(valueType key_type, llvm::Value *base_record_ptr,
-                                                   llvm::Value *index_key) {
+llvm::Value *LLVMCodegenStatement::readConstantAttribute(const std::string &attribute_name) {
+  auto attribute = build_ctx->current_builder->getAttribute(attribute_name);
+
+  if (attribute->is_compile_time_constant && attribute->type_category == ATTRIBUTE_TYPE_CATEGORY::PRIMITIVE &&
+      std::static_pointer_cast<SimpleAttribute>(attribute)->hasDefaultValue()) {
+    return build_ctx->codegen->createDefaultValue(attribute);
+  }
+
+  // singleton functions are the ones allowed to initialize runtime constants, so they read them as usual.
+  if (attribute->is_runtime_constant && !build_ctx->current_fb->isSingleton() &&
+      (attribute->type == valueType::RECORD_PTR || attribute->type == valueType::INT64)) {
+    return build_ctx->codegen->gen_call(
+        table_read_runtime_constant,
+        {getArg_mainRecord(),
+         build_ctx->codegen->createSizeT(build_ctx->current_builder->getAttributeIndex(attribute_name))},
+        build_ctx->codegen->DcdsToLLVMType(attribute->type));
+  }
+
+  return nullptr;
+}
+
+llvm::Value *LLVMCodegenStatement::readListBaseRecord(const std::string &attribute_name) {
+  if (auto *constant = readConstantAttribute(attribute_name)) return constant;
+
+  auto *base_record = build_ctx->codegen->allocateScratchVar(
+      "idx_base_tmp_arTy", build_ctx->codegen->DcdsToLLVMType(valueType::RECORD_PTR));
+
+  build_ctx->codegen->gen_call(
+      table_read_attribute,
+      {getArg_txnManager(), getArg_mainRecord(), getArg_txn(), base_record,
+       build_ctx->codegen->createSizeT(build_ctx->current_builder->getAttributeIndex(attribute_name))},
+      Type::getVoidTy(ctx()));
+
+  auto *base_record_ptr =
+      IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(valueType::RECORD_PTR), base_record);
+  build_ctx->codegen->releaseScratchVar(base_record);
+  return base_record_ptr;
+}
+
+llvm::Value *LLVMCodegenStatement::genIndexKey(const std::shared_ptr<expressions::Expression> &key_expr) {
+  llvm::Value *key = LLVMExpressionVisitor::gen(build_ctx, key_expr);
+  auto *composite = dynamic_cast<CompositeKeyExpression *>(key_expr.get());
+  if (composite && composite->getKeyBytes()) return key;
+
+  if (key->getType()->isPointerTy()) {
+    key = IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(key_expr->getResultType()), key);
+  }
+  return key;
+}
+
+llvm::Value *LLVMCodegenStatement::indexKeysDiffer(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                                   llvm::Value *key_a, llvm::Value *key_b) {
+  if (!indexedList->key_bytes) return IRBuilder()->CreateICmpNE(key_a, key_b);
+
+  auto *wordsTy = FixedVectorType::get(Type::getInt64Ty(ctx()), indexedList->key_bytes / sizeof(uint64_t));
+  auto loadWords = [&](llvm::Value *key) {
+    return IRBuilder()->CreateAlignedLoad(wordsTy, IRBuilder()->CreateBitCast(key, wordsTy->getPointerTo()),
+                                          MaybeAlign(sizeof(uint64_t)));
+  };
+  return IRBuilder()->CreateOrReduce(IRBuilder()->CreateICmpNE(loadWords(key_a), loadWords(key_b)));
+}
+
+llvm::Value *LLVMCodegenStatement::call_index_find(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                                   llvm::Value *base_record_ptr, llvm::Value *index_key) {
   auto return_uintptr_type = Type::getInt64Ty(ctx());
-  switch (key_type) {
+  auto txn = getArg_txn();
+  if (indexedList->key_bytes == 16) {
+    return build_ctx->codegen->gen_call(index_find_txn_ref<indexes::BinaryKey<16>>, {txn, base_record_ptr, index_key},
+                                        return_uintptr_type);
+  } else if (indexedList->key_bytes == 32) {
+    return build_ctx->codegen->gen_call(index_find_txn_ref<indexes::BinaryKey<32>>, {txn, base_record_ptr, index_key},
+                                        return_uintptr_type);
+  }
+  switch (indexedList->key_type) {
     case valueType::INT64:
-      return build_ctx->codegen->gen_call(index_find<int64_t>, {base_record_ptr, index_key}, return_uintptr_type);
+      return build_ctx->codegen->gen_call(index_find_txn<int64_t>, {txn, base_record_ptr, index_key},
+                                          return_uintptr_type);
     case valueType::INT32:
-      return build_ctx->codegen->gen_call(index_find<int32_t>, {base_record_ptr, index_key}, return_uintptr_type);
+      return build_ctx->codegen->gen_call(index_find_txn<int32_t>, {txn, base_record_ptr, index_key},
+                                          return_uintptr_type);
     case valueType::FLOAT:
-      return build_ctx->codegen->gen_call(index_find<float>, {base_record_ptr, index_key}, return_uintptr_type);
+      return build_ctx->codegen->gen_call(index_find_txn<float>, {txn, base_record_ptr, index_key},
+                                          return_uintptr_type);
     case valueType::DOUBLE:
-      return build_ctx->codegen->gen_call(index_find<double>, {base_record_ptr, index_key}, return_uintptr_type);
+      return build_ctx->codegen->gen_call(index_find_txn<double>, {txn, base_record_ptr, index_key},
+                                          return_uintptr_type);
     case valueType::RECORD_PTR:
-      return build_ctx->codegen->gen_call(index_find<uintptr_t>, {base_record_ptr, index_key}, return_uintptr_type);
+      return build_ctx->codegen->gen_call(index_find_txn<uintptr_t>, {txn, base_record_ptr, index_key},
+                                          return_uintptr_type);
     case valueType::VOID:
     case valueType::BOOL:
       assert(false);
@@ -276,24 +436,33 @@ llvm::Value *LLVMCodegenStatement::call_index_find(valueType key_type, llvm::Val
   }
 }
 
-llvm::Value *LLVMCodegenStatement::call_index_insert(valueType key_type, llvm::Value *base_record_ptr,
-                                                     llvm::Value *index_key, llvm::Value *index_value) {
+llvm::Value *LLVMCodegenStatement::call_index_insert(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                                     llvm::Value *base_record_ptr, llvm::Value *index_key,
+                                                     llvm::Value *index_value) {
   auto return_bool_type = Type::getInt1Ty(ctx());
-  switch (key_type) {
+  auto txn = getArg_txn();
+  if (indexedList->key_bytes == 16) {
+    return build_ctx->codegen->gen_call(index_insert_txn_ref<indexes::BinaryKey<16>>,
+                                        {txn, base_record_ptr, index_key, index_value}, return_bool_type);
+  } else if (indexedList->key_bytes == 32) {
+    return build_ctx->codegen->gen_call(index_insert_txn_ref<indexes::BinaryKey<32>>,
+                                        {txn, base_record_ptr, index_key, index_value}, return_bool_type);
+  }
+  switch (indexedList->key_type) {
     case valueType::INT64:
-      return build_ctx->codegen->gen_call(index_insert<int64_t>, {base_record_ptr, index_key, index_value},
+      return build_ctx->codegen->gen_call(index_insert_txn<int64_t>, {txn, base_record_ptr, index_key, index_value},
                                           return_bool_type);
     case valueType::INT32:
-      return build_ctx->codegen->gen_call(index_insert<int32_t>, {base_record_ptr, index_key, index_value},
+      return build_ctx->codegen->gen_call(index_insert_txn<int32_t>, {txn, base_record_ptr, index_key, index_value},
                                           return_bool_type);
     case valueType::FLOAT:
-      return build_ctx->codegen->gen_call(index_insert<float>, {base_record_ptr, index_key, index_value},
+      return build_ctx->codegen->gen_call(index_insert_txn<float>, {txn, base_record_ptr, index_key, index_value},
                                           return_bool_type);
     case valueType::DOUBLE:
-      return build_ctx->codegen->gen_call(index_insert<double>, {base_record_ptr, index_key, index_value},
+      return build_ctx->codegen->gen_call(index_insert_txn<double>, {txn, base_record_ptr, index_key, index_value},
                                           return_bool_type);
     case valueType::RECORD_PTR:
-      return build_ctx->codegen->gen_call(index_insert<uintptr_t>, {base_record_ptr, index_key, index_value},
+      return build_ctx->codegen->gen_call(index_insert_txn<uintptr_t>, {txn, base_record_ptr, index_key, index_value},
                                           return_bool_type);
     case valueType::VOID:
     case valueType::BOOL:
@@ -302,20 +471,35 @@ llvm::Value *LLVMCodegenStatement::call_index_insert(valueType key_type, llvm::V
   }
 }
 
-llvm::Value *LLVMCodegenStatement::call_index_remove(valueType key_type, llvm::Value *base_record_ptr,
-                                                     llvm::Value *index_key) {
-  auto *return_void_type = Type::getVoidTy(ctx());
-  switch (key_type) {
+llvm::Value *LLVMCodegenStatement::call_index_remove(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                                     llvm::Value *base_record_ptr, llvm::Value *index_key,
+                                                     llvm::Value *removed) {
+  auto return_bool_type = Type::getInt1Ty(ctx());
+  auto txn = getArg_txn();
+  if (!removed) removed = ConstantPointerNull::get(Type::getInt64PtrTy(ctx()));
+  if (indexedList->key_bytes == 16) {
+    return build_ctx->codegen->gen_call(index_remove_txn_ref<indexes::BinaryKey<16>>,
+                                        {txn, base_record_ptr, index_key, removed}, return_bool_type);
+  } else if (indexedList->key_bytes == 32) {
+    return build_ctx->codegen->gen_call(index_remove_txn_ref<indexes::BinaryKey<32>>,
+                                        {txn, base_record_ptr, index_key, removed}, return_bool_type);
+  }
+  switch (indexedList->key_type) {
     case valueType::INT64:
-      return build_ctx->codegen->gen_call(index_remove<int64_t>, {base_record_ptr, index_key}, return_void_type);
+      return build_ctx->codegen->gen_call(index_remove_txn<int64_t>, {txn, base_record_ptr, index_key, removed},
+                                          return_bool_type);
     case valueType::INT32:
-      return build_ctx->codegen->gen_call(index_remove<int32_t>, {base_record_ptr, index_key}, return_void_type);
+      return build_ctx->codegen->gen_call(index_remove_txn<int32_t>, {txn, base_record_ptr, index_key, removed},
+                                          return_bool_type);
     case valueType::FLOAT:
-      return build_ctx->codegen->gen_call(index_remove<float>, {base_record_ptr, index_key}, return_void_type);
+      return build_ctx->codegen->gen_call(index_remove_txn<float>, {txn, base_record_ptr, index_key, removed},
+                                          return_bool_type);
     case valueType::DOUBLE:
-      return build_ctx->codegen->gen_call(index_remove<double>, {base_record_ptr, index_key}, return_void_type);
+      return build_ctx->codegen->gen_call(index_remove_txn<double>, {txn, base_record_ptr, index_key, removed},
+                                          return_bool_type);
     case valueType::RECORD_PTR:
-      return build_ctx->codegen->gen_call(index_remove<uintptr_t>, {base_record_ptr, index_key}, return_void_type);
+      return build_ctx->codegen->gen_call(index_remove_txn<uintptr_t>, {txn, base_record_ptr, index_key, removed},
+                                          return_bool_type);
     case valueType::VOID:
     case valueType::BOOL:
       assert(false);
@@ -323,6 +507,244 @@ llvm::Value *LLVMCodegenStatement::call_index_remove(valueType key_type, llvm::V
   }
 }
 
+llvm::Value *LLVMCodegenStatement::call_secondary_insert(const std::shared_ptr<AttributeIndexedList> &secondary,
+                                                         llvm::Value *base_record_ptr, llvm::Value *index_key,
+                                                         llvm::Value *record) {
+  // keys of secondary indexes are packed composite keys, i.e., INT64 or binary keys.
+  if (secondary->defer_maintenance) {
+    std::initializer_list<llvm::Value *> args = {getArg_txn(), base_record_ptr, index_key, record};
+    if (secondary->key_bytes == 16) {
+      return build_ctx->codegen->gen_call(index_insert_deferred_txn_ref<indexes::BinaryKey<16>>, args,
+                                          Type::getInt1Ty(ctx()));
+    } else if (secondary->key_bytes == 32) {
+      return build_ctx->codegen->gen_call(index_insert_deferred_txn_ref<indexes::BinaryKey<32>>, args,
+                                          Type::getInt1Ty(ctx()));
+    }
+    return build_ctx->codegen->gen_call(index_insert_deferred_txn<int64_t>, args, Type::getInt1Ty(ctx()));
+  }
+  return call_index_insert(secondary, base_record_ptr, index_key, record);
+}
+
+llvm::Value *LLVMCodegenStatement::call_index_scan_next(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                                        llvm::Value *base_record_ptr, llvm::Value *cursor,
+                                                        llvm::Value *inclusive, llvm::Value *upper,
+                                                        llvm::Value *record) {
+  auto return_bool_type = Type::getInt1Ty(ctx());
+  if (indexedList->key_bytes == 16) {
+    return build_ctx->codegen->gen_call(index_scan_next_ref<indexes::BinaryKey<16>>,
+                                        {base_record_ptr, cursor, inclusive, upper, record}, return_bool_type);
+  } else if (indexedList->key_bytes == 32) {
+    return build_ctx->codegen->gen_call(index_scan_next_ref<indexes::BinaryKey<32>>,
+                                        {base_record_ptr, cursor, inclusive, upper, record}, return_bool_type);
+  }
+  switch (indexedList->key_type) {
+    case valueType::INT64:
+      return build_ctx->codegen->gen_call(index_scan_next<int64_t>,
+                                          {base_record_ptr, cursor, inclusive, upper, record}, return_bool_type);
+    case valueType::INT32:
+      return build_ctx->codegen->gen_call(index_scan_next<int32_t>,
+                                          {base_record_ptr, cursor, inclusive, upper, record}, return_bool_type);
+    case valueType::FLOAT:
+      return build_ctx->codegen->gen_call(index_scan_next<float>, {base_record_ptr, cursor, inclusive, upper, record},
+                                          return_bool_type);
+    case valueType::DOUBLE:
+      return build_ctx->codegen->gen_call(index_scan_next<double>,
+                                          {base_record_ptr, cursor, inclusive, upper, record}, return_bool_type);
+    case valueType::RECORD_PTR:
+    case valueType::VOID:
+    case valueType::BOOL:
+      assert(false);
+      break;
+  }
+}
+
+llvm::Value *LLVMCodegenStatement::inlineIndexFind(valueType key_type, llvm::Value *base_record_ptr,
+                                                   llvm::Value *index_key) {
+  // Same probe as OpenAddressingIndex::_find, over the memory layout it exports. Concurrent operations pin the epoch
+  // for their whole duration (LLVMCodegen::buildOneFunction_outer), hence the probe only reads.
+  using WideIndex = indexes::OpenAddressingIndex<int64_t>;
+  using NarrowIndex = indexes::OpenAddressingIndex<int32_t>;
+  static_assert(WideIndex::group_size == NarrowIndex::group_size);
+  constexpr auto group_size = WideIndex::group_size;
+
+  auto key_bytes = indexKeyBytes(key_type);
+  const auto &layout = (key_bytes == 8) ? WideIndex::layout : NarrowIndex::layout;
+
+  auto *F = IRBuilder()->GetInsertBlock()->getParent();
+  auto *i8Ty = IRBuilder()->getInt8Ty();
+  auto *i64Ty = IRBuilder()->getInt64Ty();
+  auto *keyBitsTy = IRBuilder()->getIntNTy(static_cast<unsigned>(key_bytes * 8));
+  auto *maskTy = IRBuilder()->getIntNTy(group_size);
+  auto *tagsTy = FixedVectorType::get(i8Ty, group_size);
+
+  auto fieldPtr = [&](llvm::Value *base, size_t offset, llvm::Type *ty) {
+    return IRBuilder()->CreateBitCast(IRBuilder()->CreateConstInBoundsGEP1_64(i8Ty, base, offset),
+                                      ty->getPointerTo());
+  };
+  auto atomicLoad = [&](llvm::Type *ty, llvm::Value *ptr, AtomicOrdering ordering) {
+    auto bytes = ty->isPointerTy() ? sizeof(void *) : ty->getPrimitiveSizeInBits() / 8;
+    auto *load = IRBuilder()->CreateAlignedLoad(ty, ptr, MaybeAlign(bytes));
+    load->setAtomic(ordering);
+    return load;
+  };
+
+  // hash, tag and home group as in OpenAddressingIndex::hash/tagOf/homeGroup.
+  llvm::Value *key_bits = index_key;
+  if (key_bits->getType()->isPointerTy()) key_bits = IRBuilder()->CreatePtrToInt(key_bits, keyBitsTy);
+  key_bits = IRBuilder()->CreateBitCast(key_bits, keyBitsTy);
+  auto *hash = IRBuilder()->CreateMul(IRBuilder()->CreateZExt(key_bits, i64Ty),
+                                      IRBuilder()->getInt64(WideIndex::hash_multiplier));
+  auto *tag = IRBuilder()->CreateTrunc(IRBuilder()->CreateOr(IRBuilder()->CreateLShr(hash, 57), 0x80), i8Ty);
+  auto *home = IRBuilder()->CreateXor(hash, IRBuilder()->CreateLShr(hash, 29));
+  auto *tagSplat = IRBuilder()->CreateVectorSplat(group_size, tag);
+  auto *index = IRBuilder()->CreateIntToPtr(base_record_ptr, i8Ty->getPointerTo());
+
+  auto *RestartBlock = BasicBlock::Create(ctx(), "oa.restart", F);
+  auto *ProbeBlock = BasicBlock::Create(ctx(), "oa.probe", F);
+  auto *MatchBlock = BasicBlock::Create(ctx(), "oa.match", F);
+  auto *HitLoopBlock = BasicBlock::Create(ctx(), "oa.hit.loop", F);
+  auto *HitCheckBlock = BasicBlock::Create(ctx(), "oa.hit.check", F);
+  auto *HitNextBlock = BasicBlock::Create(ctx(), "oa.hit.next", F);
+  auto *HitFoundBlock = BasicBlock::Create(ctx(), "oa.hit.found", F);
+  auto *ValidateBlock = BasicBlock::Create(ctx(), "oa.validate", F);
+  auto *NextGroupBlock = BasicBlock::Create(ctx(), "oa.next.group", F);
+  auto *DoneBlock = BasicBlock::Create(ctx(), "oa.done", F);
+
+  IRBuilder()->CreateBr(RestartBlock);
+
+  // (re)load the table: a concurrent rehash replaces it, and makes the groups of the old one odd.
+  IRBuilder()->SetInsertPoint(RestartBlock);
+  auto *table = atomicLoad(i8Ty->getPointerTo(), fieldPtr(index, layout.index_table, i8Ty->getPointerTo()),
+                           AtomicOrdering::Acquire);
+  auto *group_mask = IRBuilder()->CreateLoad(i64Ty, fieldPtr(table, layout.table_group_mask, i64Ty));
+  auto *groups =
+      IRBuilder()->CreateLoad(i8Ty->getPointerTo(), fieldPtr(table, layout.table_groups, i8Ty->getPointerTo()));
+  auto *home_group = IRBuilder()->CreateAnd(home, group_mask);
+  IRBuilder()->CreateBr(ProbeBlock);
+
+  // one group per iteration: version, tags, then the keys of the matching tags.
+  IRBuilder()->SetInsertPoint(ProbeBlock);
+  auto *g = IRBuilder()->CreatePHI(i64Ty, 2);
+  g->addIncoming(home_group, RestartBlock);
+  auto *group_offset = IRBuilder()->CreateMul(g, IRBuilder()->getInt64(layout.group_bytes));
+  auto *group = IRBuilder()->CreateInBoundsGEP(i8Ty, groups, group_offset);
+  auto *versionPtr = fieldPtr(group, layout.group_version, i64Ty);
+  auto *version = atomicLoad(i64Ty, versionPtr, AtomicOrdering::Acquire);
+  IRBuilder()->CreateCondBr(IRBuilder()->CreateTrunc(version, IRBuilder()->getInt1Ty()), RestartBlock, MatchBlock);
+
+  IRBuilder()->SetInsertPoint(MatchBlock);
+  auto *tags = IRBuilder()->CreateAlignedLoad(tagsTy, fieldPtr(group, layout.group_tags, tagsTy), MaybeAlign(1), true);
+  auto *hits = IRBuilder()->CreateBitCast(IRBuilder()->CreateICmpEQ(tags, tagSplat), maskTy);
+  auto *empties =
+      IRBuilder()->CreateBitCast(IRBuilder()->CreateICmpEQ(tags, llvm::Constant::getNullValue(tagsTy)), maskTy);
+  auto *keys = fieldPtr(group, layout.group_keys, keyBitsTy);
+  auto *values = fieldPtr(group, layout.group_values, i64Ty);
+  IRBuilder()->CreateBr(HitLoopBlock);
+
+  IRBuilder()->SetInsertPoint(HitLoopBlock);
+  auto *pending = IRBuilder()->CreatePHI(maskTy, 2);
+  pending->addIncoming(hits, MatchBlock);
+  auto *noHit = ConstantInt::get(i64Ty, 0);
+  IRBuilder()->CreateCondBr(IRBuilder()->CreateIsNotNull(pending), HitCheckBlock, ValidateBlock);
+
+  IRBuilder()->SetInsertPoint(HitCheckBlock);
+  auto *slot = IRBuilder()->CreateZExt(
+      IRBuilder()->CreateBinaryIntrinsic(Intrinsic::cttz, pending, IRBuilder()->getTrue()), i64Ty);
+  auto *slotKey =
+      atomicLoad(keyBitsTy, IRBuilder()->CreateInBoundsGEP(keyBitsTy, keys, slot), AtomicOrdering::Monotonic);
+  IRBuilder()->CreateCondBr(IRBuilder()->CreateICmpEQ(slotKey, key_bits), HitFoundBlock, HitNextBlock);
+
+  IRBuilder()->SetInsertPoint(HitNextBlock);
+  pending->addIncoming(IRBuilder()->CreateAnd(pending, IRBuilder()->CreateSub(pending, ConstantInt::get(maskTy, 1))),
+                       HitNextBlock);
+  IRBuilder()->CreateBr(HitLoopBlock);
+
+  IRBuilder()->SetInsertPoint(HitFoundBlock);
+  auto *slotValue = atomicLoad(i64Ty, IRBuilder()->CreateInBoundsGEP(i64Ty, values, slot), AtomicOrdering::Monotonic);
+  IRBuilder()->CreateBr(ValidateBlock);
+
+  // the group did not change while it was read, otherwise restart. Done if found, or the group has an empty slot.
+  IRBuilder()->SetInsertPoint(ValidateBlock);
+  auto *result = IRBuilder()->CreatePHI(i64Ty, 2);
+  result->addIncoming(noHit, HitLoopBlock);
+  result->addIncoming(slotValue, HitFoundBlock);
+  auto *found = IRBuilder()->CreatePHI(IRBuilder()->getInt1Ty(), 2);
+  found->addIncoming(IRBuilder()->getFalse(), HitLoopBlock);
+  found->addIncoming(IRBuilder()->getTrue(), HitFoundBlock);
+  IRBuilder()->CreateFence(AtomicOrdering::Acquire);
+  auto *changed = IRBuilder()->CreateICmpNE(atomicLoad(i64Ty, versionPtr, AtomicOrdering::Monotonic), version);
+  auto *ValidBlock = BasicBlock::Create(ctx(), "oa.valid", F);
+  IRBuilder()->CreateCondBr(changed, RestartBlock, ValidBlock);
+
+  IRBuilder()->SetInsertPoint(ValidBlock);
+  IRBuilder()->CreateCondBr(IRBuilder()->CreateOr(found, IRBuilder()->CreateIsNotNull(empties)), DoneBlock,
+                            NextGroupBlock);
+
+  IRBuilder()->SetInsertPoint(NextGroupBlock);
+  g->addIncoming(IRBuilder()->CreateAnd(IRBuilder()->CreateAdd(g, IRBuilder()->getInt64(1)), group_mask),
+                 NextGroupBlock);
+  IRBuilder()->CreateBr(ProbeBlock);
+
+  IRBuilder()->SetInsertPoint(DoneBlock);
+  return result;
+}
+
+llvm::Value *LLVMCodegenStatement::inlineFilterProbe(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                                     llvm::Value *base_record_ptr, llvm::Value *index_key) {
+  // Same probe as NegativeLookupFilter::mayContain, on the filter of the index.
+  using Filter = indexes::NegativeLookupFilter;
+
+  auto *i8Ty = IRBuilder()->getInt8Ty();
+  auto *i64Ty = IRBuilder()->getInt64Ty();
+  auto fieldPtr = [&](llvm::Value *base, size_t offset, llvm::Type *ty) {
+    return IRBuilder()->CreateBitCast(IRBuilder()->CreateConstInBoundsGEP1_64(i8Ty, base, offset),
+                                      ty->getPointerTo());
+  };
+
+  auto *index = IRBuilder()->CreateIntToPtr(base_record_ptr, i8Ty->getPointerTo());
+  auto *filter = IRBuilder()->CreateLoad(i8Ty->getPointerTo(),
+                                         fieldPtr(index, indexes::IndexBase::filter_offset, i8Ty->getPointerTo()));
+  auto *words =
+      IRBuilder()->CreateLoad(i64Ty->getPointerTo(), fieldPtr(filter, Filter::layout.words, i64Ty->getPointerTo()));
+  auto *word_shift = IRBuilder()->CreateLoad(i64Ty, fieldPtr(filter, Filter::layout.word_shift, i64Ty));
+
+  llvm::Value *key_bits = index_key;
+  if (indexedList->key_bytes) {
+    // BinaryKey::fold: one multiply per word, as one vector multiply, then folded with xor.
+    auto n_words = indexedList->key_bytes / sizeof(uint64_t);
+    auto *keyWordsTy = FixedVectorType::get(i64Ty, n_words);
+    std::vector<llvm::Constant *> multipliers;
+    for (size_t i = 0; i < n_words; i++) {
+      multipliers.push_back(IRBuilder()->getInt64(indexes::BinaryKey<32>::word_multipliers[i]));
+    }
+    auto *key_words = IRBuilder()->CreateAlignedLoad(
+        keyWordsTy, IRBuilder()->CreateBitCast(index_key, keyWordsTy->getPointerTo()), MaybeAlign(sizeof(uint64_t)));
+    key_bits = IRBuilder()->CreateXorReduce(IRBuilder()->CreateMul(key_words, ConstantVector::get(multipliers)));
+  } else {
+    auto *keyBitsTy = IRBuilder()->getIntNTy(static_cast<unsigned>(indexKeyBytes(indexedList->key_type) * 8));
+    if (key_bits->getType()->isPointerTy()) key_bits = IRBuilder()->CreatePtrToInt(key_bits, keyBitsTy);
+    key_bits = IRBuilder()->CreateZExt(IRBuilder()->CreateBitCast(key_bits, keyBitsTy), i64Ty);
+  }
+  auto *h = IRBuilder()->CreateMul(key_bits, IRBuilder()->getInt64(Filter::hash_multiplier));
+  h = IRBuilder()->CreateXor(h, IRBuilder()->CreateLShr(h, 29));
+
+  auto *word = IRBuilder()->CreateAlignedLoad(
+      i64Ty, IRBuilder()->CreateInBoundsGEP(i64Ty, words, IRBuilder()->CreateLShr(h, word_shift)), MaybeAlign(8));
+  word->setAtomic(AtomicOrdering::Acquire);
+
+  // all the counters of the key are non-zero: one mask of their lowest bits, as 4-bit counters are all non-zero iff
+  // (word | word >> 1 | word >> 2 | word >> 3) has the lowest bit of each counter set.
+  auto *any = IRBuilder()->CreateOr(IRBuilder()->CreateOr(word, IRBuilder()->CreateLShr(word, 1)),
+                                    IRBuilder()->CreateOr(IRBuilder()->CreateLShr(word, 2),
+                                                          IRBuilder()->CreateLShr(word, 3)));
+  llvm::Value *mask = IRBuilder()->getInt64(0);
+  for (auto shift : Filter::counter_shifts) {
+    auto *bit = IRBuilder()->CreateShl(IRBuilder()->CreateAnd(IRBuilder()->CreateLShr(h, shift), 15), 2);
+    mask = IRBuilder()->CreateOr(mask, IRBuilder()->CreateShl(IRBuilder()->getInt64(1), bit));
+  }
+  return IRBuilder()->CreateICmpEQ(IRBuilder()->CreateAnd(any, mask), mask);
+}
+
 // RemoveIndexedStatement
 void LLVMCodegenStatement::buildStatement_RemoveIndexed(Statement *stmt) {
   auto removeStmt = reinterpret_cast<RemoveIndexedStatement *>(stmt);
@@ -332,35 +754,26 @@ void LLVMCodegenStatement::buildStatement_RemoveIndexed(Statement *stmt) {
   CHECK(sourceAttribute->type_category == ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST);
   auto attributeList = std::static_pointer_cast<AttributeList>(sourceAttribute);
 
-  auto txnManager = getArg_txnManager();
-  auto mainRecord = getArg_mainRecord();
-  auto txn = getArg_txn();
+  llvm::Value *index_key = genIndexKey(removeStmt->index_expr);
 
-  llvm::Value *index_key = LLVMExpressionVisitor::gen(build_ctx, removeStmt->index_expr);
-  if (index_key->getType()->isPointerTy()) {
-    index_key =
-        IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(removeStmt->index_expr->getResultType()), index_key);
-  }
-
-  auto *base_record = build_ctx->codegen->allocateOneVar("idx_ins_tmp_arTy", valueType::RECORD_PTR);
-
-  build_ctx->codegen->gen_call(
-      table_read_attribute,
-      {txnManager, mainRecord, txn, base_record,
-       build_ctx->codegen->createSizeT(build_ctx->current_builder->getAttributeIndex(removeStmt->source_attr))},
-      Type::getVoidTy(ctx()));
+  auto *base_record_ptr = readListBaseRecord(removeStmt->source_attr);
 
   auto indexedList = std::static_pointer_cast<AttributeIndexedList>(attributeList);
   assert(!indexedList->is_primitive_type);
 
-  auto *base_record_ptr =
-      IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(valueType::RECORD_PTR), base_record);
+  // transactional: the key is locked and the remove is only applied when the transaction commits. The removed record
+  // is looked up once the key is locked, so that it cannot change anymore until then.
+  auto hasSecondaryIndexes = !build_ctx->current_builder->getSecondaryIndexes(removeStmt->source_attr).empty();
+  llvm::AllocaInst *removed = nullptr;
+  if (hasSecondaryIndexes) removed = build_ctx->codegen->allocateScratchVar("removed_record", Type::getInt64Ty(ctx()));
 
-  // FIXME: What about CC? removing key and it fails after?
+  auto *remove_success = call_index_remove(indexedList, base_record_ptr, index_key, removed);
+  gen_conditional_abort(remove_success);
 
-  call_index_remove(indexedList->type, base_record_ptr, index_key);
-  // auto *remove_success = call_index_remove(indexedList->type, base_record_ptr, index_key);
-  // gen_conditional_abort(remove_success);
+  if (hasSecondaryIndexes) {
+    removeSecondaryEntries(indexedList, IRBuilder()->CreateLoad(Type::getInt64Ty(ctx()), removed));
+    build_ctx->codegen->releaseScratchVar(removed);
+  }
 }
 
 // InsertIndexedStatement
@@ -372,27 +785,14 @@ void LLVMCodegenStatement::buildStatement_InsertIndexed(Statement *stmt) {
   CHECK(sourceAttribute->type_category == ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST);
   auto attributeList = std::static_pointer_cast<AttributeList>(sourceAttribute);
 
-  auto txnManager = getArg_txnManager();
-  auto mainRecord = getArg_mainRecord();
-  auto txn = getArg_txn();
-
   llvm::Value *value_rec = LLVMExpressionVisitor::gen(build_ctx, insStmt->value_expr);
-  llvm::Value *index_key = LLVMExpressionVisitor::gen(build_ctx, insStmt->index_expr);
+  llvm::Value *index_key = genIndexKey(insStmt->index_expr);
 
-  auto *base_record = build_ctx->codegen->allocateOneVar("idx_ins_tmp_arTy", valueType::RECORD_PTR);
-
-  build_ctx->codegen->gen_call(
-      table_read_attribute,
-      {txnManager, mainRecord, txn, base_record,
-       build_ctx->codegen->createSizeT(build_ctx->current_builder->getAttributeIndex(insStmt->source_attr))},
-      Type::getVoidTy(ctx()));
+  auto *base_record_ptr = readListBaseRecord(insStmt->source_attr);
 
   auto indexedList = std::static_pointer_cast<AttributeIndexedList>(attributeList);
   assert(!indexedList->is_primitive_type);
 
-  auto *base_record_ptr =
-      IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(valueType::RECORD_PTR), base_record);
-
   // Here, instead of find, do an insert. what if fails?
   //  auto *record_ptr = call_index_find(indexedList->type, base_record_ptr, index_key);
   //  IRBuilder()->CreateStore(record_ptr, destination);
@@ -401,13 +801,193 @@ void LLVMCodegenStatement::buildStatement_InsertIndexed(Statement *stmt) {
   auto *value_ptr =
       IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(insStmt->value_expr->getType()), value_rec);
 
-  if (index_key->getType()->isPointerTy()) {
-    index_key =
-        IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(insStmt->index_expr->getResultType()), index_key);
+  auto *ins_success = call_index_insert(indexedList, base_record_ptr, index_key, value_ptr);
+  gen_conditional_abort(ins_success);
+
+  insertSecondaryEntries(indexedList, base_record_ptr, index_key, value_ptr);
+}
+
+void LLVMCodegenStatement::insertSecondaryEntries(const std::shared_ptr<AttributeIndexedList> &primary,
+                                                  llvm::Value *primary_base, llvm::Value *primary_key,
+                                                  llvm::Value *record) {
+  auto secondaries = build_ctx->current_builder->getSecondaryIndexes(primary->name);
+  if (secondaries.empty()) return;
+
+  // unique ones first, as they can fail on an existing key: then the entries added so far are taken back, and the
+  // insert fails as a whole. The others cannot, their keys contain the primary key.
+  std::stable_partition(secondaries.begin(), secondaries.end(), [](const auto &s) { return s->is_unique; });
+
+  lockIndexedRecord(record);
+  std::vector<std::tuple<std::shared_ptr<AttributeIndexedList>, llvm::Value *, llvm::Value *>> inserted;
+  for (const auto &secondary : secondaries) {
+    auto *base_record_ptr = readListBaseRecord(secondary->name);
+    auto *key = readRecordKey(secondary, record);
+    auto *success = call_secondary_insert(secondary, base_record_ptr, key, record);
+    if (!secondary->is_unique) {
+      gen_conditional_abort(success);
+      continue;
+    }
+
+    build_ctx->codegen->gen_if(IRBuilder()->CreateNot(success))([&]() {
+      for (const auto &[index, index_base, index_key] : inserted) {
+        call_index_remove(index, index_base, index_key);
+      }
+      call_index_remove(primary, primary_base, primary_key);
+      gen_return_false();
+    });
+    inserted.emplace_back(secondary, base_record_ptr, key);
   }
+}
 
-  auto *ins_success = call_index_insert(indexedList->type, base_record_ptr, index_key, value_ptr);
-  gen_conditional_abort(ins_success);
+void LLVMCodegenStatement::removeSecondaryEntries(const std::shared_ptr<AttributeIndexedList> &primary,
+                                                  llvm::Value *record) {
+  build_ctx->codegen->gen_if(IRBuilder()->CreateICmpNE(record, build_ctx->codegen->createSizeT(0)))([&]() {
+    lockIndexedRecord(record);
+    for (const auto &secondary : build_ctx->current_builder->getSecondaryIndexes(primary->name)) {
+      auto *base_record_ptr = readListBaseRecord(secondary->name);
+      gen_conditional_abort(call_index_remove(secondary, base_record_ptr, readRecordKey(secondary, record)));
+    }
+  });
+}
+
+std::vector<std::shared_ptr<AttributeIndexedList>> LLVMCodegenStatement::secondaryIndexesUpdatedBy(
+    const FunctionBuilder &callee) {
+  rw_set_t read_set, write_set;
+  callee.entryPoint->extractReadWriteSet_recursive(read_set, write_set);
+  const auto &written = write_set[callee.builder->getName()];
+
+  auto secondaries = build_ctx->current_builder->getSecondaryIndexes();
+  std::erase_if(secondaries, [&](const auto &secondary) {
+    return secondary->composite_type->getName() != callee.builder->getName() ||
+           std::none_of(secondary->key_parts.begin(), secondary->key_parts.end(),
+                        [&](const CompositeKeyPart &part) { return written.contains(part.attribute); });
+  });
+  return secondaries;
+}
+
+void LLVMCodegenStatement::updateSecondaryEntries(const std::vector<std::shared_ptr<AttributeIndexedList>> &secondaries,
+                                                  llvm::Value *record,
+                                                  const std::map<std::string, llvm::Value *> &old_values) {
+  auto type = secondaries.front()->composite_type;
+  std::map<std::string, llvm::Value *> new_values;
+  for (const auto &[attribute, value] : old_values) {
+    new_values.emplace(attribute, readRecordAttribute(type, record, attribute));
+  }
+
+  // only records in the primary list have entries, e.g., not the ones being initialized before their insert.
+  std::map<std::string, llvm::Value *> in_primary;
+  for (const auto &secondary : secondaries) {
+    if (in_primary.contains(secondary->primary_list)) continue;
+    auto primary = std::static_pointer_cast<AttributeIndexedList>(
+        build_ctx->current_builder->getAttribute(secondary->primary_list));
+    auto *found = call_index_find(primary, readListBaseRecord(primary->name), readRecordKey(primary, record));
+    in_primary.emplace(secondary->primary_list, IRBuilder()->CreateICmpEQ(found, record));
+  }
+
+  struct entry_t {
+    std::shared_ptr<AttributeIndexedList> index;
+    llvm::Value *base_record_ptr, *old_key, *new_key, *changed;
+  };
+  std::vector<entry_t> entries;
+  for (const auto &secondary : secondaries) {
+    auto *old_key = packRecordKey(secondary, old_values);
+    auto *new_key = packRecordKey(secondary, new_values);
+    entries.push_back({secondary, readListBaseRecord(secondary->name), old_key, new_key,
+                       IRBuilder()->CreateAnd(in_primary[secondary->primary_list],
+                                              indexKeysDiffer(secondary, old_key, new_key))});
+  }
+  std::stable_partition(entries.begin(), entries.end(), [](const entry_t &e) { return e.index->is_unique; });
+
+  // new keys of the unique indexes first, if one exists already, the update is taken back and the call fails.
+  auto *success = build_ctx->codegen->allocateScratchVar("idx_upd_success", Type::getInt1Ty(ctx()));
+  for (size_t i = 0; i < entries.size() && entries[i].index->is_unique; i++) {
+    auto &e = entries[i];
+    IRBuilder()->CreateStore(build_ctx->codegen->createTrue(), success);
+    build_ctx->codegen->gen_if(e.changed)([&]() {
+      IRBuilder()->CreateStore(call_index_insert(e.index, e.base_record_ptr, e.new_key, record), success);
+    });
+
+    build_ctx->codegen->gen_if(IRBuilder()->CreateNot(IRBuilder()->CreateLoad(Type::getInt1Ty(ctx()), success)))([&]() {
+      for (size_t j = 0; j < i; j++) {
+        build_ctx->codegen->gen_if(entries[j].changed)([&]() {
+          call_index_remove(entries[j].index, entries[j].base_record_ptr, entries[j].new_key);
+        });
+      }
+      for (const auto &[attribute, value] : old_values) {
+        auto *restore_tmp = build_ctx->codegen->allocateScratchVar("idx_restore_tmp", value->getType());
+        IRBuilder()->CreateStore(value, restore_tmp);
+        build_ctx->codegen->gen_call(
+            table_write_attribute,
+            {getArg_txnManager(), record, getArg_txn(),
+             IRBuilder()->CreateBitCast(restore_tmp, llvm::Type::getInt8PtrTy(ctx())),
+             build_ctx->codegen->createSizeT(type->getAttributeIndex(attribute))},
+            Type::getVoidTy(ctx()));
+        build_ctx->codegen->releaseScratchVar(restore_tmp);
+      }
+      gen_return_false();
+    });
+  }
+  build_ctx->codegen->releaseScratchVar(success);
+
+  for (const auto &e : entries) {
+    build_ctx->codegen->gen_if(e.changed)([&]() {
+      gen_conditional_abort(call_index_remove(e.index, e.base_record_ptr, e.old_key));
+      if (!e.index->is_unique) {
+        gen_conditional_abort(call_secondary_insert(e.index, e.base_record_ptr, e.new_key, record));
+      }
+    });
+  }
+}
+
+llvm::Value *LLVMCodegenStatement::readRecordAttribute(const std::shared_ptr<Builder> &type, llvm::Value *record,
+                                                       const std::string &attribute_name) {
+  auto *attributeTy = build_ctx->codegen->DcdsToLLVMType(type->getAttribute(attribute_name)->type);
+  auto *value_tmp = build_ctx->codegen->allocateScratchVar("idx_attr_tmp", attributeTy);
+  build_ctx->codegen->gen_call(table_read_attribute,
+                               {getArg_txnManager(), record, getArg_txn(), value_tmp,
+                                build_ctx->codegen->createSizeT(type->getAttributeIndex(attribute_name))},
+                               Type::getVoidTy(ctx()));
+  auto *value = IRBuilder()->CreateLoad(attributeTy, value_tmp);
+  build_ctx->codegen->releaseScratchVar(value_tmp);
+  return value;
+}
+
+llvm::Value *LLVMCodegenStatement::readRecordKey(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                                 llvm::Value *record) {
+  if (!indexedList->isCompositeKey()) {
+    return readRecordAttribute(indexedList->composite_type, record, indexedList->key_attribute);
+  }
+
+  std::map<std::string, llvm::Value *> values;
+  for (const auto &part : indexedList->key_parts) {
+    values.emplace(part.attribute, readRecordAttribute(indexedList->composite_type, record, part.attribute));
+  }
+  return packRecordKey(indexedList, values);
+}
+
+llvm::Value *LLVMCodegenStatement::packRecordKey(const std::shared_ptr<AttributeIndexedList> &indexedList,
+                                                 const std::map<std::string, llvm::Value *> &values) {
+  std::vector<llvm::Value *> parts;
+  std::vector<uint32_t> bits;
+  for (const auto &part : indexedList->key_parts) {
+    parts.push_back(values.at(part.attribute));
+    bits.push_back(part.bits);
+  }
+  if (indexedList->key_bytes) {
+    auto *key = build_ctx->codegen->createEntryBlockAlloca(
+        "record_key", ArrayType::get(Type::getInt64Ty(ctx()), indexedList->key_bytes / sizeof(uint64_t)));
+    LLVMExpressionVisitor::packBinaryKey(IRBuilder(), key, parts, bits, indexedList->key_bytes);
+    return key;
+  }
+  return LLVMExpressionVisitor::packCompositeKey(IRBuilder(), parts, bits);
+}
+
+void LLVMCodegenStatement::lockIndexedRecord(llvm::Value *record) {
+  auto txn = getArg_txn();
+  build_ctx->codegen->gen_if(IRBuilder()->CreateIsNotNull(txn))([&]() {
+    gen_conditional_abort(build_ctx->codegen->gen_call(lock_exclusive, {getArg_txnManager(), txn, record},
+                                                       build_ctx->codegen->DcdsToLLVMType(valueType::BOOL)));
+  });
 }
 
 void LLVMCodegenStatement::buildStatement_ReadIndexed(Statement *stmt) {
@@ -418,33 +998,22 @@ void LLVMCodegenStatement::buildStatement_ReadIndexed(Statement *stmt) {
   auto attributeList = std::static_pointer_cast<AttributeList>(sourceAttribute);
 
   auto txnManager = getArg_txnManager();
-  auto mainRecord = getArg_mainRecord();
   auto txn = getArg_txn();
   llvm::Value *destination = LLVMExpressionVisitor::gen(build_ctx, readStmt->dest_expr);
 
-  auto *base_record = build_ctx->codegen->allocateOneVar("idx_read_tmp_arTy", valueType::RECORD_PTR);
-
-  build_ctx->codegen->gen_call(
-      table_read_attribute,
-      {txnManager, mainRecord, txn, base_record,
-       build_ctx->codegen->createSizeT(build_ctx->current_builder->getAttributeIndex(readStmt->source_attr))},
-      Type::getVoidTy(ctx()));
-
-  llvm::Value *index_key = LLVMExpressionVisitor::gen(build_ctx, readStmt->index_expr);
-  if (index_key->getType()->isPointerTy()) {
-    index_key =
-        IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(readStmt->index_expr->getResultType()), index_key);
-  }
+  auto *base_record_ptr = readListBaseRecord(readStmt->source_attr);
+  llvm::Value *index_key = genIndexKey(readStmt->index_expr);
 
   // now we have the pointer to actual table in record_ptr
   if (readStmt->integer_indexed) {
     auto attributeArray = std::static_pointer_cast<AttributeArray>(attributeList);
 
     if (attributeArray->is_primitive_type) {
-      assert(false);  // directly read the thing in the nth index.
+      // elements are stored densely, so the read is a plain load which LLVM can hoist/vectorize in loops.
+      auto *elementTy = build_ctx->codegen->DcdsToLLVMType(attributeArray->simple_type->type);
+      auto *element = primitiveArrayElement(attributeArray, index_key);
+      IRBuilder()->CreateStore(IRBuilder()->CreateLoad(elementTy, element), destination);
     } else {
-      auto *base_record_ptr =
-          IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(valueType::RECORD_PTR), base_record);
       auto *record_ptr = build_ctx->codegen->gen_call(
           table_get_nth_record, {txnManager, base_record_ptr, txn, index_key}, Type::getInt64Ty(ctx()));
       IRBuilder()->CreateStore(record_ptr, destination);
@@ -455,13 +1024,97 @@ void LLVMCodegenStatement::buildStatement_ReadIndexed(Statement *stmt) {
     auto indexedList = std::static_pointer_cast<AttributeIndexedList>(attributeList);
     assert(!indexedList->is_primitive_type);
 
-    auto *base_record_ptr =
-        IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(valueType::RECORD_PTR), base_record);
+    // The filter and the inline probe only see the index, i.e., the committed entries: they serve the lookups unless
+    // the transaction wrote index entries, which it finds first (index_find_txn).
+    auto genFind = [&]() {
+      if (indexedList->index_type == hints::IndexHints::OPEN_ADDRESSING) {
+        return inlineIndexFind(indexedList->key_type, base_record_ptr, index_key);
+      } else {
+        return call_index_find(indexedList, base_record_ptr, index_key);
+      }
+    };
+
+    auto *txn_has_writes = build_ctx->codegen->gen_call(index_txn_has_writes, {txn}, Type::getInt1Ty(ctx()));
+    build_ctx->codegen->gen_if(IRBuilder()->CreateNot(txn_has_writes))([&]() {
+      if (indexedList->size_hints.negative_lookup_filter) {
+        // absent keys (usually) stop at the filter: the index is only probed if the filter may contain the key.
+        IRBuilder()->CreateStore(build_ctx->codegen->createSizeT(0), destination);
+        build_ctx->codegen->gen_if(inlineFilterProbe(indexedList, base_record_ptr, index_key))(
+            [&]() { IRBuilder()->CreateStore(genFind(), destination); });
+      } else {
+        IRBuilder()->CreateStore(genFind(), destination);
+      }
+    });
+    build_ctx->codegen->gen_if(txn_has_writes)([&]() {
+      IRBuilder()->CreateStore(call_index_find(indexedList, base_record_ptr, index_key), destination);
+    });
+  }
+}
 
-    auto *record_ptr = call_index_find(indexedList->type, base_record_ptr, index_key);
+// Loads through the element pointer are ordered against transactional writes and locks, as those runtime calls may
+// clobber any memory (see llvm-runtime-attributes.cpp).
+llvm::Value *LLVMCodegenStatement::primitiveArrayElement(const std::shared_ptr<AttributeArray> &attributeArray,
+                                                         llvm::Value *index) {
+  auto *elementTy = build_ctx->codegen->DcdsToLLVMType(attributeArray->simple_type->type);
+  auto genColumn = [&]() -> llvm::Value * {
+    return build_ctx->codegen->gen_call(table_get_column,
+                                        {readListBaseRecord(attributeArray->name), build_ctx->codegen->createSizeT(0)},
+                                        Type::getInt8PtrTy(ctx()));
+  };
+
+  // The column never moves, and outside the singleton functions (which construct the array) its base record is a
+  // runtime constant, so its address is looked up once per function: loops over the array then index one base
+  // pointer, and vectorize, rather than calling into the runtime for every element.
+  auto *column = build_ctx->current_fb->isSingleton()
+                     ? genColumn()
+                     : build_ctx->getFunctionContext()->getEntryBlockValue("column." + attributeArray->name, genColumn);
+  auto *elements = IRBuilder()->CreateBitCast(column, elementTy->getPointerTo());
+  return IRBuilder()->CreateInBoundsGEP(elementTy, elements, index);
+}
+
+// UpdateIndexedStatement
+void LLVMCodegenStatement::buildStatement_UpdateIndexed(Statement *stmt) {
+  auto updStmt = reinterpret_cast<UpdateIndexedStatement *>(stmt);
+  CHECK(build_ctx->current_builder->hasAttribute(updStmt->destination_attr)) << "write attribute does not exists";
+  auto destinationAttribute = build_ctx->current_builder->getAttribute(updStmt->destination_attr);
+  CHECK(destinationAttribute->type_category == ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST);
+  auto attributeArray = std::static_pointer_cast<AttributeArray>(destinationAttribute);
+  CHECK(attributeArray->is_primitive_type) << "indexed update is only supported on arrays of primitives";
+
+  auto txnManager = getArg_txnManager();
+  auto txn = getArg_txn();
+  auto *elementTy = build_ctx->codegen->DcdsToLLVMType(attributeArray->simple_type->type);
+
+  llvm::Value *source = LLVMExpressionVisitor::gen(build_ctx, updStmt->source_expr);
+  if (source->getType()->isPointerTy()) {
+    source = IRBuilder()->CreateLoad(elementTy, source);
+  }
 
-    IRBuilder()->CreateStore(record_ptr, destination);
+  llvm::Value *index_key = LLVMExpressionVisitor::gen(build_ctx, updStmt->index_expr);
+  if (index_key->getType()->isPointerTy()) {
+    index_key =
+        IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(updStmt->index_expr->getResultType()), index_key);
   }
+
+  auto *base_record_ptr = readListBaseRecord(updStmt->destination_attr);
+
+  // without a transaction (single-threaded), there is nothing to log: store straight into the column. Otherwise,
+  // write through the table so that the old value is logged for abort.
+  auto *update_tmp = build_ctx->codegen->allocateScratchVar("upd_idx_tmp", elementTy);
+  build_ctx->codegen
+      ->gen_if(IRBuilder()->CreateIsNull(txn))(
+          [&]() {
+            IRBuilder()->CreateStore(source, primitiveArrayElement(attributeArray, index_key));
+          })
+      .gen_else([&]() {
+        IRBuilder()->CreateStore(source, update_tmp);
+        build_ctx->codegen->gen_call(table_write_attribute_offset,
+                                     {txnManager, base_record_ptr, txn,
+                                      IRBuilder()->CreateBitCast(update_tmp, llvm::Type::getInt8PtrTy(ctx())),
+                                      IRBuilder()->getInt32(0), index_key},
+                                     Type::getVoidTy(ctx()));
+      });
+  build_ctx->codegen->releaseScratchVar(update_tmp);
 }
 
 void LLVMCodegenStatement::buildStatement_Update(Statement *stmt) {
@@ -473,15 +1126,16 @@ void LLVMCodegenStatement::buildStatement_Update(Statement *stmt) {
   CHECK(build_ctx->current_builder->hasAttribute(updStmt->destination_attr)) << "write attribute does not exists";
 
   llvm::Value *updateSource;
+  llvm::AllocaInst *update_tmp = nullptr;
   llvm::Value *source = LLVMExpressionVisitor::gen(build_ctx, updStmt->source_expr);
 
   if (source->getType()->isPointerTy()) {
     updateSource = IRBuilder()->CreateBitCast(source, llvm::Type::getInt8PtrTy(ctx()));
   } else {
     // NOTE: because are update function expects a void* to the src, we need to create a temporary allocation.
-    llvm::AllocaInst *allocaInst = IRBuilder()->CreateAlloca(source->getType());
-    IRBuilder()->CreateStore(source, allocaInst);
-    updateSource = IRBuilder()->CreateBitCast(allocaInst, llvm::Type::getInt8PtrTy(ctx()));
+    update_tmp = build_ctx->codegen->allocateScratchVar("upd_tmp", source->getType());
+    IRBuilder()->CreateStore(source, update_tmp);
+    updateSource = IRBuilder()->CreateBitCast(update_tmp, llvm::Type::getInt8PtrTy(ctx()));
   }
 
   //    extern "C" void table_write_attribute(void* _txnManager, uintptr_t _mainRecord, void*
@@ -492,6 +1146,7 @@ void LLVMCodegenStatement::buildStatement_Update(Statement *stmt) {
       {txnManager, mainRecord, txn, updateSource,
        build_ctx->codegen->createSizeT(build_ctx->current_builder->getAttributeIndex(updStmt->destination_attr))},
       Type::getVoidTy(ctx()));
+  if (update_tmp) build_ctx->codegen->releaseScratchVar(update_tmp);
 }
 
 void LLVMCodegenStatement::buildStatement_LogString(Statement *stmt) {
@@ -592,6 +1247,20 @@ void LLVMCodegenStatement::buildStatement_MethodCall(Statement *stmt) {
 
   callArgs.push_back(txn);
 
+  // updates of key attributes of records in an indexed list move their entries in its secondary indexes.
+  auto updatedSecondaryIndexes = secondaryIndexesUpdatedBy(*fn_instance);
+  std::map<std::string, llvm::Value *> old_key_values;
+  if (!updatedSecondaryIndexes.empty()) {
+    lockIndexedRecord(callArgs[1]);
+    for (const auto &secondary : updatedSecondaryIndexes) {
+      for (const auto &part : secondary->key_parts) {
+        if (old_key_values.contains(part.attribute)) continue;
+        old_key_values.emplace(part.attribute,
+                               readRecordAttribute(secondary->composite_type, callArgs[1], part.attribute));
+      }
+    }
+  }
+
   // --- call statement return value
   bool doesReturn = true;
   llvm::Value *returnValueArg;
@@ -656,6 +1325,8 @@ void LLVMCodegenStatement::buildStatement_MethodCall(Statement *stmt) {
     IRBuilder()->CreateBr(build_ctx->getFunctionContext()->GetReturnBlock());
   });
 
+  if (!updatedSecondaryIndexes.empty()) updateSecondaryEntries(updatedSecondaryIndexes, callArgs[1], old_key_values);
+
   if (doesReturn) {
     if (!(isa<PointerType>(ret_dest_expr->getType()))) {
       auto retLoadIns = IRBuilder()->CreateLoad(
@@ -673,26 +1344,44 @@ void LLVMCodegenStatement::buildStatement_CC_Lock(Statement *stmt) {
   auto lockStmt = reinterpret_cast<LockStatement2 *>(stmt);
 
   // FIXME: is the mainRecord the record we want to lock?
+  llvm::Value *lockRecord = mainRecord;
+  if (lockStmt->index_expr) {
+    // element lock of a primitive array: lock the metadata of the stripe's slot instead of the owner record.
+    auto attributeArray =
+        std::static_pointer_cast<AttributeArray>(build_ctx->current_builder->getAttribute(lockStmt->attribute));
+    CHECK(attributeArray->lock_stripes > 0);
+
+    llvm::Value *index_key = LLVMExpressionVisitor::gen(build_ctx, lockStmt->index_expr);
+    if (index_key->getType()->isPointerTy()) {
+      index_key = IRBuilder()->CreateLoad(build_ctx->codegen->DcdsToLLVMType(lockStmt->index_expr->getResultType()),
+                                          index_key);
+    }
+    auto *stripe = IRBuilder()->CreateURem(index_key, build_ctx->codegen->createSizeT(attributeArray->lock_stripes));
+    lockRecord = build_ctx->codegen->gen_call(table_get_nth_record,
+                                              {txnManager, readListBaseRecord(lockStmt->attribute), txn, stripe},
+                                              Type::getInt64Ty(ctx()));
+  }
 
   // void* _txnManager, void* txnPtr, uintptr_t record, size_t attributeIdx
   llvm::Value *ret = build_ctx->codegen->gen_call(
       // lockStmt->stType == dcds::statementType::CC_LOCK_SHARED ? lock_shared : lock_exclusive,
       lockStmt->is_exclusive ? lock_exclusive : lock_shared,
       {txnManager, txn,
-       mainRecord /*, this->createSizeT(build_ctx->current_builder->getAttributeIndex(lockStmt->attribute))*/},
+       lockRecord /*, this->createSizeT(build_ctx->current_builder->getAttributeIndex(lockStmt->attribute))*/},
       build_ctx->codegen->DcdsToLLVMType(valueType::BOOL));
 
   // (ret == false) goto returnBB;
   gen_conditional_abort(ret);
 }
 
+void LLVMCodegenStatement::gen_return_false() {
+  IRBuilder()->CreateStore(build_ctx->codegen->createFalse(), build_ctx->getFunctionContext()->getReturnVariable());
+  IRBuilder()->CreateBr(build_ctx->getFunctionContext()->GetReturnBlock());
+}
+
 void LLVMCodegenStatement::gen_conditional_abort(llvm::Value *do_continue) {
   // (ret == false) goto returnBB;
-  auto genIf = build_ctx->codegen->gen_if(IRBuilder()->CreateNot(do_continue))([&]() {
-    IRBuilder()->CreateStore(build_ctx->codegen->createFalse(), build_ctx->getFunctionContext()->getReturnVariable());
-
-    IRBuilder()->CreateBr(build_ctx->getFunctionContext()->GetReturnBlock());
-  });
+  auto genIf = build_ctx->codegen->gen_if(IRBuilder()->CreateNot(do_continue))([&]() { gen_return_false(); });
 }
 
 }  // namespace dcds
@@ -23,6 +23,8 @@
 
 #include <llvm/IR/Instructions.h>
 
+#include <algorithm>
+#include <optional>
 #include <utility>
 
 #include "dcds/builder/function-builder.hpp"
@@ -41,12 +43,40 @@ static constexpr bool print_debug_log = false;
 namespace dcds {
 
 void LLVMCodegen::saveToFile(const std::string &filename) {
+  auto lock = theLLVMContext.getLock();
   std::error_code errorCode;
   llvm::raw_fd_ostream outLL(filename, errorCode);
   theLLVMModule->print(outLL, nullptr);
 }
 
-void LLVMCodegen::printIR() { theLLVMModule->print(llvm::outs(), nullptr); }
+void LLVMCodegen::emitObjectFile(const std::string &filename) {
+  auto lock = theLLVMContext.getLock();
+  CHECK(theLLVMModule) << "Module is already handed over to the JIT";
+
+  // Same target and pipeline as the JIT, but position-independent so that the object can be linked into
+  // executables and shared libraries.
+  auto JTMB = optimization_config.getTargetMachineBuilder(
+      llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()));
+  JTMB.setRelocationModel(llvm::Reloc::PIC_);
+
+  auto TM = llvm::cantFail(JTMB.createTargetMachine());
+  theLLVMModule->setDataLayout(TM->createDataLayout());
+  LLVMOptimizer::optimize(*theLLVMModule, *TM, optimization_config);
+
+  std::error_code errorCode;
+  llvm::raw_fd_ostream out(filename, errorCode, llvm::sys::fs::OF_None);
+  CHECK(!errorCode) << "Cannot open output file: " << filename << " (" << errorCode.message() << ")";
+
+  llvm::legacy::PassManager pm;
+  CHECK(!TM->addPassesToEmitFile(pm, out, nullptr, llvm::CGFT_ObjectFile)) << "Target cannot emit object files";
+  pm.run(*theLLVMModule);
+  out.flush();
+}
+
+void LLVMCodegen::printIR() {
+  auto lock = theLLVMContext.getLock();
+  theLLVMModule->print(llvm::outs(), nullptr);
+}
 
 llvm::Type *LLVMCodegen::DcdsToLLVMType(dcds::valueType dcds_type, bool is_reference) {
   llvm::Type *ty;
@@ -84,51 +114,36 @@ void LLVMCodegen::initializeLLVMModule(const std::string &name) {
   llvm::InitializeNativeTarget();
   llvm::InitializeNativeTargetAsmPrinter();
 
-  theLLVMContext = std::make_unique<LLVMContext>();
+  // All builders generate code into the context of the process-wide JIT, which is also used by its compile threads.
+  jitEngine = LLVMJIT::getInstance();
+  theLLVMContext = jitEngine->getContext();
+  auto lock = theLLVMContext.getLock();
 
-  theLLVMModule = std::make_unique<Module>(name, *theLLVMContext);
+  theLLVMModule = std::make_unique<Module>(name, *theLLVMContext.getContext());
   assert(theLLVMModule.get());
-  llvmBuilder = std::make_unique<IRBuilder<>>(*theLLVMContext);
+  llvmBuilder = std::make_unique<IRBuilder<>>(*theLLVMContext.getContext());
   assert(llvmBuilder.get());
 }
 
-LLVMCodegen::LLVMCodegen(Builder *builder) : Codegen(builder), LLVMCodegenContext(builder->getName()) {
+LLVMCodegen::LLVMCodegen(Builder *builder)
+    : Codegen(builder),
+      LLVMCodegenContext(builder->getName()),
+      optimization_config{builder->getOptimizationProfile(), builder->getTargetHint()} {
   // LOG_IF(INFO, print_debug_log) << "[LLVMCodegen] constructor: " << this->moduleName;
   initializeLLVMModule(builder->getName());
-  initializePassManager();
+  auto lock = theLLVMContext.getLock();
   this->registerAllFunctions();
 }
 
 llvm::Module *LLVMCodegen::getModule() const { return theLLVMModule.get(); }
 llvm::IRBuilder<> *LLVMCodegen::getBuilder() const { return llvmBuilder.get(); }
 
-void LLVMCodegen::initializePassManager() {
-  LOG_IF(INFO, print_debug_log) << "[LLVMCodegen] Initializing LLVM pass manager";
-  assert(theLLVMModule.get());
-  /// Create a new pass manager.
-  theLLVMFPM = std::make_unique<legacy::FunctionPassManager>(theLLVMModule.get());
-
-  /// Promote allocas to registers.
-  theLLVMFPM->add(createPromoteMemoryToRegisterPass());
-  /// Do simple "peephole" optimizations and bit-twiddling optimizations.
-  theLLVMFPM->add(createInstructionCombiningPass());
-  /// Re-associate expressions.
-  theLLVMFPM->add(createReassociatePass());
-  /// Eliminate Common SubExpressions.
-  theLLVMFPM->add(createGVNPass());
-  /// Simplify the control flow graph (deleting unreachable blocks, etc).
-  theLLVMFPM->add(createCFGSimplificationPass());
-
-  theLLVMFPM->add(createDeadCodeEliminationPass());
-
-  theLLVMFPM->doInitialization();
-}
-
 void LLVMCodegen::build(dcds::Builder *builder, bool is_nested_type) {
   if (!builder) {
     builder = this->top_level_builder;
   }
   LOG_IF(INFO, print_debug_log) << "[LLVMCodegen] Building: " << builder->getName();
+  auto lock = theLLVMContext.getLock();
 
   // codegenHelloWorld();
 
@@ -138,6 +153,11 @@ void LLVMCodegen::build(dcds::Builder *builder, bool is_nested_type) {
   LOG_IF(INFO, print_debug_log) << "[LLVMCodegen::build()] buildConstructor";
   this->buildConstructor(*builder, is_nested_type);
 
+  if (!is_nested_type) {
+    LOG_IF(INFO, print_debug_log) << "[LLVMCodegen::build()] buildBulkLoaders";
+    this->buildBulkLoaders(*builder);
+  }
+
   LOG_IF(INFO, print_debug_log) << "[LLVMCodegen::build()] BuildFunctions";
   this->buildFunctions(builder, is_nested_type);
   LOG_IF(INFO, print_debug_log) << "[LLVMCodegen::build()] DONE";
@@ -261,6 +281,10 @@ llvm::Function *LLVMCodegen::buildOneFunction_outer(dcds::Builder *builder, std:
     function_ret_value_arg = allocateOneVar("function_ret_value_arg", fb->getReturnValueType(), {});
   }
 
+  // concurrent operations pin the epoch once, for all the index probes and records of the operation and its retries.
+  llvm::Value *is_pinned = nullptr;
+  if (genCC) is_pinned = this->gen_call(epoch_pin, {}, Type::getInt1Ty(getLLVMContext()));
+
   this->gen_do([&]() {
         if (genCC) {
           txnPtr = this->gen_call(beginTxn, {fn_outer->getArg(0), arg_is_readOnly});
@@ -293,6 +317,8 @@ llvm::Function *LLVMCodegen::buildOneFunction_outer(dcds::Builder *builder, std:
         }
       });
 
+  if (genCC) this->gen_if(is_pinned)([&]() { this->gen_call(epoch_unpin, {}, Type::getVoidTy(getLLVMContext())); });
+
   if (fb->returnValueType == valueType::VOID) {
     getBuilder()->CreateRetVoid();
   } else {
@@ -421,9 +447,12 @@ llvm::Value *LLVMCodegen::allocateOneVar(const std::string &var_name, dcds::valu
   LOG_IF(INFO, print_debug_log) << "[LLVMCodegen] allocateOneVar temp-var: " << var_name << "::" << var_type
                                 << " | has_value: " << has_value;
 
+  // NOTE: the slot is hoisted to the entry block, but the initial value is stored at the current insertion point, so
+  //  a variable allocated inside a loop body is still re-initialized in every iteration.
+
   switch (var_type) {
     case dcds::valueType::INT64: {
-      auto vr = getBuilder()->CreateAlloca(llvm::Type::getInt64Ty(getLLVMContext()), nullptr, var_name);
+      auto vr = createEntryBlockAlloca(var_name, llvm::Type::getInt64Ty(getLLVMContext()));
       if (has_value) {
         auto value = createInt64(std::any_cast<uint64_t>(init_value));
         getBuilder()->CreateStore(value, vr);
@@ -431,13 +460,13 @@ llvm::Value *LLVMCodegen::allocateOneVar(const std::string &var_name, dcds::valu
       return vr;
     }
     case dcds::valueType::RECORD_PTR: {
-      auto vr = getBuilder()->CreateAlloca(llvm::Type::getInt64Ty(getLLVMContext()), nullptr, var_name);
+      auto vr = createEntryBlockAlloca(var_name, llvm::Type::getInt64Ty(getLLVMContext()));
       // Initialize all pointers to zero for safe size!
       getBuilder()->CreateStore(createInt64(UINT64_C(0)), vr);
       return vr;
     }
     case dcds::valueType::INT32: {
-      auto vr = getBuilder()->CreateAlloca(llvm::Type::getInt32Ty(getLLVMContext()), nullptr, var_name);
+      auto vr = createEntryBlockAlloca(var_name, llvm::Type::getInt32Ty(getLLVMContext()));
       if (has_value) {
         auto value = createInt32(std::any_cast<int32_t>(init_value));
         getBuilder()->CreateStore(value, vr);
@@ -446,7 +475,7 @@ llvm::Value *LLVMCodegen::allocateOneVar(const std::string &var_name, dcds::valu
     }
     case dcds::valueType::BOOL: {
       auto bool_type = llvm::Type::getInt1Ty(getLLVMContext());
-      auto vr = getBuilder()->CreateAlloca(bool_type, nullptr, var_name);
+      auto vr = createEntryBlockAlloca(var_name, bool_type);
       if (has_value) {
         auto value = std::any_cast<bool>(init_value) ? createTrue() : createFalse();
         getBuilder()->CreateStore(value, vr);
@@ -454,7 +483,7 @@ llvm::Value *LLVMCodegen::allocateOneVar(const std::string &var_name, dcds::valu
       return vr;
     }
     case dcds::valueType::FLOAT: {
-      auto vr = getBuilder()->CreateAlloca(llvm::Type::getFloatTy(getLLVMContext()), nullptr, var_name);
+      auto vr = createEntryBlockAlloca(var_name, llvm::Type::getFloatTy(getLLVMContext()));
       if (has_value) {
         auto value = createFloat(std::any_cast<float>(init_value));
         getBuilder()->CreateStore(value, vr);
@@ -462,7 +491,7 @@ llvm::Value *LLVMCodegen::allocateOneVar(const std::string &var_name, dcds::valu
       return vr;
     }
     case dcds::valueType::DOUBLE: {
-      auto vr = getBuilder()->CreateAlloca(llvm::Type::getDoubleTy(getLLVMContext()), nullptr, var_name);
+      auto vr = createEntryBlockAlloca(var_name, llvm::Type::getDoubleTy(getLLVMContext()));
       if (has_value) {
         auto value = createDouble(std::any_cast<double>(init_value));
         getBuilder()->CreateStore(value, vr);
@@ -474,6 +503,14 @@ llvm::Value *LLVMCodegen::allocateOneVar(const std::string &var_name, dcds::valu
   }
 }
 
+llvm::AllocaInst *LLVMCodegen::allocateScratchVar(const std::string &var_name, llvm::Type *type) {
+  auto *vr = createEntryBlockAlloca(var_name, type);
+  getBuilder()->CreateLifetimeStart(vr);
+  return vr;
+}
+
+void LLVMCodegen::releaseScratchVar(llvm::AllocaInst *var) { getBuilder()->CreateLifetimeEnd(var); }
+
 std::map<std::string, llvm::Value *> LLVMCodegen::allocateTemporaryVariables(std::shared_ptr<FunctionBuilder> &fb,
                                                                              llvm::BasicBlock *basicBlock) {
   std::map<std::string, llvm::Value *> variableCodeMap;
@@ -575,7 +612,8 @@ Value *LLVMCodegen::initializeDsValueStructDefault(dcds::Builder &builder) {
 }
 
 llvm::Function *LLVMCodegen::genInitStorageFn(const std::string &function_name_prefix, llvm::Value *table_name,
-                                              const std::map<std::string, std::shared_ptr<Attribute>> &attributes) {
+                                              const std::map<std::string, std::shared_ptr<Attribute>> &attributes,
+                                              uint32_t layout_flags) {
   auto function_name = function_name_prefix + "_init_storage";
   auto fn_type =
       llvm::FunctionType::get(llvm::Type::getInt8PtrTy(getLLVMContext()), std::vector<llvm::Type *>{}, false);
@@ -593,11 +631,16 @@ llvm::Function *LLVMCodegen::genInitStorageFn(const std::string &function_name_p
   Type *cppEnumType = Type::getInt32Ty(getLLVMContext());
   ArrayType *enumArrayType = ArrayType::get(cppEnumType, attributes.size());
 
+  Type *boolType = Type::getInt8Ty(getLLVMContext());  // C++ bool
+  ArrayType *coldArrayType = ArrayType::get(boolType, attributes.size());
+
   std::vector<Constant *> valueTypeArray;
+  std::vector<Constant *> isColdArray;
   std::vector<std::string> names;
 
   for (const auto &a : attributes) {
     valueTypeArray.push_back(ConstantInt::get(cppEnumType, std::to_underlying(a.second->type)));
+    isColdArray.push_back(ConstantInt::get(boolType, a.second->is_cold));
     names.push_back(a.first);
   }
 
@@ -608,11 +651,16 @@ llvm::Function *LLVMCodegen::genInitStorageFn(const std::string &function_name_p
                          ConstantInt::get(Type::getInt32Ty(getLLVMContext()), 0)};
   Value *elementPtrAttributeType = getBuilder()->CreateGEP(enumArrayType, allocaInstAttributeTypes, gepIndices);
 
+  AllocaInst *allocaInstIsCold = getBuilder()->CreateAlloca(coldArrayType, nullptr, "attributeIsColdArray");
+  getBuilder()->CreateStore(ConstantArray::get(coldArrayType, isColdArray), allocaInstIsCold);
+  Value *elementPtrIsCold = getBuilder()->CreateGEP(coldArrayType, allocaInstIsCold, gepIndices);
+
   llvm::Value *attributeNames = createStringArray(names, function_name_prefix + "_attr_");
   llvm::Value *attributeNamesFirstCharPtr = getBuilder()->CreateExtractValue(attributeNames, {0});
 
-  llvm::Value *resultPtr = this->gen_call(
-      createTablesInternal, {tableNameCharPtr, elementPtrAttributeType, attributeNamesFirstCharPtr, numAttributes});
+  llvm::Value *resultPtr =
+      this->gen_call(createTablesInternal, {tableNameCharPtr, elementPtrAttributeType, attributeNamesFirstCharPtr,
+                                            elementPtrIsCold, numAttributes, createInt32(layout_flags)});
 
   // return the table*
   getBuilder()->CreateRet(resultPtr);
@@ -622,49 +670,7 @@ llvm::Function *LLVMCodegen::genInitStorageFn(const std::string &function_name_p
 }
 
 llvm::Function *LLVMCodegen::buildInitTablesFn(dcds::Builder &builder, llvm::Value *table_name) {
-  auto function_name = builder.getName() + "_init_storage";
-  auto returnType = llvm::Type::getInt8PtrTy(getLLVMContext());
-  auto fn_type = llvm::FunctionType::get(returnType, std::vector<llvm::Type *>{}, false);
-  auto fn = llvm::Function::Create(fn_type, llvm::GlobalValue::LinkageTypes::PrivateLinkage,
-                                   builder.getName() + "_init_storage", getModule());
-  userFunctions.emplace(function_name, fn);
-
-  BasicBlock *entryBlock = BasicBlock::Create(getLLVMContext(), "entry", fn);
-  getBuilder()->SetInsertPoint(entryBlock);
-
-  Value *numAttributes = ConstantInt::get(getLLVMContext(), APInt(32, builder.attributes.size()));
-
-  llvm::Value *tableNameCharPtr = getBuilder()->CreateBitCast(table_name, llvm::Type::getInt8PtrTy(getLLVMContext()));
-
-  Type *cppEnumType = Type::getInt32Ty(getLLVMContext());
-  ArrayType *enumArrayType = ArrayType::get(cppEnumType, builder.attributes.size());
-
-  std::vector<Constant *> valueTypeArray;
-  std::vector<std::string> names;
-
-  for (const auto &a : builder.attributes) {
-    valueTypeArray.push_back(ConstantInt::get(cppEnumType, std::to_underlying(a.second->type)));
-    names.push_back(a.first);
-  }
-
-  Constant *constAttributeTypeArray = ConstantArray::get(enumArrayType, valueTypeArray);
-  AllocaInst *allocaInstAttributeTypes = getBuilder()->CreateAlloca(enumArrayType, nullptr, "attributeTypeArray");
-  getBuilder()->CreateStore(constAttributeTypeArray, allocaInstAttributeTypes);
-  Value *gepIndices[] = {ConstantInt::get(Type::getInt32Ty(getLLVMContext()), 0),
-                         ConstantInt::get(Type::getInt32Ty(getLLVMContext()), 0)};
-  Value *elementPtrAttributeType = getBuilder()->CreateGEP(enumArrayType, allocaInstAttributeTypes, gepIndices);
-
-  llvm::Value *attributeNames = createStringArray(names, builder.getName() + "_attr_");
-  llvm::Value *attributeNamesFirstCharPtr = getBuilder()->CreateExtractValue(attributeNames, {0});
-
-  llvm::Value *resultPtr = this->gen_call(
-      createTablesInternal, {tableNameCharPtr, elementPtrAttributeType, attributeNamesFirstCharPtr, numAttributes});
-
-  // return the table*
-  getBuilder()->CreateRet(resultPtr);
-
-  dcds::LLVMCodegen::llvmVerifyFunction(fn);
-  return fn;
+  return genInitStorageFn(builder.getName(), table_name, builder.attributes, builder.getLayoutFlags());
 }
 
 void LLVMCodegen::buildDestructor() {
@@ -673,6 +679,12 @@ void LLVMCodegen::buildDestructor() {
   //  what about user-defined cleanups, if any.
 }
 
+// layout flags a fixed-size array adds to the ones of its element type.
+static uint32_t arrayLayoutFlags(const AttributeList &attributeList) {
+  if (!attributeList.is_fixed_size) return 0;
+  return static_cast<const AttributeArray &>(attributeList).layout_flags;
+}
+
 void LLVMCodegen::initializeArrayAttributes(dcds::Builder &builder,
                                             std::map<std::string, llvm::Function *> &fn_init_sub_tables,
                                             llvm::Value *txn_manager, llvm::Value *main_record, llvm::Value *txn) {
@@ -691,18 +703,12 @@ void LLVMCodegen::initializeArrayAttributes(dcds::Builder &builder,
         llvm::Value *sub_table_name_llvm_const;
         llvm::Function *init_sub_table_fn;
 
-        if (attributeList->is_primitive_type) {
-          std::map<std::string, std::shared_ptr<Attribute>> tbl_attributes;
-          tbl_attributes[attributeList->name] = attributeList->simple_type;
+        if (attributeList->is_primitive_type || arrayLayoutFlags(*attributeList) != 0) {
+          // the array has a table of its own, see buildConstructorInner.
           std::string sub_table_name_prefix = builder.getName() + "_" + attributeList->name;
-
           sub_table_name = sub_table_name_prefix + "_tbl";
           sub_table_name_llvm_const = this->createStringConstant(sub_table_name, sub_table_name_prefix);
-          // FIXME: Now out function generator will insert the IR in the middle, fix that.
-          //  fix is simple, use/build the functionGenerator, so it can restore the entry point in IRBuilder.
-          init_sub_table_fn =
-              this->genInitStorageFn(sub_table_name_prefix, sub_table_name_llvm_const, builder.attributes);
-
+          init_sub_table_fn = fn_init_sub_tables[attributeList->name];
         } else {
           sub_table_name = attributeList->composite_type->getName() + "_tbl";
           sub_table_name_llvm_const =
@@ -733,7 +739,10 @@ void LLVMCodegen::initializeArrayAttributes(dcds::Builder &builder,
         // NOW, either this is a simple or complex type.
         llvm::Value *defaultValue;
         if (attributeArray->is_primitive_type) {
-          defaultValue = this->createDefaultValue(attributeArray->simple_type);
+          auto *element = this->createDefaultValue(attributeArray->simple_type);
+          auto *element_tmp = createEntryBlockAlloca("array_default_value", element->getType());
+          getBuilder()->CreateStore(element, element_tmp);
+          defaultValue = getBuilder()->CreateBitCast(element_tmp, llvm::Type::getInt8PtrTy(getLLVMContext()));
         } else {
           defaultValue = this->initializeDsValueStructDefault(*(attributeArray->composite_type));
         }
@@ -751,16 +760,21 @@ void LLVMCodegen::initializeArrayAttributes(dcds::Builder &builder,
         CHECK(indexedList->is_primitive_type == false) << "IndexedList can only be of complex type";
 
         // create a cuckoo-map, or index_t with type<key_t, record_ptr>
-        auto key_attribute = indexedList->composite_type->getAttribute(indexedList->key_attribute);
-
-        // FIXME: createIndexMap is a fixed function which creates cuckooMap. we need it to be switch-able to
-        //  cuckoo (hash), or some other range, or specific types.
-        // ----> also add it to destructor.
-        auto key_type = ConstantInt::get(Type::getInt32Ty(getLLVMContext()), std::to_underlying(key_attribute->type));
-        index_ptr = this->gen_call(createIndexMap, {key_type}, Type::getInt64Ty(getLLVMContext()));
+        // FIXME: also add it to destructor.
+        auto key_type = ConstantInt::get(Type::getInt32Ty(getLLVMContext()), std::to_underlying(indexedList->key_type));
+        auto key_bytes = this->createSizeT(indexedList->key_bytes);
+        auto index_type =
+            ConstantInt::get(Type::getInt32Ty(getLLVMContext()), std::to_underlying(indexedList->index_type));
+        auto capacity = this->createSizeT(indexedList->size_hints.capacity);
+        auto growth_factor = this->createSizeT(indexedList->size_hints.growth_factor);
+        auto negative_lookup_filter = getBuilder()->getInt1(indexedList->size_hints.negative_lookup_filter);
+        index_ptr =
+            this->gen_call(createIndexMap,
+                           {key_type, key_bytes, index_type, capacity, growth_factor, negative_lookup_filter},
+                           Type::getInt64Ty(getLLVMContext()));
       }
 
-      llvm::AllocaInst *allocaInst = getBuilder()->CreateAlloca(index_ptr->getType());
+      llvm::AllocaInst *allocaInst = createEntryBlockAlloca("index_ptr", index_ptr->getType());
       getBuilder()->CreateStore(index_ptr, allocaInst);
       Value *indexPtrT = getBuilder()->CreateBitCast(allocaInst, llvm::Type::getInt8PtrTy(getLLVMContext()));
 
@@ -782,7 +796,9 @@ llvm::Function *LLVMCodegen::buildConstructorInner(dcds::Builder &builder) {
 
   //  llvm::Function *fn_initTables = hasAttributes ? this->buildInitTablesFn(builder, tableNameLlvmConstant) : nullptr;
   llvm::Function *fn_initTables =
-      hasAttributes ? this->genInitStorageFn(builder.getName(), tableNameLlvmConstant, builder.attributes) : nullptr;
+      hasAttributes ? this->genInitStorageFn(builder.getName(), tableNameLlvmConstant, builder.attributes,
+                                             builder.getLayoutFlags())
+                    : nullptr;
 
   // mainly for indexed attribute which causes another table to be created.
   std::map<std::string, llvm::Function *> fn_init_sub_tables;
@@ -792,7 +808,18 @@ llvm::Function *LLVMCodegen::buildConstructorInner(dcds::Builder &builder) {
       auto attributeList = std::static_pointer_cast<AttributeList>(at);
       // gen tables or whatever to get them started
       if (attributeList->is_primitive_type) {
-        assert(false);
+        // a single-column table, stored column-wise, so that the elements form one dense buffer.
+        CHECK(attributeList->is_fixed_size) << "Indexed lists of primitive types are not supported yet";
+        std::map<std::string, std::shared_ptr<Attribute>> tbl_attributes;
+        tbl_attributes[attributeList->name] = attributeList->simple_type;
+
+        auto sub_table_name_prefix = builder.getName() + "_" + attributeList->name;
+        auto sub_table_name_llvm_const =
+            this->createStringConstant(sub_table_name_prefix + "_tbl", sub_table_name_prefix);
+        fn_init_sub_tables.insert_or_assign(
+            attributeList->name,
+            this->genInitStorageFn(sub_table_name_prefix, sub_table_name_llvm_const, tbl_attributes,
+                                   std::to_underlying(hints::LayoutHints::COLUMN_STORE)));
       } else {
         auto initSubTableFnName = attributeList->composite_type->getName() + "_init_storage";
 
@@ -800,6 +827,18 @@ llvm::Function *LLVMCodegen::buildConstructorInner(dcds::Builder &builder) {
         LOG_IF(INFO, print_debug_log) << "initSubTableFnName: " << initSubTableFnName << " | "
                                       << userFunctions.at(initSubTableFnName);
         fn_init_sub_tables.insert_or_assign(attributeList->name, userFunctions.at(initSubTableFnName));
+
+        // arrays with their own layout (e.g., column store) get a table of their own.
+        if (auto extra_flags = arrayLayoutFlags(*attributeList); extra_flags != 0) {
+          auto sub_table_name_prefix = builder.getName() + "_" + attributeList->name;
+          auto sub_table_name_llvm_const =
+              this->createStringConstant(sub_table_name_prefix + "_tbl", sub_table_name_prefix);
+          fn_init_sub_tables.insert_or_assign(
+              attributeList->name,
+              this->genInitStorageFn(sub_table_name_prefix, sub_table_name_llvm_const,
+                                     attributeList->composite_type->attributes,
+                                     attributeList->composite_type->getLayoutFlags() | extra_flags));
+        }
       }
     }
   }
@@ -908,6 +947,83 @@ void LLVMCodegen::buildConstructor(dcds::Builder &builder, bool is_nested_type)
   LOG_IF(INFO, print_debug_log) << "buildConstructor DONE";
 }
 
+// Loader of an indexed list, for JitContainer::bulkLoad:
+//   uintptr_t <ds>_<list>_bulk_load(txnManager, mainRecord, const key_t *keys, size_t n, uintptr_t *records)
+// inserts n records of the list with the default values and the given keys, as one group (insertNRecords), writes
+// their references to records, and returns the index of the list, for the caller to insert them in bulk. It runs
+// without a transaction, i.e., without CC and logging, as the DS is not published while it is loaded; loaders of
+// disjoint keys run in parallel.
+//
+// Only for lists with a single key attribute and without secondary indexes, which the loader would have to maintain.
+void LLVMCodegen::buildBulkLoaders(dcds::Builder &builder) {
+  auto ptrType = IntegerType::getInt8PtrTy(getLLVMContext());
+  auto uintPtrType = IntegerType::getInt64Ty(getLLVMContext());
+
+  auto isIndexedList = [](const std::shared_ptr<Attribute> &at) {
+    return at->type_category == ATTRIBUTE_TYPE_CATEGORY::ARRAY_LIST &&
+           !std::static_pointer_cast<AttributeList>(at)->is_fixed_size;
+  };
+
+  for (auto &[name, at] : builder.attributes) {
+    if (!isIndexedList(at)) continue;
+    auto indexedList = std::static_pointer_cast<AttributeIndexedList>(at);
+    if (indexedList->isCompositeKey() || indexedList->isSecondaryIndex()) continue;
+    auto hasSecondaryIndex = std::any_of(builder.attributes.begin(), builder.attributes.end(), [&](const auto &a) {
+      return isIndexedList(a.second) && std::static_pointer_cast<AttributeIndexedList>(a.second)->primary_list == name;
+    });
+    if (hasSecondaryIndex) continue;
+
+    auto &item_type = *(indexedList->composite_type);
+    auto keyTy = DcdsToLLVMType(indexedList->key_type);
+
+    auto function_name = builder.getName() + "_" + name + "_bulk_load";
+    auto fn_type = llvm::FunctionType::get(
+        uintPtrType, std::vector<llvm::Type *>{ptrType, uintPtrType, ptrType, createSizeType(), ptrType}, false);
+    auto fn = llvm::Function::Create(fn_type, llvm::GlobalValue::LinkageTypes::ExternalLinkage, function_name,
+                                     theLLVMModule.get());
+    userFunctions.emplace(function_name, fn);
+
+    getBuilder()->SetInsertPoint(llvm::BasicBlock::Create(getLLVMContext(), "entry", fn));
+    Value *txnManager = fn->getArg(0);
+    Value *mainRecord = fn->getArg(1);
+    Value *keys = getBuilder()->CreateBitCast(fn->getArg(2), keyTy->getPointerTo());
+    Value *n = fn->getArg(3);
+    Value *records = getBuilder()->CreateBitCast(fn->getArg(4), uintPtrType->getPointerTo());
+    Value *txn = llvm::ConstantPointerNull::get(ptrType);
+
+    // the constructor created the table of the items.
+    auto table_name = this->createStringConstant(item_type.getName() + "_tbl", item_type.getName());
+    auto table = this->gen_call(getTable, {table_name});
+    auto base = this->gen_call(insertNRecords, {table, txn, this->initializeDsValueStructDefault(item_type), n},
+                               Type::getInt64Ty(getLLVMContext()));
+
+    auto key_attribute_index = getBuilder()->getInt32(item_type.getAttributeIndex(indexedList->key_attribute));
+    auto *i = createEntryBlockAlloca("i", createSizeType());
+    getBuilder()->CreateStore(this->createSizeT(0), i);
+
+    this->gen_if(getBuilder()->CreateICmpNE(n, this->createSizeT(0)))([&]() {
+      this->gen_do([&]() {
+            auto *offset = getBuilder()->CreateLoad(createSizeType(), i);
+            auto *key = getBuilder()->CreateBitCast(getBuilder()->CreateGEP(keyTy, keys, offset), ptrType);
+            this->gen_call(table_write_attribute_offset, {txnManager, base, txn, key, key_attribute_index, offset},
+                           Type::getVoidTy(getLLVMContext()));
+            auto *record = this->gen_call(table_get_nth_record, {txnManager, base, txn, offset},
+                                          Type::getInt64Ty(getLLVMContext()));
+            getBuilder()->CreateStore(record, getBuilder()->CreateGEP(uintPtrType, records, offset));
+            getBuilder()->CreateStore(getBuilder()->CreateAdd(offset, this->createSizeT(1)), i);
+          })
+          .gen_while([&]() { return getBuilder()->CreateICmpULT(getBuilder()->CreateLoad(createSizeType(), i), n); });
+    });
+
+    auto index = this->gen_call(table_read_runtime_constant,
+                                {mainRecord, this->createSizeT(builder.getAttributeIndex(name))}, uintPtrType);
+    getBuilder()->CreateRet(index);
+
+    llvmVerifyFunction(fn);
+    bulk_load_lists.emplace_back(name, indexedList->key_type);
+  }
+}
+
 void LLVMCodegen::codegenHelloWorld() {
   // Create a function named "main" with return type void
   llvm::FunctionType *funcType = llvm::FunctionType::get(llvm::Type::getVoidTy(getLLVMContext()), false);
@@ -939,7 +1055,8 @@ void LLVMCodegen::testHelloWorld() {
 }
 
 void LLVMCodegen::runOptimizationPasses() {
-  for (auto &F : *theLLVMModule) theLLVMFPM->run(F);
+  auto lock = theLLVMContext.getLock();
+  LLVMOptimizer::simplify(*theLLVMModule);
 }
 
 void *LLVMCodegen::getFunction(const std::string &name) { return this->jitter->getRawAddress(name); }
@@ -956,30 +1073,83 @@ void LLVMCodegen::buildFunctionDictionary(dcds::Builder &builder) {
     auto return_type = fb.second->returnValueType;
     auto args_expr = fb.second->getArguments();
     std::vector<std::pair<std::string, dcds::valueType>> args;
+    std::vector<bool> args_by_reference;
     for (auto &fa : args_expr) {
       args.emplace_back(fa->getName(), fa->getType());
+      args_by_reference.push_back(fa->is_reference_type);
     }
     LOG_IF(INFO, print_debug_log) << "Resolving address: " << fb.first << " | " << address;
-    available_jit_functions.emplace(name, new jit_function_t{name, address, return_type, args});
+    available_jit_functions.emplace(name, new jit_function_t{name, address, return_type, args, args_by_reference});
+  }
+  for (auto &[list, key_type] : bulk_load_lists) {
+    bulk_loaders.emplace(list, bulk_loader_t{getFunctionPrefixed(list + "_bulk_load"), key_type});
   }
 }
 
 void LLVMCodegen::jitCompileAndLoad() {
-  this->jitter = std::make_unique<LLVMJIT>();
-  this->theLLVMModule->setDataLayout(jitter->getDataLayout());
+  // Every builder gets its own dylib in the shared engine; destroying the codegen unloads the generated code.
+  this->jitter = jitEngine->createDylib(getModuleName());
+
+  // NOTE: the context lock must not be held while adding/looking up the module, as compile threads take it as well.
+  std::optional<llvm::orc::ThreadSafeModule> TSM;
+  {
+    auto lock = theLLVMContext.getLock();
+    this->theLLVMModule->setDataLayout(jitter->getDataLayout());
+    optimization_config.attachTo(*theLLVMModule);
+    LOG_IF(INFO, print_debug_log) << "Module name: " << getModule()->getName().str();
+    TSM.emplace(std::move(theLLVMModule), theLLVMContext);
+  }
 
-  LOG_IF(INFO, print_debug_log) << "Module name: " << getModule()->getName().str();
+  // NOTE: ORC materializes lazily, so compilation (on a miss) happens during the lookups in buildFunctionDictionary,
+  //  or, with lazy compilation, only on the first call of each function.
+  startup_stats.lazy_compilation = jitter->isLazyCompilationEnabled();
+  startup_stats.tiered_compilation = jitter->isTieredCompilationEnabled();
+  {
+    time_blockT<std::chrono::microseconds> startup([&](const auto &d) { startup_stats.startup_time = d; });
+    {
+      time_blockT<std::chrono::microseconds> t([&](const auto &d) { startup_stats.load_time = d; });
+      startup_stats.object_cache_hit = this->jitter->addModule(std::move(*TSM));
+    }
+    // this->jitter->dump();
 
-  // llvm::orc::ThreadSafeContext NewTSCtx(std::make_unique<LLVMContext>());
-  // auto TSM = llvm::orc::ThreadSafeModule(std::move(theLLVMModule), std::move(NewTSCtx));
+    this->is_jit_done = true;
+    {
+      time_blockT<std::chrono::microseconds> t([&](const auto &d) { startup_stats.resolve_time = d; });
+      this->buildFunctionDictionary(*top_level_builder);
+    }
+  }
 
-  auto TSM = llvm::orc::ThreadSafeModule(std::move(theLLVMModule), std::move(theLLVMContext));
+  if (startup_stats.lazy_compilation) {
+    std::vector<std::string> exposed_functions;
+    exposed_functions.reserve(available_jit_functions.size() + bulk_loaders.size() + 1);
+    exposed_functions.emplace_back(top_level_builder->getName() + "_constructor");
+    for (auto &[name, fn] : available_jit_functions) {
+      exposed_functions.emplace_back(top_level_builder->getName() + "_" + name);
+    }
+    for (auto &[list, fn] : bulk_loaders) {
+      exposed_functions.emplace_back(top_level_builder->getName() + "_" + list + "_bulk_load");
+    }
+    this->jitter->compileInBackground(exposed_functions);
+  }
 
-  this->jitter->addModule(std::move(TSM));
-  // this->jitter->dump();
+  const char *cache_status = "";
+  if (jitter->isObjectCacheEnabled()) {
+    cache_status = startup_stats.object_cache_hit ? " (object cache hit)" : " (object cache miss)";
+  }
+  const char *compilation_mode = "";
+  if (startup_stats.lazy_compilation) compilation_mode = " (lazy compilation)";
+  if (startup_stats.tiered_compilation) compilation_mode = " (tiered compilation)";
+  LOG_IF(INFO, print_debug_log || jitter->isObjectCacheEnabled() || startup_stats.lazy_compilation ||
+                   startup_stats.tiered_compilation)
+      << "[LLVMCodegen] " << getModuleName() << ": JIT startup " << toString(startup_stats.startup_time) << " (load "
+      << toString(startup_stats.load_time) << ", resolve " << toString(startup_stats.resolve_time) << ") ["
+      << optimization_config.toString() << "]" << compilation_mode << cache_status;
+}
 
-  this->is_jit_done = true;
-  this->buildFunctionDictionary(*top_level_builder);
+size_t LLVMCodegen::getNumCompiledUnits() const {
+  return jitter ? jitter->getEngine().getNumCompiledModules() : 0;
 }
 
+size_t LLVMCodegen::getNumTieredUpFunctions() const { return jitter ? jitter->getNumTieredUpFunctions() : 0; }
+
 }  // namespace dcds
@@ -27,6 +27,7 @@
 #include <vector>
 
 #include "dcds/codegen/llvm-codegen/functions.hpp"
+#include "dcds/codegen/llvm-codegen/llvm-runtime-attributes.hpp"
 #include "dcds/codegen/llvm-codegen/utils/conditionals.hpp"
 #include "dcds/codegen/llvm-codegen/utils/loops.hpp"
 #include "dcds/codegen/llvm-codegen/utils/phi-node.hpp"
@@ -80,8 +81,9 @@ void LLVMCodegenContext::registerAllFunctions() {
   registerFunction("extractRecordFromDsContainer", uintptr_type, {void_ptr_type}, true);
 
   //  void* createTablesInternal(char* table_name, const dcds::valueType attributeTypes[], char* attributeNames[],
-  //                             int num_attributes)
-  registerFunction("createTablesInternal", void_ptr_type, {char_ptr_type, int32_ptr_type, char_ptr_type, int32_type});
+  //                             const bool attributeIsCold[], int num_attributes, uint32_t layout_flags)
+  registerFunction("createTablesInternal", void_ptr_type,
+                   {char_ptr_type, int32_ptr_type, char_ptr_type, char_ptr_type, int32_type, int32_type});
 
   //  registerFunction("c1", void_ptr_type, {char_ptr_type});
   //  registerFunction("c2", void_ptr_type, {int32_type});
@@ -303,6 +305,12 @@ AllocaInst *LLVMCodegenContext::createAlloca(BasicBlock *InsertAtBB, const std::
   return TmpBuilder.CreateAlloca(varType, nullptr, VarName);
 }
 
+AllocaInst *LLVMCodegenContext::createEntryBlockAlloca(const std::string &VarName, Type *varType) const {
+  auto *fn = getBuilder()->GetInsertBlock()->getParent();
+  assert(fn && "no function to allocate in");
+  return createAlloca(&fn->getEntryBlock(), VarName, varType);
+}
+
 void LLVMCodegenContext::CreateIfElseBlocks(Function *fn, const std::string &if_label, const std::string &else_label,
                                             BasicBlock **if_block, BasicBlock **else_block,
                                             BasicBlock *insert_before) const {
@@ -346,7 +354,10 @@ Value *LLVMCodegenContext::getArrayElemMem(Value *val_ptr, Value *offset) const
 
 PointerType *LLVMCodegenContext::getPointerType(Type *type) { return PointerType::get(type, 0); }
 
-void LLVMCodegenContext::registerFunction(const char *funcName, Function *func) { availableFunctions[funcName] = func; }
+void LLVMCodegenContext::registerFunction(const char *funcName, Function *func) {
+  if (func->isDeclaration()) dcds::LLVMRuntimeAttributes::annotate(func);
+  availableFunctions[funcName] = func;
+}
 
 void LLVMCodegenContext::registerFunction(const std::string &function_name, llvm::Type *returnType,
                                           const std::vector<llvm::Type *> &args, bool always_inline,
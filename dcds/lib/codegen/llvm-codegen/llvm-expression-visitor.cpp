@@ -24,6 +24,8 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+#include <numeric>
+
 #include "dcds/builder/function-builder.hpp"
 #include "dcds/codegen/llvm-codegen/llvm-codegen-function.hpp"
 #include "dcds/codegen/llvm-codegen/llvm-context.hpp"
@@ -334,4 +336,68 @@ void* LLVMExpressionVisitor::visit(const expressions::NotEqualExpression& expr)
   CHECK(leftValue->getType()->getTypeID() == rightValue->getType()->getTypeID()) << "Type mismatch";
 
   return builder->CreateICmpNE(leftValue, rightValue);
-}
\ No newline at end of file
+}
+void* LLVMExpressionVisitor::visit(const expressions::CompositeKeyExpression& expr) {
+  LOG_IF(INFO, print_debug_log) << "LLVMExpressionVisitor::CompositeKeyExpression::visit";
+  auto& values = expr.getValues();
+
+  std::vector<llvm::Value*> generated_values;
+  for (const auto& value : values) {
+    generated_values.push_back(loadValueIfRequired(static_cast<llvm::Value*>(value->accept(this)),
+                                                   value->getResultType()));
+  }
+  if (expr.getKeyBytes()) {
+    auto* key = build_ctx->getCodegen()->createEntryBlockAlloca(
+        "composite_key", llvm::ArrayType::get(build_ctx->getCodegen()->getBuilder()->getInt64Ty(),
+                                              expr.getKeyBytes() / sizeof(uint64_t)));
+    packBinaryKey(build_ctx->getCodegen()->getBuilder(), key, generated_values, expr.getBits(), expr.getKeyBytes());
+    return key;
+  }
+  return packCompositeKey(build_ctx->getCodegen()->getBuilder(), generated_values, expr.getBits());
+}
+
+// Packs parts into one word, without the sign flip of INT64 keys.
+static llvm::Value* packKeyWord(llvm::IRBuilder<>* builder, const std::vector<llvm::Value*>& values,
+                                const std::vector<uint32_t>& bits) {
+  llvm::Value* key = builder->getInt64(0);
+  for (size_t i = 0; i < values.size(); i++) {
+    auto* value = builder->CreateSExtOrTrunc(values[i], builder->getInt64Ty());
+
+    // biased by half the range of the part, so that negative values come first, then truncated to the part.
+    auto bias = uint64_t{1} << (bits[i] - 1);
+    auto mask = bits[i] == 64 ? ~uint64_t{0} : (uint64_t{1} << bits[i]) - 1;
+    value = builder->CreateAnd(builder->CreateAdd(value, builder->getInt64(bias)), builder->getInt64(mask));
+    key = bits[i] == 64 ? value : builder->CreateOr(builder->CreateShl(key, bits[i]), value);
+  }
+  return key;
+}
+
+llvm::Value* LLVMExpressionVisitor::packCompositeKey(llvm::IRBuilder<>* builder,
+                                                     const std::vector<llvm::Value*>& values,
+                                                     const std::vector<uint32_t>& bits) {
+  auto* key = packKeyWord(builder, values, bits);
+
+  // packed keys compare as unsigned, flip the sign bit if they use it, so that they compare the same as INT64.
+  if (std::accumulate(bits.begin(), bits.end(), uint32_t{0}) == 64) {
+    key = builder->CreateXor(key, builder->getInt64(uint64_t{1} << 63));
+  }
+  return key;
+}
+
+void LLVMExpressionVisitor::packBinaryKey(llvm::IRBuilder<>* builder, llvm::Value* key,
+                                          const std::vector<llvm::Value*>& values, const std::vector<uint32_t>& bits,
+                                          size_t key_bytes) {
+  auto* keyTy = llvm::ArrayType::get(builder->getInt64Ty(), key_bytes / sizeof(uint64_t));
+  auto words = compositeKeyWords(bits);
+  for (uint32_t word = 0; word < key_bytes / sizeof(uint64_t); word++) {
+    std::vector<llvm::Value*> word_values;
+    std::vector<uint32_t> word_bits;
+    for (size_t i = 0; i < values.size(); i++) {
+      if (words[i] != word) continue;
+      word_values.push_back(values[i]);
+      word_bits.push_back(bits[i]);
+    }
+    builder->CreateStore(packKeyWord(builder, word_values, word_bits),
+                         builder->CreateConstInBoundsGEP2_32(keyTy, key, 0, word));
+  }
+}
@@ -21,9 +21,83 @@
 
 #include "dcds/codegen/llvm-codegen/llvm-jit.hpp"
 
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
 using namespace llvm;
 using namespace dcds;
 
+static constexpr bool print_debug_log = false;
+
+LLVMJITOptions LLVMJITOptions::createFromEnvironment() {
+  LLVMJITOptions options;
+
+  if (auto lazy = llvm::sys::Process::GetEnv("DCDS_JIT_LAZY")) {
+    options.lazy_compilation = (*lazy == "1" || *lazy == "true");
+  }
+
+  if (auto background = llvm::sys::Process::GetEnv("DCDS_JIT_BACKGROUND_COMPILE")) {
+    options.background_compilation = (*background == "1" || *background == "true");
+  }
+
+  if (auto threads = llvm::sys::Process::GetEnv("DCDS_JIT_COMPILE_THREADS")) {
+    size_t n = 0;
+    if (!llvm::StringRef(*threads).getAsInteger(10, n)) {
+      options.compile_threads = n;
+    } else {
+      LOG(WARNING) << "[LLVMJIT] Ignoring invalid DCDS_JIT_COMPILE_THREADS: " << *threads;
+    }
+  }
+
+  if (auto tiered = llvm::sys::Process::GetEnv("DCDS_JIT_TIERED")) {
+    options.tiered_compilation = (*tiered == "1" || *tiered == "true");
+  }
+
+  if (auto threshold = llvm::sys::Process::GetEnv("DCDS_JIT_TIER_UP_THRESHOLD")) {
+    uint64_t n = 0;
+    if (!llvm::StringRef(*threshold).getAsInteger(10, n) && n > 0) {
+      options.tier_up_threshold = n;
+    } else {
+      LOG(WARNING) << "[LLVMJIT] Ignoring invalid DCDS_JIT_TIER_UP_THRESHOLD: " << *threshold;
+    }
+  }
+
+  return options;
+}
+
+void LLVMJIT::handleLazyCallThroughError() {
+  LOG(FATAL) << "[LLVMJIT] Failed to materialize a lazily compiled function";
+}
+
+llvm::Optional<llvm::orc::CompileOnDemandLayer::GlobalValueSet> LLVMJIT::partitionWithCallees(
+    llvm::orc::CompileOnDemandLayer::GlobalValueSet requested) {
+  llvm::orc::CompileOnDemandLayer::GlobalValueSet partition;
+  std::vector<const llvm::Function *> worklist;
+
+  for (auto *gv : requested) {
+    partition.insert(gv);
+    if (auto *f = llvm::dyn_cast<llvm::Function>(gv)) worklist.push_back(f);
+  }
+
+  while (!worklist.empty()) {
+    auto *f = worklist.back();
+    worklist.pop_back();
+
+    for (auto &bb : *f) {
+      for (auto &inst : bb) {
+        auto *call = llvm::dyn_cast<llvm::CallBase>(&inst);
+        if (!call) continue;
+        auto *callee = call->getCalledFunction();
+        if (callee && !callee->isDeclaration() && partition.insert(callee).second) worklist.push_back(callee);
+      }
+    }
+  }
+
+  return partition;
+}
+
 llvm::Expected<llvm::orc::ThreadSafeModule> LLVMJIT::printIR(llvm::orc::ThreadSafeModule module,
                                                              const std::string &suffix) {
   module.withModuleDo([&suffix](llvm::Module &m) {
@@ -36,63 +110,276 @@ llvm::Expected<llvm::orc::ThreadSafeModule> LLVMJIT::printIR(llvm::orc::ThreadSa
   return std::move(module);
 }
 
-llvm::orc::ThreadSafeModule LLVMJIT::optimizeModule2(llvm::orc::ThreadSafeModule TSM,
-                                                     std::unique_ptr<llvm::TargetMachine> TM) {
-  TSM.withModuleDo([&TM](llvm::Module &M) {
-    // time_block t("Optimization phase ");
+llvm::Expected<llvm::orc::ThreadSafeModule> LLVMJIT::optimizeModule(llvm::orc::ThreadSafeModule TSM,
+                                                                    const llvm::orc::JITTargetMachineBuilder &JTMB) {
+  llvm::Error err = llvm::Error::success();
+  TSM.withModuleDo([&](llvm::Module &M) {
+    auto config = LLVMOptimizationConfig::readFrom(M);
+    auto TM = config.getTargetMachineBuilder(JTMB).createTargetMachine();
+    if (!TM) {
+      err = TM.takeError();
+      return;
+    }
+    LLVMOptimizer::optimize(M, **TM, config);
+  });
+  if (err) return std::move(err);
+  return std::move(TSM);
+}
+
+std::shared_ptr<LLVMJIT> LLVMJIT::getInstance() {
+  static std::shared_ptr<LLVMJIT> instance = std::make_shared<LLVMJIT>();
+  return instance;
+}
+
+std::unique_ptr<LLVMJITDylib> LLVMJIT::createDylib(const std::string &name, const LLVMJITOptions &options) {
+  // Builder names are not necessarily unique (e.g., rebuilding a type), dylib names have to be.
+  auto &jd = llvm::cantFail(ES.createJITDylib(name + "#" + std::to_string(n_dylibs++)));
+  jd.addGenerator(
+      llvm::cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(this->DL.getGlobalPrefix())));
+
+  return std::unique_ptr<LLVMJITDylib>(new LLVMJITDylib(shared_from_this(), jd, options));
+}
+
+LLVMJITOptions LLVMJITDylib::normalizeOptions(LLVMJITOptions options) {
+  if (options.tiered_compilation) {
+    LOG_IF(WARNING, options.lazy_compilation) << "[LLVMJIT] Tiered compilation enabled, ignoring lazy compilation";
+    options.lazy_compilation = false;
+    options.tier_up_threshold = std::max<uint64_t>(options.tier_up_threshold, 1);
+  }
+  return options;
+}
+
+LLVMJITDylib::LLVMJITDylib(std::shared_ptr<LLVMJIT> _engine, llvm::orc::JITDylib &_jd,
+                           const LLVMJITOptions &_options)
+    : engine(std::move(_engine)), MainJD(_jd), options(normalizeOptions(_options)) {
+  auto &ES = engine->ES;
+
+  if (options.lazy_compilation || options.tiered_compilation) {
+    CODLayer = std::make_unique<llvm::orc::CompileOnDemandLayer>(
+        ES, engine->PrintGeneratedIRLayer, engine->EPCIU->getLazyCallThroughManager(),
+        [this]() { return engine->EPCIU->createIndirectStubsManager(); });
+    CODLayer->setPartitionFunction(LLVMJIT::partitionWithCallees);
+  }
+
+  if (options.tiered_compilation) {
+    LOG_IF(WARNING, !engine->compileThreads)
+        << "[LLVMJIT] No compile threads, optimized tiers are compiled on the calling thread";
+
+    TierStubs = engine->EPCIU->createIndirectStubsManager();
+    Tier1JD = &llvm::cantFail(ES.createJITDylib(MainJD.getName() + ".tier1"));
+    Tier1JD->addToLinkOrder(MainJD);
+
+    llvm::orc::SymbolMap tier_up_symbol;
+    tier_up_symbol[engine->Mangle(tier_up_function_name)] =
+        llvm::JITEvaluatedSymbol(llvm::pointerToJITTargetAddress(&tierUpCallback),
+                                 llvm::JITSymbolFlags::Exported | llvm::JITSymbolFlags::Callable);
+    llvm::cantFail(MainJD.define(llvm::orc::absoluteSymbols(std::move(tier_up_symbol))));
+  }
+}
+
+LLVMJITDylib::~LLVMJITDylib() {
+  // Background compilations and tier-ups may still resolve symbols in the dylibs removed below.
+  while (n_pending_lookups > 0) std::this_thread::yield();
+
+  auto &ES = engine->ES;
+  std::vector<llvm::orc::JITDylib *> dylibs;
+  if (Tier1JD) {
+    if (Tier1ImplJD) dylibs.push_back(Tier1ImplJD);
+    dylibs.push_back(Tier1JD);
+  }
+  if (auto *implJD = ES.getJITDylibByName(MainJD.getName() + ".impl")) dylibs.push_back(implJD);
+  dylibs.push_back(&MainJD);
+
+  for (auto *jd : dylibs) {
+    if (auto err = ES.removeJITDylib(*jd)) ES.reportError(std::move(err));
+  }
+}
+
+bool LLVMJITDylib::addModule(llvm::orc::ThreadSafeModule M) {
+  if (options.tiered_compilation) {
+    addModuleTiered(std::move(M));
+    return false;
+  }
+
+  if (isObjectCacheEnabled()) {
+    std::string key;
+    M.withModuleDo([&](llvm::Module &m) {
+      key = LLVMObjectCache::computeKey(m, engine->target_fingerprint);
+      LLVMObjectCache::setModuleKey(m, key);
+    });
+
+    if (auto obj = engine->objectCache->getObject(key)) {
+      llvm::cantFail(engine->ObjectLayer.add(MainJD, std::move(obj)));
+      return true;
+    }
+  }
+
+  if (CODLayer) {
+    llvm::cantFail(CODLayer->add(MainJD, std::move(M)));
+  } else {
+    llvm::cantFail(engine->PrintGeneratedIRLayer.add(MainJD, std::move(M)));
+  }
+  return false;
+}
+
+void LLVMJITDylib::lookupAsync(llvm::orc::JITDylib &dylib, llvm::orc::SymbolLookupSet symbols,
+                               std::function<void(llvm::Expected<llvm::orc::SymbolMap>)> on_complete) {
+  n_pending_lookups++;
+  engine->ES.lookup(
+      llvm::orc::LookupKind::Static,
+      llvm::orc::makeJITDylibSearchOrder(&dylib, llvm::orc::JITDylibLookupFlags::MatchAllSymbols),
+      std::move(symbols), llvm::orc::SymbolState::Ready,
+      [this, _on_complete = std::move(on_complete)](llvm::Expected<llvm::orc::SymbolMap> result) {
+        _on_complete(std::move(result));
+        n_pending_lookups--;
+      },
+      llvm::orc::NoDependenciesToRegister);
+}
 
-    M.setTargetTriple(TM->getTargetTriple().str());
+void LLVMJITDylib::compileInBackground(const std::vector<std::string> &function_names) {
+  if (!options.lazy_compilation || !options.background_compilation) return;
+  // without compile threads, the lookup below would compile all functions on the calling thread.
+  if (!engine->compileThreads) {
+    LOG(WARNING) << "[LLVMJIT] No compile threads, skipping background compilation";
+    return;
+  }
 
-    PassConfiguration pc{std::move(TM)};
+  // CompileOnDemandLayer keeps the function bodies in "<JD>.impl" and leaves only stubs in the main dylib. Looking the
+  // bodies up there materializes them without going through (and resolving) the stubs.
+  auto *implJD = engine->ES.getJITDylibByName(MainJD.getName() + ".impl");
+  if (!implJD) return;
 
-    llvm::legacy::FunctionPassManager FPasses{&M};
+  llvm::orc::SymbolLookupSet symbols;
+  for (const auto &name : function_names) {
+    symbols.add(engine->Mangle(name), llvm::orc::SymbolLookupFlags::WeaklyReferencedSymbol);
+  }
 
-    pc.Builder.populateFunctionPassManager(FPasses);
+  lookupAsync(*implJD, std::move(symbols), [](llvm::Expected<llvm::orc::SymbolMap> result) {
+    if (!result) LOG(WARNING) << "[LLVMJIT] Background compilation failed: " << llvm::toString(result.takeError());
+  });
+}
 
-    FPasses.add(pc.TTIPass);
-    FPasses.add(pc.PrefetchPass);
+void LLVMJITDylib::addModuleTiered(llvm::orc::ThreadSafeModule M) {
+  auto &ES = engine->ES;
+  auto &Mangle = engine->Mangle;
 
-    {
-      // time_block t_run("Optimization run phase ");
+  // Tier-1 is an untouched clone of the module, compiled per function (partitionWithCallees) with the optimizing
+  // pipeline into its own dylib. Its external globals are turned into declarations so that both tiers share the
+  // definitions of tier-0.
+  llvm::orc::ThreadSafeModule tier1_module;
+  std::vector<std::string> exposed_functions;
 
-      FPasses.doInitialization();
-      for (llvm::Function &F : M) FPasses.run(F);
-      FPasses.doFinalization();
+  M.withModuleDo([&](llvm::Module &m) {
+    auto tier1 = llvm::CloneModule(m);
+    for (auto &gv : tier1->globals()) {
+      if (!gv.isDeclaration() && !gv.hasLocalLinkage()) {
+        gv.setInitializer(nullptr);
+        gv.setLinkage(llvm::GlobalValue::ExternalLinkage);
+      }
+    }
+    tier1_module = llvm::orc::ThreadSafeModule(std::move(tier1), M.getContext());
 
-      // Now that we have all the passes ready, run them.
-      pc.Passes.run(M);
+    // Tier-0 renames every exposed function F to F.tier0 and instruments it. F itself becomes an indirection stub.
+    for (auto &f : m) {
+      if (f.isDeclaration() || f.hasLocalLinkage()) continue;
+      exposed_functions.emplace_back(f.getName().str());
+    }
+    for (const auto &name : exposed_functions) {
+      auto *f = m.getFunction(name);
+      f->setName(name + tier0_suffix);
+      instrumentTier0Function(*f, name);
     }
   });
-  return TSM;
-}
-
-// llvm::Expected<llvm::orc::ThreadSafeModule> LLVMJIT::optimizeModule(llvm::orc::ThreadSafeModule TSM,
-//                                                                     const llvm::orc::MaterializationResponsibility
-//                                                                     &R) {
-//   TSM.withModuleDo([](Module &M) {
-//     // Create a function pass manager.
-//     auto FPM = std::make_unique<legacy::FunctionPassManager>(&M);
-//
-//     // Add some optimizations.
-//     FPM->add(createInstructionCombiningPass());
-//     FPM->add(createReassociatePass());
-//     FPM->add(createGVNPass());
-//     FPM->add(createCFGSimplificationPass());
-//     FPM->add(createDeadCodeEliminationPass());
-//     FPM->doInitialization();
-//
-//     // Run the optimizations over all functions in the module being added to
-//     // the JIT.
-//     for (auto &F : M) FPM->run(F);
-//   });
-//
-//   return std::move(TSM);
-// }
-
-void *LLVMJIT::getCompiledFunction(llvm::Function *function_ptr) {
+
+  llvm::cantFail(engine->Tier0CompileLayer.add(MainJD, std::move(M)));
+  engine->n_compiled_modules++;
+  if (exposed_functions.empty()) return;
+
+  llvm::orc::SymbolLookupSet tier0_symbols;
+  for (const auto &name : exposed_functions) tier0_symbols.add(Mangle(name + tier0_suffix));
+  auto tier0_addresses = llvm::cantFail(ES.lookup(llvm::orc::makeJITDylibSearchOrder(&MainJD), tier0_symbols));
+
+  llvm::orc::IndirectStubsManager::StubInitsMap stubs;
+  for (const auto &name : exposed_functions) {
+    stubs[name] = {tier0_addresses[Mangle(name + tier0_suffix)].getAddress(),
+                   llvm::JITSymbolFlags::Exported | llvm::JITSymbolFlags::Callable};
+  }
+  llvm::cantFail(TierStubs->createStubs(stubs));
+
+  llvm::orc::SymbolMap stub_symbols;
+  for (const auto &name : exposed_functions) {
+    stub_symbols[Mangle(name)] = TierStubs->findStub(name, true);
+  }
+  llvm::cantFail(MainJD.define(llvm::orc::absoluteSymbols(std::move(stub_symbols))));
+
+  // Looking up any tier-1 symbol only installs the lazy stubs of CompileOnDemandLayer (no compilation), but creates
+  // the dylib holding the bodies, which is where tierUp resolves the optimized code.
+  llvm::cantFail(CODLayer->add(*Tier1JD, std::move(tier1_module)));
+  llvm::cantFail(ES.lookup(llvm::orc::makeJITDylibSearchOrder(Tier1JD), Mangle(exposed_functions.front())));
+  Tier1ImplJD = ES.getJITDylibByName(Tier1JD->getName() + ".impl");
+  CHECK(Tier1ImplJD) << "[LLVMJIT] Missing dylib for optimized tier";
+}
+
+void LLVMJITDylib::instrumentTier0Function(llvm::Function &F, const std::string &exposed_name) {
+  auto &ctx = F.getContext();
+  auto *module = F.getParent();
+
+  auto *i64 = llvm::Type::getInt64Ty(ctx);
+  auto *counter = new llvm::GlobalVariable(*module, i64, false, llvm::GlobalValue::InternalLinkage,
+                                           llvm::ConstantInt::get(i64, 0), exposed_name + ".calls");
+
+  auto *i8_ptr = llvm::Type::getInt8PtrTy(ctx);
+  auto tier_up_fn = module->getOrInsertFunction(
+      tier_up_function_name, llvm::FunctionType::get(llvm::Type::getVoidTy(ctx), {i8_ptr, i8_ptr}, false));
+
+  // Keep static allocas in the entry block and count the call right after them.
+  auto &entry = F.getEntryBlock();
+  auto it = entry.begin();
+  while (llvm::isa<llvm::AllocaInst>(*it)) ++it;
+  auto *body = entry.splitBasicBlock(it, "tier0.body");
+  entry.getTerminator()->eraseFromParent();
+  auto *tier_up_block = llvm::BasicBlock::Create(ctx, "tier0.tier_up", &F, body);
+
+  llvm::IRBuilder<> builder(&entry);
+  auto *n_calls = builder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, counter, builder.getInt64(1), llvm::MaybeAlign(8),
+                                          llvm::AtomicOrdering::Monotonic);
+  auto *is_hot = builder.CreateICmpEQ(n_calls, builder.getInt64(options.tier_up_threshold - 1));
+  builder.CreateCondBr(is_hot, tier_up_block, body, llvm::MDBuilder(ctx).createBranchWeights(1, (1U << 20)));
+
+  builder.SetInsertPoint(tier_up_block);
+  auto *dylib_ptr = builder.CreateIntToPtr(builder.getInt64(reinterpret_cast<uintptr_t>(this)), i8_ptr);
+  auto *name_ptr = builder.CreateGlobalStringPtr(exposed_name, exposed_name + ".name");
+  builder.CreateCall(tier_up_fn, {dylib_ptr, name_ptr});
+  builder.CreateBr(body);
+}
+
+void LLVMJITDylib::tierUpCallback(LLVMJITDylib *dylib, const char *function_name) { dylib->tierUp(function_name); }
+
+void LLVMJITDylib::tierUp(const std::string &function_name) {
+  LOG_IF(INFO, print_debug_log) << "[LLVMJIT] Tiering up: " << function_name;
+
+  // Asynchronous: the optimized tier is compiled on the compile threads while callers keep running tier-0 code.
+  lookupAsync(*Tier1ImplJD, llvm::orc::SymbolLookupSet(engine->Mangle(function_name)),
+              [this, function_name](llvm::Expected<llvm::orc::SymbolMap> result) {
+                if (!result) {
+                  LOG(WARNING) << "[LLVMJIT] Tier-up of " << function_name
+                               << " failed: " << llvm::toString(result.takeError());
+                  return;
+                }
+                // Stub pointers are updated with a single pointer-sized store, so concurrent callers see either tier.
+                if (auto err = TierStubs->updatePointer(function_name, result->begin()->second.getAddress())) {
+                  LOG(WARNING) << "[LLVMJIT] Tier-up of " << function_name
+                               << " failed: " << llvm::toString(std::move(err));
+                  return;
+                }
+                n_tiered_up_functions++;
+              });
+}
+
+void *LLVMJITDylib::getCompiledFunction(llvm::Function *function_ptr) {
   assert(function_ptr);
   return getCompiledFunction(function_ptr->getName().str());
 }
-void *LLVMJIT::getCompiledFunction(const std::string &function_name) {
+void *LLVMJITDylib::getCompiledFunction(const std::string &function_name) {
   return (void *)this->lookup(function_name).getAddress();
-}
\ No newline at end of file
+}
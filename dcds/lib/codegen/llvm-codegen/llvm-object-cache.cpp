@@ -0,0 +1,140 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include "dcds/codegen/llvm-codegen/llvm-object-cache.hpp"
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/SHA1.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "dcds/util/logging.hpp"
+
+static constexpr bool print_debug_log = false;
+static constexpr auto module_key_metadata = "dcds.object_cache.key";
+
+namespace dcds {
+
+LLVMObjectCache::LLVMObjectCache(std::string cache_directory) : cache_dir(std::move(cache_directory)) {
+  if (auto ec = llvm::sys::fs::create_directories(cache_dir)) {
+    LOG(WARNING) << "[LLVMObjectCache] Cannot create cache directory '" << cache_dir << "': " << ec.message();
+  }
+}
+
+std::unique_ptr<LLVMObjectCache> LLVMObjectCache::createFromEnvironment() {
+  auto dir = llvm::sys::Process::GetEnv("DCDS_JIT_CACHE_DIR");
+  if (!dir || dir->empty()) return nullptr;
+  return std::make_unique<LLVMObjectCache>(*dir);
+}
+
+std::string LLVMObjectCache::computeKey(const llvm::Module &module, const std::string &target_fingerprint) {
+  // Named struct types live in the (shared) LLVMContext, which suffixes a repeated name (".N") depending on what was
+  // built before in the process. They are printed unnamed, i.e., numbered in the order of the module, and renamed back
+  // after: their names are free in the context meanwhile, so they get them back unchanged.
+  auto types = module.getIdentifiedStructTypes();
+  std::vector<std::string> type_names;
+  type_names.reserve(types.size());
+  for (auto *type : types) {
+    type_names.push_back(type->hasName() ? type->getName().str() : "");
+    type->setName("");
+  }
+
+  std::string ir;
+  llvm::raw_string_ostream ir_stream(ir);
+  module.print(ir_stream, nullptr);
+  ir_stream.flush();
+
+  for (size_t i = 0; i < types.size(); i++) {
+    if (!type_names[i].empty()) types[i]->setName(type_names[i]);
+  }
+
+  llvm::SHA1 hasher;
+  hasher.update(LLVM_VERSION_STRING);
+  hasher.update(target_fingerprint);
+  hasher.update(ir);
+  return llvm::toHex(hasher.final(), true);
+}
+
+void LLVMObjectCache::setModuleKey(llvm::Module &module, const std::string &key) {
+  auto *md = module.getOrInsertNamedMetadata(module_key_metadata);
+  md->clearOperands();
+  md->addOperand(llvm::MDNode::get(module.getContext(), llvm::MDString::get(module.getContext(), key)));
+}
+
+std::optional<std::string> LLVMObjectCache::getModuleKey(const llvm::Module &module) {
+  auto *md = module.getNamedMetadata(module_key_metadata);
+  if (!md || md->getNumOperands() == 0) return std::nullopt;
+  return llvm::cast<llvm::MDString>(md->getOperand(0)->getOperand(0))->getString().str();
+}
+
+std::string LLVMObjectCache::getObjectPath(const std::string &key) const {
+  llvm::SmallString<256> path(cache_dir);
+  llvm::sys::path::append(path, key + ".o");
+  return path.str().str();
+}
+
+void LLVMObjectCache::notifyObjectCompiled(const llvm::Module *module, llvm::MemoryBufferRef obj) {
+  auto key = getModuleKey(*module);
+  if (!key) return;
+
+  // Write to a process-unique file first and rename, so that concurrent processes never observe a partial object.
+  auto path = getObjectPath(*key);
+  auto tmp_path = path + ".tmp." + std::to_string(llvm::sys::Process::getProcessId());
+  {
+    std::error_code ec;
+    llvm::raw_fd_ostream out(tmp_path, ec, llvm::sys::fs::OF_None);
+    if (ec) {
+      LOG(WARNING) << "[LLVMObjectCache] Cannot write object '" << tmp_path << "': " << ec.message();
+      return;
+    }
+    out << obj.getBuffer();
+  }
+  if (auto ec = llvm::sys::fs::rename(tmp_path, path)) {
+    LOG(WARNING) << "[LLVMObjectCache] Cannot store object '" << path << "': " << ec.message();
+    llvm::sys::fs::remove(tmp_path);
+    return;
+  }
+  LOG_IF(INFO, print_debug_log) << "[LLVMObjectCache] Stored: " << module->getName().str() << " -> " << path;
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMObjectCache::getObject(const std::string &key) {
+  auto buffer = llvm::MemoryBuffer::getFile(getObjectPath(key), false, false);
+  if (!buffer) return nullptr;
+  n_hits++;
+  LOG_IF(INFO, print_debug_log) << "[LLVMObjectCache] Hit: " << key;
+  return std::move(buffer.get());
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMObjectCache::getObject(const llvm::Module *module) {
+  auto key = getModuleKey(*module);
+  if (key) {
+    if (auto obj = getObject(*key)) return obj;
+  }
+  n_misses++;
+  return nullptr;
+}
+
+}  // namespace dcds
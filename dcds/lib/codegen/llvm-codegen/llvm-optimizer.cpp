@@ -0,0 +1,202 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include "dcds/codegen/llvm-codegen/llvm-optimizer.hpp"
+
+#include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Transforms/InstCombine/InstCombine.h>
+#include <llvm/Transforms/Scalar/DCE.h>
+#include <llvm/Transforms/Scalar/GVN.h>
+#include <llvm/Transforms/Scalar/LoopDataPrefetch.h>
+#include <llvm/Transforms/Scalar/Reassociate.h>
+#include <llvm/Transforms/Scalar/SimplifyCFG.h>
+#include <llvm/Transforms/Utils/Mem2Reg.h>
+
+#include "dcds/util/logging.hpp"
+
+using namespace dcds;
+
+static constexpr bool print_debug_log = false;
+
+static constexpr const char *profile_flag = "dcds.optimization_profile";
+static constexpr const char *target_flag = "dcds.target";
+
+void LLVMOptimizationConfig::attachTo(llvm::Module &module) const {
+  auto *i32 = llvm::Type::getInt32Ty(module.getContext());
+  module.setModuleFlag(llvm::Module::Override, profile_flag,
+                       llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(i32, static_cast<uint32_t>(profile))));
+  module.setModuleFlag(llvm::Module::Override, target_flag,
+                       llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(i32, static_cast<uint32_t>(target))));
+}
+
+LLVMOptimizationConfig LLVMOptimizationConfig::readFrom(const llvm::Module &module) {
+  LLVMOptimizationConfig config;
+  if (auto *flag = llvm::mdconst::extract_or_null<llvm::ConstantInt>(module.getModuleFlag(profile_flag))) {
+    config.profile = static_cast<hints::OptimizationProfile>(flag->getZExtValue());
+  }
+  if (auto *flag = llvm::mdconst::extract_or_null<llvm::ConstantInt>(module.getModuleFlag(target_flag))) {
+    config.target = static_cast<hints::TargetHints>(flag->getZExtValue());
+  }
+  return config;
+}
+
+llvm::OptimizationLevel LLVMOptimizationConfig::getOptimizationLevel() const {
+  switch (profile) {
+    case hints::OptimizationProfile::LATENCY:
+      return llvm::OptimizationLevel::O3;
+    case hints::OptimizationProfile::SIZE:
+      return llvm::OptimizationLevel::Oz;
+    case hints::OptimizationProfile::COMPILE_SPEED:
+      return llvm::OptimizationLevel::O1;
+  }
+  assert(false && "unknown optimization profile");
+  return llvm::OptimizationLevel::O3;
+}
+
+llvm::CodeGenOpt::Level LLVMOptimizationConfig::getCodeGenOptLevel() const {
+  switch (profile) {
+    case hints::OptimizationProfile::LATENCY:
+      return llvm::CodeGenOpt::Aggressive;
+    case hints::OptimizationProfile::SIZE:
+      return llvm::CodeGenOpt::Default;
+    case hints::OptimizationProfile::COMPILE_SPEED:
+      // FastISel and the fast register allocator.
+      return llvm::CodeGenOpt::None;
+  }
+  assert(false && "unknown optimization profile");
+  return llvm::CodeGenOpt::Aggressive;
+}
+
+llvm::orc::JITTargetMachineBuilder LLVMOptimizationConfig::getTargetMachineBuilder(
+    llvm::orc::JITTargetMachineBuilder host) const {
+  host.setCodeGenOptLevel(getCodeGenOptLevel());
+  if (target == hints::TargetHints::PORTABLE) {
+    // "generic" is the baseline of the triple (e.g., x86-64 with SSE2), without any detected host feature.
+    host.setCPU("generic");
+    host.getFeatures() = llvm::SubtargetFeatures();
+  }
+  return host;
+}
+
+std::string LLVMOptimizationConfig::toString() const {
+  std::string str;
+  switch (profile) {
+    case hints::OptimizationProfile::LATENCY:
+      str = "latency";
+      break;
+    case hints::OptimizationProfile::SIZE:
+      str = "size";
+      break;
+    case hints::OptimizationProfile::COMPILE_SPEED:
+      str = "compile-speed";
+      break;
+  }
+  return str + (target == hints::TargetHints::PORTABLE ? "/portable" : "/host");
+}
+
+void LLVMOptimizer::optimize(llvm::Module &module, llvm::TargetMachine &TM, const LLVMOptimizationConfig &config) {
+  LOG_IF(INFO, print_debug_log) << "[LLVMOptimizer] " << module.getName().str() << ": " << config.toString();
+  module.setTargetTriple(TM.getTargetTriple().str());
+
+  auto level = config.getOptimizationLevel();
+  if (config.profile == hints::OptimizationProfile::SIZE) {
+    // The IR pipeline follows -Oz, but instruction selection and the backend look at the function attributes.
+    for (auto &F : module) {
+      if (F.isDeclaration()) continue;
+      F.addFnAttr(llvm::Attribute::OptimizeForSize);
+      F.addFnAttr(llvm::Attribute::MinSize);
+    }
+  }
+
+  llvm::PipelineTuningOptions PTO;
+  PTO.LoopUnrolling = (level == llvm::OptimizationLevel::O3);
+  PTO.LoopVectorization = (level == llvm::OptimizationLevel::O3);
+  PTO.SLPVectorization = (level == llvm::OptimizationLevel::O3);
+
+  llvm::PassBuilder PB(&TM, PTO);
+
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+
+  llvm::TargetLibraryInfoImpl TLII(TM.getTargetTriple());
+  FAM.registerPass([&TLII] { return llvm::TargetLibraryAnalysis(TLII); });
+
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  if (level == llvm::OptimizationLevel::O3) {
+    // Software prefetching for the strided loops over attribute arrays/lists, as the legacy pipeline did.
+    PB.registerOptimizerLastEPCallback([](llvm::ModulePassManager &MPM, llvm::OptimizationLevel) {
+      MPM.addPass(llvm::createModuleToFunctionPassAdaptor(llvm::LoopDataPrefetchPass()));
+    });
+  }
+
+  auto MPM = PB.buildPerModuleDefaultPipeline(level);
+  MPM.run(module, MAM);
+}
+
+void LLVMOptimizer::simplify(llvm::Module &module) {
+  llvm::PassBuilder PB;
+
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  llvm::FunctionPassManager FPM;
+  FPM.addPass(llvm::PromotePass());
+  FPM.addPass(llvm::InstCombinePass());
+  FPM.addPass(llvm::ReassociatePass());
+  FPM.addPass(llvm::GVNPass());
+  FPM.addPass(llvm::SimplifyCFGPass());
+  FPM.addPass(llvm::DCEPass());
+
+  llvm::ModulePassManager MPM;
+  MPM.addPass(llvm::createModuleToFunctionPassAdaptor(std::move(FPM)));
+  MPM.run(module, MAM);
+}
+
+LLVMProfileCompiler::LLVMProfileCompiler(llvm::orc::JITTargetMachineBuilder _JTMB, llvm::ObjectCache *_objCache)
+    : IRCompiler(llvm::orc::irManglingOptionsFromTargetOptions(_JTMB.getOptions())),
+      JTMB(std::move(_JTMB)),
+      objCache(_objCache) {}
+
+llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> LLVMProfileCompiler::operator()(llvm::Module &M) {
+  auto config = LLVMOptimizationConfig::readFrom(M);
+  auto TM = config.getTargetMachineBuilder(JTMB).createTargetMachine();
+  if (!TM) return TM.takeError();
+  return llvm::orc::SimpleCompiler(**TM, objCache)(M);
+}
@@ -0,0 +1,168 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include "dcds/codegen/llvm-codegen/llvm-runtime-attributes.hpp"
+
+#include <unordered_map>
+
+#include "dcds/codegen/llvm-codegen/functions.hpp"
+#include "dcds/codegen/llvm-codegen/llvm-context.hpp"
+#include "dcds/indexes/index-functions.hpp"
+
+using namespace dcds;
+using AK = llvm::Attribute::AttrKind;
+
+// The transaction manager, which the storage and lock functions may read, but neither write nor keep.
+static const std::vector<AK> txn_manager_ptr = {AK::NoCapture, AK::ReadOnly};
+// Runtime pointers which the callee dereferences, updates and may keep (e.g., transactions in undo logs or pools).
+static const std::vector<AK> runtime_ptr = {};
+// Destination/source buffers in the memory of the generated code.
+static const std::vector<AK> dst_ptr = {AK::NoCapture, AK::NoAlias, AK::WriteOnly};
+static const std::vector<AK> src_ptr = {AK::NoCapture, AK::ReadOnly};
+static const std::vector<AK> scalar = {};
+
+// NOTE: nounwind holds for the inputs generated code passes; out-of-memory in the runtime is fatal anyway.
+// Storage functions: the generated code loads and stores columns directly, so these may access any memory. Resolving a
+// record's table may also lock the registry and fill a per-thread cache, so none of them is nosync or nofree.
+static const std::vector<AK> reads_storage = {AK::NoUnwind, AK::WillReturn};
+// Lookups of records and column addresses, which derive from record and table metadata only: they write no memory the
+// module can observe (only the per-thread table cache), hence readonly, so equal calls with no write in between are
+// combined. Not speculatable, as the record may be behind a null-check in inlined method calls.
+static const std::vector<AK> storage_lookup = {AK::NoUnwind, AK::WillReturn, AK::ReadOnly};
+// Writes to storage, transaction begin/end and locks: they are compiler barriers, which loads are neither moved across
+// nor forwarded over.
+static const std::vector<AK> updates_storage = {AK::NoUnwind, AK::WillReturn};
+// Index lookups and scans synchronize with writers (group versions, bucket locks, reclamation epochs) and read index
+// memory which generated code also reads directly (inline probes, filters), so they get no memory attributes either.
+static const std::vector<AK> index_lookup = {AK::NoUnwind, AK::WillReturn};
+
+template <typename K>
+static void addIndexFunctions(std::unordered_map<std::string, LLVMRuntimeAttributes::function_attributes_t> &table) {
+  table[getFunctionName((void *)index_find<K>)] = {index_lookup, {scalar, scalar}};
+  // uintptr_t index_find_txn(void* txnPtr, uintptr_t index, K key); also reads the log of the txn.
+  table[getFunctionName((void *)index_find_txn<K>)] = {index_lookup, {runtime_ptr, scalar, scalar}};
+  table[getFunctionName((void *)index_insert<K>)] = {updates_storage, {scalar, scalar, scalar}};
+  table[getFunctionName((void *)index_remove<K>)] = {updates_storage, {scalar, scalar}};
+  // bool index_insert_txn(void* txnPtr, uintptr_t index, K key, uintptr_t value); also locks and logs in the txn.
+  table[getFunctionName((void *)index_insert_txn<K>)] = {updates_storage, {runtime_ptr, scalar, scalar, scalar}};
+  table[getFunctionName((void *)index_insert_deferred_txn<K>)] = {updates_storage,
+                                                                  {runtime_ptr, scalar, scalar, scalar}};
+  table[getFunctionName((void *)index_remove_txn<K>)] = {updates_storage, {runtime_ptr, scalar, scalar, dst_ptr}};
+  // bool index_scan_next(uintptr_t index, K* cursor, bool inclusive, K upper, uintptr_t* record);
+  table[getFunctionName((void *)index_scan_next<K>)] = {index_lookup,
+                                                        {scalar, {AK::NoCapture}, scalar, scalar, dst_ptr}};
+}
+
+// Binary keys are passed by pointer, to a key in the frame of the generated code which the runtime copies if it keeps.
+template <typename K>
+static void addBinaryKeyIndexFunctions(
+    std::unordered_map<std::string, LLVMRuntimeAttributes::function_attributes_t> &table) {
+  table[getFunctionName((void *)index_find_ref<K>)] = {index_lookup, {scalar, src_ptr}};
+  table[getFunctionName((void *)index_find_txn_ref<K>)] = {index_lookup, {runtime_ptr, scalar, src_ptr}};
+  table[getFunctionName((void *)index_remove_ref<K>)] = {updates_storage, {scalar, src_ptr}};
+  table[getFunctionName((void *)index_insert_txn_ref<K>)] = {updates_storage, {runtime_ptr, scalar, src_ptr, scalar}};
+  table[getFunctionName((void *)index_insert_deferred_txn_ref<K>)] = {updates_storage,
+                                                                      {runtime_ptr, scalar, src_ptr, scalar}};
+  table[getFunctionName((void *)index_remove_txn_ref<K>)] = {updates_storage,
+                                                             {runtime_ptr, scalar, src_ptr, dst_ptr}};
+  table[getFunctionName((void *)index_scan_next_ref<K>)] = {index_lookup,
+                                                            {scalar, {AK::NoCapture}, scalar, src_ptr, dst_ptr}};
+}
+
+static std::unordered_map<std::string, LLVMRuntimeAttributes::function_attributes_t> createAttributeTable() {
+  std::unordered_map<std::string, LLVMRuntimeAttributes::function_attributes_t> table;
+
+  // void table_read_attribute(void* _txnManager, uintptr_t _mainRecord, void* txn, void* dst, size_t attributeIdx);
+  table["table_read_attribute"] = {reads_storage, {txn_manager_ptr, scalar, runtime_ptr, dst_ptr, scalar}};
+  table["table_read_attribute_offset"] = {reads_storage,
+                                          {txn_manager_ptr, scalar, runtime_ptr, dst_ptr, scalar, scalar}};
+
+  // uintptr_t table_get_nth_record(void* _txnManager, uintptr_t _mainRecord, void* txnPtr, size_t record_offset);
+  table["table_get_nth_record"] = {storage_lookup, {txn_manager_ptr, scalar, runtime_ptr, scalar}};
+
+  // uintptr_t table_read_runtime_constant(uintptr_t _mainRecord, size_t attributeIdx);
+  // The value is fixed once the record is constructed, and generated code never stores to it directly.
+  table["table_read_runtime_constant"] = {storage_lookup, {scalar, scalar}};
+
+  // void* table_get_column(uintptr_t _mainRecord, size_t attributeIdx);
+  // Reads only metadata, never the column contents. Loops over an array call it once, before the loop, rather than
+  // relying on LLVM to hoist it past the stores to the elements.
+  table["table_get_column"] = {storage_lookup, {scalar, scalar}};
+
+  // void table_write_attribute(void* _txnManager, uintptr_t _mainRecord, void* txnPtr, void* src, uint attributeIdx);
+  table["table_write_attribute"] = {updates_storage, {txn_manager_ptr, scalar, runtime_ptr, src_ptr, scalar}};
+  table["table_write_attribute_offset"] = {updates_storage,
+                                           {txn_manager_ptr, scalar, runtime_ptr, src_ptr, scalar, scalar}};
+
+  // bool lock_shared/lock_exclusive(void* _txnManager, void* txnPtr, uintptr_t record);
+  table["lock_shared"] = {updates_storage, {txn_manager_ptr, runtime_ptr, scalar}};
+  table["lock_exclusive"] = {updates_storage, {txn_manager_ptr, runtime_ptr, scalar}};
+
+  // void* beginTxn(void* txnManager, bool isReadOnly); bool endTxn(void* txnManager, void* txnPtr);
+  table["beginTxn"] = {updates_storage, {runtime_ptr, scalar}};
+  table["endTxn"] = {updates_storage, {runtime_ptr, runtime_ptr}};
+
+  // bool index_txn_has_writes(void* txnPtr); reads the log of the txn, which its index writes extend.
+  table["index_txn_has_writes"] = {index_lookup, {runtime_ptr}};
+
+  // bool epoch_pin(); void epoch_unpin(); the reads of the operation are neither moved above the pin nor below the
+  // unpin.
+  table["epoch_pin"] = {updates_storage, {}};
+  table["epoch_unpin"] = {updates_storage, {}};
+
+  // uintptr_t extractRecordFromDsContainer(void* container);
+  table["extractRecordFromDsContainer"] = {{AK::NoUnwind, AK::WillReturn, AK::NoFree, AK::NoSync, AK::ReadOnly,
+                                            AK::ArgMemOnly},
+                                           {src_ptr}};
+
+  addIndexFunctions<int64_t>(table);
+  addIndexFunctions<int32_t>(table);
+  addIndexFunctions<float>(table);
+  addIndexFunctions<double>(table);
+  addIndexFunctions<uintptr_t>(table);
+  addBinaryKeyIndexFunctions<indexes::BinaryKey<16>>(table);
+  addBinaryKeyIndexFunctions<indexes::BinaryKey<32>>(table);
+
+  return table;
+}
+
+const LLVMRuntimeAttributes::function_attributes_t *LLVMRuntimeAttributes::lookup(const std::string &symbol_name) {
+  static const auto table = createAttributeTable();
+  auto it = table.find(symbol_name);
+  return it == table.end() ? nullptr : &it->second;
+}
+
+bool LLVMRuntimeAttributes::annotate(llvm::Function *fn) {
+  assert(fn);
+  auto *attributes = lookup(fn->getName().str());
+  if (!attributes) return false;
+
+  assert(attributes->params.size() == fn->arg_size() && "runtime function signature and attributes do not match");
+  for (auto kind : attributes->fn) fn->addFnAttr(kind);
+  for (size_t i = 0; i < attributes->params.size() && i < fn->arg_size(); i++) {
+    for (auto kind : attributes->params[i]) {
+      // pointer attributes on integer parameters would fail verification, e.g., if a signature changed.
+      if (fn->getArg(i)->getType()->isPointerTy()) fn->addParamAttr(i, kind);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,196 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include "dcds/exporter/code-exporter.hpp"
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+#include "dcds/builder/function-builder.hpp"
+#include "dcds/codegen/llvm-codegen/llvm-codegen.hpp"
+
+using namespace dcds;
+
+void CodeExporter::exportToDirectory(const std::string &output_directory) {
+  auto ec = llvm::sys::fs::create_directories(output_directory);
+  CHECK(!ec) << "Cannot create output directory: " << output_directory << " (" << ec.message() << ")";
+
+  llvm::SmallString<256> object_path(output_directory);
+  llvm::sys::path::append(object_path, builder->getName() + ".o");
+  llvm::SmallString<256> header_path(output_directory);
+  llvm::sys::path::append(header_path, builder->getName() + ".hpp");
+
+  exportObjectFile(object_path.str().str());
+  exportHeaderFile(header_path.str().str());
+}
+
+void CodeExporter::exportObjectFile(const std::string &filename) {
+  LOG(INFO) << "[CodeExporter] Exporting object file: " << filename;
+
+  // Independent codegen engine, the builder may or may not be JIT-ed in this process. The engine takes the target
+  // from the builder when created, so the exporter's target is swapped in only for that.
+  auto builder_target = builder->getTargetHint();
+  builder->addHint(target);
+  std::shared_ptr<Codegen> engine = std::make_shared<LLVMCodegen>(builder.get());
+  builder->addHint(builder_target);
+  builder->build_no_jit(engine, false);
+  engine->emitObjectFile(filename);
+}
+
+void CodeExporter::exportHeaderFile(const std::string &filename) {
+  LOG(INFO) << "[CodeExporter] Exporting header file: " << filename;
+
+  const auto ds_name = builder->getName();
+  const auto class_name = toIdentifier(ds_name);
+  const auto guard = "DCDS_AOT_" + class_name + "_HPP";
+
+  std::stringstream out;
+  out << getLicenseString() << std::endl;
+  out << "// Generated by dcds::CodeExporter for the data structure '" << ds_name << "'. DO NOT EDIT." << std::endl;
+  out << std::endl;
+  out << "#ifndef " << guard << std::endl;
+  out << "#define " << guard << std::endl;
+  out << std::endl;
+  out << "#include <cstddef>" << std::endl;
+  out << "#include <cstdint>" << std::endl;
+  out << std::endl;
+
+  // Symbols in the exported object. asm-labels keep the exact symbol names even if the type name is not a valid
+  // C++ identifier.
+  out << "namespace dcds::aot::detail {" << std::endl;
+  out << "extern \"C\" void destroyDsContainer(void *container);" << std::endl;
+  out << "void *" << class_name << "_constructor() __asm__(\"" << ds_name << "_constructor\");" << std::endl;
+
+  std::stringstream methods;
+  for (auto &[fn_name, fb] : builder->functions) {
+    auto ret_type = toCppType(fb->getReturnValueType());
+    auto fn_identifier = toIdentifier(fn_name);
+
+    std::stringstream params;
+    std::stringstream args;
+    for (auto &arg : fb->getArguments()) {
+      auto arg_name = toIdentifier(arg->getName());
+      params << ", " << toCppType(arg->getType()) << (arg->is_reference_type ? " *" : " ") << arg_name;
+      args << ", " << arg_name;
+    }
+    auto params_str = params.str();
+    auto args_str = args.str();
+
+    out << ret_type << " " << class_name << "_" << fn_identifier << "(void *txnManager, uintptr_t mainRecord"
+        << params_str << ") __asm__(\"" << ds_name << "_" << fn_name << "\");" << std::endl;
+
+    methods << "  inline " << ret_type << " " << fn_identifier << "("
+            << (params_str.empty() ? "" : params_str.substr(2)) << ") {" << std::endl;
+    methods << "    return detail::" << class_name << "_" << fn_identifier
+            << "(_container->txnManager, _container->mainRecord" << args_str << ");" << std::endl;
+    methods << "  }" << std::endl;
+  }
+  out << "}  // namespace dcds::aot::detail" << std::endl;
+  out << std::endl;
+
+  out << "namespace dcds::aot {" << std::endl;
+  out << std::endl;
+  out << "class " << class_name << " {" << std::endl;
+  out << " public:" << std::endl;
+  out << "  " << class_name << "() : _container(static_cast<container_t *>(detail::" << class_name
+      << "_constructor())) {}" << std::endl;
+  out << "  ~" << class_name << "() { detail::destroyDsContainer(_container); }" << std::endl;
+  out << "  " << class_name << "(const " << class_name << " &) = delete;" << std::endl;
+  out << "  " << class_name << " &operator=(const " << class_name << " &) = delete;" << std::endl;
+  out << std::endl;
+  out << " public:" << std::endl;
+  out << methods.str();
+  out << std::endl;
+  out << " private:" << std::endl;
+  out << "  // Mirrors dcds::JitContainer::dcds_jit_container_t" << std::endl;
+  out << "  struct container_t {" << std::endl;
+  out << "    void *txnManager;" << std::endl;
+  out << "    uintptr_t mainRecord;" << std::endl;
+  out << "  };" << std::endl;
+  out << "  container_t *_container;" << std::endl;
+  out << "};" << std::endl;
+  out << std::endl;
+  out << "}  // namespace dcds::aot" << std::endl;
+  out << std::endl;
+  out << "#endif  // " << guard << std::endl;
+
+  std::ofstream file(filename);
+  CHECK(file.is_open()) << "Cannot open output file: " << filename;
+  file << out.str();
+}
+
+std::string CodeExporter::toCppType(dcds::valueType type) {
+  switch (type) {
+    case valueType::INT64:
+      return "int64_t";
+    case valueType::INT32:
+      return "int32_t";
+    case valueType::FLOAT:
+      return "float";
+    case valueType::DOUBLE:
+      return "double";
+    case valueType::RECORD_PTR:
+      return "uintptr_t";
+    case valueType::VOID:
+      return "void";
+    case valueType::BOOL:
+      return "bool";
+  }
+  CHECK(false) << "Unknown type: " << type;
+  return {};
+}
+
+std::string CodeExporter::toIdentifier(const std::string &name) {
+  std::string ret = name;
+  for (auto &c : ret) {
+    if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+  }
+  if (ret.empty() || std::isdigit(static_cast<unsigned char>(ret[0]))) ret.insert(0, "_");
+  return ret;
+}
+
+std::string CodeExporter::getLicenseString() {
+  return R"(/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */)";
+}
@@ -0,0 +1,79 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include "dcds/indexes/binary-key.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dcds::indexes {
+
+static constexpr size_t hash_bytes = 7;
+
+StringKey::key_type StringKey::pack(std::string_view prefix, uint8_t last, uint64_t hash) {
+  uint8_t bytes[sizeof(key_type)]{};
+  std::memcpy(bytes, prefix.data(), prefix.size());
+  for (size_t i = 0; i < hash_bytes; i++) {
+    bytes[inline_bytes + i] = static_cast<uint8_t>(hash >> (8 * (hash_bytes - 1 - i)));
+  }
+  bytes[sizeof(key_type) - 1] = last;
+
+  // big-endian words, so that the order of the words is the order of the bytes.
+  key_type key{};
+  for (size_t i = 0; i < key_type::n_words; i++) {
+    uint64_t word;
+    std::memcpy(&word, bytes + 8 * i, sizeof(word));
+    key.words[i] = std::endian::native == std::endian::little ? std::byteswap(word) : word;
+  }
+  return key;
+}
+
+// Over the whole string, by 8-byte words, so that it is the same in every process (unlike std::hash).
+uint64_t StringKey::hashOf(std::string_view str) {
+  uint64_t h = str.size() * key_type::word_multipliers[0];
+  for (size_t i = 0; i < str.size(); i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    std::memcpy(&word, str.data() + i, std::min(sizeof(uint64_t), str.size() - i));
+    h = (h ^ word) * key_type::word_multipliers[1];
+    h ^= h >> 29;
+  }
+  return (h * key_type::word_multipliers[2]) >> (8 * (sizeof(uint64_t) - hash_bytes));
+}
+
+StringKey::key_type StringKey::encode(std::string_view str) {
+  if (str.size() <= inline_bytes) return pack(str, static_cast<uint8_t>(str.size()), 0);
+  return pack(str.substr(0, inline_bytes), long_marker, hashOf(str));
+}
+
+bool StringKey::isExact(const key_type &key) { return (key.words[key_type::n_words - 1] & 0xFF) != long_marker; }
+
+std::string StringKey::decode(const key_type &key) {
+  uint8_t bytes[sizeof(key_type)];
+  for (size_t i = 0; i < key_type::n_words; i++) {
+    auto word = std::endian::native == std::endian::little ? std::byteswap(key.words[i]) : key.words[i];
+    std::memcpy(bytes + 8 * i, &word, sizeof(word));
+  }
+  auto len = isExact(key) ? bytes[sizeof(key_type) - 1] : inline_bytes;
+  return {reinterpret_cast<const char *>(bytes), len};
+}
+
+}  // namespace dcds::indexes
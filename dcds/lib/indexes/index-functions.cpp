@@ -21,6 +21,7 @@
 
 #include "dcds/indexes/index-functions.hpp"
 
+#include "dcds/indexes/index-registry.hpp"
 #include "dcds/indexes/index.hpp"
 
 // #include <libcuckoo/cuckoohash_map.hh>
@@ -42,31 +43,36 @@
 //   }
 // }
 
-uintptr_t createIndexMap(dcds::valueType key_type) {
-  void* ret;
-
-  switch (key_type) {
-    case dcds::valueType::INT64:
-      ret = new dcds::indexes::CuckooHashIndex<int64_t>();
-      break;
-    case dcds::valueType::INT32:
-      ret = new dcds::indexes::CuckooHashIndex<int32_t>();
-      break;
-    case dcds::valueType::FLOAT:
-      ret = new dcds::indexes::CuckooHashIndex<float>();
-      break;
-    case dcds::valueType::DOUBLE:
-      ret = new dcds::indexes::CuckooHashIndex<double>();
-      break;
-    case dcds::valueType::RECORD_PTR:
-    case dcds::valueType::BOOL:
-    case dcds::valueType::VOID:
-      assert(false);
-      break;
-  }
-
-  assert(ret != nullptr);
+uintptr_t createIndexMap(dcds::valueType key_type, size_t key_bytes, dcds::hints::IndexHints index_type,
+                         size_t capacity, size_t growth_factor, bool negative_lookup_filter) {
+  auto ret = dcds::indexes::IndexRegistry::getInstance().createIndex(
+      key_type, key_bytes, index_type, {capacity, growth_factor, negative_lookup_filter});
 
   // LOG(INFO) << "createIndexMap: ptr: " << ret << " | uintptr_t: " << reinterpret_cast<uintptr_t>(ret);
   return reinterpret_cast<uintptr_t>(ret);
 }
+
+bool index_lock_key(dcds::txn::Txn* txn, dcds::txn::cc::RecordMetaData& key_lock) {
+  if (txn->key_locks.contains(&key_lock)) return true;
+
+  if (key_lock.lock_ex()) {
+    txn->key_locks.insert(&key_lock);
+    return true;
+  } else {
+    txn->status = dcds::txn::TXN_STATUS::ABORTED;
+    return false;
+  }
+}
+
+bool index_txn_has_writes(void* txnPtr) {
+  auto* txn = static_cast<dcds::txn::Txn*>(txnPtr);
+  return txn && txn->getLog().hasIndexEntries();
+}
+
+DCDS_INDEX_FUNCTIONS(template, int64_t)
+DCDS_INDEX_FUNCTIONS(template, int32_t)
+DCDS_INDEX_FUNCTIONS(template, float)
+DCDS_INDEX_FUNCTIONS(template, double)
+DCDS_INDEX_FUNCTIONS(template, uintptr_t)
+DCDS_BINARY_KEY_INDEX_FUNCTIONS(template, dcds::indexes::BinaryKey<16>)
+DCDS_BINARY_KEY_INDEX_FUNCTIONS(template, dcds::indexes::BinaryKey<32>)
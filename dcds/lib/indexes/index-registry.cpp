@@ -0,0 +1,102 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include "dcds/indexes/index-registry.hpp"
+
+#include "dcds/indexes/btree-index.hpp"
+#include "dcds/indexes/open-addressing-index.hpp"
+#include "dcds/util/logging.hpp"
+
+namespace dcds::indexes {
+
+template <typename K>
+static IndexBase* createTypedIndex(hints::IndexHints index_type, const hints::IndexSizeHints& size_hints) {
+  switch (index_type) {
+    case hints::IndexHints::HASH:
+      return new CuckooHashIndex<K>(size_hints.capacity);
+    case hints::IndexHints::ORDERED:
+      return new BTreeIndex<K>();
+    case hints::IndexHints::OPEN_ADDRESSING:
+      if constexpr (sizeof(K) <= sizeof(uint64_t)) {
+        return new OpenAddressingIndex<K>(size_hints.capacity, size_hints.growth_factor);
+      } else {
+        CHECK(false) << "Open-addressing indexes only have keys of up to 8 bytes, not " << sizeof(K);
+        return nullptr;
+      }
+  }
+  assert(false);
+  return nullptr;
+}
+
+static IndexBase* createKeyedIndex(dcds::valueType key_type, size_t key_bytes, hints::IndexHints index_type,
+                                   const hints::IndexSizeHints& size_hints) {
+  if (key_bytes == 16) return createTypedIndex<BinaryKey<16>>(index_type, size_hints);
+  if (key_bytes == 32) return createTypedIndex<BinaryKey<32>>(index_type, size_hints);
+  CHECK(key_bytes == 0) << "Unsupported width of binary keys: " << key_bytes;
+
+  switch (key_type) {
+    case dcds::valueType::INT64:
+      return createTypedIndex<int64_t>(index_type, size_hints);
+    case dcds::valueType::INT32:
+      return createTypedIndex<int32_t>(index_type, size_hints);
+    case dcds::valueType::FLOAT:
+      return createTypedIndex<float>(index_type, size_hints);
+    case dcds::valueType::DOUBLE:
+      return createTypedIndex<double>(index_type, size_hints);
+    case dcds::valueType::RECORD_PTR:
+    case dcds::valueType::BOOL:
+    case dcds::valueType::VOID:
+      assert(false);
+      break;
+  }
+  return nullptr;
+}
+
+IndexBase* IndexRegistry::createIndex(dcds::valueType key_type, size_t key_bytes, hints::IndexHints index_type,
+                                      const hints::IndexSizeHints& size_hints) {
+  IndexBase* index = createKeyedIndex(key_type, key_bytes, index_type, size_hints);
+  assert(index != nullptr);
+  if (size_hints.negative_lookup_filter) index->enableNegativeLookupFilter(size_hints.capacity);
+
+  std::unique_lock lk(this->registry_lk);
+  indexes.insert(index);
+  return index;
+}
+
+std::vector<IndexStats> IndexRegistry::getStats() {
+  std::unique_lock lk(this->registry_lk);
+  std::vector<IndexStats> stats;
+  stats.reserve(indexes.size());
+  for (auto* index : indexes) {
+    stats.push_back(index->_stats());
+    if (auto* filter = index->negativeLookupFilter()) stats.back().filter_bytes = filter->memoryBytes();
+  }
+  return stats;
+}
+
+void IndexRegistry::clear() {
+  std::unique_lock lk(this->registry_lk);
+  for (auto* index : indexes) delete index;
+  indexes.clear();
+}
+
+}  // namespace dcds::indexes
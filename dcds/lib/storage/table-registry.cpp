@@ -26,8 +26,7 @@ namespace dcds::storage {
 bool TableRegistry::exists(table_id_t tableId) {
   std::shared_lock lk(this->registry_lk);
 
-  return (tables.lookup(tableId) != nullptr);  // llvm::DenseMap
-  // return tables.contains(tableId);          // std::map
+  return tables.contains(tableId);
 }
 bool TableRegistry::exists(const std::string &name) {
   std::shared_lock lk(this->registry_lk);
@@ -35,7 +34,7 @@ bool TableRegistry::exists(const std::string &name) {
 }
 
 Table *TableRegistry::createTable(const std::string &name, const std::vector<AttributeDef> &columns,
-                                  bool multi_version) {
+                                  const record_layout_t &layout, bool multi_version) {
   size_t record_size = 0;
   for (const auto &c : columns) {
     record_size += c.getSize();
@@ -50,10 +49,15 @@ Table *TableRegistry::createTable(const std::string &name, const std::vector<Att
   if (multi_version) {
     throw std::runtime_error("unimplemented MV");
   } else {
-    auto tablePtr = new SingleVersionRowStore(tableId, name, record_size, columns);
+    Table *tablePtr;
+    if (layout.column_store) {
+      tablePtr = new SingleVersionColumnStore(tableId, name, record_size, columns, layout);
+    } else {
+      tablePtr = new SingleVersionRowStore(tableId, name, record_size, columns, layout);
+    }
     // assert(tables.insert(tableId, tablePtr)); // cuckoo::map
     // tables.emplace(tableId, tablePtr); // std::map
-    tables.try_emplace(tableId, tablePtr);  // llvm::DenseMap
+    tables.try_emplace(tableId, tablePtr);
     return tablePtr;
   }
 }
@@ -80,8 +84,8 @@ Table *TableRegistry::getTable(table_id_t tableId) {
   //      return {};
   //    }
 
-  // llvm::DenseMap
-  return tables.lookup(tableId);
+  auto iter = tables.find(tableId);
+  return iter != tables.end() ? iter->second : nullptr;
 }
 Table *TableRegistry::getTable(const std::string &name) {
   //  if (table_name_map.contains(name)) {
@@ -92,7 +96,7 @@ Table *TableRegistry::getTable(const std::string &name) {
   std::shared_lock lk(this->registry_lk);
 
   if (auto iter = table_name_map.find(name); likely(iter != table_name_map.end())) {
-    return tables.lookup(iter->second);
+    if (auto table = tables.find(iter->second); likely(table != tables.end())) return table->second;
   }
   return {};
 }
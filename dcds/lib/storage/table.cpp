@@ -21,11 +21,13 @@
 
 #include "dcds/storage/table.hpp"
 
+#include <algorithm>
+#include <numeric>
 #include <utility>
 
 #include "dcds/storage/table-registry.hpp"
+#include "dcds/util/epoch.hpp"
 #include "dcds/util/logging.hpp"
-#include "llvm/ADT/DenseMap.h"
 
 using namespace dcds::storage;
 
@@ -46,49 +48,81 @@ Table* RecordReference::getTable() {
   //    return tablePtr;
   //  }
 
-  // llvm::SmallDenseMap cache --> Best-so-far
-  static thread_local llvm::SmallDenseMap<table_id_t, Table*> cache_map;
-  auto ret = cache_map.lookup(tableId);
-  if (unlikely(ret == nullptr)) {
-    auto tablePtr = registry->getTable(static_cast<table_id_t>(tableId));
-    cache_map.try_emplace(tableId, tablePtr);
-    return tablePtr;
-  } else {
-    return ret;
-  }
+  // table ids are dense: a per-thread array of the tables by id.
+  static thread_local std::vector<Table*> cache;
+  if (likely(tableId < cache.size() && cache[tableId] != nullptr)) return cache[tableId];
+
+  auto tablePtr = registry->getTable(static_cast<table_id_t>(tableId));
+  if (tableId >= cache.size()) cache.resize(tableId + 1, nullptr);
+  cache[tableId] = tablePtr;
+  return tablePtr;
 }
 
+static inline size_t alignUp(size_t size, size_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
 Table::Table(table_id_t tableId, std::string tableName, size_t recordSize, std::vector<AttributeDef> attributes,
-             bool is_multi_versioned)
+             record_layout_t record_layout, bool is_multi_versioned)
     : table_id(tableId),
       table_name(std::move(tableName)),
-      record_size(recordSize + sizeof(record_metadata_t)),
       record_size_data_only(recordSize),
       columns(std::move(attributes)),
+      layout(record_layout),
       is_multiversion(is_multi_versioned) {
   // LOG(INFO) << "Table(): " << table_name;
   // LOG(INFO) << "sizeof(record_metadata_t): " << sizeof(record_metadata_t);
 
   size_t rec_size = 0;
-  size_t col_offset = 0;
+  bool has_cold = false;
 
   for (const auto& a : columns) {
-    auto col_width = a.getSize();
+    column_size.push_back(a.getSize());
+    column_input_offsets.push_back(rec_size);
+    column_is_cold.push_back(a.isCold());
 
-    column_size.push_back(col_width);
-    column_size_offsets.push_back(col_offset);
-    column_size_offset_pairs.emplace_back(col_width, col_offset);
+    has_cold |= a.isCold();
+    rec_size += a.getSize();
+  }
+  assert(recordSize == rec_size);
 
-    col_offset += col_width;
-    rec_size += col_width;
+  // physical order of the columns: as declared, or widest first so that all are naturally aligned.
+  std::vector<size_t> order(columns.size());
+  std::iota(order.begin(), order.end(), 0);
+  if (layout.sort_columns) {
+    std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) { return column_size[a] > column_size[b]; });
   }
 
-  assert(recordSize == rec_size);
+  // the pointer to the cold part comes first in the hot part.
+  size_t hot_offset = has_cold ? sizeof(uintptr_t) : 0;
+  size_t cold_offset = 0;
+  column_size_offsets.resize(columns.size());
+  for (auto i : order) {
+    auto& col_offset = column_is_cold[i] ? cold_offset : hot_offset;
+    column_size_offsets[i] = col_offset;
+    col_offset += column_size[i];
+  }
+  for (size_t i = 0; i < columns.size(); i++) {
+    column_size_offset_pairs.emplace_back(column_size[i], column_size_offsets[i]);
+  }
+
+  data_size = hot_offset;
+  cold_data_size = cold_offset;
+  cold_stride = alignUp(cold_data_size, sizeof(uintptr_t));
+
+  auto alignment = std::max<size_t>(layout.record_alignment, 1);
+  if (layout.separate_metadata) {
+    record_size = alignUp(sizeof(record_metadata_t) + sizeof(uintptr_t), alignment);
+    data_stride = alignUp(data_size, alignment);
+  } else {
+    record_size = alignUp(sizeof(record_metadata_t) + data_size, alignment);
+  }
+
+  identity_layout = !has_cold && !layout.separate_metadata &&
+                    std::equal(column_size_offsets.begin(), column_size_offsets.end(), column_input_offsets.begin());
 }
 
 SingleVersionRowStore::SingleVersionRowStore(table_id_t tableId, const std::string& table_name, size_t recordSize,
-                                             std::vector<AttributeDef> attributes)
-    : Table(tableId, table_name, recordSize, std::move(attributes), false) {}
+                                             std::vector<AttributeDef> attributes, record_layout_t record_layout)
+    : Table(tableId, table_name, recordSize, std::move(attributes), record_layout, false) {}
 
 SingleVersionRowStore::~SingleVersionRowStore() {
   allocation_lock.acquire();
@@ -99,10 +133,14 @@ SingleVersionRowStore::~SingleVersionRowStore() {
   allocation_lock.release();
 }
 
-void* SingleVersionRowStore::allocateRecordMemory(size_t n_records) {
+void* SingleVersionRowStore::allocateRecordMemory(size_t n_records) { return allocateMemory(record_size * n_records); }
+
+void* SingleVersionRowStore::allocateMemory(size_t bytes) {
   // TODO: use some sort of caching or allocate more and then return from the allocations.
-  // FIXME: what about alignments?
-  void* mem = malloc(record_size * n_records);
+  // groups of records (insertNRecord) start at the record alignment as well.
+  auto alignment = layout.record_alignment;
+  void* mem =
+      alignment > alignof(std::max_align_t) ? aligned_alloc(alignment, alignUp(bytes, alignment)) : malloc(bytes);
   {
     allocation_lock.acquire();
     memory_allocations.insert(mem);
@@ -110,13 +148,15 @@ void* SingleVersionRowStore::allocateRecordMemory(size_t n_records) {
   }
   return mem;
 }
+// Records of rolled back transactions: a concurrent operation may have read the record from where the transaction
+// linked it (e.g., a record attribute), so the memory is only freed once no pinned operation can hold it (util::Epoch).
 void SingleVersionRowStore::freeRecordMemory(void* mem) {
   {
     allocation_lock.acquire();
     memory_allocations.erase(mem);
     allocation_lock.release();
   }
-  free(mem);
+  dcds::util::Epoch::retire(mem, free);
 }
 
 record_reference_t SingleVersionRowStore::insertRecord(dcds::txn::Txn* txn, const void* data) {
@@ -124,11 +164,8 @@ record_reference_t SingleVersionRowStore::insertRecord(dcds::txn::Txn* txn, cons
   CHECK(!txn || (txn && !txn->read_only)) << "RO txn inserting ???";
 
   void* mem = allocateRecordMemory();
-  //  auto* meta = new (mem) record_metadata_t(txn ? txn->txnTs.start_time : 0);
-  auto* meta = new (mem) record_metadata_t(0);
-  void* dataMemory = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(mem) + sizeof(record_metadata_t));
-
-  memcpy(dataMemory, data, record_size_data_only);
+  auto* meta = initRecords(mem, 1);
+  copyRecordData(meta, data);
 
   auto rec = record_reference_t{this->table_id, meta};
   if (likely(txn != nullptr)) {
@@ -141,32 +178,54 @@ record_reference_t SingleVersionRowStore::insertNRecord(txn::Txn* txn, size_t N,
   CHECK(!txn || (txn && !txn->read_only)) << "RO txn inserting ???";
 
   void* mem = allocateRecordMemory(N);
-  auto mem_p = reinterpret_cast<uintptr_t>(mem);
-  record_reference_t ret;
+  auto* first = initRecords(mem, N);
 
-  for (size_t i = 0; i < N; i++) {
-    void* base = reinterpret_cast<void*>(mem_p + (record_size * i));
+  if (likely(data != nullptr)) {
+    auto mem_p = reinterpret_cast<uintptr_t>(first);
+    for (size_t i = 0; i < N; i++) {
+      copyRecordData(reinterpret_cast<record_metadata_t*>(mem_p + (record_size * i)), data);
+    }
+  }
+  return record_reference_t{this->table_id, first};
+}
 
-    auto* meta = new (base) record_metadata_t(0);
-    if (likely(data != nullptr)) {
-      void* dataMemory = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(base) + sizeof(record_metadata_t));
-      memcpy(dataMemory, data, record_size_data_only);
+record_metadata_t* SingleVersionRowStore::initRecords(void* mem, size_t n_records) {
+  auto mem_p = reinterpret_cast<uintptr_t>(mem);
+  auto data_mem_p = layout.separate_metadata ? reinterpret_cast<uintptr_t>(allocateMemory(data_stride * n_records)) : 0;
+  auto cold_mem_p = hasColdPart() ? reinterpret_cast<uintptr_t>(allocateMemory(cold_stride * n_records)) : 0;
+
+  for (size_t i = 0; i < n_records; i++) {
+    //  auto* meta = new (base) record_metadata_t(txn ? txn->txnTs.start_time : 0);
+    auto* meta = new (reinterpret_cast<void*>(mem_p + (record_size * i))) record_metadata_t(0);
+    if (layout.separate_metadata) {
+      dataPointer(meta) = data_mem_p + (data_stride * i);
+    }
+    if (hasColdPart()) {
+      coldPart(meta) = cold_mem_p + (cold_stride * i);
     }
+  }
+  return reinterpret_cast<record_metadata_t*>(mem);
+}
+
+void SingleVersionRowStore::copyRecordData(record_metadata_t* rc, const void* data) {
+  if (likely(identity_layout)) {
+    memcpy(reinterpret_cast<void*>(dataPart(rc)), data, record_size_data_only);
+    return;
+  }
 
-    if (i == 0) ret = record_reference_t{this->table_id, meta};
+  auto data_p = reinterpret_cast<uintptr_t>(data);
+  for (uint i = 0; i < columns.size(); i++) {
+    memcpy(columnAddress(rc, i), reinterpret_cast<const void*>(data_p + column_input_offsets[i]), column_size[i]);
   }
-  return ret;
 }
 
 void SingleVersionRowStore::updateAttribute(txn::Txn* txn, record_metadata_t* rc, void* value, uint attribute_idx) {
-  auto colWidthOffset = column_size_offset_pairs.at(attribute_idx);
-  auto data_ptr =
-      reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(rc) + sizeof(record_metadata_t) + colWidthOffset.second);
+  auto col_width = column_size.at(attribute_idx);
+  auto data_ptr = columnAddress(rc, attribute_idx);
   if (likely(txn != nullptr)) {
-    txn->getLog().addUpdateLog(record_reference_t{this->table_id, rc}.getBase(), attribute_idx, data_ptr,
-                               colWidthOffset.first);
+    txn->getLog().addUpdateLog(record_reference_t{this->table_id, rc}.getBase(), attribute_idx, data_ptr, col_width);
   }
-  memcpy(data_ptr, value, colWidthOffset.first);
+  memcpy(data_ptr, value, col_width);
 }
 
 void SingleVersionRowStore::updateNthRecord(txn::Txn* txn, record_metadata_t* rc, void* value, uint record_offset,
@@ -190,18 +249,13 @@ void SingleVersionRowStore::updateNthRecord(txn::Txn* txn, record_metadata_t* rc
 // }
 
 void SingleVersionRowStore::getData(txn::Txn* txn, record_metadata_t* rc, void* dst, size_t offset, size_t len) {
-  assert(offset + len < record_size);
-  auto data_ptr =
-      reinterpret_cast<record_reference_t*>(reinterpret_cast<uintptr_t>(rc) + sizeof(record_metadata_t) + offset);
-  memcpy(dst, data_ptr, len);
+  assert(offset + len <= data_size);
+  memcpy(dst, reinterpret_cast<void*>(dataPart(rc) + offset), len);
 }
 void SingleVersionRowStore::getAttribute(txn::Txn* txn, record_metadata_t* rc, void* dst, uint attribute_idx) {
   assert(rc != nullptr);
   //  LOG(INFO) << rc << " | " << this->name();
-  auto colWidthOffset = column_size_offset_pairs.at(attribute_idx);
-  auto data_ptr = reinterpret_cast<record_reference_t*>(reinterpret_cast<uintptr_t>(rc) + sizeof(record_metadata_t) +
-                                                        colWidthOffset.second);
-  memcpy(dst, data_ptr, colWidthOffset.first);
+  memcpy(dst, columnAddress(rc, attribute_idx), column_size.at(attribute_idx));
 }
 
 void SingleVersionRowStore::getNthRecord(txn::Txn* txn, record_metadata_t* rc, void* dst, uint record_offset,
@@ -219,10 +273,165 @@ record_reference_t SingleVersionRowStore::getNthRecordReference(txn::Txn* txn, r
 }
 
 void SingleVersionRowStore::rollback_update(record_metadata_t* rc, void* prev_value, uint attribute_idx) {
-  auto colWidthOffset = column_size_offset_pairs.at(attribute_idx);
-  auto data_ptr =
-      reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(rc) + sizeof(record_metadata_t) + colWidthOffset.second);
+  memcpy(columnAddress(rc, attribute_idx), prev_value, column_size.at(attribute_idx));
+}
+void SingleVersionRowStore::rollback_create(record_metadata_t* rc) {
+  if (hasColdPart()) {
+    freeRecordMemory(reinterpret_cast<void*>(coldPart(rc)));
+  }
+  if (layout.separate_metadata) {
+    freeRecordMemory(reinterpret_cast<void*>(dataPointer(rc)));
+  }
+  freeRecordMemory(rc);
+}
+std::pair<void*, size_t> SingleVersionRowStore::getColumn(record_metadata_t* rc, uint attribute_idx) {
+  // the hot (or cold) parts of a group are allocated back to back, see initRecords.
+  if (column_is_cold[attribute_idx]) return {columnAddress(rc, attribute_idx), cold_stride};
+  return {columnAddress(rc, attribute_idx), layout.separate_metadata ? data_stride : record_size};
+}
+
+SingleVersionColumnStore::SingleVersionColumnStore(table_id_t tableId, const std::string& table_name,
+                                                   size_t recordSize, std::vector<AttributeDef> attributes,
+                                                   record_layout_t record_layout)
+    : Table(tableId, table_name, recordSize, std::move(attributes), record_layout, false) {
+  // columns live in the column arrays of the group, so records are only the metadata and the row index.
+  auto alignment = std::max(layout.record_alignment, alignof(record_metadata_t));
+  record_size = alignUp(sizeof(record_metadata_t) + sizeof(size_t), alignment);
+  header_size = alignUp(columns.size() * sizeof(uintptr_t), alignment);
+}
 
-  memcpy(data_ptr, prev_value, colWidthOffset.first);
+SingleVersionColumnStore::~SingleVersionColumnStore() {
+  allocation_lock.acquire();
+  for (auto& m : memory_allocations) {
+    free(m);
+  }
+  memory_allocations.clear();
+  allocation_lock.release();
+}
+
+record_metadata_t* SingleVersionColumnStore::allocateGroup(size_t n_records_in_group, const void* data) {
+  auto columns_offset = alignUp(header_size + (record_size * n_records_in_group), dcds::CACHE_LINE_SIZE);
+  auto bytes = columns_offset;
+  for (auto w : column_size) {
+    bytes += alignUp(w * n_records_in_group, dcds::CACHE_LINE_SIZE);
+  }
+
+  void* mem = aligned_alloc(dcds::CACHE_LINE_SIZE, bytes);
+  {
+    allocation_lock.acquire();
+    memory_allocations.insert(mem);
+    allocation_lock.release();
+  }
+
+  auto mem_p = reinterpret_cast<uintptr_t>(mem);
+  auto* column_bases = reinterpret_cast<uintptr_t*>(mem);
+  auto column_p = mem_p + columns_offset;
+  for (size_t i = 0; i < columns.size(); i++) {
+    column_bases[i] = column_p;
+    column_p += alignUp(column_size[i] * n_records_in_group, dcds::CACHE_LINE_SIZE);
+  }
+
+  auto first_p = mem_p + header_size;
+  for (size_t r = 0; r < n_records_in_group; r++) {
+    auto* meta = new (reinterpret_cast<void*>(first_p + (record_size * r))) record_metadata_t(0);
+    rowOf(meta) = r;
+  }
+
+  // the same data for every record of the group, filled column by column.
+  if (likely(data != nullptr)) {
+    auto data_p = reinterpret_cast<uintptr_t>(data);
+    for (size_t i = 0; i < columns.size(); i++) {
+      auto src = reinterpret_cast<const void*>(data_p + column_input_offsets[i]);
+      for (size_t r = 0; r < n_records_in_group; r++) {
+        memcpy(reinterpret_cast<void*>(column_bases[i] + (column_size[i] * r)), src, column_size[i]);
+      }
+    }
+  }
+
+  n_records += n_records_in_group;
+  return reinterpret_cast<record_metadata_t*>(first_p);
+}
+
+record_reference_t SingleVersionColumnStore::insertRecord(txn::Txn* txn, const void* data) {
+  CHECK(!txn || (txn && !txn->read_only)) << "RO txn inserting ???";
+
+  auto rec = record_reference_t{this->table_id, allocateGroup(1, data)};
+  if (likely(txn != nullptr)) {
+    txn->getLog().addInsertLog(rec.getBase());
+  }
+  return rec;
+}
+
+record_reference_t SingleVersionColumnStore::insertNRecord(txn::Txn* txn, size_t N, const void* data) {
+  CHECK(!txn || (txn && !txn->read_only)) << "RO txn inserting ???";
+  return record_reference_t{this->table_id, allocateGroup(N, data)};
+}
+
+void SingleVersionColumnStore::updateAttribute(txn::Txn* txn, record_metadata_t* rc, void* value,
+                                               uint attribute_idx) {
+  auto col_width = column_size.at(attribute_idx);
+  auto data_ptr = columnAddress(rc, attribute_idx);
+  if (likely(txn != nullptr)) {
+    txn->getLog().addUpdateLog(record_reference_t{this->table_id, rc}.getBase(), attribute_idx, data_ptr, col_width);
+  }
+  memcpy(data_ptr, value, col_width);
+}
+
+void SingleVersionColumnStore::updateNthRecord(txn::Txn* txn, record_metadata_t* rc, void* value, uint record_offset,
+                                               uint attribute_idx) {
+  auto rd_rc = reinterpret_cast<uintptr_t>(rc) + (record_size * record_offset);
+  return this->updateAttribute(txn, reinterpret_cast<record_metadata_t*>(rd_rc), value, attribute_idx);
+}
+
+void SingleVersionColumnStore::getData(txn::Txn* txn, record_metadata_t* rc, void* dst, size_t offset, size_t len) {
+  // offset and len are in the packed data as given to insert; gather the overlapping part of each column.
+  assert(offset + len <= record_size_data_only);
+  auto dst_p = reinterpret_cast<uintptr_t>(dst);
+  for (uint i = 0; i < columns.size(); i++) {
+    auto begin = std::max<size_t>(offset, column_input_offsets[i]);
+    auto end = std::min<size_t>(offset + len, column_input_offsets[i] + column_size[i]);
+    if (begin < end) {
+      auto src = reinterpret_cast<uintptr_t>(columnAddress(rc, i)) + (begin - column_input_offsets[i]);
+      memcpy(reinterpret_cast<void*>(dst_p + (begin - offset)), reinterpret_cast<void*>(src), end - begin);
+    }
+  }
+}
+
+void SingleVersionColumnStore::getAttribute(txn::Txn* txn, record_metadata_t* rc, void* dst, uint attribute_idx) {
+  assert(rc != nullptr);
+  memcpy(dst, columnAddress(rc, attribute_idx), column_size.at(attribute_idx));
+}
+
+void SingleVersionColumnStore::getNthRecord(txn::Txn* txn, record_metadata_t* rc, void* dst, uint record_offset,
+                                            uint attribute_idx) {
+  // straight from the column, without touching the record of the nth element.
+  memcpy(dst, columnAddress(rc, attribute_idx, record_offset), column_size.at(attribute_idx));
+}
+
+record_reference_t SingleVersionColumnStore::getNthRecordReference(txn::Txn* txn, record_metadata_t* rc,
+                                                                   uint record_offset) {
+  auto rd_rc = reinterpret_cast<uintptr_t>(rc) + (record_size * record_offset);
+  return record_reference_t{this->table_id, reinterpret_cast<record_metadata_t*>(rd_rc)};
+}
+
+std::pair<void*, size_t> SingleVersionColumnStore::getColumn(record_metadata_t* rc, uint attribute_idx) {
+  return {columnAddress(rc, attribute_idx), column_size[attribute_idx]};
+}
+
+void SingleVersionColumnStore::rollback_update(record_metadata_t* rc, void* prev_value, uint attribute_idx) {
+  memcpy(columnAddress(rc, attribute_idx), prev_value, column_size.at(attribute_idx));
+}
+
+void SingleVersionColumnStore::rollback_create(record_metadata_t* rc) {
+  // only single-record groups (insertRecord) are logged, so the group goes with the record.
+  assert(rowOf(rc) == 0);
+  void* mem = columnsOf(rc);
+  {
+    allocation_lock.acquire();
+    memory_allocations.erase(mem);
+    allocation_lock.release();
+  }
+  // as SingleVersionRowStore::freeRecordMemory.
+  dcds::util::Epoch::retire(mem, free);
+  n_records--;
 }
-void SingleVersionRowStore::rollback_create(record_metadata_t* rc) { freeRecordMemory(rc); }
\ No newline at end of file
@@ -35,13 +35,9 @@ txn_ptr_t TransactionManager::beginTransaction(bool is_read_only) {
 }
 
 void TransactionManager::releaseAllLocks(txn_ptr_t txn) {
-  for (auto rec : txn->exclusive_locks) {
-    dcds::storage::record_reference_t(rec)->unlock_ex();
-  }
-
-  for (auto rec : txn->shared_locks) {
-    dcds::storage::record_reference_t(rec)->unlock_shared();
-  }
+  txn->exclusive_locks.forEach([](uintptr_t rec) { dcds::storage::record_reference_t(rec)->unlock_ex(); });
+  txn->shared_locks.forEach([](uintptr_t rec) { dcds::storage::record_reference_t(rec)->unlock_shared(); });
+  txn->key_locks.forEach([](cc::RecordMetaData* key_lock) { key_lock->unlock_ex(); });
 }
 
 bool TransactionManager::endTransaction(txn_ptr_t txn) {
@@ -57,6 +53,7 @@ bool TransactionManager::endTransaction(txn_ptr_t txn) {
   }
   assert(txn);
   //  delete txn;
+  txn->~Txn();
   scalable_free(txn);
 
   return success;
@@ -65,6 +62,8 @@ bool TransactionManager::endTransaction(txn_ptr_t txn) {
 bool TransactionManager::commitTransaction(txn_ptr_t txn) {
   // txn->commit_ts = txnIdGenerator.getCommitTs();
   // txn->status = TXN_STATUS::COMMITTED;
+  // deferred index removes, while the keys are still locked.
+  txn->log.commit();
   releaseAllLocks(txn);
 
   return true;
@@ -21,6 +21,9 @@
 
 #include "dcds/transaction/txn-log.hpp"
 
+#include <vector>
+
+#include "dcds/indexes/index.hpp"
 #include "dcds/storage/table.hpp"
 #include "dcds/util/logging.hpp"
 
@@ -38,19 +41,94 @@ void TransactionLog::addInsertLog(uintptr_t record) {
   this->log.push_front(new InsertLog(record));
 }
 
-void TransactionLog::rollback() {
+void TransactionLog::addIndexInsertLog(indexes::IndexBase* index, const void* key, size_t key_len, uintptr_t value) {
+  this->log.push_front(new IndexLog(TXN_LOG_TYPE::INDEX_INSERT, index, key, key_len, value));
+  n_index_entries++;
+}
+void TransactionLog::addIndexRemoveLog(indexes::IndexBase* index, const void* key, size_t key_len) {
+  this->log.push_front(new IndexLog(TXN_LOG_TYPE::INDEX_REMOVE, index, key, key_len, 0));
+  n_index_entries++;
+}
+void TransactionLog::addIndexDeferredInsertLog(indexes::IndexBase* index, const void* key, size_t key_len,
+                                               uintptr_t value) {
+  this->log.push_front(new IndexLog(TXN_LOG_TYPE::INDEX_DEFERRED_INSERT, index, key, key_len, value));
+  n_index_entries++;
+}
+
+bool TransactionLog::findIndexEntry(const indexes::IndexBase* index, const void* key, size_t key_len, bool& present,
+                                    uintptr_t& value) const {
+  if (n_index_entries == 0) return false;
+
+  // the log is newest-first, so the first entry of the key is the latest.
   for (auto& action : this->log) {
-    auto mainRecord = dcds::storage::record_reference_t(action->record);
-    auto storageTable = mainRecord.getTable();
+    switch (action->type) {
+      case TXN_LOG_TYPE::INDEX_INSERT:
+      case TXN_LOG_TYPE::INDEX_REMOVE:
+      case TXN_LOG_TYPE::INDEX_DEFERRED_INSERT: {
+        auto idx_action = reinterpret_cast<const IndexLog*>(action);
+        if (!idx_action->isKey(index, key, key_len)) break;
+        present = action->type != TXN_LOG_TYPE::INDEX_REMOVE;
+        if (present) value = action->record;
+        return true;
+      }
+      case TXN_LOG_TYPE::INSERT:
+      case TXN_LOG_TYPE::READ:
+      case TXN_LOG_TYPE::UPDATE:
+      case TXN_LOG_TYPE::DELETE:
+        break;
+    }
+  }
+  return false;
+}
 
-    if (action->type == TXN_LOG_TYPE::INSERT) {
-      storageTable->rollback_create(mainRecord.operator->());
-    } else if (action->type == TXN_LOG_TYPE::UPDATE) {
-      auto upd_action = reinterpret_cast<UpdateLog*>(action);
-      storageTable->rollback_update(mainRecord.operator->(), upd_action->prev_value, upd_action->attribute_index);
+void TransactionLog::commit() {
+  if (n_index_entries == 0) return;
 
+  // the log is newest-first, but the index entries are applied oldest-first: an entry may be removed and inserted
+  // again, e.g., when its key goes back and forth in one transaction.
+  std::vector<IndexLog*> entries;
+  entries.reserve(n_index_entries);
+  for (auto& action : this->log) {
+    if (action->type == TXN_LOG_TYPE::INDEX_INSERT || action->type == TXN_LOG_TYPE::INDEX_REMOVE ||
+        action->type == TXN_LOG_TYPE::INDEX_DEFERRED_INSERT) {
+      entries.push_back(reinterpret_cast<IndexLog*>(action));
+    }
+  }
+
+  for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+    auto idx_action = *it;
+    if (idx_action->type == TXN_LOG_TYPE::INDEX_REMOVE) {
+      idx_action->index->_remove_erased(idx_action->key);
     } else {
-      CHECK(false) << "what kind of log type?";
+      idx_action->index->_insert_erased(idx_action->key, idx_action->record);
+    }
+  }
+}
+
+void TransactionLog::rollback() {
+  for (auto& action : this->log) {
+    switch (action->type) {
+      case TXN_LOG_TYPE::INSERT: {
+        auto mainRecord = dcds::storage::record_reference_t(action->record);
+        mainRecord.getTable()->rollback_create(mainRecord.operator->());
+        break;
+      }
+      case TXN_LOG_TYPE::UPDATE: {
+        auto mainRecord = dcds::storage::record_reference_t(action->record);
+        auto upd_action = reinterpret_cast<UpdateLog*>(action);
+        mainRecord.getTable()->rollback_update(mainRecord.operator->(), upd_action->prev_value,
+                                               upd_action->attribute_index);
+        break;
+      }
+      case TXN_LOG_TYPE::INDEX_INSERT:
+      case TXN_LOG_TYPE::INDEX_REMOVE:
+      case TXN_LOG_TYPE::INDEX_DEFERRED_INSERT:
+        // never applied before the commit.
+        break;
+      case TXN_LOG_TYPE::READ:
+      case TXN_LOG_TYPE::DELETE:
+        CHECK(false) << "what kind of log type?";
+        break;
     }
   }
 }
@@ -0,0 +1,127 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+#include "dcds/util/epoch.hpp"
+
+#include <mutex>
+#include <vector>
+
+using namespace dcds::util;
+
+// 0 is the unpinned slot.
+std::atomic<uint64_t> Epoch::global_epoch{1};
+
+// Slots are never freed: an exited thread's slot is taken by a later one.
+static std::atomic<Epoch::Slot *> slots{nullptr};
+
+namespace {
+
+struct SlotHolder {
+  Epoch::Slot *s;
+
+  SlotHolder() {
+    for (s = slots.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+      bool in_use = false;
+      if (!s->in_use.load(std::memory_order_relaxed) &&
+          s->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+        return;
+      }
+    }
+    s = new Epoch::Slot();
+    s->in_use.store(true, std::memory_order_relaxed);
+    s->next = slots.load(std::memory_order_relaxed);
+    while (!slots.compare_exchange_weak(s->next, s, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+  }
+
+  ~SlotHolder() {
+    s->pinned.store(0, std::memory_order_release);
+    s->in_use.store(false, std::memory_order_release);
+  }
+};
+
+struct Retired {
+  void *ptr;
+  void (*deleter)(void *);
+  uint64_t epoch;
+};
+
+// retired memory of exited threads, taken over by the next retire of any thread.
+std::mutex orphans_lock;
+std::vector<Retired> orphans;
+
+struct RetireList {
+  // retires before the batch is reclaimed: every retire scans the slots otherwise.
+  static constexpr size_t batch = 32;
+
+  std::vector<Retired> retired;
+
+  ~RetireList() {
+    reclaim();
+    if (retired.empty()) return;
+    std::lock_guard lk(orphans_lock);
+    orphans.insert(orphans.end(), retired.begin(), retired.end());
+  }
+
+  void reclaim() {
+    {
+      std::unique_lock lk(orphans_lock, std::try_to_lock);
+      if (lk.owns_lock() && !orphans.empty()) {
+        retired.insert(retired.end(), orphans.begin(), orphans.end());
+        orphans.clear();
+      }
+    }
+
+    auto now = Epoch::tryAdvance();
+    std::erase_if(retired, [now](const Retired &r) {
+      if (!Epoch::reclaimable(r.epoch, now)) return false;
+      r.deleter(r.ptr);
+      return true;
+    });
+  }
+};
+
+}  // namespace
+
+Epoch::Slot &Epoch::slot() {
+  static thread_local SlotHolder holder;
+  return *holder.s;
+}
+
+uint64_t Epoch::tryAdvance() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto epoch = global_epoch.load(std::memory_order_relaxed);
+  for (int i = 0; i < 2; i++) {
+    for (auto *s = slots.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+      auto pinned = s->pinned.load(std::memory_order_acquire);
+      if (pinned != 0 && pinned != epoch) return epoch;
+    }
+    // fails if another thread advanced meanwhile, which loads the new epoch.
+    if (global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst)) epoch++;
+  }
+  return epoch;
+}
+
+void Epoch::retire(void *ptr, void (*deleter)(void *)) {
+  static thread_local RetireList list;
+  list.retired.push_back({ptr, deleter, current()});
+  if (list.retired.size() >= RetireList::batch) list.reclaim();
+}
@@ -0,0 +1,118 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <functional>
+
+#include <dcds/codegen/llvm-codegen/llvm-optimizer.hpp>
+#include <dcds/codegen/llvm-codegen/llvm-runtime-attributes.hpp>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+
+// Mirrors what the statement codegen emits for:
+//   a = read(attr0); r1 = nth_record(3); r2 = nth_record(3); write(attr1, a); b = read-back of a's temporary
+// and checks what LLVMOptimizer::simplify makes of it with and without the runtime attributes.
+static std::unique_ptr<llvm::Module> buildRuntimeCallsIR(llvm::LLVMContext &context, bool annotate) {
+  auto module = std::make_unique<llvm::Module>("IRHygieneTest", context);
+  auto *i8PtrTy = llvm::Type::getInt8PtrTy(context);
+  auto *i64Ty = llvm::Type::getInt64Ty(context);
+  auto *voidTy = llvm::Type::getVoidTy(context);
+
+  auto declare = [&](const char *name, llvm::Type *retTy, llvm::ArrayRef<llvm::Type *> args) {
+    auto *fn = llvm::Function::Create(llvm::FunctionType::get(retTy, args, false), llvm::GlobalValue::ExternalLinkage,
+                                      name, module.get());
+    if (annotate) EXPECT_TRUE(dcds::LLVMRuntimeAttributes::annotate(fn));
+    return fn;
+  };
+  auto *read_attribute = declare("table_read_attribute", voidTy, {i8PtrTy, i64Ty, i8PtrTy, i8PtrTy, i64Ty});
+  auto *get_nth_record = declare("table_get_nth_record", i64Ty, {i8PtrTy, i64Ty, i8PtrTy, i64Ty});
+  auto *write_attribute = declare("table_write_attribute", voidTy, {i8PtrTy, i64Ty, i8PtrTy, i8PtrTy, i64Ty});
+
+  auto *fn = llvm::Function::Create(llvm::FunctionType::get(i64Ty, {i8PtrTy, i64Ty, i8PtrTy}, false),
+                                    llvm::GlobalValue::ExternalLinkage, "IRHygieneTest_op", module.get());
+  auto *txnManager = fn->getArg(0);
+  auto *mainRecord = fn->getArg(1);
+  auto *txn = fn->getArg(2);
+
+  llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", fn));
+  auto *tmp = builder.CreateAlloca(i64Ty, nullptr, "tmp");
+  auto *src = builder.CreateAlloca(i64Ty, nullptr, "src");
+
+  builder.CreateCall(read_attribute,
+                     {txnManager, mainRecord, txn, builder.CreateBitCast(tmp, i8PtrTy), builder.getInt64(0)});
+  auto *a = builder.CreateLoad(i64Ty, tmp);
+  auto *r1 = builder.CreateCall(get_nth_record, {txnManager, mainRecord, txn, builder.getInt64(3)});
+  auto *r2 = builder.CreateCall(get_nth_record, {txnManager, mainRecord, txn, builder.getInt64(3)});
+  builder.CreateStore(a, src);
+  builder.CreateCall(write_attribute,
+                     {txnManager, mainRecord, txn, builder.CreateBitCast(src, i8PtrTy), builder.getInt64(1)});
+  auto *b = builder.CreateLoad(i64Ty, tmp);
+  builder.CreateRet(builder.CreateAdd(builder.CreateAdd(a, b), builder.CreateAdd(r1, r2)));
+
+  EXPECT_FALSE(llvm::verifyModule(*module, &llvm::errs()));
+  dcds::LLVMOptimizer::simplify(*module);
+  EXPECT_FALSE(llvm::verifyModule(*module, &llvm::errs()));
+  return module;
+}
+
+static size_t countInstructions(llvm::Module &module, const std::function<bool(llvm::Instruction &)> &pred) {
+  size_t count = 0;
+  for (auto &inst : llvm::instructions(module.getFunction("IRHygieneTest_op"))) {
+    if (pred(inst)) count++;
+  }
+  return count;
+}
+
+static size_t countCalls(llvm::Module &module, const std::string &callee) {
+  return countInstructions(module, [&](llvm::Instruction &inst) {
+    auto *call = llvm::dyn_cast<llvm::CallInst>(&inst);
+    return call && call->getCalledFunction() && call->getCalledFunction()->getName() == callee;
+  });
+}
+
+static size_t countLoads(llvm::Module &module) {
+  return countInstructions(module, [](llvm::Instruction &inst) { return llvm::isa<llvm::LoadInst>(inst); });
+}
+
+TEST(IRHygieneTest, RedundantReadsCollapse) {
+  llvm::LLVMContext context;
+
+  auto plain = buildRuntimeCallsIR(context, false);
+  auto annotated = buildRuntimeCallsIR(context, true);
+
+  // Opaque runtime calls: the lookup is repeated, and the temporary escapes into table_read_attribute, so it is
+  // re-read after table_write_attribute.
+  EXPECT_EQ(countCalls(*plain, "table_get_nth_record"), 2);
+  EXPECT_EQ(countLoads(*plain), 2);
+
+  // With attributes: the repeated lookup is combined and the read-back is forwarded from the first load.
+  EXPECT_EQ(countCalls(*annotated, "table_get_nth_record"), 1);
+  EXPECT_EQ(countLoads(*annotated), 1);
+
+  // Side effects are kept either way.
+  EXPECT_EQ(countCalls(*annotated, "table_read_attribute"), 1);
+  EXPECT_EQ(countCalls(*annotated, "table_write_attribute"), 1);
+}
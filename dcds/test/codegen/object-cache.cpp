@@ -0,0 +1,57 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <dcds/codegen/llvm-codegen/llvm-object-cache.hpp>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+// Module with a function which takes the named struct type of a DS, as the codegen creates it.
+static std::unique_ptr<llvm::Module> buildStructModule(llvm::LLVMContext &context, llvm::StructType *type) {
+  auto module = std::make_unique<llvm::Module>("ObjectCacheTest", context);
+  auto *i64Ty = llvm::Type::getInt64Ty(context);
+  auto *fn = llvm::Function::Create(llvm::FunctionType::get(i64Ty, {type->getPointerTo()}, false),
+                                    llvm::GlobalValue::ExternalLinkage, "ObjectCacheTest_get", module.get());
+  llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", fn));
+  builder.CreateRet(builder.CreateLoad(i64Ty, builder.CreateStructGEP(type, fn->getArg(0), 1)));
+  return module;
+}
+
+// The key does not depend on the names which the shared context gave to the struct types, e.g., after a rebuild.
+TEST(ObjectCacheTest, KeyIgnoresStructTypeSuffixes) {
+  llvm::LLVMContext context;
+  auto *i64Ty = llvm::Type::getInt64Ty(context);
+  auto *first = llvm::StructType::create(context, {i64Ty, i64Ty}, "ObjectCacheTest_t");
+  auto *second = llvm::StructType::create(context, {i64Ty, i64Ty}, "ObjectCacheTest_t");
+  auto second_name = second->getName().str();
+  ASSERT_NE(second_name, "ObjectCacheTest_t");
+
+  auto key = dcds::LLVMObjectCache::computeKey(*buildStructModule(context, first), "target");
+  EXPECT_EQ(dcds::LLVMObjectCache::computeKey(*buildStructModule(context, second), "target"), key);
+  EXPECT_NE(dcds::LLVMObjectCache::computeKey(*buildStructModule(context, first), "other-target"), key);
+
+  // the types keep their names.
+  EXPECT_EQ(first->getName(), "ObjectCacheTest_t");
+  EXPECT_EQ(second->getName(), second_name);
+}
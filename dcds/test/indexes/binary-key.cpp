@@ -0,0 +1,200 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <dcds/dcds.hpp>
+
+using dcds::indexes::StringKey;
+
+TEST(StringKeyTest, EncodeDecode) {
+  std::vector<std::string> values{"",  "a", "ab", std::string("ab\0", 3), "abc", "b", std::string(24, 'x'),
+                                  std::string(25, 'x'), std::string(100, 'y'), "zz"};
+  std::vector<StringKey::key_type> keys;
+  for (const auto& str : values) {
+    auto key = StringKey::encode(str);
+    EXPECT_EQ(StringKey::isExact(key), str.size() <= StringKey::inline_bytes);
+    EXPECT_EQ(StringKey::decode(key), str.substr(0, StringKey::inline_bytes));
+    EXPECT_EQ(StringKey::fromParts(StringKey::parts(key)), key);
+    EXPECT_EQ(StringKey::encode(str), key);
+    keys.push_back(key);
+  }
+
+  // keys order as their strings, as long as they differ in their first inline_bytes bytes.
+  EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+
+  // long strings with the same first inline_bytes bytes differ by their hash.
+  EXPECT_NE(StringKey::encode(std::string(101, 'y')), keys[8]);
+  EXPECT_NE(StringKey::encode(std::string(99, 'y') + "z"), keys[8]);
+}
+
+// Items keyed by a string, i.e., a composite key of four 64-bit parts, as a 32-byte binary key.
+static std::shared_ptr<dcds::Builder> buildStringMap(const std::string& name, dcds::hints::IndexHints index_type) {
+  auto builder = std::make_shared<dcds::Builder>(name);
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto item = builder->createType(name + "_Item");
+  std::vector<dcds::CompositeKeyPart> key_parts;
+  for (int i = 0; i < 4; i++) {
+    item->addAttribute("s" + std::to_string(i), dcds::valueType::INT64, UINT64_C(0));
+    key_parts.push_back({"s" + std::to_string(i), 64});
+  }
+  auto value_attr = item->addAttribute("value", dcds::valueType::INT64, UINT64_C(0));
+  {
+    auto fn = item->createFunction("set", dcds::valueType::VOID);
+    auto sb = fn->getStatementBuilder();
+    for (int i = 0; i < 4; i++) {
+      auto s = "s" + std::to_string(i);
+      sb->addUpdateStatement(item->getAttribute(s), fn->addArgument(s, dcds::valueType::INT64));
+    }
+    sb->addUpdateStatement(value_attr, fn->addArgument("value", dcds::valueType::INT64));
+    sb->addReturnVoidStatement();
+  }
+  {
+    auto fn = item->createFunction("get_value", dcds::valueType::INT64);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addReadStatement(value_attr, v);
+    fn->getStatementBuilder()->addReturnStatement(v);
+  }
+
+  dcds::hints::IndexSizeHints size_hints{.capacity = 1024, .negative_lookup_filter = true};
+  auto items = builder->addAttributeIndexedList("items", item, key_parts, index_type, size_hints);
+  EXPECT_EQ(items->key_bytes, size_t{32});
+
+  using key_values = std::vector<std::shared_ptr<dcds::expressions::Expression>>;
+  auto keyArguments = [&](const std::shared_ptr<dcds::FunctionBuilder>& fn, const std::string& prefix) {
+    key_values values;
+    for (int i = 0; i < 4; i++) values.push_back(fn->addArgument(prefix + std::to_string(i), dcds::valueType::INT64));
+    return values;
+  };
+  auto key = [&](const key_values& values) {
+    return std::make_shared<dcds::expressions::CompositeKeyExpression>(items, values);
+  };
+  {
+    auto fn = builder->createFunction("insert", dcds::valueType::BOOL);
+    auto values = keyArguments(fn, "s");
+    auto value = fn->addArgument("value", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    auto rec = sb->addInsertStatement(item, "rec");
+    auto set_args = values;
+    set_args.push_back(value);
+    sb->addMethodCall(item, rec, "set", set_args);
+    sb->addInsertStatement(items, key(values), rec);
+    sb->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(true));
+  }
+  {
+    auto fn = builder->createFunction("remove", dcds::valueType::VOID);
+    fn->getStatementBuilder()->addRemoveStatement(items, key(keyArguments(fn, "s")));
+    fn->getStatementBuilder()->addReturnVoidStatement();
+  }
+  {
+    // value of the item, or -1 if absent.
+    auto fn = builder->createFunction("lookup", dcds::valueType::INT64);
+    auto values = keyArguments(fn, "s");
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+
+    sb->addReadStatement(items, rec, key(values));
+    auto conditionalBlocks = sb->addConditionalBranch(new dcds::expressions::IsNotNullExpression{rec});
+    conditionalBlocks.ifBlock->addMethodCall(item, rec, "get_value", v);
+    conditionalBlocks.ifBlock->addReturnStatement(v);
+    conditionalBlocks.elseBlock->addReturnStatement(std::make_shared<dcds::expressions::Int64Constant>(-1));
+  }
+  if (index_type == dcds::hints::IndexHints::ORDERED) {
+    // sum of the values of the items with a key in [lower, upper].
+    auto fn = builder->createFunction("sum", dcds::valueType::INT64);
+    auto lower = keyArguments(fn, "l");
+    auto upper = keyArguments(fn, "u");
+    auto total = builder->addAttribute("total", dcds::valueType::INT64, UINT64_C(0));
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    auto sum = fn->addTempVariable("sum", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+
+    sb->addUpdateStatement(total, std::make_shared<dcds::expressions::Int64Constant>(0));
+    auto body = sb->addRangeScan(items, key(lower), key(upper), rec);
+    body->addMethodCall(item, rec, "get_value", v);
+    body->addReadStatement(total, sum);
+    body->addUpdateStatement(total, std::make_shared<dcds::expressions::AddExpression>(sum, v));
+    sb->addReadStatement(total, sum);
+    sb->addReturnStatement(sum);
+  }
+
+  builder->build();
+  return builder;
+}
+
+TEST(BinaryKeyTest, StringKeyedLists) {
+  for (auto index_type : {dcds::hints::IndexHints::HASH, dcds::hints::IndexHints::ORDERED}) {
+    auto builder = buildStringMap(index_type == dcds::hints::IndexHints::HASH ? "BinaryKeyTest_Hash"
+                                                                                : "BinaryKeyTest_Ordered",
+                                  index_type);
+    auto instance = builder->createInstance();
+    auto insert = instance->get<bool(int64_t, int64_t, int64_t, int64_t, int64_t)>("insert");
+    auto remove = instance->get<void(int64_t, int64_t, int64_t, int64_t)>("remove");
+    auto lookup = instance->get<int64_t(int64_t, int64_t, int64_t, int64_t)>("lookup");
+
+    auto name = [](int64_t i) {
+      // some short enough to be inline, others not.
+      return "customer-" + std::to_string(i) + (i % 3 ? "" : std::string(40, '-'));
+    };
+    // a long string is compared to the one of the value found, i.e., out of line.
+    auto lookupString = [&](const std::string& str) {
+      auto key = StringKey::encode(str);
+      auto p = StringKey::parts(key);
+      auto value = lookup(p[0], p[1], p[2], p[3]);
+      if (value != -1 && !StringKey::isExact(key) && name(value) != str) return int64_t{-1};
+      return value;
+    };
+
+    constexpr int64_t n_keys = 1000;
+    for (int64_t i = 0; i < n_keys; i++) {
+      auto p = StringKey::parts(StringKey::encode(name(i)));
+      EXPECT_TRUE(insert(p[0], p[1], p[2], p[3], i));
+    }
+    for (int64_t i = 0; i < n_keys; i++) {
+      EXPECT_EQ(lookupString(name(i)), i);
+      EXPECT_EQ(lookupString(name(i) + "!"), -1);
+    }
+
+    if (index_type == dcds::hints::IndexHints::ORDERED) {
+      auto sum = instance->get<int64_t(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t)>("sum");
+      // "customer-1" to "customer-1~": 1, 10..19, 100..199.
+      auto l = StringKey::parts(StringKey::encode("customer-1"));
+      auto u = StringKey::parts(StringKey::encode("customer-1~"));
+      int64_t expected = 1;
+      for (int64_t i = 10; i < 20; i++) expected += i;
+      for (int64_t i = 100; i < 200; i++) expected += i;
+      EXPECT_EQ(sum(l[0], l[1], l[2], l[3], u[0], u[1], u[2], u[3]), expected);
+    }
+
+    for (int64_t i = 0; i < n_keys; i += 2) {
+      auto p = StringKey::parts(StringKey::encode(name(i)));
+      remove(p[0], p[1], p[2], p[3]);
+    }
+    for (int64_t i = 0; i < n_keys; i++) EXPECT_EQ(lookupString(name(i)), (i % 2) ? i : -1);
+    delete instance;
+  }
+}
@@ -0,0 +1,144 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <dcds/dcds.hpp>
+#include <dcds/indexes/btree-index.hpp>
+#include <map>
+#include <numeric>
+#include <random>
+
+TEST(BulkLoadTest, BTreeBuild) {
+  dcds::indexes::BTreeIndex<int64_t> index;
+  std::map<int64_t, uintptr_t> reference;
+  std::mt19937_64 rng(42);
+
+  // unsorted, with repeated keys, of which the first one is kept.
+  std::vector<int64_t> keys;
+  std::vector<uintptr_t> values;
+  for (size_t i = 0; i < 100000; i++) {
+    keys.push_back(static_cast<int64_t>(rng() % 80000));
+    values.push_back(i);
+    reference.emplace(keys.back(), i);
+  }
+  EXPECT_EQ(index.bulkInsert(keys.data(), values.data(), keys.size()), reference.size());
+  EXPECT_EQ(index._stats().entries, reference.size());
+
+  // the built tree takes inserts and removes as usual.
+  for (size_t i = 0; i < 20000; i++) {
+    int64_t key = static_cast<int64_t>(rng() % 100000);
+    if (rng() % 4 == 0) {
+      index._remove(key);
+      reference.erase(key);
+    } else {
+      EXPECT_EQ(index._insert(key, 1), reference.emplace(key, 1).second);
+    }
+  }
+
+  std::vector<std::pair<int64_t, uintptr_t>> scanned;
+  int64_t key = 0;
+  uintptr_t value = 0;
+  for (bool inclusive = true; index._next(key, inclusive, INT64_MAX, value); inclusive = false) {
+    scanned.emplace_back(key, value);
+  }
+  std::vector<std::pair<int64_t, uintptr_t>> expected(reference.begin(), reference.end());
+  EXPECT_EQ(scanned, expected);
+}
+
+static std::shared_ptr<dcds::Builder> buildStock(const std::string& name, dcds::hints::IndexHints index_type) {
+  auto builder = std::make_shared<dcds::Builder>(name);
+
+  auto item = builder->createType(name + "_Item");
+  auto key_attr = item->addAttribute("key_", dcds::valueType::INT64, UINT64_C(0));
+  auto qty_attr = item->addAttribute("qty", dcds::valueType::INT64, UINT64_C(10));
+  {
+    auto fn = item->createFunction("set_key", dcds::valueType::VOID);
+    fn->getStatementBuilder()->addUpdateStatement(key_attr, fn->addArgument("key", dcds::valueType::INT64));
+    fn->getStatementBuilder()->addReturnVoidStatement();
+  }
+  {
+    auto fn = item->createFunction("get_sum", dcds::valueType::INT64);
+    auto key = fn->addTempVariable("key", dcds::valueType::INT64);
+    auto qty = fn->addTempVariable("qty", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addReadStatement(key_attr, key);
+    fn->getStatementBuilder()->addReadStatement(qty_attr, qty);
+    fn->getStatementBuilder()->addReturnStatement(std::make_shared<dcds::expressions::AddExpression>(key, qty));
+  }
+
+  auto items = builder->addAttributeIndexedList("items", item, "key_", index_type);
+  {
+    auto fn = builder->createFunction("insert", dcds::valueType::BOOL);
+    auto key = fn->addArgument("key", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    auto rec = sb->addInsertStatement(item, "rec");
+    sb->addMethodCall(item, rec, "set_key", std::vector<std::shared_ptr<dcds::expressions::Expression>>{key});
+    sb->addInsertStatement(items, key, rec);
+    sb->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(true));
+  }
+  {
+    // key + qty of the item, or -1 if absent.
+    auto fn = builder->createFunction("lookup", dcds::valueType::INT64);
+    auto key = fn->addArgument("key", dcds::valueType::INT64);
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+
+    sb->addReadStatement(items, rec, key);
+    auto conditionalBlocks = sb->addConditionalBranch(new dcds::expressions::IsNotNullExpression{rec});
+    conditionalBlocks.ifBlock->addMethodCall(item, rec, "get_sum", v);
+    conditionalBlocks.ifBlock->addReturnStatement(v);
+    conditionalBlocks.elseBlock->addReturnStatement(std::make_shared<dcds::expressions::Int64Constant>(-1));
+  }
+
+  builder->build();
+  return builder;
+}
+
+TEST(BulkLoadTest, GeneratedLoader) {
+  for (auto index_type : {dcds::hints::IndexHints::HASH, dcds::hints::IndexHints::ORDERED,
+                          dcds::hints::IndexHints::OPEN_ADDRESSING}) {
+    auto builder = buildStock("BulkLoadTest_" + std::to_string(std::to_underlying(index_type)), index_type);
+    auto instance = builder->createInstance();
+    auto insert = instance->get<bool(int64_t)>("insert");
+    auto lookup = instance->get<int64_t(int64_t)>("lookup");
+
+    // every third key, shuffled, on a few threads.
+    constexpr int64_t n_keys = 30000;
+    std::vector<int64_t> keys(n_keys);
+    std::iota(keys.begin(), keys.end(), 0);
+    for (auto& key : keys) key *= 3;
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(7));
+    instance->bulkLoad("items", keys.data(), keys.size(), 4);
+
+    for (int64_t i = 0; i < n_keys; i++) {
+      EXPECT_EQ(lookup(i * 3), i * 3 + 10);
+      EXPECT_EQ(lookup(i * 3 + 1), -1);
+    }
+
+    // the ops continue on the loaded DS.
+    EXPECT_TRUE(insert(1));
+    EXPECT_EQ(lookup(1), 11);
+    delete instance;
+  }
+}
@@ -0,0 +1,163 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <dcds/dcds.hpp>
+
+// Orders keyed by (w_id, d_id, o_id), as in TPC-C: 16 + 8 + 40 bits, the whole packed key.
+static std::shared_ptr<dcds::Builder> buildOrders(const std::string& name, dcds::hints::IndexHints index_type) {
+  auto builder = std::make_shared<dcds::Builder>(name);
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto order = builder->createType(name + "_Order");
+  auto w_attr = order->addAttribute("w_id", dcds::valueType::INT64, UINT64_C(0));
+  auto d_attr = order->addAttribute("d_id", dcds::valueType::INT32, UINT32_C(0));
+  auto o_attr = order->addAttribute("o_id", dcds::valueType::INT64, UINT64_C(0));
+  auto qty_attr = order->addAttribute("qty", dcds::valueType::INT64, UINT64_C(0));
+  {
+    auto fn = order->createFunction("set", dcds::valueType::VOID);
+    auto w = fn->addArgument("w", dcds::valueType::INT64);
+    auto d = fn->addArgument("d", dcds::valueType::INT32);
+    auto o = fn->addArgument("o", dcds::valueType::INT64);
+    auto qty = fn->addArgument("qty", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    sb->addUpdateStatement(w_attr, w);
+    sb->addUpdateStatement(d_attr, d);
+    sb->addUpdateStatement(o_attr, o);
+    sb->addUpdateStatement(qty_attr, qty);
+    sb->addReturnVoidStatement();
+  }
+  {
+    auto fn = order->createFunction("get_qty", dcds::valueType::INT64);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addReadStatement(qty_attr, v);
+    fn->getStatementBuilder()->addReturnStatement(v);
+  }
+
+  auto orders = builder->addAttributeIndexedList("orders", order, {{"w_id", 16}, {"d_id", 8}, {"o_id", 40}},
+                                                 index_type);
+  using key_values = std::vector<std::shared_ptr<dcds::expressions::Expression>>;
+  auto key = [&](const key_values& values) {
+    return std::make_shared<dcds::expressions::CompositeKeyExpression>(orders, values);
+  };
+  {
+    auto fn = builder->createFunction("insert", dcds::valueType::BOOL);
+    auto w = fn->addArgument("w", dcds::valueType::INT64);
+    auto d = fn->addArgument("d", dcds::valueType::INT32);
+    auto o = fn->addArgument("o", dcds::valueType::INT64);
+    auto qty = fn->addArgument("qty", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    auto rec = sb->addInsertStatement(order, "rec");
+    sb->addMethodCall(order, rec, "set", key_values{w, d, o, qty});
+    sb->addInsertStatement(orders, key({w, d, o}), rec);
+    sb->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(true));
+  }
+  {
+    // qty of the order, or -1 if absent.
+    auto fn = builder->createFunction("lookup", dcds::valueType::INT64);
+    auto w = fn->addArgument("w", dcds::valueType::INT64);
+    auto d = fn->addArgument("d", dcds::valueType::INT32);
+    auto o = fn->addArgument("o", dcds::valueType::INT64);
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto qty = fn->addTempVariable("qty", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+
+    sb->addReadStatement(orders, rec, key({w, d, o}));
+    auto conditionalBlocks = sb->addConditionalBranch(new dcds::expressions::IsNotNullExpression{rec});
+    conditionalBlocks.ifBlock->addMethodCall(order, rec, "get_qty", qty);
+    conditionalBlocks.ifBlock->addReturnStatement(qty);
+    conditionalBlocks.elseBlock->addReturnStatement(std::make_shared<dcds::expressions::Int64Constant>(-1));
+  }
+  if (index_type == dcds::hints::IndexHints::ORDERED) {
+    // sum of qty over the orders of a district with o_id in [lower, upper].
+    auto fn = builder->createFunction("sum_qty", dcds::valueType::INT64);
+    auto w = fn->addArgument("w", dcds::valueType::INT64);
+    auto d = fn->addArgument("d", dcds::valueType::INT32);
+    auto lower = fn->addArgument("lower", dcds::valueType::INT64);
+    auto upper = fn->addArgument("upper", dcds::valueType::INT64);
+    auto total = builder->addAttribute("total", dcds::valueType::INT64, UINT64_C(0));
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto qty = fn->addTempVariable("qty", dcds::valueType::INT64);
+    auto sum = fn->addTempVariable("sum", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+
+    sb->addUpdateStatement(total, std::make_shared<dcds::expressions::Int64Constant>(0));
+    auto body = sb->addRangeScan(orders, key({w, d, lower}), key({w, d, upper}), rec);
+    body->addMethodCall(order, rec, "get_qty", qty);
+    body->addReadStatement(total, sum);
+    body->addUpdateStatement(total, std::make_shared<dcds::expressions::AddExpression>(sum, qty));
+    sb->addReadStatement(total, sum);
+    sb->addReturnStatement(sum);
+  }
+
+  builder->build();
+  return builder;
+}
+
+TEST(CompositeKeyTest, HashLookup) {
+  auto builder = buildOrders("CompositeKeyTest_Hash", dcds::hints::IndexHints::OPEN_ADDRESSING);
+  auto instance = builder->createInstance();
+  auto insert = instance->get<bool(int64_t, int32_t, int64_t, int64_t)>("insert");
+  auto lookup = instance->get<int64_t(int64_t, int32_t, int64_t)>("lookup");
+
+  for (int64_t w = 1; w <= 4; w++) {
+    for (int32_t d = 1; d <= 10; d++) {
+      for (int64_t o = 0; o < 100; o++) insert(w, d, o, w * 10000 + d * 100 + o);
+    }
+  }
+  // negative values take the lower half of their part.
+  insert(-1, -1, -1, 42);
+
+  EXPECT_EQ(lookup(3, 7, 42), 30742);
+  EXPECT_EQ(lookup(4, 10, 99), 41099);
+  EXPECT_EQ(lookup(-1, -1, -1), 42);
+  EXPECT_EQ(lookup(3, 7, 100), -1);
+  EXPECT_EQ(lookup(7, 3, 42), -1);
+  delete instance;
+}
+
+TEST(CompositeKeyTest, OrderedRangeScan) {
+  auto builder = buildOrders("CompositeKeyTest_Ordered", dcds::hints::IndexHints::ORDERED);
+  auto instance = builder->createInstance();
+  auto insert = instance->get<bool(int64_t, int32_t, int64_t, int64_t)>("insert");
+  auto lookup = instance->get<int64_t(int64_t, int32_t, int64_t)>("lookup");
+  auto sum_qty = instance->get<int64_t(int64_t, int32_t, int64_t, int64_t)>("sum_qty");
+
+  // inserted out of order.
+  for (int64_t o = 0; o < 100; o++) {
+    for (int32_t d = 10; d >= 1; d--) {
+      for (int64_t w = 2; w >= 1; w--) insert(w, d, (o * 37) % 100, 1);
+    }
+  }
+  insert(1, 5, -3, 1000);
+
+  EXPECT_EQ(lookup(2, 9, 37), 1);
+  EXPECT_EQ(lookup(2, 11, 37), -1);
+  // the orders of one district only, in o_id order.
+  EXPECT_EQ(sum_qty(1, 5, 0, 99), 100);
+  EXPECT_EQ(sum_qty(1, 5, 10, 19), 10);
+  EXPECT_EQ(sum_qty(1, 5, -10, 0), 1001);
+  EXPECT_EQ(sum_qty(2, 10, 90, INT64_C(1) << 38), 10);
+  EXPECT_EQ(sum_qty(2, 11, 0, 99), 0);
+  delete instance;
+}
@@ -0,0 +1,110 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <dcds/dcds.hpp>
+#include <dcds/indexes/negative-lookup-filter.hpp>
+
+// The generated lookups probe the filter inline, inserts and removes keep it in sync with the index.
+TEST(NegativeLookupFilterTest, InlineProbe) {
+  for (auto index_type : {dcds::hints::IndexHints::OPEN_ADDRESSING, dcds::hints::IndexHints::ORDERED}) {
+    auto builder = std::make_shared<dcds::Builder>("NegativeLookupFilterTest_Map");
+    builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+    auto item = builder->createType("NegativeLookupFilterTest_Item");
+    auto key_attr = item->addAttribute("key_", dcds::valueType::INT64, UINT64_C(0));
+    {
+      auto fn = item->createFunction("set", dcds::valueType::VOID);
+      auto key = fn->addArgument("key", dcds::valueType::INT64);
+      fn->getStatementBuilder()->addUpdateStatement(key_attr, key);
+      fn->getStatementBuilder()->addReturnVoidStatement();
+    }
+
+    dcds::hints::IndexSizeHints size_hints{.capacity = 1024, .negative_lookup_filter = true};
+    auto records = builder->addAttributeIndexedList("records", item, "key_", index_type, size_hints);
+
+    {
+      auto fn = builder->createFunction("insert", dcds::valueType::VOID);
+      auto key = fn->addArgument("key", dcds::valueType::INT64);
+      auto sb = fn->getStatementBuilder();
+      auto rec = sb->addInsertStatement(item, "rec");
+      sb->addMethodCall(item, rec, "set", std::vector<std::shared_ptr<dcds::expressions::Expression>>{key});
+      sb->addInsertStatement(records, key, rec);
+      sb->addReturnVoidStatement();
+    }
+    {
+      auto fn = builder->createFunction("remove", dcds::valueType::VOID);
+      auto key = fn->addArgument("key", dcds::valueType::INT64);
+      fn->getStatementBuilder()->addRemoveStatement(records, key);
+      fn->getStatementBuilder()->addReturnVoidStatement();
+    }
+    {
+      auto fn = builder->createFunction("lookup", dcds::valueType::BOOL);
+      auto key = fn->addArgument("key", dcds::valueType::INT64);
+      auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+      auto sb = fn->getStatementBuilder();
+
+      sb->addReadStatement(records, rec, key);
+      auto conditionalBlocks = sb->addConditionalBranch(new dcds::expressions::IsNotNullExpression{rec});
+      conditionalBlocks.ifBlock->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(true));
+      conditionalBlocks.elseBlock->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(false));
+    }
+
+    builder->build();
+    auto instance = builder->createInstance();
+    auto insert = instance->get<void(int64_t)>("insert");
+    auto remove = instance->get<void(int64_t)>("remove");
+    auto lookup = instance->get<bool(int64_t)>("lookup");
+
+    // more keys than the filter is sized for: less precise, still no false negatives.
+    constexpr int64_t n_keys = 20000;
+    for (int64_t key = 0; key < n_keys; key++) insert(key * 3);
+    for (int64_t key = 0; key < n_keys; key += 2) remove(key * 3);
+    // a second remove of an absent key must not remove it from the filter again.
+    for (int64_t key = 0; key < n_keys; key += 2) remove(key * 3);
+
+    for (int64_t key = 0; key < n_keys; key++) {
+      EXPECT_EQ(lookup(key * 3), key % 2 == 1);
+      EXPECT_FALSE(lookup(key * 3 + 1));
+    }
+    delete instance;
+  }
+}
+
+TEST(NegativeLookupFilterTest, CountingRemoves) {
+  constexpr int64_t n_keys = 100000;
+  dcds::indexes::NegativeLookupFilter filter(n_keys);
+  for (int64_t key = 0; key < n_keys; key++) filter.add(key);
+  for (int64_t key = 0; key < n_keys; key += 2) filter.remove(key);
+
+  size_t false_positives = 0;
+  for (int64_t key = 0; key < n_keys; key++) {
+    if (key % 2) {
+      EXPECT_TRUE(filter.mayContain(key));
+    } else {
+      false_positives += filter.mayContain(key);
+    }
+  }
+  // about 2% at the expected size, twice as many keys as it holds now.
+  EXPECT_LT(false_positives, n_keys / 2 / 20);
+}
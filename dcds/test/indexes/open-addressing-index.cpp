@@ -0,0 +1,182 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <dcds/dcds.hpp>
+#include <dcds/indexes/open-addressing-index.hpp>
+#include <thread>
+
+// The lookups of an open-addressing index are generated inline, the writes go through the index.
+TEST(OpenAddressingIndexTest, InlineLookup) {
+  auto builder = std::make_shared<dcds::Builder>("OpenAddressingIndexTest_Map");
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto item = builder->createType("OpenAddressingIndexTest_Item");
+  auto key_attr = item->addAttribute("key_", dcds::valueType::INT64, UINT64_C(0));
+  auto value_attr = item->addAttribute("value_", dcds::valueType::INT64, UINT64_C(0));
+  {
+    auto fn = item->createFunction("set", dcds::valueType::VOID);
+    auto key = fn->addArgument("key", dcds::valueType::INT64);
+    auto value = fn->addArgument("value", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addUpdateStatement(key_attr, key);
+    fn->getStatementBuilder()->addUpdateStatement(value_attr, value);
+    fn->getStatementBuilder()->addReturnVoidStatement();
+  }
+  {
+    auto fn = item->createFunction("get_value", dcds::valueType::INT64);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addReadStatement(value_attr, v);
+    fn->getStatementBuilder()->addReturnStatement(v);
+  }
+
+  auto records = builder->addAttributeIndexedList("records", item, "key_", dcds::hints::IndexHints::OPEN_ADDRESSING);
+
+  {
+    auto fn = builder->createFunction("insert", dcds::valueType::VOID);
+    auto key = fn->addArgument("key", dcds::valueType::INT64);
+    auto value = fn->addArgument("value", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    auto rec = sb->addInsertStatement(item, "rec");
+    sb->addMethodCall(item, rec, "set", std::vector<std::shared_ptr<dcds::expressions::Expression>>{key, value});
+    sb->addInsertStatement(records, key, rec);
+    sb->addReturnVoidStatement();
+  }
+  {
+    auto fn = builder->createFunction("remove", dcds::valueType::VOID);
+    auto key = fn->addArgument("key", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addRemoveStatement(records, key);
+    fn->getStatementBuilder()->addReturnVoidStatement();
+  }
+  {
+    // value of the key, or -1 if absent.
+    auto fn = builder->createFunction("lookup", dcds::valueType::INT64);
+    auto key = fn->addArgument("key", dcds::valueType::INT64);
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto value = fn->addTempVariable("value", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+
+    sb->addReadStatement(records, rec, key);
+    auto conditionalBlocks = sb->addConditionalBranch(new dcds::expressions::IsNotNullExpression{rec});
+    conditionalBlocks.ifBlock->addMethodCall(item, rec, "get_value", value);
+    conditionalBlocks.ifBlock->addReturnStatement(value);
+    conditionalBlocks.elseBlock->addReturnStatement(std::make_shared<dcds::expressions::Int64Constant>(-1));
+  }
+
+  builder->build();
+  auto instance = builder->createInstance();
+  auto insert = instance->get<void(int64_t, int64_t)>("insert");
+  auto remove = instance->get<void(int64_t)>("remove");
+  auto lookup = instance->get<int64_t(int64_t)>("lookup");
+
+  // enough keys for the table to be rehashed a few times.
+  constexpr int64_t n_keys = 100000;
+  for (int64_t key = 0; key < n_keys; key++) insert(key * 3, key);
+  for (int64_t key = 0; key < n_keys; key += 2) remove(key * 3);
+
+  for (int64_t key = 0; key < n_keys; key++) {
+    EXPECT_EQ(lookup(key * 3), (key % 2) ? key : -1);
+    EXPECT_EQ(lookup(key * 3 + 1), -1);
+  }
+  delete instance;
+}
+
+TEST(OpenAddressingIndexTest, SizeHints) {
+  // without a capacity, nothing is allocated before the first insert.
+  dcds::indexes::OpenAddressingIndex<int64_t> grown;
+  EXPECT_EQ(grown._stats().memory_bytes, 0);
+
+  constexpr int64_t n_keys = 100000;
+  dcds::indexes::OpenAddressingIndex<int64_t> presized(n_keys);
+  for (int64_t key = 0; key < n_keys; key++) {
+    EXPECT_TRUE(grown._insert(key, static_cast<uintptr_t>(key + 1)));
+    EXPECT_TRUE(presized._insert(key, static_cast<uintptr_t>(key + 1)));
+  }
+
+  // the incremental resizes do not lose entries.
+  for (int64_t key = 0; key < n_keys; key++) EXPECT_EQ(grown._find(key), static_cast<uintptr_t>(key + 1));
+  EXPECT_EQ(grown._stats().entries, static_cast<size_t>(n_keys));
+  EXPECT_GT(grown._stats().resizes, 0);
+  EXPECT_EQ(presized._stats().resizes, 0);
+}
+
+// Writers of different keys lock groups instead of the index, and serialize on a resize.
+TEST(OpenAddressingIndexTest, ConcurrentWriters) {
+  constexpr int64_t n_threads = 8;
+  constexpr int64_t n_keys = 20000;
+  dcds::indexes::OpenAddressingIndex<int64_t> index;
+  std::atomic<size_t> duplicates{0};
+
+  std::vector<std::thread> writers;
+  for (int64_t t = 0; t < n_threads; t++) {
+    writers.emplace_back([&, t]() {
+      for (int64_t i = 0; i < n_keys; i++) EXPECT_TRUE(index._insert(i * n_threads + t, static_cast<uintptr_t>(i)));
+      for (int64_t i = 0; i < n_keys; i += 2) index._remove(i * n_threads + t);
+      // keys which all the threads insert: only one insert succeeds.
+      for (int64_t i = 1; i <= 1000; i++) duplicates += !index._insert(-i, 0);
+    });
+  }
+  for (auto &writer : writers) writer.join();
+
+  for (int64_t key = 0; key < n_keys * n_threads; key++) {
+    uintptr_t value = 0;
+    bool found = index._find(key, value);
+    EXPECT_EQ(found, (key / n_threads) % 2 == 1);
+    if (found) EXPECT_EQ(value, static_cast<uintptr_t>(key / n_threads));
+  }
+  EXPECT_EQ(duplicates, (n_threads - 1) * 1000);
+  EXPECT_EQ(index._stats().entries, static_cast<size_t>(n_keys * n_threads / 2 + 1000));
+}
+
+// A replaced table is freed by the next writer which sees no lookup in progress.
+TEST(OpenAddressingIndexTest, RetiredTables) {
+  constexpr int64_t n_keys = 1000;
+  std::vector<int64_t> keys(n_keys);
+  std::vector<uintptr_t> values(n_keys);
+  for (int64_t i = 0; i < n_keys; i++) {
+    keys[i] = i;
+    values[i] = static_cast<uintptr_t>(i + 1);
+  }
+
+  // the bulk insert grows the table at once, and frees the old one when it releases the index.
+  dcds::indexes::OpenAddressingIndex<int64_t> grown(16);
+  dcds::indexes::OpenAddressingIndex<int64_t> presized(n_keys);
+  EXPECT_EQ(grown._bulk_insert(keys.data(), values.data(), n_keys), static_cast<size_t>(n_keys));
+  EXPECT_EQ(grown._stats().resizes, 1);
+  EXPECT_EQ(grown._stats().memory_bytes, presized._stats().memory_bytes);
+
+  // lookups during the resizes find the keys on the old tables, or restart on the new ones.
+  constexpr int64_t n_readers = 4;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int64_t t = 0; t < n_readers; t++) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        for (int64_t key = 0; key < n_keys; key++) EXPECT_EQ(grown._find(key), static_cast<uintptr_t>(key + 1));
+      }
+    });
+  }
+  for (int64_t key = n_keys; key < 100 * n_keys; key++) grown._insert(key, static_cast<uintptr_t>(key + 1));
+  done = true;
+  for (auto &reader : readers) reader.join();
+  EXPECT_GT(grown._stats().resizes, 1);
+}
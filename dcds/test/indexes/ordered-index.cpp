@@ -0,0 +1,136 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <dcds/dcds.hpp>
+#include <dcds/indexes/btree-index.hpp>
+#include <map>
+#include <random>
+
+TEST(OrderedIndexTest, BTreeIndex) {
+  dcds::indexes::BTreeIndex<int64_t> index;
+  std::map<int64_t, uintptr_t> reference;
+  std::mt19937_64 rng(42);
+
+  // enough keys for a few levels of inner nodes.
+  for (size_t i = 0; i < 100000; i++) {
+    int64_t key = static_cast<int64_t>(rng() % 50000);
+    if (rng() % 4 == 0) {
+      index._remove(key);
+      reference.erase(key);
+    } else {
+      auto value = static_cast<uintptr_t>(key * 2);
+      EXPECT_EQ(index._insert(key, value), reference.emplace(key, value).second);
+    }
+  }
+
+  for (int64_t key = 0; key < 50000; key++) EXPECT_EQ(index._contains(key), reference.contains(key));
+
+  for (size_t i = 0; i < 100; i++) {
+    int64_t lower = static_cast<int64_t>(rng() % 50000);
+    int64_t upper = lower + static_cast<int64_t>(rng() % 2000);
+
+    std::vector<int64_t> scanned;
+    int64_t key = lower;
+    uintptr_t value = 0;
+    for (bool inclusive = true; index._next(key, inclusive, upper, value); inclusive = false) {
+      EXPECT_EQ(value, static_cast<uintptr_t>(key * 2));
+      scanned.push_back(key);
+    }
+
+    std::vector<int64_t> expected;
+    for (auto it = reference.lower_bound(lower); it != reference.end() && it->first <= upper; ++it) {
+      expected.push_back(it->first);
+    }
+    EXPECT_EQ(scanned, expected);
+  }
+}
+
+TEST(OrderedIndexTest, RangeScanStatement) {
+  auto builder = std::make_shared<dcds::Builder>("OrderedIndexTest_Stock");
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto item = builder->createType("OrderedIndexTest_Item");
+  auto key_attr = item->addAttribute("key_", dcds::valueType::INT64, UINT64_C(0));
+  auto qty_attr = item->addAttribute("qty", dcds::valueType::INT64, UINT64_C(0));
+  {
+    auto fn = item->createFunction("set", dcds::valueType::VOID);
+    auto key = fn->addArgument("key", dcds::valueType::INT64);
+    auto qty = fn->addArgument("qty", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addUpdateStatement(key_attr, key);
+    fn->getStatementBuilder()->addUpdateStatement(qty_attr, qty);
+    fn->getStatementBuilder()->addReturnVoidStatement();
+  }
+  {
+    auto fn = item->createFunction("get_qty", dcds::valueType::INT64);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addReadStatement(qty_attr, v);
+    fn->getStatementBuilder()->addReturnStatement(v);
+  }
+
+  auto items = builder->addAttributeIndexedList("items", item, "key_", dcds::hints::IndexHints::ORDERED);
+  auto total = builder->addAttribute("total", dcds::valueType::INT64, UINT64_C(0));
+
+  {
+    auto fn = builder->createFunction("insert", dcds::valueType::BOOL);
+    auto key = fn->addArgument("key", dcds::valueType::INT64);
+    auto qty = fn->addArgument("qty", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    auto rec = sb->addInsertStatement(item, "rec");
+    sb->addMethodCall(item, rec, "set", std::vector<std::shared_ptr<dcds::expressions::Expression>>{key, qty});
+    sb->addInsertStatement(items, key, rec);
+    sb->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(true));
+  }
+  {
+    // sum of qty over the keys in [lower, upper], e.g., as the stock-level query.
+    auto fn = builder->createFunction("sum_qty", dcds::valueType::INT64);
+    auto lower = fn->addArgument("lower", dcds::valueType::INT64);
+    auto upper = fn->addArgument("upper", dcds::valueType::INT64);
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto qty = fn->addTempVariable("qty", dcds::valueType::INT64);
+    auto sum = fn->addTempVariable("sum", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+
+    sb->addUpdateStatement(total, std::make_shared<dcds::expressions::Int64Constant>(0));
+    auto body = sb->addRangeScan(items, lower, upper, rec);
+    body->addMethodCall(item, rec, "get_qty", qty);
+    body->addReadStatement(total, sum);
+    body->addUpdateStatement(total, std::make_shared<dcds::expressions::AddExpression>(sum, qty));
+    sb->addReadStatement(total, sum);
+    sb->addReturnStatement(sum);
+  }
+
+  builder->build();
+  auto instance = builder->createInstance();
+  auto insert = instance->get<bool(int64_t, int64_t)>("insert");
+  auto sum_qty = instance->get<int64_t(int64_t, int64_t)>("sum_qty");
+
+  // inserted out of order.
+  for (int64_t key = 0; key < 1000; key++) insert((key * 7) % 1000, (key * 7) % 1000);
+
+  EXPECT_EQ(sum_qty(10, 19), 145);
+  EXPECT_EQ(sum_qty(0, 999), 999 * 1000 / 2);
+  EXPECT_EQ(sum_qty(500, 499), 0);
+  EXPECT_EQ(sum_qty(998, 5000), 998 + 999);
+  delete instance;
+}
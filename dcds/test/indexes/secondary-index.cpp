@@ -0,0 +1,199 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <dcds/dcds.hpp>
+
+// Customers keyed by (w_id, d_id, c_id), as in TPC-C, with a non-unique secondary index by last name (its id here)
+// and a unique one by phone number.
+static std::shared_ptr<dcds::Builder> buildCustomers(const std::string& name, bool single_threaded) {
+  auto builder = std::make_shared<dcds::Builder>(name);
+  if (single_threaded) builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto customer = builder->createType(name + "_Customer");
+  auto w_attr = customer->addAttribute("w_id", dcds::valueType::INT64, UINT64_C(0));
+  auto d_attr = customer->addAttribute("d_id", dcds::valueType::INT32, UINT32_C(0));
+  auto c_attr = customer->addAttribute("c_id", dcds::valueType::INT64, UINT64_C(0));
+  auto last_attr = customer->addAttribute("last", dcds::valueType::INT64, UINT64_C(0));
+  auto phone_attr = customer->addAttribute("phone", dcds::valueType::INT64, UINT64_C(0));
+  {
+    auto fn = customer->createFunction("set", dcds::valueType::VOID);
+    auto w = fn->addArgument("w", dcds::valueType::INT64);
+    auto d = fn->addArgument("d", dcds::valueType::INT32);
+    auto c = fn->addArgument("c", dcds::valueType::INT64);
+    auto last = fn->addArgument("last", dcds::valueType::INT64);
+    auto phone = fn->addArgument("phone", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    sb->addUpdateStatement(w_attr, w);
+    sb->addUpdateStatement(d_attr, d);
+    sb->addUpdateStatement(c_attr, c);
+    sb->addUpdateStatement(last_attr, last);
+    sb->addUpdateStatement(phone_attr, phone);
+    sb->addReturnVoidStatement();
+  }
+  for (const auto& attr : {last_attr, phone_attr}) {
+    auto fn = customer->createFunction("set_" + attr->name, dcds::valueType::VOID);
+    auto v = fn->addArgument("v", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addUpdateStatement(attr, v);
+    fn->getStatementBuilder()->addReturnVoidStatement();
+  }
+  {
+    auto fn = customer->createFunction("get_c_id", dcds::valueType::INT64);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addReadStatement(c_attr, v);
+    fn->getStatementBuilder()->addReturnStatement(v);
+  }
+
+  auto customers = builder->addAttributeIndexedList("customers", customer, {{"w_id", 8}, {"d_id", 8}, {"c_id", 24}});
+  // (w_id, d_id, last) + c_id
+  auto by_last = builder->addSecondaryIndex("by_last", "customers", {{"w_id", 8}, {"d_id", 8}, {"last", 16}}, false,
+                                            dcds::hints::IndexHints::ORDERED);
+  auto by_phone = builder->addSecondaryIndex("by_phone", "customers", {{"phone", 64}}, true);
+
+  using key_values = std::vector<std::shared_ptr<dcds::expressions::Expression>>;
+  auto key = [&](const std::shared_ptr<dcds::Attribute>& list, const key_values& values) {
+    return std::make_shared<dcds::expressions::CompositeKeyExpression>(list, values);
+  };
+  auto addCustomerCall = [&](const std::string& fn_name, const std::string& method) {
+    // calls the method on the customer, if it exists.
+    auto fn = builder->createFunction(fn_name, dcds::valueType::BOOL);
+    auto w = fn->addArgument("w", dcds::valueType::INT64);
+    auto d = fn->addArgument("d", dcds::valueType::INT32);
+    auto c = fn->addArgument("c", dcds::valueType::INT64);
+    auto v = fn->addArgument("v", dcds::valueType::INT64);
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto sb = fn->getStatementBuilder();
+    sb->addReadStatement(customers, rec, key(customers, {w, d, c}));
+    auto conditionalBlocks = sb->addConditionalBranch(new dcds::expressions::IsNotNullExpression{rec});
+    conditionalBlocks.ifBlock->addMethodCall(customer, rec, method, key_values{v});
+    conditionalBlocks.ifBlock->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(true));
+    conditionalBlocks.elseBlock->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(false));
+  };
+  {
+    auto fn = builder->createFunction("insert", dcds::valueType::BOOL);
+    auto w = fn->addArgument("w", dcds::valueType::INT64);
+    auto d = fn->addArgument("d", dcds::valueType::INT32);
+    auto c = fn->addArgument("c", dcds::valueType::INT64);
+    auto last = fn->addArgument("last", dcds::valueType::INT64);
+    auto phone = fn->addArgument("phone", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    auto rec = sb->addInsertStatement(customer, "rec");
+    sb->addMethodCall(customer, rec, "set", key_values{w, d, c, last, phone});
+    sb->addInsertStatement(customers, key(customers, {w, d, c}), rec);
+    sb->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(true));
+  }
+  {
+    auto fn = builder->createFunction("remove", dcds::valueType::BOOL);
+    auto w = fn->addArgument("w", dcds::valueType::INT64);
+    auto d = fn->addArgument("d", dcds::valueType::INT32);
+    auto c = fn->addArgument("c", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addRemoveStatement(customers, key(customers, {w, d, c}));
+    fn->getStatementBuilder()->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(true));
+  }
+  addCustomerCall("set_last", "set_last");
+  addCustomerCall("set_phone", "set_phone");
+  {
+    // number of customers of a district with the last name.
+    auto fn = builder->createFunction("count_by_last", dcds::valueType::INT64);
+    auto w = fn->addArgument("w", dcds::valueType::INT64);
+    auto d = fn->addArgument("d", dcds::valueType::INT32);
+    auto last = fn->addArgument("last", dcds::valueType::INT64);
+    auto total = builder->addAttribute("total", dcds::valueType::INT64, UINT64_C(0));
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto count = fn->addTempVariable("count", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+
+    auto min_c = std::make_shared<dcds::expressions::Int64Constant>(0);
+    auto max_c = std::make_shared<dcds::expressions::Int64Constant>((INT64_C(1) << 23) - 1);
+    sb->addUpdateStatement(total, std::make_shared<dcds::expressions::Int64Constant>(0));
+    auto body = sb->addRangeScan(by_last, key(by_last, {w, d, last, min_c}), key(by_last, {w, d, last, max_c}), rec);
+    body->addReadStatement(total, count);
+    body->addUpdateStatement(total, std::make_shared<dcds::expressions::AddExpression>(
+                                        count, std::make_shared<dcds::expressions::Int64Constant>(1)));
+    sb->addReadStatement(total, count);
+    sb->addReturnStatement(count);
+  }
+  {
+    // c_id of the customer with the phone number, or -1.
+    auto fn = builder->createFunction("find_by_phone", dcds::valueType::INT64);
+    auto phone = fn->addArgument("phone", dcds::valueType::INT64);
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto c = fn->addTempVariable("c", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+
+    sb->addReadStatement(by_phone, rec, key(by_phone, {phone}));
+    auto conditionalBlocks = sb->addConditionalBranch(new dcds::expressions::IsNotNullExpression{rec});
+    conditionalBlocks.ifBlock->addMethodCall(customer, rec, "get_c_id", c);
+    conditionalBlocks.ifBlock->addReturnStatement(c);
+    conditionalBlocks.elseBlock->addReturnStatement(std::make_shared<dcds::expressions::Int64Constant>(-1));
+  }
+
+  builder->build();
+  return builder;
+}
+
+static void checkMaintenance(const std::shared_ptr<dcds::Builder>& builder) {
+  auto instance = builder->createInstance();
+  auto insert = instance->get<bool(int64_t, int32_t, int64_t, int64_t, int64_t)>("insert");
+  auto remove = instance->get<bool(int64_t, int32_t, int64_t)>("remove");
+  auto set_last = instance->get<bool(int64_t, int32_t, int64_t, int64_t)>("set_last");
+  auto set_phone = instance->get<bool(int64_t, int32_t, int64_t, int64_t)>("set_phone");
+  auto count_by_last = instance->get<int64_t(int64_t, int32_t, int64_t)>("count_by_last");
+  auto find_by_phone = instance->get<int64_t(int64_t)>("find_by_phone");
+
+  for (int64_t w = 1; w <= 2; w++) {
+    for (int32_t d = 1; d <= 3; d++) {
+      for (int64_t c = 0; c < 10; c++) EXPECT_TRUE(insert(w, d, c, c % 3, w * 1000 + d * 100 + c));
+    }
+  }
+  EXPECT_EQ(count_by_last(1, 2, 0), 4);
+  EXPECT_EQ(find_by_phone(1203), 3);
+
+  // updates move the entries.
+  EXPECT_TRUE(set_last(1, 2, 3, 1));
+  EXPECT_EQ(count_by_last(1, 2, 0), 3);
+  EXPECT_EQ(count_by_last(1, 2, 1), 4);
+  EXPECT_EQ(count_by_last(2, 2, 0), 4);
+  EXPECT_TRUE(set_phone(1, 2, 3, 9999));
+  EXPECT_EQ(find_by_phone(1203), -1);
+  EXPECT_EQ(find_by_phone(9999), 3);
+
+  // a taken phone number fails the update and the insert, and leaves the indexes as they were.
+  EXPECT_FALSE(set_phone(1, 2, 4, 9999));
+  EXPECT_EQ(find_by_phone(9999), 3);
+  EXPECT_EQ(find_by_phone(1204), 4);
+  EXPECT_FALSE(insert(1, 2, 50, 0, 1205));
+  EXPECT_EQ(count_by_last(1, 2, 0), 3);
+  EXPECT_EQ(find_by_phone(1205), 5);
+  EXPECT_TRUE(insert(1, 2, 50, 0, 1250));
+  EXPECT_EQ(count_by_last(1, 2, 0), 4);
+
+  EXPECT_TRUE(remove(1, 2, 6));
+  EXPECT_EQ(count_by_last(1, 2, 0), 3);
+  EXPECT_EQ(find_by_phone(1206), -1);
+  delete instance;
+}
+
+TEST(SecondaryIndexTest, SingleThreaded) { checkMaintenance(buildCustomers("SecondaryIndexTest_ST", true)); }
+
+TEST(SecondaryIndexTest, Transactional) { checkMaintenance(buildCustomers("SecondaryIndexTest_Txn", false)); }
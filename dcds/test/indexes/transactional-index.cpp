@@ -0,0 +1,85 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <dcds/indexes/index-functions.hpp>
+#include <dcds/indexes/open-addressing-index.hpp>
+#include <dcds/transaction/transaction-manager.hpp>
+
+// Index writes of a transaction lock their keys and are applied at commit, until then only the transaction finds them.
+TEST(TransactionalIndexTest, CommitTimeVisibility) {
+  dcds::txn::TransactionManager txnManager("TransactionalIndexTest");
+  dcds::indexes::OpenAddressingIndex<int64_t> index;
+  auto index_ptr = reinterpret_cast<uintptr_t>(&index);
+  index._insert(1, 100);
+
+  auto *txn = txnManager.beginTransaction(false);
+  EXPECT_FALSE(index_txn_has_writes(txn));
+  EXPECT_TRUE(index_insert_txn<int64_t>(txn, index_ptr, 2, 200));
+  EXPECT_TRUE(index_remove_txn<int64_t>(txn, index_ptr, 1, nullptr));
+  EXPECT_TRUE(index_txn_has_writes(txn));
+  EXPECT_EQ(index_find_txn<int64_t>(txn, index_ptr, 2), 200);
+  EXPECT_EQ(index_find_txn<int64_t>(txn, index_ptr, 1), 0);
+  EXPECT_EQ(index._find(2), 0);
+  EXPECT_EQ(index._find(1), 100);
+
+  // inserts of existing keys fail, as the transaction finds them.
+  EXPECT_FALSE(index_insert_txn<int64_t>(txn, index_ptr, 2, 222));
+  EXPECT_EQ(txn->getStatus(), dcds::txn::TXN_STATUS::ACTIVE);
+
+  // the keys are locked until txn ends.
+  auto *other = txnManager.beginTransaction(false);
+  EXPECT_EQ(index_find_txn<int64_t>(other, index_ptr, 2), 0);
+  EXPECT_FALSE(index_insert_txn<int64_t>(other, index_ptr, 2, 201));
+  EXPECT_EQ(other->getStatus(), dcds::txn::TXN_STATUS::ABORTED);
+  EXPECT_FALSE(txnManager.endTransaction(other));
+
+  txn->status = dcds::txn::TXN_STATUS::ABORTED;
+  EXPECT_FALSE(txnManager.endTransaction(txn));
+  EXPECT_EQ(index._find(2), 0);
+  EXPECT_EQ(index._find(1), 100);
+
+  // a key may go back and forth in one transaction, its entries are applied in order.
+  txn = txnManager.beginTransaction(false);
+  uintptr_t removed = 0;
+  EXPECT_TRUE(index_remove_txn<int64_t>(txn, index_ptr, 1, &removed));
+  EXPECT_EQ(removed, 100);
+  EXPECT_TRUE(index_insert_txn<int64_t>(txn, index_ptr, 1, 111));
+  EXPECT_TRUE(index_insert_txn<int64_t>(txn, index_ptr, 3, 300));
+  EXPECT_TRUE(index_remove_txn<int64_t>(txn, index_ptr, 3, &removed));
+  EXPECT_EQ(removed, 300);
+  EXPECT_EQ(index_find_txn<int64_t>(txn, index_ptr, 3), 0);
+  EXPECT_EQ(index_find_txn<int64_t>(txn, index_ptr, 1), 111);
+  EXPECT_EQ(index._find(1), 100);
+  EXPECT_TRUE(txnManager.endTransaction(txn));
+  EXPECT_EQ(index._find(1), 111);
+  EXPECT_EQ(index._find(3), 0);
+
+  // ... and none of them on abort.
+  txn = txnManager.beginTransaction(false);
+  EXPECT_TRUE(index_remove_txn<int64_t>(txn, index_ptr, 1, nullptr));
+  EXPECT_TRUE(index_insert_txn<int64_t>(txn, index_ptr, 1, 122));
+  txn->status = dcds::txn::TXN_STATUS::ABORTED;
+  EXPECT_FALSE(txnManager.endTransaction(txn));
+  EXPECT_EQ(index._find(1), 111);
+}
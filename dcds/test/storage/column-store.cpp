@@ -0,0 +1,126 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <dcds/dcds.hpp>
+#include <dcds/storage/table-registry.hpp>
+
+TEST(ColumnStoreTest, DenseColumns) {
+  using dcds::storage::AttributeDef;
+  constexpr size_t n = 100;
+
+  dcds::storage::record_layout_t layout;
+  layout.column_store = true;
+  auto table = dcds::storage::TableRegistry::getInstance().createTable(
+      "ColumnStoreTest_DenseColumns",
+      {AttributeDef("flag", dcds::valueType::BOOL, 1), AttributeDef("qty", dcds::valueType::INT64, 8)}, layout);
+
+  struct __attribute__((packed)) {
+    bool flag = true;
+    int64_t qty = 5;
+  } defaults;
+  auto first = table->insertNRecord(nullptr, n, &defaults);
+  ASSERT_TRUE(first.valid());
+
+  for (uint i = 0; i < n; i += 2) {
+    int64_t qty = i;
+    table->updateNthRecord(nullptr, first.operator->(), &qty, i, 1);
+  }
+
+  auto [qty_column, stride] = table->getColumn(first.operator->(), 1);
+  EXPECT_EQ(stride, sizeof(int64_t));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(qty_column) % dcds::CACHE_LINE_SIZE, 0);
+
+  int64_t sum = 0;
+  for (size_t i = 0; i < n; i++) sum += static_cast<int64_t*>(qty_column)[i];
+  EXPECT_EQ(sum, (n / 2) * 5 + (n / 2) * (n - 2) / 2);
+
+  // records still map to their own slots in the columns.
+  auto tenth = table->getNthRecordReference(nullptr, first.operator->(), 10);
+  int64_t qty = 0;
+  table->getAttribute(nullptr, tenth.operator->(), &qty, 1);
+  EXPECT_EQ(qty, 10);
+  bool flag = false;
+  table->getNthRecord(nullptr, first.operator->(), &flag, 11, 0);
+  EXPECT_TRUE(flag);
+}
+
+TEST(ColumnStoreTest, ColumnarArrayAttribute) {
+  auto builder = std::make_shared<dcds::Builder>("ColumnStoreTest_Array");
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto item = builder->createType("ColumnStoreTest_Item");
+  auto qty = item->addAttribute("qty", dcds::valueType::INT64, UINT64_C(3));
+  {
+    auto fn = item->createFunction("get_qty", dcds::valueType::INT64);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addReadStatement(qty, v);
+    fn->getStatementBuilder()->addReturnStatement(v);
+  }
+  {
+    auto fn = item->createFunction("set_qty", dcds::valueType::VOID);
+    fn->addArgument("value", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addUpdateStatement(qty, "value");
+    fn->getStatementBuilder()->addReturnVoidStatement();
+  }
+
+  builder->addAttributeArray("items", item, 16, dcds::hints::LayoutHints::COLUMN_STORE);
+
+  {
+    auto fn = builder->createFunction("get", dcds::valueType::INT64);
+    auto idx = fn->addArgument("idx", dcds::valueType::INT64);
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto ret = fn->addTempVariable("ret", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    sb->addReadStatement(builder->getAttribute("items"), rec, idx);
+    sb->addMethodCall(item, rec, "get_qty", ret);
+    sb->addReturnStatement(ret);
+  }
+  {
+    auto fn = builder->createFunction("set", dcds::valueType::VOID);
+    auto idx = fn->addArgument("idx", dcds::valueType::INT64);
+    auto value = fn->addArgument("value", dcds::valueType::INT64);
+    auto rec = fn->addTempVariable("rec", dcds::valueType::RECORD_PTR);
+    auto sb = fn->getStatementBuilder();
+    sb->addReadStatement(builder->getAttribute("items"), rec, idx);
+    sb->addMethodCall(item, rec, "set_qty", std::vector<std::shared_ptr<dcds::expressions::Expression>>{value});
+    sb->addReturnVoidStatement();
+  }
+
+  builder->build();
+  auto instance = builder->createInstance();
+  auto get = instance->get<int64_t(int64_t)>("get");
+  auto set = instance->get<void(int64_t, int64_t)>("set");
+
+  set(4, 40);
+  set(5, 50);
+  EXPECT_EQ(get(3), 3);
+  EXPECT_EQ(get(4), 40);
+  EXPECT_EQ(get(5), 50);
+
+  // the array has its own column-store table, the element type keeps its row store.
+  auto table = dcds::storage::TableRegistry::getInstance().getTable("ColumnStoreTest_Array_items_tbl");
+  ASSERT_NE(table, nullptr);
+  EXPECT_NE(dynamic_cast<dcds::storage::SingleVersionColumnStore*>(table), nullptr);
+  delete instance;
+}
@@ -48,4 +48,307 @@ TEST(BuilderTest, NoAttributeBuild) {
   EXPECT_TRUE(std::any_cast<bool>(instance->op(op_name, 3)));
   EXPECT_TRUE(std::any_cast<bool>(instance->op(op_name, 4)));
   EXPECT_TRUE(std::any_cast<bool>(instance->op(op_name, 5)));
-}
\ No newline at end of file
+}
+
+TEST(BuilderTest, LazyCompilationBuild) {
+  std::string name = "BuilderTest_LazyCompilationBuild";
+  auto op_name = name + "_op";
+
+  auto builder = std::make_shared<dcds::Builder>(name);
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto fn = builder->createFunction(op_name, dcds::valueType::BOOL);
+  fn->addArgument("arg_one", dcds::valueType::INT64);
+  fn->getStatementBuilder()->addReturnStatement(std::make_shared<dcds::expressions::BoolConstant>(true));
+
+  // options are read when the JIT is created.
+  setenv("DCDS_JIT_LAZY", "1", 1);
+  builder->build();
+  unsetenv("DCDS_JIT_LAZY");
+
+  auto instance = builder->createInstance();
+  EXPECT_TRUE(instance->getJitStartupStats().lazy_compilation);
+
+  EXPECT_TRUE(std::any_cast<bool>(instance->op(op_name, 1)));
+  EXPECT_TRUE(std::any_cast<bool>(instance->op(op_name, 2)));
+}
+
+TEST(BuilderTest, RebuildAfterUnload) {
+  std::string name = "BuilderTest_RebuildAfterUnload";
+  auto op_name = name + "_op";
+
+  // every build gets its own dylib in the shared JIT, which is removed together with the builder and its instances.
+  for (uint64_t i = 0; i < 3; i++) {
+    auto builder = std::make_shared<dcds::Builder>(name);
+    builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+    auto fn = builder->createFunction(op_name, dcds::valueType::INT64);
+    fn->getStatementBuilder()->addReturnStatement(std::make_shared<dcds::expressions::Int64Constant>(i));
+
+    builder->build();
+    auto instance = builder->createInstance();
+    EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name)), i);
+    delete instance;
+  }
+}
+
+TEST(BuilderTest, OptimizationProfiles) {
+  for (auto profile : {dcds::hints::OptimizationProfile::LATENCY, dcds::hints::OptimizationProfile::SIZE,
+                       dcds::hints::OptimizationProfile::COMPILE_SPEED}) {
+    for (auto target : {dcds::hints::TargetHints::HOST_CPU, dcds::hints::TargetHints::PORTABLE}) {
+      std::string name = "BuilderTest_OptimizationProfiles";
+      auto op_name = name + "_op";
+
+      auto builder = std::make_shared<dcds::Builder>(name);
+      builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+      builder->addHint(profile);
+      builder->addHint(target);
+
+      auto attr = builder->addAttribute("int64_attribute", dcds::valueType::INT64, UINT64_C(0));
+      auto fn = builder->createFunction(op_name, dcds::valueType::INT64);
+      fn->addArgument("arg_one", dcds::valueType::INT64);
+      auto tmpVar = fn->addTempVariable("tmp", dcds::valueType::INT64);
+      auto sb = fn->getStatementBuilder();
+      sb->addReadStatement(attr, tmpVar);
+      sb->addUpdateStatement(attr, "arg_one");
+      sb->addReturnStatement(tmpVar);
+
+      builder->build();
+      auto instance = builder->createInstance();
+      EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name, 10)), 0);
+      EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name, 20)), 10);
+      delete instance;
+    }
+  }
+}
+
+TEST(BuilderTest, RedundantStatementElimination) {
+  std::string name = "BuilderTest_RedundantStatementElimination";
+  auto op_name = name + "_op";
+
+  auto builder = std::make_shared<dcds::Builder>(name);
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto attr = builder->addAttribute("int64_attribute", dcds::valueType::INT64, UINT64_C(0));
+  auto fn = builder->createFunction(op_name, dcds::valueType::INT64);
+  fn->addArgument("arg_one", dcds::valueType::INT64);
+  auto a = fn->addTempVariable("a", dcds::valueType::INT64);
+  auto b = fn->addTempVariable("b", dcds::valueType::INT64);
+  auto c = fn->addTempVariable("c", dcds::valueType::INT64);
+  auto sb = fn->getStatementBuilder();
+  sb->addReadStatement(attr, a);
+  sb->addReadStatement(attr, b);  // same as a
+  sb->addUpdateStatement(attr, "arg_one");
+  sb->addReadStatement(attr, c);  // same as arg_one
+
+  auto a_plus_b = std::make_shared<dcds::expressions::AddExpression>(a, b);
+  auto sum = std::make_shared<dcds::expressions::AddExpression>(a_plus_b, c);
+  sb->addReturnStatement(sum);
+
+  dcds::BuilderOptPasses buildOptimizer(builder);
+  buildOptimizer.runAll();
+  EXPECT_EQ(buildOptimizer.getRedundancyStats().forwarded_reads, 1);
+  EXPECT_EQ(buildOptimizer.getRedundancyStats().forwarded_writes, 1);
+
+  builder->build();
+  auto instance = builder->createInstance();
+  EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name, 10)), 10);
+  EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name, 20)), 40);
+  delete instance;
+}
+
+TEST(BuilderTest, ConstantAttributeReads) {
+  std::string name = "BuilderTest_ConstantAttributeReads";
+  auto op_name = name + "_op";
+
+  auto builder = std::make_shared<dcds::Builder>(name);
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto compile_time_attr = builder->addAttribute("compile_time_attribute", dcds::valueType::INT64, UINT64_C(40));
+  compile_time_attr->is_compile_time_constant = true;
+  auto runtime_attr = builder->addAttribute("runtime_attribute", dcds::valueType::INT64, UINT64_C(2));
+  runtime_attr->is_runtime_constant = true;
+
+  auto fn = builder->createFunction(op_name, dcds::valueType::INT64);
+  auto a = fn->addTempVariable("a", dcds::valueType::INT64);
+  auto b = fn->addTempVariable("b", dcds::valueType::INT64);
+  auto sb = fn->getStatementBuilder();
+  sb->addReadStatement(compile_time_attr, a);  // folded into an immediate
+  sb->addReadStatement(runtime_attr, b);       // read without the transactional table access
+  sb->addReturnStatement(std::make_shared<dcds::expressions::AddExpression>(a, b));
+
+  builder->build();
+  auto instance = builder->createInstance();
+  EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name)), 42);
+  delete instance;
+}
+
+TEST(BuilderTest, WriteOnlyAttributeElimination) {
+  std::string name = "BuilderTest_WriteOnlyAttributeElimination";
+  auto op_name = name + "_op";
+
+  auto builder = std::make_shared<dcds::Builder>(name);
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto value_attr = builder->addAttribute("value", dcds::valueType::INT64, UINT64_C(0));
+  auto last_arg_attr = builder->addAttribute("last_arg", dcds::valueType::INT64, UINT64_C(0));  // write-only
+  builder->addAttribute("unused", dcds::valueType::INT64, UINT64_C(0));
+
+  auto fn = builder->createFunction(op_name, dcds::valueType::INT64);
+  auto arg = fn->addArgument("arg_one", dcds::valueType::INT64);
+  auto a = fn->addTempVariable("a", dcds::valueType::INT64);
+  auto sb = fn->getStatementBuilder();
+  sb->addReadStatement(value_attr, a);
+  auto sum = std::make_shared<dcds::expressions::AddExpression>(a, arg);
+  sb->addUpdateStatement(value_attr, sum);
+  sb->addUpdateStatement(last_arg_attr, "arg_one");
+  sb->addReturnStatement(sum);
+
+  dcds::BuilderOptPasses buildOptimizer(builder);
+  buildOptimizer.runAll();
+  EXPECT_EQ(buildOptimizer.getNumRemovedAttributes(), 2);
+  EXPECT_TRUE(builder->hasAttribute("value"));
+  EXPECT_FALSE(builder->hasAttribute("last_arg"));
+  EXPECT_FALSE(builder->hasAttribute("unused"));
+
+  builder->build();
+  auto instance = builder->createInstance();
+  EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name, 10)), 10);
+  EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name, 5)), 15);
+  delete instance;
+}
+
+TEST(BuilderTest, OptPassesOnBuild) {
+  auto generate = [](dcds::Builder& builder) {
+    builder.addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+    auto value_attr = builder.addAttribute("value", dcds::valueType::INT64, UINT64_C(7));
+    builder.addAttribute("unused", dcds::valueType::INT64, UINT64_C(0));
+
+    auto fn = builder.createFunction("get", dcds::valueType::INT64);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addReadStatement(value_attr, v);
+    fn->getStatementBuilder()->addReturnStatement(v);
+  };
+
+  // the specification is built as-is by default.
+  dcds::Builder as_is("BuilderTest_OptPassesOnBuild_AsIs");
+  generate(as_is);
+  as_is.build();
+  EXPECT_TRUE(as_is.hasAttribute("unused"));
+
+  // with the hint, also for a builder which is not owned by a shared_ptr.
+  dcds::Builder optimized("BuilderTest_OptPassesOnBuild_Optimized");
+  generate(optimized);
+  optimized.addHint(dcds::hints::BuilderHints::RUN_BUILDER_OPT_PASSES);
+  optimized.build();
+  EXPECT_FALSE(optimized.hasAttribute("unused"));
+
+  auto instance = optimized.createInstance();
+  EXPECT_EQ(std::any_cast<uint64_t>(instance->op("get")), 7);
+  delete instance;
+}
+
+TEST(BuilderTest, HotColdAttributeSplit) {
+  std::string name = "BuilderTest_HotColdAttributeSplit";
+
+  auto builder = std::make_shared<dcds::Builder>(name);
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto counter = builder->addAttribute("counter", dcds::valueType::INT64, UINT64_C(0));
+  std::vector<std::shared_ptr<dcds::SimpleAttribute>> details;
+  for (auto attr_name : {"detail_a", "detail_b", "detail_c"}) {
+    details.push_back(builder->addAttribute(attr_name, dcds::valueType::INT64, UINT64_C(0)));
+  }
+
+  auto inc = builder->createFunction("inc", dcds::valueType::INT64);
+  auto c = inc->addTempVariable("c", dcds::valueType::INT64);
+  auto inc_sb = inc->getStatementBuilder();
+  inc_sb->addReadStatement(counter, c);
+  auto c_plus_one = std::make_shared<dcds::expressions::AddExpression>(
+      c, std::make_shared<dcds::expressions::Int64Constant>(1));
+  inc_sb->addUpdateStatement(counter, c_plus_one);
+  inc_sb->addReturnStatement(c_plus_one);
+
+  auto set_details = builder->createFunction("set_details", dcds::valueType::VOID);
+  set_details->addArgument("value", dcds::valueType::INT64);
+  auto set_sb = set_details->getStatementBuilder();
+  for (auto& d : details) set_sb->addUpdateStatement(d, "value");
+  set_sb->addReturnVoidStatement();
+
+  auto sum_details = builder->createFunction("sum_details", dcds::valueType::INT64);
+  auto sum_sb = sum_details->getStatementBuilder();
+  std::shared_ptr<dcds::expressions::Expression> sum = std::make_shared<dcds::expressions::Int64Constant>(0);
+  for (auto& d : details) {
+    auto var = sum_details->addTempVariable("v_" + d->name, dcds::valueType::INT64);
+    sum_sb->addReadStatement(d, var);
+    sum = std::make_shared<dcds::expressions::AddExpression>(sum, var);
+  }
+  sum_sb->addReturnStatement(sum);
+
+  // without a hint or a profile, the declared layout is kept.
+  dcds::BuilderOptPasses buildOptimizer(builder);
+  buildOptimizer.runAll();
+  EXPECT_FALSE(counter->is_cold);
+  for (auto& d : details) EXPECT_FALSE(d->is_cold);
+
+  // profile: inc is called far more often than the others.
+  buildOptimizer.opt_pass_splitHotColdAttributes({{"inc", 100}});
+  EXPECT_FALSE(counter->is_cold);
+  for (auto& d : details) EXPECT_TRUE(d->is_cold);
+
+  const auto& report = buildOptimizer.getFootprintReport();
+  ASSERT_TRUE(report.contains("inc"));
+  EXPECT_LE(report.at("inc").bytes_after, report.at("inc").bytes_before);
+
+  builder->build();
+  auto instance = builder->createInstance();
+  EXPECT_EQ(std::any_cast<uint64_t>(instance->op("inc")), 1);
+  instance->op("set_details", 5);
+  EXPECT_EQ(std::any_cast<uint64_t>(instance->op("inc")), 2);
+  EXPECT_EQ(std::any_cast<uint64_t>(instance->op("sum_details")), 15);
+  delete instance;
+}
+
+TEST(BuilderTest, RecordLayoutHints) {
+  std::string name = "BuilderTest_RecordLayoutHints";
+
+  auto builder = std::make_shared<dcds::Builder>(name);
+  EXPECT_EQ(builder->getLayoutFlags(), std::to_underlying(dcds::hints::LayoutHints::PACKED));
+  builder->addHint(dcds::hints::LayoutHints::ALIGNED_COLUMNS);
+  builder->addHint(dcds::hints::LayoutHints::CACHE_LINE_ALIGNED_RECORDS);
+  builder->addHint(dcds::hints::LayoutHints::SEPARATE_METADATA);
+
+  // declared narrowest-first, so the aligned layout has to reorder them.
+  auto flag = builder->addAttribute("flag", dcds::valueType::BOOL, true);
+  auto small = builder->addAttribute("small", dcds::valueType::INT32, int32_t{7});
+  auto big = builder->addAttribute("big", dcds::valueType::INT64, UINT64_C(40));
+
+  auto get_flag = builder->createFunction("get_flag", dcds::valueType::BOOL);
+  auto f = get_flag->addTempVariable("f", dcds::valueType::BOOL);
+  get_flag->getStatementBuilder()->addReadStatement(flag, f);
+  get_flag->getStatementBuilder()->addReturnStatement(f);
+
+  auto get_small = builder->createFunction("get_small", dcds::valueType::INT32);
+  auto s = get_small->addTempVariable("s", dcds::valueType::INT32);
+  get_small->getStatementBuilder()->addReadStatement(small, s);
+  get_small->getStatementBuilder()->addReturnStatement(s);
+
+  auto swap_big = builder->createFunction("swap_big", dcds::valueType::INT64);
+  swap_big->addArgument("value", dcds::valueType::INT64);
+  auto b = swap_big->addTempVariable("b", dcds::valueType::INT64);
+  swap_big->getStatementBuilder()->addReadStatement(big, b);
+  swap_big->getStatementBuilder()->addUpdateStatement(big, "value");
+  swap_big->getStatementBuilder()->addReturnStatement(b);
+
+  builder->injectCC();
+  builder->build();
+  auto instance = builder->createInstance();
+
+  EXPECT_TRUE(instance->get<bool()>("get_flag")());
+  EXPECT_EQ(instance->get<int32_t()>("get_small")(), 7);
+  auto swap = instance->get<uint64_t(uint64_t)>("swap_big");
+  EXPECT_EQ(swap(41), 40);
+  EXPECT_EQ(swap(42), 41);
+  EXPECT_EQ(instance->get<int32_t()>("get_small")(), 7);
+  delete instance;
+}
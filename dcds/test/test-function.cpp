@@ -21,6 +21,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <thread>
+
 #include <dcds/dcds.hpp>
 
 std::string test_name_prefix = "FunctionBuilderTest_";
@@ -154,4 +157,98 @@ TEST(FunctionBuilderTest, PtrTypeArgumentRead) {
   EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name, &x)), UINT64_C(30));
   x = 50;
   EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name, &x)), UINT64_C(40));
-}
\ No newline at end of file
+}
+
+TEST(FunctionBuilderTest, TypedFunctionHandle) {
+  std::string name = test_name_prefix + "TypedFunctionHandle";
+  auto op_name = name + "_op";
+  uint64_t initial_value = 7;
+
+  auto builder = std::make_shared<dcds::Builder>(name);
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto int64_attr = builder->addAttribute("int64_attribute", dcds::valueType::INT64, initial_value);
+
+  // -- function create
+  auto fn = builder->createFunction(op_name, dcds::valueType::INT64);
+  auto argOne = fn->addArgument("arg_one", dcds::valueType::INT64);
+  auto argTwo = fn->addArgument("arg_two", dcds::valueType::INT64, true);
+
+  auto sb = fn->getStatementBuilder();
+  auto tmpVar = fn->addTempVariable("tmp", dcds::valueType::INT64);
+
+  sb->addReadStatement(int64_attr, argTwo);
+  sb->addReadStatement(int64_attr, tmpVar);
+  sb->addUpdateStatement(int64_attr, "arg_one");
+  sb->addReturnStatement(tmpVar);
+
+  // -- function end
+
+  builder->build();
+  auto instance = builder->createInstance();
+
+  auto handle = instance->get<uint64_t(uint64_t, uint64_t *)>(op_name);
+  EXPECT_TRUE(handle);
+  // arg_two is passed by reference, so it has to be a pointer in the signature.
+  EXPECT_DEATH(instance->get<uint64_t(uint64_t, uint64_t)>(op_name), "Signature mismatch");
+
+  uint64_t output = 0;
+  EXPECT_EQ(handle(10, &output), initial_value);
+  EXPECT_EQ(output, initial_value);
+  EXPECT_EQ(handle(20, &output), 10);
+  EXPECT_EQ(output, 10);
+
+  // typed handle and op() dispatch to the same generated function.
+  EXPECT_EQ(std::any_cast<uint64_t>(instance->op(op_name, 30, &output)), 20);
+  EXPECT_EQ(handle(40, &output), 30);
+}
+
+TEST(FunctionBuilderTest, TieredCompilation) {
+  std::string name = test_name_prefix + "TieredCompilation";
+  auto op_name = name + "_op";
+
+  auto builder = std::make_shared<dcds::Builder>(name);
+  builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+
+  auto int64_attr = builder->addAttribute("int64_attribute", dcds::valueType::INT64, UINT64_C(0));
+
+  // -- function create
+  auto fn = builder->createFunction(op_name, dcds::valueType::INT64);
+  fn->addArgument("arg_one", dcds::valueType::INT64);
+
+  auto sb = fn->getStatementBuilder();
+  auto tmpVar = fn->addTempVariable("tmp", dcds::valueType::INT64);
+
+  sb->addReadStatement(int64_attr, tmpVar);
+  sb->addUpdateStatement(int64_attr, "arg_one");
+  sb->addReturnStatement(tmpVar);
+
+  // -- function end
+
+  // options are read when the JIT is created.
+  setenv("DCDS_JIT_TIERED", "1", 1);
+  setenv("DCDS_JIT_TIER_UP_THRESHOLD", "10", 1);
+  builder->build();
+  unsetenv("DCDS_JIT_TIERED");
+  unsetenv("DCDS_JIT_TIER_UP_THRESHOLD");
+
+  auto instance = builder->createInstance();
+  EXPECT_TRUE(instance->getJitStartupStats().tiered_compilation);
+
+  // results must not change while the function is switched to the optimized tier.
+  auto handle = instance->get<uint64_t(uint64_t)>(op_name);
+  for (uint64_t i = 1; i < 10; i++) {
+    EXPECT_EQ(handle(i), i - 1);
+  }
+  EXPECT_EQ(instance->getJitStartupStats().tiered_up_functions, 0);
+  for (uint64_t i = 10; i <= 1000; i++) {
+    EXPECT_EQ(handle(i), i - 1);
+  }
+
+  // the 10th call tiers up; with compile threads, the optimized tier is compiled asynchronously.
+  for (size_t wait_ms = 0; wait_ms < 10000 && instance->getJitStartupStats().tiered_up_functions == 0; wait_ms++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(instance->getJitStartupStats().tiered_up_functions, 1);
+  EXPECT_EQ(handle(1001), 1000);
+}
@@ -0,0 +1,117 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <dcds/dcds.hpp>
+
+static std::shared_ptr<dcds::Builder> generateSlotCounters(const std::string& name, bool single_threaded,
+                                                           size_t lock_stripes) {
+  auto builder = std::make_shared<dcds::Builder>(name);
+  if (single_threaded) builder->addHint(dcds::hints::BuilderHints::SINGLE_THREADED);
+  auto slots = builder->addAttributeArray("slots", dcds::valueType::INT64, 64, INT64_C(1), lock_stripes);
+
+  {
+    auto fn = builder->createFunction("fetch_add", dcds::valueType::INT64);
+    auto idx = fn->addArgument("idx", dcds::valueType::INT64);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    sb->addReadStatement(slots, v, idx);
+    sb->addUpdateStatement(slots, idx,
+                           std::make_shared<dcds::expressions::AddExpression>(
+                               v, std::make_shared<dcds::expressions::Int64Constant>(1)));
+    sb->addReturnStatement(v);
+  }
+  {
+    auto fn = builder->createFunction("get", dcds::valueType::INT64);
+    auto idx = fn->addArgument("idx", dcds::valueType::INT64);
+    auto v = fn->addTempVariable("v", dcds::valueType::INT64);
+    fn->getStatementBuilder()->addReadStatement(slots, v, idx);
+    fn->getStatementBuilder()->addReturnStatement(v);
+  }
+
+  if (!single_threaded) builder->injectCC();
+  builder->build();
+  return builder;
+}
+
+TEST(PrimitiveArrayTest, SingleThreaded) {
+  auto builder = generateSlotCounters("PrimitiveArrayTest_SingleThreaded", true, 0);
+  auto instance = builder->createInstance();
+  auto fetch_add = instance->get<int64_t(int64_t)>("fetch_add");
+  auto get = instance->get<int64_t(int64_t)>("get");
+
+  EXPECT_EQ(fetch_add(7), 1);
+  EXPECT_EQ(fetch_add(7), 2);
+  EXPECT_EQ(get(7), 3);
+  EXPECT_EQ(get(8), 1);
+  delete instance;
+}
+
+TEST(PrimitiveArrayTest, LockStripes) {
+  constexpr size_t iterations = 1000;
+  auto builder = generateSlotCounters("PrimitiveArrayTest_LockStripes", false, 8);
+  auto instance = builder->createInstance();
+
+  auto fetch_add = instance->get<int64_t(int64_t)>("fetch_add");
+  auto get = instance->get<int64_t(int64_t)>("get");
+
+  // more slots than stripes, so that different slots share a lock.
+  const size_t n_threads = std::thread::hardware_concurrency();
+  auto thr = dcds::ThreadRunner(n_threads);
+  thr([&](const uint64_t tid) {
+    for (size_t i = 0; i < iterations; i++) fetch_add(static_cast<int64_t>((tid + i) % 16));
+  });
+
+  int64_t sum = 0;
+  for (int64_t i = 0; i < 64; i++) sum += get(i);
+  EXPECT_EQ(sum, 64 + static_cast<int64_t>(n_threads * iterations));
+  delete instance;
+}
+
+TEST(PrimitiveArrayTest, ReadAfterUpdateInTxn) {
+  // elements are loaded in the generated code, so reads after an update in the same transaction must not be served
+  // from a value loaded before it.
+  auto builder = std::make_shared<dcds::Builder>("PrimitiveArrayTest_ReadAfterUpdateInTxn");
+  auto slots = builder->addAttributeArray("slots", dcds::valueType::INT64, 8, INT64_C(1));
+  {
+    auto fn = builder->createFunction("add_and_get", dcds::valueType::INT64);
+    auto idx = fn->addArgument("idx", dcds::valueType::INT64);
+    auto delta = fn->addArgument("delta", dcds::valueType::INT64);
+    auto before = fn->addTempVariable("before", dcds::valueType::INT64);
+    auto after = fn->addTempVariable("after", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    sb->addReadStatement(slots, before, idx);
+    sb->addUpdateStatement(slots, idx, std::make_shared<dcds::expressions::AddExpression>(before, delta));
+    sb->addReadStatement(slots, after, idx);
+    sb->addReturnStatement(after);
+  }
+
+  builder->injectCC();
+  builder->build();
+  auto instance = builder->createInstance();
+  auto add_and_get = instance->get<int64_t(int64_t, int64_t)>("add_and_get");
+
+  EXPECT_EQ(add_and_get(3, 5), 6);
+  EXPECT_EQ(add_and_get(3, 5), 11);
+  EXPECT_EQ(add_and_get(4, -1), 0);
+  delete instance;
+}
@@ -0,0 +1,82 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <dcds/util/epoch.hpp>
+#include <thread>
+
+using dcds::util::Epoch;
+
+// Memory retired while a thread is pinned is reclaimable only once the thread unpinned.
+TEST(EpochTest, PinnedThreadHoldsBackReclamation) {
+  std::atomic<int> stage{0};
+  std::thread reader([&]() {
+    Epoch::Guard pin;
+    stage = 1;
+    while (stage != 2) std::this_thread::yield();
+  });
+  while (stage != 1) std::this_thread::yield();
+
+  auto retired_at = Epoch::current();
+  EXPECT_FALSE(Epoch::reclaimable(retired_at, Epoch::tryAdvance()));
+  EXPECT_FALSE(Epoch::reclaimable(retired_at, Epoch::tryAdvance()));
+
+  stage = 2;
+  reader.join();
+  EXPECT_TRUE(Epoch::reclaimable(retired_at, Epoch::tryAdvance()));
+}
+
+// Nested sections keep the pin of the outermost one.
+TEST(EpochTest, NestedPins) {
+  auto &slot = Epoch::slot();
+  {
+    Epoch::Guard outer;
+    auto pinned = slot.pinned.load();
+    EXPECT_NE(pinned, 0);
+    {
+      Epoch::Guard inner;
+      EXPECT_EQ(slot.pinned.load(), pinned);
+    }
+    EXPECT_EQ(slot.pinned.load(), pinned);
+  }
+  EXPECT_EQ(slot.pinned.load(), 0);
+}
+
+static std::atomic<size_t> freed{0};
+
+TEST(EpochTest, RetireFreesInBatches) {
+  std::thread retirer([]() {
+    for (int i = 0; i < 40; i++) {
+      Epoch::retire(new int(i), [](void *ptr) {
+        delete static_cast<int *>(ptr);
+        freed++;
+      });
+    }
+    // no thread is pinned: the first batch is freed when it fills up, the rest when the thread exits.
+    EXPECT_GT(freed.load(), 0);
+    EXPECT_LT(freed.load(), 40);
+  });
+  retirer.join();
+  EXPECT_EQ(freed.load(), 40);
+}
@@ -0,0 +1,47 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+#include <Counter.hpp>
+#include <dcds/util/logging.hpp>
+#include <dcds/util/thread-runner.hpp>
+
+// Uses the ahead-of-time generated Counter: no builder, no JIT compilation at startup and no LLVM (dcds_runtime only).
+int main(int argc, char** argv) {
+  dcds::InitializeLog(argc, argv);
+
+  dcds::aot::Counter counter;
+  constexpr int64_t iterations = 5;
+  for (int64_t i = 0; i < iterations; i++) {
+    auto val = counter.fetch_add();
+    CHECK(val == 100 + i) << "value mismatch: " << val << " != " << 100 + i;
+  }
+
+  const auto n_threads = std::thread::hardware_concurrency();
+  auto thr = dcds::ThreadRunner(n_threads);
+  thr([&](const uint64_t) {
+    for (int64_t i = 0; i < iterations; i++) counter.fetch_add();
+  });
+  CHECK(counter.get() == 100 + iterations * (1 + static_cast<int64_t>(n_threads)))
+      << "(multi-threaded) value mismatch: " << counter.get();
+
+  LOG(INFO) << "AOT Counter: " << counter.get();
+  return 0;
+}
@@ -0,0 +1,54 @@
+/*
+                              Copyright (c) 2023.
+          Data Intensive Applications and Systems Laboratory (DIAS)
+                  École Polytechnique Fédérale de Lausanne
+
+                              All Rights Reserved.
+
+      Permission to use, copy, modify and distribute this software and
+      its documentation is hereby granted, provided that both the
+      copyright notice and this permission notice appear in all copies of
+      the software, derivative works or modified versions, and any
+      portions thereof, and that both notices appear in supporting
+      documentation.
+
+      This code is distributed in the hope that it will be useful, but
+      WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+      DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+      RESULTING FROM THE USE OF THIS SOFTWARE.
+ */
+
+#include <dcds/dcds.hpp>
+#include <dcds/exporter/code-exporter.hpp>
+
+// Exports the Counter data structure (see examples/counter) to the directory given as the only argument.
+int main(int argc, char** argv) {
+  dcds::InitializeLog(argc, argv);
+  CHECK(argc == 2) << "usage: " << argv[0] << " <output-directory>";
+
+  auto builder = std::make_shared<dcds::Builder>("Counter");
+  auto ctr_attr = builder->addAttribute("ctr", dcds::valueType::INT64, UINT64_C(100));
+
+  {
+    auto fn = builder->createFunction("fetch_add", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    auto tmpVar = fn->addTempVariable("tmp", dcds::valueType::INT64);
+    sb->addReadStatement(ctr_attr, tmpVar);
+    sb->addUpdateStatement(ctr_attr, std::make_shared<dcds::expressions::AddExpression>(
+                                         tmpVar, std::make_shared<dcds::expressions::Int64Constant>(1)));
+    sb->addReturnStatement(tmpVar);
+  }
+  {
+    auto fn = builder->createFunction("get", dcds::valueType::INT64);
+    auto sb = fn->getStatementBuilder();
+    auto tmpVar = fn->addTempVariable("tmp", dcds::valueType::INT64);
+    sb->addReadStatement(ctr_attr, tmpVar);
+    sb->addReturnStatement(tmpVar);
+  }
+  builder->injectCC();
+
+  // the default, baseline-CPU target: the library may run on other machines than the one building it.
+  dcds::CodeExporter(builder).exportToDirectory(argv[1]);
+  return 0;
+}